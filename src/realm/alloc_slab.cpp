@@ -109,6 +109,20 @@ SlabAlloc::SlabAlloc()
         m_section_bases[i] = compute_section_base(i);
     }
     m_section_bases[m_num_section_bases] = max;
+    set_translation_cache_size(default_translation_cache_size); // Throws
+}
+
+
+constexpr size_t SlabAlloc::translation_cache_ways;
+constexpr size_t SlabAlloc::default_translation_cache_size;
+
+void SlabAlloc::set_translation_cache_size(size_t num_entries)
+{
+    size_t num_sets = 1;
+    while (num_sets * translation_cache_ways < num_entries)
+        num_sets <<= 1;
+    m_cache.reset(new hash_set[num_sets]); // Throws
+    m_cache_mask = num_sets - 1;
 }
 
 util::File& SlabAlloc::get_file()
@@ -366,6 +380,13 @@ void SlabAlloc::FreeBlock::unlink()
 void SlabAlloc::remove_freelist_entry(FreeBlock* entry)
 {
     int size = bb_before(entry)->block_after_size;
+    if (is_small_block(size)) {
+        FreeBlock*& header = m_size_classes[size >> 3];
+        if (header == entry)
+            header = entry->next == entry ? nullptr : entry->next;
+        entry->unlink();
+        return;
+    }
     auto it = m_block_map.find(size);
     REALM_ASSERT_EX(it != m_block_map.end(), get_file_path_for_assertions());
     auto header = it->second;
@@ -382,6 +403,20 @@ void SlabAlloc::remove_freelist_entry(FreeBlock* entry)
 void SlabAlloc::push_freelist_entry(FreeBlock* entry)
 {
     int size = bb_before(entry)->block_after_size;
+    if (is_small_block(size)) {
+        FreeBlock*& header = m_size_classes[size >> 3];
+        if (header) {
+            entry->next = header;
+            entry->prev = header->prev;
+            entry->prev->next = entry;
+            entry->next->prev = entry;
+        }
+        else {
+            entry->next = entry->prev = entry;
+        }
+        header = entry;
+        return;
+    }
     FreeBlock* header;
     auto it = m_block_map.find(size);
     if (it != m_block_map.end()) {
@@ -423,18 +458,45 @@ void SlabAlloc::mark_allocated(FreeBlock* entry)
 
 SlabAlloc::FreeBlock* SlabAlloc::allocate_block(int size)
 {
-    FreeList list = find(size);
-    if (list.found_exact(size)) {
-        return pop_freelist_entry(list);
-    }
-    // no exact matches.
-    list = find_larger(list, size);
     FreeBlock* block;
-    if (list.found_something()) {
-        block = pop_freelist_entry(list);
-    }
-    else {
-        block = grow_slab_for(size);
+    for (;;) {
+        if (is_small_block(size)) {
+            block = m_size_classes[size >> 3];
+            if (block) {
+                remove_freelist_entry(block);
+                return block;
+            }
+            // Split the smallest free block from a larger size class, which
+            // leaves room for a free block after it
+            int needed_size = size + sizeof(BetweenBlocks) + sizeof(FreeBlock);
+            block = nullptr;
+            for (int i = (needed_size + 7) >> 3; i <= max_small_block_size >> 3; ++i) {
+                block = m_size_classes[i];
+                if (block)
+                    break;
+            }
+            if (block) {
+                remove_freelist_entry(block);
+                break;
+            }
+        }
+        FreeList list = find(size);
+        if (list.found_exact(size)) {
+            return pop_freelist_entry(list);
+        }
+        // no exact matches.
+        list = find_larger(list, size);
+        if (list.found_something()) {
+            block = pop_freelist_entry(list);
+            break;
+        }
+        // Small blocks freed since the last pass may now be merged into a
+        // block which is large enough
+        if (!m_has_unmerged_blocks) {
+            block = grow_slab_for(size);
+            break;
+        }
+        coalesce_free_blocks();
     }
     FreeBlock* remaining = break_block(block, size);
     if (remaining)
@@ -461,6 +523,32 @@ SlabAlloc::FreeBlock* SlabAlloc::slab_to_entry(const Slab& slab, ref_type ref_st
 void SlabAlloc::clear_freelists()
 {
     m_block_map.clear();
+    std::fill(std::begin(m_size_classes), std::end(m_size_classes), nullptr);
+    m_has_unmerged_blocks = false;
+}
+
+void SlabAlloc::coalesce_free_blocks()
+{
+    clear_freelists();
+    for (const auto& e : m_slabs) {
+        BetweenBlocks* bb = reinterpret_cast<BetweenBlocks*>(e.addr.get());
+        FreeBlock* run = nullptr; // free block being extended
+        while (int size = bb->block_after_size) {
+            if (size < 0) {
+                if (run) {
+                    push_freelist_entry(run);
+                    run = nullptr;
+                }
+                bb = reinterpret_cast<BetweenBlocks*>(reinterpret_cast<char*>(bb + 1) - size);
+                continue;
+            }
+            FreeBlock* block = block_after(bb);
+            bb = bb_after(block);
+            run = run ? merge_blocks(run, block) : block;
+        }
+        if (run)
+            push_freelist_entry(run);
+    }
 }
 
 void SlabAlloc::rebuild_freelists_from_slab()
@@ -626,8 +714,14 @@ void SlabAlloc::do_free(ref_type ref, char* addr) noexcept
 
 void SlabAlloc::free_block(ref_type ref, SlabAlloc::FreeBlock* block)
 {
-    // merge with surrounding blocks if possible
     block->ref = ref;
+    // small blocks are merged lazily by coalesce_free_blocks()
+    if (is_small_block(size_from_block(block))) {
+        push_freelist_entry(block);
+        m_has_unmerged_blocks = true;
+        return;
+    }
+    // merge with surrounding blocks if possible
     FreeBlock* prev = get_prev_block_if_mergeable(block);
     if (prev) {
         remove_freelist_entry(prev);
@@ -692,9 +786,23 @@ char* SlabAlloc::do_translate(ref_type ref) const noexcept
     // 32. Shifting twice x16 however, is defined and gives zero. On 64-bitters
     // the compiler should reduce it to a single 32 bit shift.
     cache_index = cache_index ^ (cache_index >> 16);
-    cache_index = (cache_index ^ (cache_index >> 8)) & 0xFF;
-    if (cache[cache_index].ref == ref && cache[cache_index].version == version)
-        return const_cast<char*>(cache[cache_index].addr);
+    cache_index = (cache_index ^ (cache_index >> 8) ^ (cache_index >> 3)) & m_cache_mask;
+    hash_set& set = m_cache[cache_index];
+    for (hash_entry& entry : set.ways) {
+        size_t seq = entry.seq.load(std::memory_order_acquire);
+        if ((seq & 1) == 0 && entry.ref.load(std::memory_order_relaxed) == ref &&
+            entry.version.load(std::memory_order_relaxed) == version) {
+            addr = entry.addr.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (entry.seq.load(std::memory_order_relaxed) == seq) {
+                if (REALM_UNLIKELY(m_cache_stats_enabled))
+                    m_cache_hits.fetch_add(1, std::memory_order_relaxed);
+                return const_cast<char*>(addr);
+            }
+        }
+    }
+    if (REALM_UNLIKELY(m_cache_stats_enabled))
+        m_cache_misses.fetch_add(1, std::memory_order_relaxed);
 
     if (ref < m_baseline) {
 
@@ -735,9 +843,17 @@ char* SlabAlloc::do_translate(ref_type ref) const noexcept
         ref_type slab_ref = i == m_slabs.begin() ? m_baseline : (i - 1)->ref_end;
         addr = i->addr.get() + (ref - slab_ref);
     }
-    cache[cache_index].addr = addr;
-    cache[cache_index].ref = ref;
-    cache[cache_index].version = version;
+    // If another thread is refilling this entry, just leave it to that thread
+    size_t victim = set.next_victim.fetch_add(1, std::memory_order_relaxed) % translation_cache_ways;
+    hash_entry& entry = set.ways[victim];
+    size_t seq = entry.seq.load(std::memory_order_relaxed);
+    if ((seq & 1) == 0 && entry.seq.compare_exchange_strong(seq, seq + 1, std::memory_order_relaxed)) {
+        std::atomic_thread_fence(std::memory_order_release);
+        entry.addr.store(addr, std::memory_order_relaxed);
+        entry.ref.store(ref, std::memory_order_relaxed);
+        entry.version.store(version, std::memory_order_relaxed);
+        entry.seq.store(seq + 2, std::memory_order_release);
+    }
     REALM_ASSERT_DEBUG(addr != nullptr);
     return const_cast<char*>(addr);
 }
@@ -792,6 +908,9 @@ ref_type SlabAlloc::attach_file(const std::string& file_path, Config& cfg)
 
     REALM_ASSERT_EX(!is_attached(), get_file_path_for_assertions());
 
+    if (cfg.translation_cache_size != 0)
+        set_translation_cache_size(cfg.translation_cache_size); // Throws
+
     // When 'read_only' is true, this function will throw InvalidDatabase if the
     // file exists already but is empty. This can happen if another process is
     // currently creating it. Note however, that it is only legal for multiple
@@ -1300,6 +1419,41 @@ void SlabAlloc::update_reader_view(size_t file_size)
         */
 }
 
+void SlabAlloc::shrink_reader_view(size_t file_size)
+{
+    internal_invalidate_cache();
+    REALM_ASSERT_EX(matches_section_boundary(file_size), file_size, get_file_path_for_assertions());
+    REALM_ASSERT_DEBUG(is_free_space_clean());
+
+    // The initial mapping cannot be shrunk
+    size_t new_baseline = std::max(file_size, m_initial_chunk_size);
+    if (new_baseline >= m_baseline)
+        return;
+    size_t old_baseline = m_baseline;
+    m_baseline = new_baseline;
+    {
+        std::lock_guard<util::Mutex> lock(m_file_mappings->m_mutex);
+
+        size_t num_additional_mappings = 0;
+        if (new_baseline > m_initial_chunk_size)
+            num_additional_mappings = get_section_index(new_baseline) - m_file_mappings->m_first_additional_mapping;
+        for (size_t k = num_additional_mappings; k < m_file_mappings->m_num_global_mappings; ++k)
+            m_file_mappings->m_global_mappings[k].reset();
+        if (num_additional_mappings < m_file_mappings->m_num_global_mappings)
+            m_file_mappings->m_num_global_mappings = num_additional_mappings;
+        for (size_t k = num_additional_mappings; k < m_num_local_mappings; ++k)
+            m_local_mappings[k].reset();
+        if (num_additional_mappings < m_num_local_mappings)
+            m_num_local_mappings = num_additional_mappings;
+    }
+    // Rebase slabs as m_baseline has moved
+    size_t ref_displacement = old_baseline - m_baseline;
+    for (auto& e : m_slabs) {
+        e.ref_end -= ref_displacement;
+    }
+    rebuild_freelists_from_slab();
+}
+
 size_t SlabAlloc::get_allocated_size() const noexcept
 {
     size_t sz = 0;
@@ -100,6 +100,10 @@ public:
     /// Always initialize the file as if it was a newly
     /// created file and ignore any pre-existing contents. Requires that
     /// Config::session_initiator be true as well.
+    ///
+    /// \var Config::translation_cache_size
+    /// The number of entries in the cache of ref to address translations, or
+    /// zero to keep the current size. See set_translation_cache_size().
     struct Config {
         bool is_shared = false;
         bool read_only = false;
@@ -109,6 +113,7 @@ public:
         bool clear_file = false;
         bool disable_sync = false;
         const char* encryption_key = nullptr;
+        size_t translation_cache_size = 0;
     };
 
     struct Retry {
@@ -290,11 +295,37 @@ public:
     /// and force any later address translations to trigger decryption if required.
     void update_reader_view(size_t file_size);
 
+    /// Drop the part of the readers view of the file beyond the specified
+    /// size, after the file has been truncated to it, such that a later call
+    /// to update_reader_view() maps that part again. The initial mapping of the
+    /// file is kept as it is. The specified size must be aligned to a section
+    /// boundary, the free space must be clean, and no other allocator may be
+    /// using the file.
+    void shrink_reader_view(size_t file_size);
+
     /// Returns true initially, and after a call to reset_free_space_tracking()
     /// up until the point of the first call to SlabAlloc::alloc(). Note that a
     /// call to SlabAlloc::alloc() corresponds to a mutation event.
     bool is_free_space_clean() const noexcept;
 
+    /// Resize the cache of ref to address translations. The cache is
+    /// set-associative with translation_cache_ways entries per set, and the
+    /// specified number of entries is rounded up to a power of two number of
+    /// sets. The cache is emptied. Must not be called while other threads may
+    /// be accessing the allocator.
+    void set_translation_cache_size(size_t num_entries);
+    size_t get_translation_cache_size() const noexcept;
+
+    /// Counting of translation cache hits and misses is disabled initially,
+    /// as the counters are shared by all threads accessing the allocator. The
+    /// counters are cumulative, and are not reset when counting is disabled.
+    void set_translation_cache_stats_enabled(bool enabled) noexcept;
+    uint_fast64_t get_translation_cache_hits() const noexcept;
+    uint_fast64_t get_translation_cache_misses() const noexcept;
+
+    static constexpr size_t translation_cache_ways = 4;
+    static constexpr size_t default_translation_cache_size = 2048;
+
     /// Returns the amount of memory requested by calls to SlabAlloc::alloc().
     size_t get_commit_size() const
     {
@@ -424,6 +455,20 @@ private:
     using FreeListMap = std::map<int, FreeBlock*>;  // log(N) addressing for larger blocks
     FreeListMap m_block_map;
 
+    // Free blocks of up to max_small_block_size bytes are kept in exact size
+    // classes, one circular list per multiple of 8 bytes, so that they can be
+    // allocated and freed in constant time. They are not merged with their
+    // neighbours when they are freed. Instead, adjacent free blocks are
+    // coalesced in a single pass over the slabs when an allocation would
+    // otherwise have to grow the slab area (see coalesce_free_blocks()).
+    static constexpr int max_small_block_size = 1024;
+    FreeBlock* m_size_classes[max_small_block_size / 8 + 1] = {};
+    bool m_has_unmerged_blocks = false;
+    static bool is_small_block(int size) noexcept
+    {
+        return size <= max_small_block_size;
+    }
+
     // abstract notion of a freelist - used to hide whether a freelist
     // is residing in the small blocks or the large blocks structures.
     struct FreeList {
@@ -484,6 +529,8 @@ private:
     void remove_freelist_entry(FreeBlock* element);
     void rebuild_freelists_from_slab();
     void clear_freelists();
+    // merge all adjacent free blocks, and rebuild the freelists from the result
+    void coalesce_free_blocks();
 
     // grow the slab area to accommodate the requested size.
     // returns a free block large enough to handle the request.
@@ -572,13 +619,25 @@ private:
     size_t m_commit_size = 0;
 
     bool m_debug_out = false;
+    // Translation cache entries may be read and refilled by several threads at once (e.g. parallel query
+    // execution), so each entry is guarded by a sequence number which is odd while the entry is being written.
     struct hash_entry {
-        ref_type ref = 0;
-        const char* addr = nullptr;
-        size_t version = 0;
+        std::atomic<size_t> seq{0};
+        std::atomic<ref_type> ref{0};
+        std::atomic<const char*> addr{nullptr};
+        std::atomic<size_t> version{0};
+    };
+    // On a miss, the ways of a set are refilled in round robin order.
+    struct hash_set {
+        hash_entry ways[translation_cache_ways];
+        std::atomic<size_t> next_victim{0};
     };
-    mutable hash_entry cache[256];
+    std::unique_ptr<hash_set[]> m_cache;
+    size_t m_cache_mask = 0; // number of sets - 1
     mutable size_t version = 1;
+    bool m_cache_stats_enabled = false;
+    mutable std::atomic<uint_fast64_t> m_cache_hits{0};
+    mutable std::atomic<uint_fast64_t> m_cache_misses{0};
 
     /// Throws if free-lists are no longer valid.
     size_t consolidate_free_read_only();
@@ -623,6 +682,26 @@ inline void SlabAlloc::internal_invalidate_cache() noexcept
     ++version;
 }
 
+inline size_t SlabAlloc::get_translation_cache_size() const noexcept
+{
+    return (m_cache_mask + 1) * translation_cache_ways;
+}
+
+inline void SlabAlloc::set_translation_cache_stats_enabled(bool enabled) noexcept
+{
+    m_cache_stats_enabled = enabled;
+}
+
+inline uint_fast64_t SlabAlloc::get_translation_cache_hits() const noexcept
+{
+    return m_cache_hits.load(std::memory_order_relaxed);
+}
+
+inline uint_fast64_t SlabAlloc::get_translation_cache_misses() const noexcept
+{
+    return m_cache_misses.load(std::memory_order_relaxed);
+}
+
 class SlabAlloc::DetachGuard {
 public:
     DetachGuard(SlabAlloc& alloc) noexcept
@@ -1062,6 +1062,78 @@ size_t find_zero(uint64_t v)
     return start;
 }
 
+#ifdef REALM_COMPILER_AVX
+
+// Sums 'chunks' 32-byte vectors of packed signed w-bit integers. Partial sums are widened to 64 bits on every
+// iteration, so unlike the SSE path in Array::sum() this cannot overflow for large arrays.
+template <size_t w>
+REALM_TARGET_AVX2 int64_t sum_avx2(const __m256i* data, size_t chunks)
+{
+    const __m256i ones = _mm256_set1_epi16(1);
+    __m256i sum_result = _mm256_setzero_si256();
+
+    for (size_t t = 0; t < chunks; ++t) {
+        __m256i v = _mm256_load_si256(data + t);
+        if (w == 8) {
+            // sign extend 8->16, add the halves, then pairwise add 16->32
+            __m256i vl = _mm256_cvtepi8_epi16(_mm256_castsi256_si128(v));
+            __m256i vh = _mm256_cvtepi8_epi16(_mm256_extracti128_si256(v, 1));
+            v = _mm256_madd_epi16(_mm256_add_epi16(vl, vh), ones);
+        }
+        else if (w == 16) {
+            v = _mm256_madd_epi16(v, ones); // pairwise add 16->32
+        }
+
+        if (w == 64) {
+            sum_result = _mm256_add_epi64(sum_result, v);
+        }
+        else {
+            // sign extend dwords 32->64
+            sum_result = _mm256_add_epi64(sum_result, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(v)));
+            sum_result = _mm256_add_epi64(sum_result, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(v, 1)));
+        }
+    }
+
+    int64_t lanes[4];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), sum_result);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3];
+}
+
+// Returns the largest (find_max) or smallest element of 'chunks' 32-byte vectors of packed signed w-bit integers
+template <bool find_max, size_t w>
+REALM_TARGET_AVX2 int64_t minmax_avx2(const __m256i* data, size_t chunks)
+{
+    __m256i state = _mm256_load_si256(data);
+
+    for (size_t t = 1; t < chunks; ++t) {
+        __m256i v = _mm256_load_si256(data + t);
+        if (w == 8)
+            state = find_max ? _mm256_max_epi8(v, state) : _mm256_min_epi8(v, state);
+        else if (w == 16)
+            state = find_max ? _mm256_max_epi16(v, state) : _mm256_min_epi16(v, state);
+        else if (w == 32)
+            state = find_max ? _mm256_max_epi32(v, state) : _mm256_min_epi32(v, state);
+        else {
+            // No 64-bit min/max before AVX-512, so select with a compare mask
+            __m256i v_is_better = find_max ? _mm256_cmpgt_epi64(v, state) : _mm256_cmpgt_epi64(state, v);
+            state = _mm256_blendv_epi8(state, v, v_is_better);
+        }
+    }
+
+    // Use memcpy to avoid aliasing problems, see comment in the disabled SSE path of Array::minmax()
+    char lanes[sizeof(__m256i)];
+    memcpy(lanes, &state, sizeof lanes);
+    int64_t m = get_direct<w>(lanes, 0);
+    for (size_t t = 1; t < sizeof(__m256i) * 8 / no0(w); ++t) {
+        int64_t v = get_direct<w>(lanes, t);
+        if (find_max ? v > m : v < m)
+            m = v;
+    }
+    return m;
+}
+
+#endif // REALM_COMPILER_AVX
+
 } // anonymous namesapce
 
 
@@ -1087,6 +1159,31 @@ bool Array::minmax(int64_t& result, size_t start, size_t end, size_t* return_ndx
     int64_t m = get<w>(start);
     ++start;
 
+#ifdef REALM_COMPILER_AVX
+    if (sseavx<2>() && w >= 8) {
+        // Test manually until 256 bit aligned
+        for (; (start < end) && (((size_t(m_data) & 0x1f) * 8 + start * w) % 256 != 0); start++) {
+            if (find_max ? get<w>(start) > m : get<w>(start) < m) {
+                m = get<w>(start);
+                best_index = start;
+            }
+        }
+
+        size_t chunks = (end - start) * w / 256;
+        if (chunks > 0) {
+            const size_t chunk_end = start + chunks * 256 / no0(w);
+            int64_t v = minmax_avx2<find_max, w>(reinterpret_cast<const __m256i*>(m_data + start * w / 8), chunks);
+            // The vector kernel only finds the value. Since everything before 'start' is strictly worse, the first
+            // occurrence of it within the vectorized range is the first occurrence overall.
+            if (find_max ? v > m : v < m) {
+                m = v;
+                best_index = find_first<Equal>(v, start, chunk_end);
+            }
+            start = chunk_end;
+        }
+    }
+#endif
+
 #if 0 // We must now return both value AND index of result. SSE does not support finding index, so we've disabled it
 #ifdef REALM_COMPILER_SSE
     if (sseavx<42>()) {
@@ -1175,6 +1272,21 @@ int64_t Array::sum(size_t start, size_t end) const
 
     int64_t s = 0;
 
+#ifdef REALM_COMPILER_AVX
+    if (sseavx<2>() && (w == 8 || w == 16 || w == 32 || w == 64)) {
+        // Sum manually until 256 bit aligned
+        for (; (start < end) && (((size_t(m_data) & 0x1f) * 8 + start * w) % 256 != 0); start++) {
+            s += get<w>(start);
+        }
+
+        size_t chunks = (end - start) * w / 256;
+        if (chunks > 0) {
+            s += sum_avx2<w>(reinterpret_cast<const __m256i*>(m_data + start * w / 8), chunks);
+            start += chunks * 256 / no0(w);
+        }
+    }
+#endif
+
     // Sum manually until 128 bit aligned
     for (; (start < end) && (((size_t(m_data) & 0xf) * 8 + start * w) % 128 != 0); start++) {
         s += get<w>(start);
@@ -1347,6 +1459,18 @@ size_t Array::count(int64_t value) const noexcept
             return m_size;
         return 0;
     }
+
+#ifdef REALM_COMPILER_AVX
+    // The vectorized finder counts a full vector of matches at a time, which beats the bit tricks below for
+    // byte-sized and wider elements
+    if (m_width >= 8 && sseavx<2>()) {
+        QueryState<int64_t> state;
+        state.init(act_Count, nullptr, size_t(-1));
+        REALM_TEMPEX3(find, Equal, act_Count, m_width, (value, 0, m_size, 0, &state, CallbackDummy()));
+        return size_t(state.m_state);
+    }
+#endif
+
     if (m_width == 1) {
         if (uint64_t(value) > 1)
             return 0;
@@ -70,6 +70,9 @@ Searching: The main finding function is:
 #include <emmintrin.h>             // SSE2
 #include <realm/realm_nmmintrin.h> // SSE42
 #endif
+#ifdef REALM_COMPILER_AVX
+#include <immintrin.h> // AVX2, AVX-512 (only used from functions marked REALM_TARGET_AVX2/REALM_TARGET_AVX512)
+#endif
 
 namespace realm {
 
@@ -761,6 +764,18 @@ public:
 
 #endif
 
+// AVX2 and AVX-512 find for the four functions Equal/NotEqual/Less/Greater. Callers must check sseavx<2>() and
+// sseavx<512>() respectively.
+#ifdef REALM_COMPILER_AVX
+    template <class cond, Action action, size_t width, class Callback>
+    REALM_TARGET_AVX2 bool find_avx2(int64_t value, const __m256i* data, size_t items, QueryState<int64_t>* state,
+                                     size_t baseindex, Callback callback) const;
+
+    template <class cond, Action action, size_t width, class Callback>
+    REALM_TARGET_AVX512 bool find_avx512(int64_t value, const __m512i* data, size_t items,
+                                         QueryState<int64_t>* state, size_t baseindex, Callback callback) const;
+#endif
+
     template <size_t width>
     inline bool test_zero(uint64_t value) const; // Tests value for 0-elements
 
@@ -2336,6 +2351,40 @@ bool Array::find_optimized(int64_t value, size_t start, size_t end, size_t basei
     // finder cannot handle this bitwidth
     REALM_ASSERT_3(m_width, !=, 0);
 
+#if defined(REALM_COMPILER_AVX)
+    // Use AVX-512 or AVX2 if available and the payload spans at least two vectors, so that the aligned middle part
+    // is never empty. Unlike SSE, both support all four conditions at all widths from 8 to 64 bits.
+    if (m_width >= 8 && sseavx<2>()) {
+        // Avoid instantiating the vector kernels for widths they can never be called with
+        constexpr size_t simd_width = bitwidth < 8 ? 8 : bitwidth;
+        const size_t vector_size = sseavx<512>() ? 64 : 32;
+
+        if ((end - start2) * bitwidth / 8 >= 2 * vector_size) {
+            char* const a = static_cast<char*>(round_up(m_data + start2 * bitwidth / 8, vector_size));
+            char* const b = static_cast<char*>(round_down(m_data + end * bitwidth / 8, vector_size));
+            const size_t a_ndx = (a - m_data) * 8 / no0(bitwidth);
+            const size_t b_ndx = (b - m_data) * 8 / no0(bitwidth);
+
+            if (!compare<cond, action, bitwidth, Callback>(value, start2, a_ndx, baseindex, state, callback))
+                return false;
+
+            if (vector_size == 64) {
+                if (!find_avx512<cond, action, simd_width, Callback>(value, reinterpret_cast<const __m512i*>(a),
+                                                                     (b - a) / 64, state, baseindex + a_ndx,
+                                                                     callback))
+                    return false;
+            }
+            else {
+                if (!find_avx2<cond, action, simd_width, Callback>(value, reinterpret_cast<const __m256i*>(a),
+                                                                   (b - a) / 32, state, baseindex + a_ndx, callback))
+                    return false;
+            }
+
+            return compare<cond, action, bitwidth, Callback>(value, b_ndx, end, baseindex, state, callback);
+        }
+    }
+#endif
+
 #if defined(REALM_COMPILER_SSE)
     // Only use SSE if payload is at least one SSE chunk (128 bits) in size. Also note taht SSE doesn't support
     // Less-than comparison for 64-bit values.
@@ -2864,6 +2913,138 @@ REALM_FORCEINLINE bool Array::find_sse_intern(__m128i* action_data, __m128i* dat
 }
 #endif // REALM_COMPILER_SSE
 
+#ifdef REALM_COMPILER_AVX
+// 'items' is the number of 32-byte AVX2 chunks. Indexes reported to the action are relative to 'baseindex', which
+// must correspond to the first element of the first chunk.
+template <class cond, Action action, size_t width, class Callback>
+bool Array::find_avx2(int64_t value, const __m256i* data, size_t items, QueryState<int64_t>* state,
+                      size_t baseindex, Callback callback) const
+{
+    static_assert(width >= 8, "Sub-byte widths are handled by compare()");
+
+    __m256i search;
+    if (width == 8)
+        search = _mm256_set1_epi8(static_cast<char>(value));
+    else if (width == 16)
+        search = _mm256_set1_epi16(static_cast<short int>(value));
+    else if (width == 32)
+        search = _mm256_set1_epi32(static_cast<int>(value));
+    else
+        search = _mm256_set1_epi64x(value);
+
+    // _mm256_movemask_epi8() yields one bit per byte. Keep only the bit of the lowest byte of each element, so that
+    // the mask has exactly one bit per matching element and can be handed to find_action_pattern() as is.
+    const unsigned int element_bits = static_cast<unsigned int>(lower_bits<width / 8>());
+
+    for (size_t i = 0; i < items; ++i) {
+        __m256i chunk = _mm256_load_si256(data + i);
+        __m256i compare_result;
+
+        if (std::is_same<cond, Equal>::value || std::is_same<cond, NotEqual>::value) {
+            if (width == 8)
+                compare_result = _mm256_cmpeq_epi8(chunk, search);
+            else if (width == 16)
+                compare_result = _mm256_cmpeq_epi16(chunk, search);
+            else if (width == 32)
+                compare_result = _mm256_cmpeq_epi32(chunk, search);
+            else
+                compare_result = _mm256_cmpeq_epi64(chunk, search);
+        }
+        else {
+            // Greater compares chunk > search, Less compares search > chunk
+            __m256i lhs = std::is_same<cond, Greater>::value ? chunk : search;
+            __m256i rhs = std::is_same<cond, Greater>::value ? search : chunk;
+            if (width == 8)
+                compare_result = _mm256_cmpgt_epi8(lhs, rhs);
+            else if (width == 16)
+                compare_result = _mm256_cmpgt_epi16(lhs, rhs);
+            else if (width == 32)
+                compare_result = _mm256_cmpgt_epi32(lhs, rhs);
+            else
+                compare_result = _mm256_cmpgt_epi64(lhs, rhs);
+        }
+
+        unsigned int resmask = static_cast<unsigned int>(_mm256_movemask_epi8(compare_result));
+        if (std::is_same<cond, NotEqual>::value)
+            resmask = ~resmask;
+        resmask &= element_bits;
+
+        if (resmask == 0)
+            continue;
+
+        size_t s = baseindex + i * 256 / width;
+        if (find_action_pattern<action, Callback>(s, resmask, state, callback))
+            continue;
+
+        const char* chunk_data = reinterpret_cast<const char*>(data + i);
+        while (resmask != 0) {
+            size_t idx = first_set_bit(resmask) / (width / 8);
+            if (!find_action<action, Callback>(s + idx, get_universal<width>(chunk_data, idx), state, callback))
+                return false;
+            resmask &= resmask - 1;
+        }
+    }
+
+    return true;
+}
+
+// 'items' is the number of 64-byte AVX-512 chunks. AVX-512 compares produce one mask bit per element directly.
+template <class cond, Action action, size_t width, class Callback>
+bool Array::find_avx512(int64_t value, const __m512i* data, size_t items, QueryState<int64_t>* state,
+                        size_t baseindex, Callback callback) const
+{
+    static_assert(width >= 8, "Sub-byte widths are handled by compare()");
+
+    // Greater is expressed as 'not less-or-equal'
+    constexpr int predicate = std::is_same<cond, Equal>::value
+                                  ? _MM_CMPINT_EQ
+                                  : std::is_same<cond, NotEqual>::value
+                                        ? _MM_CMPINT_NE
+                                        : std::is_same<cond, Greater>::value ? _MM_CMPINT_NLE : _MM_CMPINT_LT;
+
+    __m512i search;
+    if (width == 8)
+        search = _mm512_set1_epi8(static_cast<char>(value));
+    else if (width == 16)
+        search = _mm512_set1_epi16(static_cast<short int>(value));
+    else if (width == 32)
+        search = _mm512_set1_epi32(static_cast<int>(value));
+    else
+        search = _mm512_set1_epi64(value);
+
+    for (size_t i = 0; i < items; ++i) {
+        __m512i chunk = _mm512_load_si512(data + i);
+        uint64_t resmask;
+
+        if (width == 8)
+            resmask = _mm512_cmp_epi8_mask(chunk, search, predicate);
+        else if (width == 16)
+            resmask = _mm512_cmp_epi16_mask(chunk, search, predicate);
+        else if (width == 32)
+            resmask = _mm512_cmp_epi32_mask(chunk, search, predicate);
+        else
+            resmask = _mm512_cmp_epi64_mask(chunk, search, predicate);
+
+        if (resmask == 0)
+            continue;
+
+        size_t s = baseindex + i * 512 / width;
+        if (find_action_pattern<action, Callback>(s, resmask, state, callback))
+            continue;
+
+        const char* chunk_data = reinterpret_cast<const char*>(data + i);
+        while (resmask != 0) {
+            size_t idx = first_set_bit64(resmask);
+            if (!find_action<action, Callback>(s + idx, get_universal<width>(chunk_data, idx), state, callback))
+                return false;
+            resmask &= resmask - 1;
+        }
+    }
+
+    return true;
+}
+#endif // REALM_COMPILER_AVX
+
 template <class cond, Action action, class Callback>
 bool Array::compare_leafs(const Array* foreign, size_t start, size_t end, size_t baseindex,
                           QueryState<int64_t>* state, Callback callback) const
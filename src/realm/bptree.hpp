@@ -20,6 +20,7 @@
 #define REALM_BPTREE_HPP
 
 #include <memory> // std::unique_ptr
+#include <vector>
 #include <realm/array.hpp>
 #include <realm/array_basic.hpp>
 #include <realm/column_type_traits.hpp>
@@ -286,6 +287,10 @@ public:
     void set_null(size_t);
     void insert(size_t ndx, T value, size_t num_rows = 1);
     void erase(size_t ndx, bool is_last = false);
+    /// Erase the elements at the specified indexes, which must be in ascending
+    /// order and unique. When many elements are erased, the remaining ones are
+    /// moved into place in a single pass rather than erased one by one.
+    void erase(const std::vector<size_t>& sorted_ndxs);
     void move_last_over(size_t ndx, size_t last_row_ndx);
     void clear();
     T front() const noexcept;
@@ -1013,6 +1018,46 @@ void BpTree<T>::erase(size_t ndx, bool is_last)
     }
 }
 
+template <class T>
+void BpTree<T>::erase(const std::vector<size_t>& sorted_ndxs)
+{
+    if (sorted_ndxs.empty())
+        return;
+    size_t prior_size = size();
+    size_t num_erased = sorted_ndxs.size();
+    REALM_ASSERT_DEBUG(sorted_ndxs.back() < prior_size);
+
+    // Erasing an element from the middle of a leaf shifts half a leaf on
+    // average, and moving an element is a lookup followed by an update, so
+    // compaction pays off when it moves fewer than a few elements per erased one
+    size_t num_moved = prior_size - sorted_ndxs.front() - num_erased;
+    const size_t max_moved_per_erased = 4;
+    if (num_moved > num_erased * max_moved_per_erased) {
+        size_t size = prior_size;
+        for (auto i = sorted_ndxs.rbegin(); i != sorted_ndxs.rend(); ++i) {
+            bool is_last = (*i == size - 1);
+            erase(*i, is_last); // Throws
+            --size;
+        }
+        return;
+    }
+
+    size_t dst = sorted_ndxs.front();
+    auto next_erased = sorted_ndxs.begin();
+    for (size_t src = dst; src < prior_size; ++src) {
+        if (next_erased != sorted_ndxs.end() && *next_erased == src) {
+            ++next_erased;
+            continue;
+        }
+        set(dst, get(src)); // Throws
+        ++dst;
+    }
+    for (size_t size = prior_size; size > dst; --size) {
+        bool is_last = true;
+        erase(size - 1, is_last); // Throws
+    }
+}
+
 template <class T>
 void BpTree<T>::move_last_over(size_t row_ndx, size_t last_row_ndx)
 {
@@ -0,0 +1,151 @@
+/*************************************************************************
+ *
+ * Copyright 2018 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#ifndef REALM_BULK_COLUMN_HPP
+#define REALM_BULK_COLUMN_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#include <realm/binary_data.hpp>
+#include <realm/data_type.hpp>
+#include <realm/string_data.hpp>
+#include <realm/timestamp.hpp>
+
+namespace realm {
+
+/// The values of one column of the rows inserted by Table::insert_rows() or
+/// Table::add_rows(), given as a column-major buffer with one element per
+/// inserted row.
+///
+/// The buffer is not copied, so it must stay valid until the rows have been
+/// inserted. The type of the buffer must match the type of the column;
+/// `int64_t` for integer columns, `bool` for boolean columns, and so on.
+///
+/// Integer, boolean, float and double values can be accompanied by a null
+/// bitmap, in which bit `i % 8` of byte `i / 8` is set if the value of the i'th
+/// inserted row is null. String, binary and timestamp values are null when
+/// their own `is_null()` says so.
+class BulkColumn {
+public:
+    BulkColumn(size_t col_ndx, const int64_t* values, const uint8_t* nulls = nullptr) noexcept;
+    BulkColumn(size_t col_ndx, const bool* values, const uint8_t* nulls = nullptr) noexcept;
+    BulkColumn(size_t col_ndx, const float* values, const uint8_t* nulls = nullptr) noexcept;
+    BulkColumn(size_t col_ndx, const double* values, const uint8_t* nulls = nullptr) noexcept;
+    BulkColumn(size_t col_ndx, const StringData* values) noexcept;
+    BulkColumn(size_t col_ndx, const BinaryData* values) noexcept;
+    BulkColumn(size_t col_ndx, const Timestamp* values) noexcept;
+
+    size_t get_column_index() const noexcept;
+    DataType get_type() const noexcept;
+
+    /// The buffer of values. `T` must be the type that this column was
+    /// constructed from.
+    template <class T>
+    const T* get_values() const noexcept;
+
+    bool is_null(size_t i) const noexcept;
+
+private:
+    size_t m_col_ndx;
+    DataType m_type;
+    const void* m_values;
+    const uint8_t* m_nulls;
+
+    BulkColumn(size_t col_ndx, DataType, const void* values, const uint8_t* nulls) noexcept;
+};
+
+
+// Implementation:
+
+inline BulkColumn::BulkColumn(size_t col_ndx, DataType type, const void* values, const uint8_t* nulls) noexcept
+    : m_col_ndx(col_ndx)
+    , m_type(type)
+    , m_values(values)
+    , m_nulls(nulls)
+{
+}
+
+inline BulkColumn::BulkColumn(size_t col_ndx, const int64_t* values, const uint8_t* nulls) noexcept
+    : BulkColumn(col_ndx, type_Int, values, nulls)
+{
+}
+
+inline BulkColumn::BulkColumn(size_t col_ndx, const bool* values, const uint8_t* nulls) noexcept
+    : BulkColumn(col_ndx, type_Bool, values, nulls)
+{
+}
+
+inline BulkColumn::BulkColumn(size_t col_ndx, const float* values, const uint8_t* nulls) noexcept
+    : BulkColumn(col_ndx, type_Float, values, nulls)
+{
+}
+
+inline BulkColumn::BulkColumn(size_t col_ndx, const double* values, const uint8_t* nulls) noexcept
+    : BulkColumn(col_ndx, type_Double, values, nulls)
+{
+}
+
+inline BulkColumn::BulkColumn(size_t col_ndx, const StringData* values) noexcept
+    : BulkColumn(col_ndx, type_String, values, nullptr)
+{
+}
+
+inline BulkColumn::BulkColumn(size_t col_ndx, const BinaryData* values) noexcept
+    : BulkColumn(col_ndx, type_Binary, values, nullptr)
+{
+}
+
+inline BulkColumn::BulkColumn(size_t col_ndx, const Timestamp* values) noexcept
+    : BulkColumn(col_ndx, type_Timestamp, values, nullptr)
+{
+}
+
+inline size_t BulkColumn::get_column_index() const noexcept
+{
+    return m_col_ndx;
+}
+
+inline DataType BulkColumn::get_type() const noexcept
+{
+    return m_type;
+}
+
+template <class T>
+inline const T* BulkColumn::get_values() const noexcept
+{
+    return static_cast<const T*>(m_values);
+}
+
+inline bool BulkColumn::is_null(size_t i) const noexcept
+{
+    switch (m_type) {
+        case type_String:
+            return get_values<StringData>()[i].is_null();
+        case type_Binary:
+            return get_values<BinaryData>()[i].is_null();
+        case type_Timestamp:
+            return get_values<Timestamp>()[i].is_null();
+        default:
+            return m_nulls && (m_nulls[i / 8] >> (i % 8) & 1) != 0;
+    }
+}
+
+} // namespace realm
+
+#endif // REALM_BULK_COLUMN_HPP
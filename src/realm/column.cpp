@@ -104,6 +104,25 @@ void ColumnBaseWithIndex::refresh_accessor_tree(size_t new_col_ndx, const realm:
 }
 
 
+void ColumnBase::batch_erase_rows(const std::vector<size_t>& row_ndxs, size_t prior_num_rows,
+                                  bool broken_reciprocal_backlinks)
+{
+    size_t num_rows = prior_num_rows;
+    auto end = row_ndxs.rend();
+    for (auto i = row_ndxs.rbegin(); i != end;) {
+        // Extend the run of consecutive rows towards the front
+        size_t row_ndx = *i;
+        size_t num_rows_to_erase = 1;
+        while (++i != end && *i == row_ndx - 1) {
+            --row_ndx;
+            ++num_rows_to_erase;
+        }
+        erase_rows(row_ndx, num_rows_to_erase, num_rows, broken_reciprocal_backlinks); // Throws
+        num_rows -= num_rows_to_erase;
+    }
+}
+
+
 void ColumnBase::cascade_break_backlinks_to(size_t, CascadeState&)
 {
     // No-op by default
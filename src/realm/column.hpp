@@ -19,6 +19,7 @@
 #ifndef REALM_COLUMN_HPP
 #define REALM_COLUMN_HPP
 
+#include <cmath>
 #include <cstdint> // unint8_t etc
 #include <cstdlib> // size_t
 #include <vector>
@@ -35,6 +36,9 @@
 #include <realm/impl/destroy_guard.hpp>
 #include <realm/exceptions.hpp>
 #include <realm/table_ref.hpp>
+#include <realm/zone_map.hpp>
+#include <realm/ordered_index.hpp>
+#include <realm/column_statistics.hpp>
 
 namespace realm {
 
@@ -159,6 +163,24 @@ public:
     virtual void erase_rows(size_t row_ndx, size_t num_rows_to_erase, size_t prior_num_rows,
                             bool broken_reciprocal_backlinks) = 0;
 
+    /// Removes the elements at the specified row indexes, as if by calling
+    /// erase_rows() for each of them, starting with the last one. Columns
+    /// override this to update their leaves, search index and links in a
+    /// single pass. The default implementation erases each contiguous run of
+    /// rows with one call to erase_rows().
+    ///
+    /// \param row_ndxs The rows to remove, in ascending order and unique.
+    /// All must be less than prior_num_rows.
+    ///
+    /// \param prior_num_rows The number of elements in this column prior to the
+    /// modification.
+    ///
+    /// \param broken_reciprocal_backlinks If true, link columns must assume
+    /// that reciprocal backlinks have already been removed. Non-link columns
+    /// should ignore this argument.
+    virtual void batch_erase_rows(const std::vector<size_t>& row_ndxs, size_t prior_num_rows,
+                                  bool broken_reciprocal_backlinks);
+
     /// Removes the element at the specified row index by
     /// moving the element at the last row index over it. This reduces the
     /// number of elements by one.
@@ -362,6 +384,11 @@ protected:
     size_t upper_bound(const L& list, T value) const noexcept;
     //@}
 
+    /// Calls `func(old_row_ndx, new_row_ndx)` for each row that is moved down
+    /// by batch_erase_rows(), in ascending order.
+    template <class Func>
+    static void for_each_moved_row(const std::vector<size_t>& erased_row_ndxs, size_t prior_num_rows, Func func);
+
     // Node functions
 
     class CreateHandler {
@@ -637,6 +664,32 @@ public:
     size_t find_first(T value, size_t begin = 0, size_t end = npos) const;
     void find_all(Column<int64_t>& out_indices, T value, size_t begin = 0, size_t end = npos) const;
 
+    using ZoneMapType = ZoneMap<typename realm::ZoneMapType<T>::type>;
+
+    /// Returns the per-leaf summary of the values of this column, or null if
+    /// the column consists of a single leaf. The summary is rebuilt if it was
+    /// computed for a different version of the owning table (see ZoneMap).
+    const ZoneMapType* get_zone_map(uint_fast64_t table_version) const;
+
+    using OrderedIndexType = OrderedIndex<int64_t>;
+
+    /// Sorts the values of this column into its ordered index, tagged with the
+    /// specified version of the owning table (see OrderedIndex). The column
+    /// must have a search index.
+    void build_ordered_index(uint_fast64_t table_version);
+
+    /// Returns the ordered index if it was computed for the specified version
+    /// of the owning table, or null. A stale ordered index is released.
+    const OrderedIndexType* get_current_ordered_index(uint_fast64_t table_version) const;
+
+    using StatisticsType = ColumnStatistics<typename realm::ZoneMapType<T>::type>;
+
+    /// Returns the statistics of the values of this column. They are rebuilt
+    /// if the owning table has changed substantially since they were computed
+    /// (see ColumnStatistics). `change_count` must be the value of
+    /// Table::get_local_change_count() of the owning table.
+    const StatisticsType* get_statistics(uint_fast64_t change_count) const;
+
     void populate_search_index();
     StringIndex* create_search_index() override;
     inline bool supports_search_index() const noexcept override
@@ -679,6 +732,7 @@ public:
 
     void insert_rows(size_t, size_t, size_t, bool) override;
     void erase_rows(size_t, size_t, size_t, bool) override;
+    void batch_erase_rows(const std::vector<size_t>&, size_t, bool) override;
     void move_last_row_over(size_t, size_t, bool) override;
 
     /// \brief Swap the elements at the specified indices.
@@ -698,6 +752,11 @@ public:
     /// \param num_rows The number of rows to insert.
     void insert_without_updating_index(size_t row_ndx, T value, size_t num_rows);
 
+    /// Insert `num_rows` rows at \a row_ndx, the values of which are given by
+    /// `get_value(i)`, and add them to the search index, if any, in one go.
+    template <class F>
+    void insert_values(size_t row_ndx, size_t num_rows, F get_value);
+
     void verify() const override;
     void to_dot(std::ostream&, StringData title) const override;
     void do_dump_node_structure(std::ostream&, int) const override;
@@ -761,6 +820,27 @@ private:
     friend class StringIndex;
 
     BpTree<T> m_tree;
+    mutable std::unique_ptr<ZoneMapType> m_zone_map;
+    mutable std::unique_ptr<OrderedIndexType> m_ordered_index;
+    mutable std::unique_ptr<StatisticsType> m_statistics;
+
+    static bool get_statistics_value(int64_t v, int64_t& value) noexcept
+    {
+        value = v;
+        return true;
+    }
+    static bool get_statistics_value(util::Optional<int64_t> v, int64_t& value) noexcept
+    {
+        value = v.value_or(0);
+        return bool(v);
+    }
+    template <class F>
+    static bool get_statistics_value(F v, F& value) noexcept
+    {
+        // Nulls are NaNs, and so are the values that can't be ordered
+        value = v;
+        return !std::isnan(v);
+    }
 
     void do_erase(size_t row_ndx, size_t num_rows_to_erase, bool is_last);
 };
@@ -1067,6 +1147,68 @@ void Column<T>::find_all(IntegerColumn& result, T value, size_t begin, size_t en
     return m_tree.find_all(result, value, begin, end);
 }
 
+template <class T>
+const typename Column<T>::ZoneMapType* Column<T>::get_zone_map(uint_fast64_t table_version) const
+{
+    if (m_tree.root_is_leaf())
+        return nullptr;
+    if (!m_zone_map)
+        m_zone_map.reset(new ZoneMapType); // Throws
+    if (!m_zone_map->is_valid_for(table_version))
+        m_zone_map->build(m_tree, is_nullable(), table_version); // Throws
+    return m_zone_map.get();
+}
+
+template <class T>
+void Column<T>::build_ordered_index(uint_fast64_t table_version)
+{
+    REALM_ASSERT(has_search_index());
+    if (!m_ordered_index)
+        m_ordered_index.reset(new OrderedIndexType); // Throws
+    auto get_value = [this](size_t row_ndx, int64_t& value) {
+        util::Optional<int64_t> v = m_tree.get(row_ndx);
+        if (!v)
+            return false;
+        value = *v;
+        return true;
+    };
+    m_ordered_index->build(size(), get_value, table_version); // Throws
+}
+
+template <class T>
+const typename Column<T>::OrderedIndexType* Column<T>::get_current_ordered_index(uint_fast64_t table_version) const
+{
+    if (m_ordered_index && !m_ordered_index->is_valid_for(table_version))
+        m_ordered_index.reset();
+    return m_ordered_index.get();
+}
+
+template <class T>
+const typename Column<T>::StatisticsType* Column<T>::get_statistics(uint_fast64_t change_count) const
+{
+    if (!m_statistics)
+        m_statistics.reset(new StatisticsType); // Throws
+    if (m_statistics->needs_refresh(size(), change_count)) {
+        // Read the values leaf by leaf
+        LeafType fallback(m_tree.get_alloc());
+        const LeafType* leaf = nullptr;
+        typename BpTree<T>::LeafInfo leaf_info{&leaf, &fallback};
+        size_t leaf_begin = 0;
+        size_t leaf_end = 0;
+        auto get_value = [&](size_t row_ndx, typename StatisticsType::Key& value) {
+            if (row_ndx >= leaf_end) {
+                size_t ndx_in_leaf;
+                m_tree.get_leaf(row_ndx, ndx_in_leaf, leaf_info);
+                leaf_begin = row_ndx - ndx_in_leaf;
+                leaf_end = leaf_begin + leaf->size();
+            }
+            return get_statistics_value(leaf->get(row_ndx - leaf_begin), value);
+        };
+        m_statistics->build(size(), get_value, change_count); // Throws
+    }
+    return m_statistics.get();
+}
+
 inline size_t ColumnBase::get_size_from_ref(ref_type root_ref, Allocator& alloc)
 {
     const char* root_header = alloc.translate(root_ref);
@@ -1116,6 +1258,23 @@ size_t ColumnBase::upper_bound(const L& list, T value) const noexcept
     return i;
 }
 
+template <class Func>
+void ColumnBase::for_each_moved_row(const std::vector<size_t>& erased_row_ndxs, size_t prior_num_rows, Func func)
+{
+    if (erased_row_ndxs.empty())
+        return;
+    size_t num_erased = 0;
+    auto next_erased = erased_row_ndxs.begin();
+    for (size_t row_ndx = erased_row_ndxs.front(); row_ndx < prior_num_rows; ++row_ndx) {
+        if (next_erased != erased_row_ndxs.end() && *next_erased == row_ndx) {
+            ++next_erased;
+            ++num_erased;
+            continue;
+        }
+        func(row_ndx, row_ndx - num_erased); // Throws
+    }
+}
+
 
 inline ref_type ColumnBase::create(Allocator& alloc, size_t column_size, CreateHandler& handler)
 {
@@ -1181,6 +1340,9 @@ void Column<T>::move_assign(Column<T>& col)
 {
     ColumnBaseWithIndex::move_assign(col);
     m_tree = std::move(col.m_tree);
+    m_zone_map.reset();
+    m_ordered_index.reset();
+    m_statistics.reset();
 }
 
 template <class T>
@@ -1319,6 +1481,23 @@ void Column<T>::insert(size_t row_ndx, T value, size_t num_rows)
     }
 }
 
+template <class T>
+template <class F>
+void Column<T>::insert_values(size_t row_ndx, size_t num_rows, F get_value)
+{
+    size_t column_size = this->size(); // Slow
+    bool is_append = row_ndx == column_size || row_ndx == npos;
+    row_ndx = is_append ? column_size : row_ndx;
+
+    for (size_t i = 0; i < num_rows; ++i) {
+        size_t ndx_or_npos_if_append = is_append ? npos : row_ndx + i;
+        m_tree.insert(ndx_or_npos_if_append, get_value(i)); // Throws
+    }
+
+    if (has_search_index())
+        m_search_index->insert_rows(row_ndx, num_rows, is_append, get_value); // Throws
+}
+
 template <class T>
 void Column<T>::erase_without_updating_index(size_t row_ndx, bool is_last)
 {
@@ -1475,6 +1654,19 @@ void Column<T>::erase_rows(size_t row_ndx, size_t num_rows_to_erase, size_t prio
     do_erase(row_ndx, num_rows_to_erase, is_last); // Throws
 }
 
+// Overriding virtual method of ColumnBase.
+template <class T>
+void Column<T>::batch_erase_rows(const std::vector<size_t>& row_ndxs, size_t prior_num_rows, bool)
+{
+    REALM_ASSERT_DEBUG(prior_num_rows == size());
+    REALM_ASSERT(row_ndxs.empty() || row_ndxs.back() < prior_num_rows);
+    static_cast<void>(prior_num_rows);
+
+    if (has_search_index())
+        m_search_index->erase_rows(row_ndxs); // Throws
+    m_tree.erase(row_ndxs);                   // Throws
+}
+
 // Implementing pure virtual method of ColumnBase.
 template <class T>
 void Column<T>::move_last_row_over(size_t row_ndx, size_t prior_num_rows, bool)
@@ -1597,6 +1789,9 @@ ref_type Column<T>::write(size_t slice_offset, size_t slice_size, size_t table_s
 template <class T>
 void Column<T>::refresh_accessor_tree(size_t new_col_ndx, const Spec& spec)
 {
+    m_zone_map.reset();
+    m_ordered_index.reset();
+    m_statistics.reset();
     m_tree.init_from_parent();
     ColumnBaseWithIndex::refresh_accessor_tree(new_col_ndx, spec);
 }
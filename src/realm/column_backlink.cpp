@@ -286,6 +286,33 @@ void BacklinkColumn::erase_rows(size_t row_ndx, size_t num_rows_to_erase, size_t
 }
 
 
+void BacklinkColumn::batch_erase_rows(const std::vector<size_t>& row_ndxs, size_t prior_num_rows,
+                                      bool broken_reciprocal_backlinks)
+{
+    REALM_ASSERT_DEBUG(prior_num_rows == size());
+
+    // Nullify forward links to the removed target rows
+    for (size_t row_ndx : row_ndxs) {
+        auto handler = [=](size_t origin_row_ndx) {
+            m_origin_column->do_nullify_link(origin_row_ndx, row_ndx); // Throws
+        };
+        bool do_destroy = true;
+        for_each_link(row_ndx, do_destroy, handler); // Throws
+    }
+
+    // Update forward links to the moved target rows
+    auto update_links = [&](size_t old_target_row_ndx, size_t new_target_row_ndx) {
+        auto handler = [=](size_t origin_row_ndx) {
+            m_origin_column->do_update_link(origin_row_ndx, old_target_row_ndx, new_target_row_ndx); // Throws
+        };
+        bool do_destroy = false;
+        for_each_link(old_target_row_ndx, do_destroy, handler); // Throws
+    };
+    for_each_moved_row(row_ndxs, prior_num_rows, update_links); // Throws
+
+    IntegerColumn::batch_erase_rows(row_ndxs, prior_num_rows, broken_reciprocal_backlinks); // Throws
+}
+
 void BacklinkColumn::move_last_row_over(size_t row_ndx, size_t prior_num_rows, bool broken_reciprocal_backlinks)
 {
     REALM_ASSERT_DEBUG(prior_num_rows == size());
@@ -64,6 +64,7 @@ public:
 
     void insert_rows(size_t, size_t, size_t, bool) override;
     void erase_rows(size_t, size_t, size_t, bool) override;
+    void batch_erase_rows(const std::vector<size_t>&, size_t, bool) override;
     void move_last_row_over(size_t, size_t, bool) override;
     void swap_rows(size_t, size_t) override;
     void clear(size_t, bool) override;
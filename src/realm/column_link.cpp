@@ -98,6 +98,30 @@ void LinkColumn::erase_rows(size_t row_ndx, size_t num_rows_to_erase, size_t pri
 }
 
 
+void LinkColumn::batch_erase_rows(const std::vector<size_t>& row_ndxs, size_t prior_num_rows,
+                                  bool broken_reciprocal_backlinks)
+{
+    REALM_ASSERT_DEBUG(prior_num_rows == size());
+
+    // Remove backlinks to the removed origin rows
+    if (!broken_reciprocal_backlinks) {
+        for (size_t row_ndx : row_ndxs)
+            remove_backlinks(row_ndx);
+    }
+
+    // Update backlinks to the moved origin rows
+    auto update_backlink = [&](size_t old_origin_row_ndx, size_t new_origin_row_ndx) {
+        uint_fast64_t value = LinkColumnBase::get_uint(old_origin_row_ndx);
+        if (value != 0) { // Zero means null
+            size_t target_row_ndx = to_size_t(value - 1);
+            m_backlink_column->update_backlink(target_row_ndx, old_origin_row_ndx, new_origin_row_ndx); // Throws
+        }
+    };
+    for_each_moved_row(row_ndxs, prior_num_rows, update_backlink); // Throws
+
+    LinkColumnBase::batch_erase_rows(row_ndxs, prior_num_rows, broken_reciprocal_backlinks); // Throws
+}
+
 void LinkColumn::move_last_row_over(size_t row_ndx, size_t prior_num_rows, bool broken_reciprocal_backlinks)
 {
     REALM_ASSERT_DEBUG(prior_num_rows == size());
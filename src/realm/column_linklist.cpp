@@ -102,6 +102,47 @@ void LinkListColumn::erase_rows(size_t row_ndx, size_t num_rows_to_erase, size_t
 }
 
 
+void LinkListColumn::batch_erase_rows(const std::vector<size_t>& row_ndxs, size_t prior_num_rows,
+                                      bool broken_reciprocal_backlinks)
+{
+    REALM_ASSERT_DEBUG(prior_num_rows == size());
+
+    // Remove backlinks to the removed origin rows
+    for (size_t row_ndx : row_ndxs) {
+        if (ref_type ref = get_as_ref(row_ndx)) {
+            if (!broken_reciprocal_backlinks) {
+                IntegerColumn link_list(get_alloc(), ref);
+                size_t n = link_list.size();
+                for (size_t j = 0; j < n; ++j) {
+                    size_t target_row_ndx = to_size_t(link_list.get(j));
+                    m_backlink_column->remove_one_backlink(target_row_ndx, row_ndx);
+                }
+            }
+            Array::destroy_deep(ref, get_alloc());
+        }
+    }
+
+    // Update backlinks to the moved origin rows
+    auto update_backlinks = [&](size_t old_origin_row_ndx, size_t new_origin_row_ndx) {
+        if (ref_type ref = get_as_ref(old_origin_row_ndx)) {
+            IntegerColumn link_list(get_alloc(), ref);
+            size_t n = link_list.size();
+            for (size_t j = 0; j < n; ++j) {
+                uint_fast64_t value = link_list.get_uint(j);
+                size_t target_row_ndx = to_size_t(value);
+                m_backlink_column->update_backlink(target_row_ndx, old_origin_row_ndx, new_origin_row_ndx); // Throws
+            }
+        }
+    };
+    for_each_moved_row(row_ndxs, prior_num_rows, update_backlinks); // Throws
+
+    LinkColumnBase::batch_erase_rows(row_ndxs, prior_num_rows, broken_reciprocal_backlinks); // Throws
+
+    const bool fix_ndx_in_parent = true;
+    for (auto i = row_ndxs.rbegin(); i != row_ndxs.rend(); ++i)
+        adj_erase_rows<fix_ndx_in_parent>(*i, 1);
+}
+
 void LinkListColumn::move_last_row_over(size_t row_ndx, size_t prior_num_rows, bool broken_reciprocal_backlinks)
 {
     REALM_ASSERT_DEBUG(prior_num_rows == size());
@@ -0,0 +1,283 @@
+/*************************************************************************
+ *
+ * Copyright 2016 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#ifndef REALM_COLUMN_STATISTICS_HPP
+#define REALM_COLUMN_STATISTICS_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include <realm/query_conditions.hpp>
+#include <realm/string_data.hpp>
+#include <realm/utilities.hpp>
+
+namespace realm {
+
+/// Column statistics summarize the values of a column by the number of rows,
+/// estimates of the number of nulls, NaNs and distinct values, and an
+/// equi-depth histogram of the other values. The query engine uses them to
+/// estimate how many rows a condition matches before it runs, so that the most
+/// selective conditions of a query are searched first.
+///
+/// As they are built while a query is initialized, the statistics are derived
+/// from at most `sample_size` rows sampled at random positions, so building
+/// them takes bounded time however large the column is. The histogram consists
+/// of evenly spaced values of the sorted sample, so every two adjacent values
+/// bound a bucket holding the same number of rows. Values which occur in many
+/// rows show up several times. NaNs are not ordered, so they are counted
+/// instead. String columns are summarized by the hashes of their values, so
+/// their statistics can only estimate equality conditions.
+///
+/// Like zone maps, statistics are not part of the file format. They are built
+/// on demand by the column accessor. Being estimates, they need not be up to
+/// date, so they are only rebuilt when the size of the table or the number of
+/// modifications of it (Table::get_local_change_count()) has changed by more
+/// than an eighth of the number of rows since they were built.
+template <class T>
+class ColumnStatistics {
+public:
+    using Key = typename std::conditional<std::is_same<T, StringData>::value, uint64_t, T>::type;
+
+    /// Upper bound on the number of rows read to build the statistics.
+    static const size_t sample_size = 16 * 1024;
+
+    /// Upper bound on the number of values in the histogram.
+    static const size_t histogram_size = 1024;
+
+    bool needs_refresh(size_t size, uint_fast64_t change_count) const noexcept
+    {
+        size_t threshold = m_size / 8;
+        size_t size_change = size > m_size ? size - m_size : m_size - size;
+        return !m_valid || size_change > threshold || change_count - m_change_count > threshold;
+    }
+
+    /// `get(row_ndx, value)` must store the value of the specified row in
+    /// `value` and return true, or return false if the value is null.
+    template <class Get>
+    void build(size_t size, Get get, uint_fast64_t change_count);
+
+    size_t size() const noexcept
+    {
+        return m_size;
+    }
+
+    /// Estimated number of nulls.
+    size_t null_count() const noexcept
+    {
+        return m_null_count;
+    }
+
+    /// Estimated number of NaNs, which is always zero for columns of other
+    /// types than float and double.
+    size_t nan_count() const noexcept
+    {
+        return m_nan_count;
+    }
+
+    /// Estimated number of distinct values other than null and NaN.
+    double distinct_count() const noexcept
+    {
+        return m_distinct_count;
+    }
+
+    /// Returns the estimated fraction of the rows for which `Cond` is true
+    /// with `value` (null if `value_is_null`) as right-hand side, or a
+    /// negative number for conditions which can't be estimated.
+    template <class Cond>
+    double estimate(T value, bool value_is_null) const noexcept;
+
+    static Key get_key(T value) noexcept
+    {
+        return get_key(value, std::is_same<T, StringData>());
+    }
+
+private:
+    std::vector<Key> m_histogram;
+    size_t m_size = 0;
+    size_t m_null_count = 0;
+    size_t m_nan_count = 0;
+    double m_distinct_count = 0;
+    uint_fast64_t m_change_count = 0;
+    bool m_valid = false;
+
+    static Key get_key(T value, std::false_type) noexcept
+    {
+        return value;
+    }
+
+    static Key get_key(StringData value, std::true_type) noexcept
+    {
+        return murmur2_or_cityhash(reinterpret_cast<const unsigned char*>(value.data()), value.size());
+    }
+
+    static bool is_nan(Key key) noexcept
+    {
+        return is_nan(key, std::is_floating_point<Key>());
+    }
+
+    static bool is_nan(Key key, std::true_type) noexcept
+    {
+        return std::isnan(key);
+    }
+
+    static bool is_nan(Key, std::false_type) noexcept
+    {
+        return false;
+    }
+};
+
+
+// Implementation:
+
+template <class T>
+const size_t ColumnStatistics<T>::sample_size;
+
+template <class T>
+const size_t ColumnStatistics<T>::histogram_size;
+
+template <class T>
+template <class Get>
+void ColumnStatistics<T>::build(size_t size, Get get, uint_fast64_t change_count)
+{
+    m_valid = false;
+    m_histogram.clear();
+
+    // One row is sampled from each of at most `sample_size` equally large
+    // strides of the column, at a pseudo-random position within the stride,
+    // so values that repeat with a period dividing the stride are still
+    // sampled fairly. Rows are sampled in ascending order.
+    size_t stride = (size + sample_size - 1) / sample_size;
+    uint64_t random = 0x9e3779b97f4a7c15ULL;
+    std::vector<Key> sample;
+    sample.reserve(std::min(size, sample_size)); // Throws
+    size_t num_sampled = 0;
+    size_t null_count = 0;
+    size_t nan_count = 0;
+    for (size_t stride_begin = 0; stride_begin < size; stride_begin += stride) {
+        random ^= random << 13;
+        random ^= random >> 7;
+        random ^= random << 17;
+        size_t row_ndx = stride_begin + size_t(random % std::min(stride, size - stride_begin));
+        ++num_sampled;
+        T value;
+        if (!get(row_ndx, value)) {
+            ++null_count;
+            continue;
+        }
+        Key key = get_key(value);
+        if (is_nan(key)) {
+            ++nan_count;
+            continue;
+        }
+        sample.push_back(key);
+    }
+    std::sort(sample.begin(), sample.end());
+
+    // The values seen once in the sample are assumed to be unique in the
+    // column, and every other distinct value of the column to have been seen
+    // more than once. This is exact when every row was sampled.
+    size_t num_distinct = 0;
+    size_t num_singletons = 0;
+    for (auto i = sample.begin(); i != sample.end();) {
+        auto j = std::upper_bound(i, sample.end(), *i);
+        ++num_distinct;
+        if (j - i == 1)
+            ++num_singletons;
+        i = j;
+    }
+    double scale = num_sampled ? double(size) / num_sampled : 0;
+    double value_count = sample.size() * scale;
+    m_distinct_count = std::min(num_distinct - num_singletons + num_singletons * scale, value_count);
+
+    size_t num_buckets = std::min(sample.size(), histogram_size);
+    m_histogram.reserve(num_buckets); // Throws
+    for (size_t i = 0; i < num_buckets; ++i)
+        m_histogram.push_back(sample[i * sample.size() / num_buckets]);
+
+    m_size = size;
+    m_null_count = size_t(null_count * scale + 0.5);
+    m_nan_count = size_t(nan_count * scale + 0.5);
+    m_change_count = change_count;
+    m_valid = true;
+}
+
+template <class T>
+template <class Cond>
+double ColumnStatistics<T>::estimate(T value, bool value_is_null) const noexcept
+{
+    constexpr bool is_ordered = !std::is_same<T, StringData>::value;
+    constexpr bool is_equal = std::is_same<Cond, Equal>::value;
+    constexpr bool is_not_equal = std::is_same<Cond, NotEqual>::value;
+    constexpr bool is_range = std::is_same<Cond, Less>::value || std::is_same<Cond, LessEqual>::value ||
+                              std::is_same<Cond, Greater>::value || std::is_same<Cond, GreaterEqual>::value;
+    if (m_size == 0 || !(is_equal || is_not_equal || (is_ordered && is_range)))
+        return -1;
+
+    double null_fraction = double(m_null_count) / m_size;
+    if (value_is_null) {
+        if (is_equal)
+            return null_fraction;
+        if (is_not_equal)
+            return 1 - null_fraction;
+        return 0;
+    }
+    Key key = get_key(value);
+    if (is_nan(key))
+        return -1;
+
+    // Nulls and NaNs are not in the histogram
+    double value_fraction = std::max(1 - null_fraction - double(m_nan_count) / m_size, 0.0);
+    if (m_histogram.empty())
+        return is_not_equal ? 1 : 0;
+
+    auto lower = std::lower_bound(m_histogram.begin(), m_histogram.end(), key);
+    auto upper = std::upper_bound(lower, m_histogram.end(), key);
+    double num_values = double(m_histogram.size());
+    double fraction;
+    if (is_equal || is_not_equal) {
+        // A value sampled only once is not known to be frequent, and is
+        // assumed to be as frequent as the average distinct value
+        size_t occurrences = upper - lower;
+        if (occurrences > 1)
+            fraction = occurrences / num_values;
+        else
+            fraction = std::min(1 / std::max(m_distinct_count, 1.0), 1 / num_values);
+        if (is_not_equal)
+            return 1 - fraction * value_fraction; // Nulls and NaNs are not equal to any value
+    }
+    else if (std::is_same<Cond, Less>::value) {
+        fraction = (lower - m_histogram.begin()) / num_values;
+    }
+    else if (std::is_same<Cond, LessEqual>::value) {
+        fraction = (upper - m_histogram.begin()) / num_values;
+    }
+    else if (std::is_same<Cond, Greater>::value) {
+        fraction = (m_histogram.end() - upper) / num_values;
+    }
+    else {
+        fraction = (m_histogram.end() - lower) / num_values;
+    }
+    return fraction * value_fraction;
+}
+
+} // namespace realm
+
+#endif // REALM_COLUMN_STATISTICS_HPP
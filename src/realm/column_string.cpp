@@ -244,6 +244,48 @@ std::unique_ptr<StringIndex> StringColumn::release_search_index() noexcept
 }
 
 
+void StringColumn::set_trigram_index(bool enable)
+{
+    if (!enable)
+        m_trigram_index.reset();
+    else if (!m_trigram_index)
+        m_trigram_index.reset(new TrigramIndex); // Throws
+}
+
+
+bool StringColumn::has_trigram_index() const noexcept
+{
+    return bool(m_trigram_index);
+}
+
+
+const TrigramIndex* StringColumn::get_trigram_index(uint_fast64_t table_version,
+                                                    const std::vector<uint32_t>& trigrams) const
+{
+    if (!m_trigram_index)
+        return nullptr;
+    auto get_value = [this](size_t row_ndx) { return get(row_ndx); };
+    if (!m_trigram_index->refresh(size(), get_value, table_version, trigrams)) // Throws
+        return nullptr;
+    return m_trigram_index.get();
+}
+
+
+const ColumnStatistics<StringData>* StringColumn::get_statistics(uint_fast64_t change_count) const
+{
+    if (!m_statistics)
+        m_statistics.reset(new ColumnStatistics<StringData>); // Throws
+    if (m_statistics->needs_refresh(size(), change_count)) {
+        auto get_value = [this](size_t row_ndx, StringData& value) {
+            value = get(row_ndx);
+            return !value.is_null();
+        };
+        m_statistics->build(size(), get_value, change_count); // Throws
+    }
+    return m_statistics.get();
+}
+
+
 void StringColumn::set_search_index_ref(ref_type ref, ArrayParent* parent, size_t ndx_in_parent)
 {
     REALM_ASSERT(!m_search_index);
@@ -524,6 +566,12 @@ void StringColumn::do_erase(size_t ndx, bool is_last)
         m_search_index->erase<StringData>(ndx, is_last);
     }
 
+    erase_without_updating_index(ndx, is_last); // Throws
+}
+
+
+void StringColumn::erase_without_updating_index(size_t ndx, bool is_last)
+{
     bool array_root_is_leaf = !m_array->is_inner_bptree_node();
     if (array_root_is_leaf) {
         bool long_strings = m_array->has_refs();
@@ -553,6 +601,23 @@ void StringColumn::do_erase(size_t ndx, bool is_last)
 }
 
 
+void StringColumn::batch_erase_rows(const std::vector<size_t>& row_ndxs, size_t prior_num_rows, bool)
+{
+    REALM_ASSERT_DEBUG(prior_num_rows == size());
+    REALM_ASSERT(row_ndxs.empty() || row_ndxs.back() < prior_num_rows);
+
+    if (m_search_index)
+        m_search_index->erase_rows(row_ndxs); // Throws
+
+    size_t num_rows = prior_num_rows;
+    for (auto i = row_ndxs.rbegin(); i != row_ndxs.rend(); ++i) {
+        bool is_last = (*i == num_rows - 1);
+        erase_without_updating_index(*i, is_last); // Throws
+        --num_rows;
+    }
+}
+
+
 void StringColumn::do_move_last_over(size_t row_ndx, size_t last_row_ndx)
 {
     REALM_ASSERT_3(row_ndx, <=, last_row_ndx);
@@ -1417,6 +1482,10 @@ void StringColumn::refresh_accessor_tree(size_t col_ndx, const Spec& spec)
     ColumnBaseSimple::refresh_accessor_tree(col_ndx, spec);
     refresh_root_accessor(); // Throws
 
+    if (m_trigram_index)
+        m_trigram_index->clear();
+    m_statistics.reset();
+
     // Refresh search index
     if (m_search_index) {
         size_t ndx_in_parent = m_array->get_ndx_in_parent();
@@ -25,6 +25,7 @@
 #include <realm/array_blobs_big.hpp>
 #include <realm/column.hpp>
 #include <realm/column_tpl.hpp>
+#include <realm/trigram_index.hpp>
 
 namespace realm {
 
@@ -65,6 +66,12 @@ public:
     void add(StringData value);
     void insert(size_t ndx);
     void insert(size_t ndx, StringData value);
+
+    /// Insert `num_rows` rows at \a row_ndx, the values of which are given by
+    /// `get_value(i)`, and add them to the search index, if any, in one go.
+    template <class F>
+    void insert_values(size_t row_ndx, size_t num_rows, F get_value);
+
     void erase(size_t row_ndx);
     void move_last_over(size_t row_ndx);
     void swap_rows(size_t row_ndx_1, size_t row_ndx_2) override;
@@ -106,6 +113,21 @@ public:
     void populate_search_index();
     void destroy_search_index() noexcept override;
 
+    /// Enables or disables the trigram index of this column (see
+    /// Table::set_trigram_index()).
+    void set_trigram_index(bool enable);
+    bool has_trigram_index() const noexcept;
+
+    /// Returns the trigram index of this column if it is enabled, and if it may
+    /// be used to find the rows containing all of `trigrams`, or null. A stale
+    /// index is rebuilt only if that pays off (see TrigramIndex::refresh()).
+    const TrigramIndex* get_trigram_index(uint_fast64_t table_version, const std::vector<uint32_t>& trigrams) const;
+
+    /// Returns the statistics of the values of this column (see
+    /// ColumnStatistics). `change_count` must be the value of
+    /// Table::get_local_change_count() of the owning table.
+    const ColumnStatistics<StringData>* get_statistics(uint_fast64_t change_count) const;
+
     // Optimizing data layout. enforce == true will enforce enumeration;
     // enforce == false will auto-evaluate if it should be enumerated or not
     bool auto_enumerate(ref_type& keys, ref_type& values, bool enforce = false) const;
@@ -130,6 +152,7 @@ public:
 
     void insert_rows(size_t, size_t, size_t, bool) override;
     void erase_rows(size_t, size_t, size_t, bool) override;
+    void batch_erase_rows(const std::vector<size_t>&, size_t, bool) override;
     void move_last_row_over(size_t, size_t, bool) override;
     void clear(size_t, bool) override;
     void set_ndx_in_parent(size_t ndx_in_parent) noexcept override;
@@ -143,6 +166,8 @@ public:
 
 private:
     std::unique_ptr<StringIndex> m_search_index;
+    mutable std::unique_ptr<TrigramIndex> m_trigram_index; // Null unless enabled
+    mutable std::unique_ptr<ColumnStatistics<StringData>> m_statistics;
     bool m_nullable;
 
     LeafType get_block(size_t ndx, ArrayParent**, size_t& off, bool use_retval = false) const;
@@ -174,6 +199,7 @@ private:
     class SliceHandler;
 
     void do_erase(size_t row_ndx, bool is_last);
+    void erase_without_updating_index(size_t row_ndx, bool is_last);
     void do_move_last_over(size_t row_ndx, size_t last_row_ndx);
     void do_swap_rows(size_t row_ndx_1, size_t row_ndx_2);
     void do_clear();
@@ -372,6 +398,20 @@ inline void StringColumn::clear(size_t, bool)
     do_clear(); // Throws
 }
 
+template <class F>
+void StringColumn::insert_values(size_t row_ndx, size_t num_rows, F get_value)
+{
+    size_t column_size = size(); // Slow
+    bool is_append = row_ndx == column_size;
+    for (size_t i = 0; i < num_rows; ++i) {
+        size_t ndx_or_npos_if_append = is_append ? realm::npos : row_ndx + i;
+        bptree_insert(ndx_or_npos_if_append, get_value(i), 1); // Throws
+    }
+
+    if (m_search_index)
+        m_search_index->insert_rows(row_ndx, num_rows, is_append, get_value); // Throws
+}
+
 } // namespace realm
 
 #endif // REALM_COLUMN_STRING_HPP
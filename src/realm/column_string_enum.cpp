@@ -359,6 +359,33 @@ void StringEnumColumn::install_search_index(std::unique_ptr<StringIndex> index)
 }
 
 
+void StringEnumColumn::set_trigram_index(bool enable)
+{
+    if (!enable)
+        m_trigram_index.reset();
+    else if (!m_trigram_index)
+        m_trigram_index.reset(new TrigramIndex); // Throws
+}
+
+
+bool StringEnumColumn::has_trigram_index() const noexcept
+{
+    return bool(m_trigram_index);
+}
+
+
+const TrigramIndex* StringEnumColumn::get_trigram_index(uint_fast64_t table_version,
+                                                        const std::vector<uint32_t>& trigrams) const
+{
+    if (!m_trigram_index)
+        return nullptr;
+    auto get_value = [this](size_t row_ndx) { return get(row_ndx); };
+    if (!m_trigram_index->refresh(size(), get_value, table_version, trigrams)) // Throws
+        return nullptr;
+    return m_trigram_index.get();
+}
+
+
 void StringEnumColumn::refresh_accessor_tree(size_t col_ndx, const Spec& spec)
 {
     IntegerColumn::refresh_accessor_tree(col_ndx, spec);
@@ -366,6 +393,9 @@ void StringEnumColumn::refresh_accessor_tree(size_t col_ndx, const Spec& spec)
     m_keys.get_root_array()->set_ndx_in_parent(ndx_is_spec_enumkeys);
     m_keys.refresh_accessor_tree(0, spec);
 
+    if (m_trigram_index)
+        m_trigram_index->clear();
+
     // Refresh search index
     if (m_search_index) {
         size_t ndx_in_parent = get_root_array()->get_ndx_in_parent();
@@ -83,6 +83,12 @@ public:
     void add(StringData value);
     void insert(size_t ndx);
     void insert(size_t ndx, StringData value);
+
+    /// Insert `num_rows` rows at \a row_ndx, the values of which are given by
+    /// `get_value(i)`, and add them to the search index, if any, in one go.
+    template <class F>
+    void insert_values(size_t row_ndx, size_t num_rows, F get_value);
+
     void erase(size_t row_ndx);
     void move_last_over(size_t row_ndx);
     void swap_rows(size_t row_ndx_1, size_t row_ndx_2) override;
@@ -120,6 +126,16 @@ public:
     void install_search_index(std::unique_ptr<StringIndex>) noexcept;
     void destroy_search_index() noexcept override;
 
+    /// Enables or disables the trigram index of this column (see
+    /// Table::set_trigram_index()).
+    void set_trigram_index(bool enable);
+    bool has_trigram_index() const noexcept;
+
+    /// Returns the trigram index of this column if it is enabled, and if it may
+    /// be used to find the rows containing all of `trigrams`, or null. A stale
+    /// index is rebuilt only if that pays off (see TrigramIndex::refresh()).
+    const TrigramIndex* get_trigram_index(uint_fast64_t table_version, const std::vector<uint32_t>& trigrams) const;
+
     // Compare two string columns for equality
     bool compare_string(const StringColumn&) const;
     bool compare_string(const StringEnumColumn&) const;
@@ -147,6 +163,7 @@ public:
 private:
     // Member variables
     StringColumn m_keys;
+    mutable std::unique_ptr<TrigramIndex> m_trigram_index; // Null unless enabled
     bool m_nullable;
 
     /// If you are appending and have the size of the column readily available,
@@ -306,6 +323,21 @@ inline const StringColumn& StringEnumColumn::get_keys() const
 }
 
 
+template <class F>
+void StringEnumColumn::insert_values(size_t row_ndx, size_t num_rows, F get_value)
+{
+    size_t column_size = size(); // Slow
+    bool is_append = row_ndx == column_size;
+    for (size_t i = 0; i < num_rows; ++i) {
+        size_t key_ndx = get_key_ndx_or_add(get_value(i)); // Throws
+        size_t ndx_or_npos_if_append = is_append ? realm::npos : row_ndx + i;
+        insert_without_updating_index(ndx_or_npos_if_append, int64_t(key_ndx), 1); // Throws
+    }
+
+    if (m_search_index)
+        m_search_index->insert_rows(row_ndx, num_rows, is_append, get_value); // Throws
+}
+
 } // namespace realm
 
 #endif // REALM_COLUMN_STRING_ENUM_HPP
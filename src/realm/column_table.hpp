@@ -44,6 +44,7 @@ public:
 
     void insert_rows(size_t, size_t, size_t, bool) override;
     void erase_rows(size_t, size_t, size_t, bool) override;
+    void batch_erase_rows(const std::vector<size_t>&, size_t, bool) override;
     void move_last_row_over(size_t, size_t, bool) override;
     void clear(size_t, bool) override;
     void swap_rows(size_t, size_t) override;
@@ -299,6 +300,14 @@ inline void SubtableColumnBase::erase_rows(size_t row_ndx, size_t num_rows_to_er
         tf::unbind_ptr(*m_table);
 }
 
+// Overriding virtual method of Column.
+inline void SubtableColumnBase::batch_erase_rows(const std::vector<size_t>& row_ndxs, size_t prior_num_rows,
+                                                 bool broken_reciprocal_backlinks)
+{
+    // Subtable accessors are adjusted per run of rows by erase_rows()
+    ColumnBase::batch_erase_rows(row_ndxs, prior_num_rows, broken_reciprocal_backlinks); // Throws
+}
+
 // Overriding virtual method of Column.
 inline void SubtableColumnBase::move_last_row_over(size_t row_ndx, size_t prior_num_rows,
                                                    bool broken_reciprocal_backlinks)
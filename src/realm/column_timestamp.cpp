@@ -182,6 +182,16 @@ void TimestampColumn::erase_rows(size_t row_ndx, size_t num_rows_to_erase, size_
     }
 }
 
+void TimestampColumn::batch_erase_rows(const std::vector<size_t>& row_ndxs, size_t /*prior_num_rows*/,
+                                       bool /*broken_reciprocal_backlinks*/)
+{
+    if (has_search_index()) {
+        m_search_index->erase_rows(row_ndxs); // Throws
+    }
+    m_seconds->erase(row_ndxs);     // Throws
+    m_nanoseconds->erase(row_ndxs); // Throws
+}
+
 void TimestampColumn::move_last_row_over(size_t row_ndx, size_t prior_num_rows, bool /*broken_reciprocal_backlinks*/)
 {
     size_t last_row_ndx = prior_num_rows - 1;
@@ -315,6 +325,9 @@ void TimestampColumn::refresh_accessor_tree(size_t new_col_ndx, const Spec& spec
 
     m_array->init_from_parent();
 
+    m_seconds_zone_map.reset();
+    m_ordered_index.reset();
+    m_seconds_statistics.reset();
     m_seconds->init_from_parent();
     m_nanoseconds->init_from_parent();
 
@@ -368,6 +381,66 @@ void TimestampColumn::get_nanoseconds_leaf(size_t ndx, size_t& ndx_in_leaf,
 
 // LCOV_EXCL_STOP ignore debug functions
 
+const ZoneMap<int64_t>* TimestampColumn::get_seconds_zone_map(uint_fast64_t table_version) const
+{
+    if (m_seconds->root_is_leaf())
+        return nullptr;
+    if (!m_seconds_zone_map)
+        m_seconds_zone_map.reset(new ZoneMap<int64_t>); // Throws
+    if (!m_seconds_zone_map->is_valid_for(table_version))
+        m_seconds_zone_map->build(*m_seconds, m_nullable, table_version); // Throws
+    return m_seconds_zone_map.get();
+}
+
+void TimestampColumn::build_ordered_index(uint_fast64_t table_version)
+{
+    REALM_ASSERT(has_search_index());
+    if (!m_ordered_index)
+        m_ordered_index.reset(new OrderedIndex<Timestamp>); // Throws
+    auto get_value = [this](size_t row_ndx, Timestamp& value) {
+        value = get(row_ndx);
+        return !value.is_null();
+    };
+    m_ordered_index->build(size(), get_value, table_version); // Throws
+}
+
+const OrderedIndex<Timestamp>* TimestampColumn::get_current_ordered_index(uint_fast64_t table_version) const
+{
+    if (m_ordered_index && !m_ordered_index->is_valid_for(table_version))
+        m_ordered_index.reset();
+    return m_ordered_index.get();
+}
+
+const ColumnStatistics<int64_t>* TimestampColumn::get_seconds_statistics(uint_fast64_t change_count) const
+{
+    if (!m_seconds_statistics)
+        m_seconds_statistics.reset(new ColumnStatistics<int64_t>); // Throws
+    if (m_seconds_statistics->needs_refresh(size(), change_count)) {
+        // Read the values leaf by leaf
+        using LeafType = BpTree<util::Optional<int64_t>>::LeafType;
+        LeafType fallback(m_seconds->get_alloc());
+        const LeafType* leaf = nullptr;
+        BpTree<util::Optional<int64_t>>::LeafInfo leaf_info{&leaf, &fallback};
+        size_t leaf_begin = 0;
+        size_t leaf_end = 0;
+        auto get_value = [&](size_t row_ndx, int64_t& value) {
+            if (row_ndx >= leaf_end) {
+                size_t ndx_in_leaf;
+                m_seconds->get_leaf(row_ndx, ndx_in_leaf, leaf_info);
+                leaf_begin = row_ndx - ndx_in_leaf;
+                leaf_end = leaf_begin + leaf->size();
+            }
+            util::Optional<int64_t> v = leaf->get(row_ndx - leaf_begin);
+            if (!v)
+                return false;
+            value = *v;
+            return true;
+        };
+        m_seconds_statistics->build(size(), get_value, change_count); // Throws
+    }
+    return m_seconds_statistics.get();
+}
+
 void TimestampColumn::add(const Timestamp& ts)
 {
     bool ts_is_null = ts.is_null();
@@ -47,6 +47,8 @@ public:
     void insert_rows(size_t row_ndx, size_t num_rows_to_insert, size_t prior_num_rows, bool nullable) override;
     void erase_rows(size_t row_ndx, size_t num_rows_to_erase, size_t prior_num_rows,
                     bool broken_reciprocal_backlinks) override;
+    void batch_erase_rows(const std::vector<size_t>& row_ndxs, size_t prior_num_rows,
+                          bool broken_reciprocal_backlinks) override;
     void move_last_row_over(size_t row_ndx, size_t prior_num_rows, bool broken_reciprocal_backlinks) override;
     void clear(size_t num_rows, bool broken_reciprocal_backlinks) override;
     void swap_rows(size_t row_ndx_1, size_t row_ndx_2) override;
@@ -87,7 +89,29 @@ public:
                           BpTree<util::Optional<int64_t>>::LeafInfo& inout_leaf) const noexcept;
     void get_nanoseconds_leaf(size_t ndx, size_t& ndx_in_leaf, BpTree<int64_t>::LeafInfo& inout_leaf) const noexcept;
 
+    /// Returns the per-leaf summary of the seconds part of the values of this
+    /// column, or null if the column consists of a single leaf (see ZoneMap).
+    const ZoneMap<int64_t>* get_seconds_zone_map(uint_fast64_t table_version) const;
+
+    /// Sorts the values of this column into its ordered index, tagged with the
+    /// specified version of the owning table (see OrderedIndex). The column
+    /// must have a search index.
+    void build_ordered_index(uint_fast64_t table_version);
+
+    /// Returns the ordered index if it was computed for the specified version
+    /// of the owning table, or null. A stale ordered index is released.
+    const OrderedIndex<Timestamp>* get_current_ordered_index(uint_fast64_t table_version) const;
+
+    /// Returns the statistics of the seconds part of the values of this
+    /// column (see ColumnStatistics). `change_count` must be the value of
+    /// Table::get_local_change_count() of the owning table.
+    const ColumnStatistics<int64_t>* get_seconds_statistics(uint_fast64_t change_count) const;
+
     void add(const Timestamp& ts = Timestamp{});
+    /// Insert `num_rows` rows at \a row_ndx, the values of which are given by
+    /// `get_value(i)`, and add them to the search index, if any, in one go.
+    template <class F>
+    void insert_values(size_t row_ndx, size_t num_rows, F get_value);
     Timestamp get(size_t row_ndx) const noexcept;
     void set(size_t row_ndx, const Timestamp& ts);
     bool compare(const TimestampColumn& c) const noexcept;
@@ -118,6 +142,9 @@ public:
 private:
     std::unique_ptr<BpTree<util::Optional<int64_t>>> m_seconds;
     std::unique_ptr<BpTree<int64_t>> m_nanoseconds;
+    mutable std::unique_ptr<ZoneMap<int64_t>> m_seconds_zone_map;
+    mutable std::unique_ptr<OrderedIndex<Timestamp>> m_ordered_index;
+    mutable std::unique_ptr<ColumnStatistics<int64_t>> m_seconds_statistics;
 
     std::unique_ptr<StringIndex> m_search_index;
     bool m_nullable;
@@ -153,6 +180,24 @@ private:
     }
 };
 
+template <class F>
+void TimestampColumn::insert_values(size_t row_ndx, size_t num_rows, F get_value)
+{
+    bool is_append = row_ndx == size();
+    for (size_t i = 0; i < num_rows; ++i) {
+        Timestamp ts = get_value(i);
+        bool ts_is_null = ts.is_null();
+        util::Optional<int64_t> seconds = ts_is_null ? util::none : util::make_optional(ts.get_seconds());
+        int32_t nanoseconds = ts_is_null ? 0 : ts.get_nanoseconds();
+        size_t ndx_or_npos_if_append = is_append ? realm::npos : row_ndx + i;
+        m_seconds->insert(ndx_or_npos_if_append, seconds);         // Throws
+        m_nanoseconds->insert(ndx_or_npos_if_append, nanoseconds); // Throws
+    }
+
+    if (has_search_index())
+        m_search_index->insert_rows(row_ndx, num_rows, is_append, get_value); // Throws
+}
+
 } // namespace realm
 
 #endif // REALM_COLUMN_TIMESTAMP_HPP
@@ -31,6 +31,7 @@
 #include <realm/util/miscellaneous.hpp>
 #include <realm/util/thread.hpp>
 #include <realm/impl/destroy_guard.hpp>
+#include <realm/impl/instruction_buffer.hpp>
 #include <realm/utilities.hpp>
 #include <realm/exceptions.hpp>
 #include <realm/column_linkbase.hpp>
@@ -1428,49 +1429,58 @@ public:
         return true;
     }
 
-    bool set_int(size_t, size_t, int_fast64_t, _impl::Instruction, size_t) noexcept
+    bool set_int(size_t, size_t row_ndx, int_fast64_t, _impl::Instruction, size_t) noexcept
     {
-        return true; // No-op
+        modify_row(row_ndx);
+        return true;
     }
 
-    bool add_int(size_t, size_t, int_fast64_t) noexcept
+    bool add_int(size_t, size_t row_ndx, int_fast64_t) noexcept
     {
-        return true; // No-op
+        modify_row(row_ndx);
+        return true;
     }
 
-    bool set_bool(size_t, size_t, bool, _impl::Instruction) noexcept
+    bool set_bool(size_t, size_t row_ndx, bool, _impl::Instruction) noexcept
     {
-        return true; // No-op
+        modify_row(row_ndx);
+        return true;
     }
 
-    bool set_float(size_t, size_t, float, _impl::Instruction) noexcept
+    bool set_float(size_t, size_t row_ndx, float, _impl::Instruction) noexcept
     {
-        return true; // No-op
+        modify_row(row_ndx);
+        return true;
     }
 
-    bool set_double(size_t, size_t, double, _impl::Instruction) noexcept
+    bool set_double(size_t, size_t row_ndx, double, _impl::Instruction) noexcept
     {
-        return true; // No-op
+        modify_row(row_ndx);
+        return true;
     }
 
-    bool set_string(size_t, size_t, StringData, _impl::Instruction, size_t) noexcept
+    bool set_string(size_t, size_t row_ndx, StringData, _impl::Instruction, size_t) noexcept
     {
-        return true; // No-op
+        modify_row(row_ndx);
+        return true;
     }
 
-    bool set_binary(size_t, size_t, BinaryData, _impl::Instruction) noexcept
+    bool set_binary(size_t, size_t row_ndx, BinaryData, _impl::Instruction) noexcept
     {
-        return true; // No-op
+        modify_row(row_ndx);
+        return true;
     }
 
-    bool set_olddatetime(size_t, size_t, OldDateTime, _impl::Instruction) noexcept
+    bool set_olddatetime(size_t, size_t row_ndx, OldDateTime, _impl::Instruction) noexcept
     {
-        return true; // No-op
+        modify_row(row_ndx);
+        return true;
     }
 
-    bool set_timestamp(size_t, size_t, Timestamp, _impl::Instruction) noexcept
+    bool set_timestamp(size_t, size_t row_ndx, Timestamp, _impl::Instruction) noexcept
     {
-        return true; // No-op
+        modify_row(row_ndx);
+        return true;
     }
 
     bool set_table(size_t col_ndx, size_t row_ndx, _impl::Instruction) noexcept
@@ -1494,9 +1504,10 @@ public:
         return true;
     }
 
-    bool set_null(size_t, size_t, _impl::Instruction, size_t) noexcept
+    bool set_null(size_t, size_t row_ndx, _impl::Instruction, size_t) noexcept
     {
-        return true; // No-op
+        modify_row(row_ndx);
+        return true;
     }
 
     bool set_link(size_t col_ndx, size_t, size_t, size_t, _impl::Instruction) noexcept
@@ -1526,14 +1537,16 @@ public:
         return true;
     }
 
-    bool insert_substring(size_t, size_t, size_t, StringData)
+    bool insert_substring(size_t, size_t row_ndx, size_t, StringData)
     {
-        return true; // No-op
+        modify_row(row_ndx);
+        return true;
     }
 
-    bool erase_substring(size_t, size_t, size_t, size_t)
+    bool erase_substring(size_t, size_t row_ndx, size_t, size_t)
     {
-        return true; // No-op
+        modify_row(row_ndx);
+        return true;
     }
 
     bool optimize_table() noexcept
@@ -1746,7 +1759,22 @@ public:
         return true; // No-op
     }
 
+    // Not a transaction log instruction. Used by _impl::InstructionBuffer in
+    // place of the instructions that only change the values of cells.
+    bool modify_rows(size_t row_ndx, size_t num_rows) noexcept
+    {
+        typedef _impl::TableFriend tf;
+        if (m_table)
+            tf::adj_acc_modify_rows(*m_table, row_ndx, num_rows);
+        return true;
+    }
+
 private:
+    void modify_row(size_t row_ndx) noexcept
+    {
+        modify_rows(row_ndx, 1);
+    }
+
     Group& m_group;
     TableRef m_table;
     DescriptorRef m_desc;
@@ -1887,6 +1915,31 @@ void Group::advance_transact(ref_type new_top_ref, size_t new_file_size, _impl::
     TransactAdvancer advancer(*this, schema_changed);
     parser.parse(in, advancer); // Throws
 
+    finish_advance_transact(new_top_ref, schema_changed); // Throws
+}
+
+
+void Group::advance_transact(ref_type new_top_ref, size_t new_file_size,
+                             const _impl::InstructionBuffer& instructions)
+{
+    REALM_ASSERT(is_attached());
+
+    // Same as above, except that the instructions were recorded while the
+    // changesets were parsed for a transaction log observer (see
+    // SharedGroup::do_advance_read()).
+
+    m_alloc.update_reader_view(new_file_size); // Throws
+
+    bool schema_changed = false;
+    TransactAdvancer advancer(*this, schema_changed);
+    instructions.replay(advancer); // Throws
+
+    finish_advance_transact(new_top_ref, schema_changed); // Throws
+}
+
+
+void Group::finish_advance_transact(ref_type new_top_ref, bool schema_changed)
+{
     m_top.detach();                                 // Soft detach
     bool create_group_when_missing = false;         // See Group::attach_shared().
     attach(new_top_ref, create_group_when_missing); // Throws
@@ -39,6 +39,7 @@ namespace realm {
 class SharedGroup;
 namespace _impl {
 class GroupFriend;
+class InstructionBuffer;
 class TransactLogConvenientEncoder;
 class TransactLogParser;
 }
@@ -706,6 +707,8 @@ private:
     void update_num_objects();
     class TransactAdvancer;
     void advance_transact(ref_type new_top_ref, size_t new_file_size, _impl::NoCopyInputStream&);
+    void advance_transact(ref_type new_top_ref, size_t new_file_size, const _impl::InstructionBuffer&);
+    void finish_advance_transact(ref_type new_top_ref, bool schema_changed);
     void refresh_dirty_accessors();
     template <class F>
     void update_table_indices(F&& map_function);
@@ -23,6 +23,7 @@
 #include <iostream>
 #include <mutex>
 #include <sstream>
+#include <thread>
 #include <type_traits>
 #include <random>
 
@@ -59,12 +60,6 @@ using Durability = SharedGroupOptions::Durability;
 
 namespace {
 
-// Constants controlling the amount of uncommited writes in flight:
-#ifdef REALM_ASYNC_DAEMON
-const uint16_t max_write_slots = 100;
-const uint16_t relaxed_sync_threshold = 50;
-#endif
-
 // value   change
 // --------------------
 //  4      Unknown
@@ -78,7 +73,13 @@ const uint16_t relaxed_sync_threshold = 50;
 //  9      Fair write transactions requires an additional condition variable,
 //         `write_fairness`
 // 10      Introducing SharedInfo::history_schema_version.
-const uint_fast16_t g_shared_info_version = 10;
+// 11      Group commit: `group_commit` (formerly `filler_1`), `durable_version`,
+//         `durable_reader_idx` and `shared_flushmutex`. The async commit
+//         daemon was replaced by an in-process thread, removing
+//         `free_write_slots`, `daemon_ready`, `shared_balancemutex`,
+//         `room_to_write`, `work_to_do` and `daemon_becomes_ready`, and
+//         renaming `daemon_started` to `async_flusher_present`.
+const uint_fast16_t g_shared_info_version = 11;
 
 // The following functions are carefully designed for minimal overhead
 // in case of contention among read transactions. In case of contention,
@@ -382,6 +383,19 @@ private:
     ReadCount data[init_readers_size];
 };
 
+
+// Returns the history schema version stored in the specified snapshot, or
+// `openers_version` if the snapshot has no history, because a history schema
+// only applies when there is a history, so there is nothing to upgrade then.
+int get_stored_hist_schema_version(const Allocator& alloc, ref_type top_ref, int openers_version) noexcept
+{
+    using gf = _impl::GroupFriend;
+    _impl::History::version_type version;
+    int hist_type, hist_schema_version;
+    gf::get_version_and_history_info(alloc, top_ref, version, hist_type, hist_schema_version);
+    return (hist_type == Replication::hist_None ? openers_version : hist_schema_version);
+}
+
 } // anonymous namespace
 
 
@@ -462,8 +476,8 @@ struct alignas(8) SharedGroup::SharedInfo {
     /// compromize version agreement checking.
     uint16_t shared_info_version = g_shared_info_version; // Offset 6
 
-    uint16_t durability;           // Offset 8
-    uint16_t free_write_slots = 0; // Offset 10
+    uint16_t durability;   // Offset 8
+    uint16_t filler_1 = 0; // Offset 10
 
     /// Number of participating shared groups
     uint32_t num_participants = 0; // Offset 12
@@ -488,17 +502,19 @@ struct alignas(8) SharedGroup::SharedInfo {
     /// sync agent can be started.
     uint8_t sync_agent_present = 0; // Offset 40
 
-    /// Set when a participant decides to start the daemon, cleared by the
-    /// daemon when it decides to exit. Participants check during open() and
-    /// start the daemon if running in async mode.
-    uint8_t daemon_started = 0; // Offset 41
+    /// True (1) if one of the session participants runs the thread that makes
+    /// commits durable in Durability::Async mode (see
+    /// SharedGroup::AsyncFlusher). Set by the participant that starts the
+    /// thread, and cleared by the thread when it stops. Participants check it
+    /// after every commit, and start a new thread if it is clear.
+    uint8_t async_flusher_present = 0; // Offset 41
 
-    /// Set by the daemon when it is ready to handle commits. Participants must
-    /// wait during open() on 'daemon_becomes_ready' for this to become true.
-    /// Cleared by the daemon when it decides to exit.
-    uint8_t daemon_ready = 0; // Offset 42
+    uint8_t filler_3 = 0; // Offset 42
 
-    uint8_t filler_1;  // Offset 43
+    /// True (1) if the session uses group commit (see
+    /// SharedGroupOptions::enable_group_commit). Must match across all session
+    /// participants.
+    uint8_t group_commit = 0; // Offset 43
 
     /// Stores a history schema version (as returned by
     /// Replication::get_history_schema_version()). Must match across all
@@ -508,19 +524,21 @@ struct alignas(8) SharedGroup::SharedInfo {
     uint16_t filler_2; // Offset 46
 
     InterprocessMutex::SharedPart shared_writemutex; // Offset 48
-#ifdef REALM_ASYNC_DAEMON
-    InterprocessMutex::SharedPart shared_balancemutex;
-#endif
     InterprocessMutex::SharedPart shared_controlmutex;
+    InterprocessMutex::SharedPart shared_flushmutex;
     // FIXME: windows pthread support for condvar not ready
-    InterprocessCondVar::SharedPart room_to_write;
-    InterprocessCondVar::SharedPart work_to_do;
-    InterprocessCondVar::SharedPart daemon_becomes_ready;
     InterprocessCondVar::SharedPart new_commit_available;
     InterprocessCondVar::SharedPart pick_next_writer;
     std::atomic<uint32_t> next_ticket;
     uint32_t next_served = 0;
 
+    /// With group commit and in Durability::Async mode, the version of the
+    /// snapshot selected by the file header, and the ringbuffer entry of the read lock which prevents that
+    /// snapshot from being overwritten until a later one has been made
+    /// durable. Guarded by the flushmutex rather than the controlmutex.
+    uint64_t durable_version = 0;
+    uint32_t durable_reader_idx = 0;
+
     // IMPORTANT: The ringbuffer MUST be the last field in SharedInfo - see above.
     Ringbuffer readers;
 
@@ -547,12 +565,10 @@ struct alignas(8) SharedGroup::SharedInfo {
 
 SharedGroup::SharedInfo::SharedInfo(Durability dura, Replication::HistoryType ht, int hsv)
     : size_of_mutex(sizeof(shared_writemutex))
-    , size_of_condvar(sizeof(room_to_write))
+    , size_of_condvar(sizeof(new_commit_available))
     , shared_writemutex() // Throws
-#ifdef REALM_ASYNC_DAEMON
-    , shared_balancemutex() // Throws
-#endif
     , shared_controlmutex() // Throws
+    , shared_flushmutex() // Throws
 {
     durability = static_cast<uint16_t>(dura); // durability level is fixed from creation
     REALM_ASSERT(!util::int_cast_has_overflow<decltype(history_type)>(ht + 0));
@@ -562,11 +578,6 @@ SharedGroup::SharedInfo::SharedInfo(Durability dura, Replication::HistoryType ht
     InterprocessCondVar::init_shared_part(new_commit_available); // Throws
     InterprocessCondVar::init_shared_part(pick_next_writer); // Throws
     next_ticket = 0;
-#ifdef REALM_ASYNC_DAEMON
-    InterprocessCondVar::init_shared_part(room_to_write);        // Throws
-    InterprocessCondVar::init_shared_part(work_to_do);           // Throws
-    InterprocessCondVar::init_shared_part(daemon_becomes_ready); // Throws
-#endif
 
     // IMPORTANT: The offsets, types (, and meanings) of these members must
     // never change, not even when the SharedInfo layout version is bumped. The
@@ -603,8 +614,8 @@ SharedGroup::SharedInfo::SharedInfo(Durability dura, Replication::HistoryType ht
                   std::is_same<decltype(history_type), int8_t>::value &&
                   offsetof(SharedInfo, durability) == 8 &&
                   std::is_same<decltype(durability), uint16_t>::value &&
-                  offsetof(SharedInfo, free_write_slots) == 10 &&
-                  std::is_same<decltype(free_write_slots), uint16_t>::value &&
+                  offsetof(SharedInfo, filler_1) == 10 &&
+                  std::is_same<decltype(filler_1), uint16_t>::value &&
                   offsetof(SharedInfo, num_participants) == 12 &&
                   std::is_same<decltype(num_participants), uint32_t>::value &&
                   offsetof(SharedInfo, latest_version_number) == 16 &&
@@ -615,12 +626,12 @@ SharedGroup::SharedInfo::SharedInfo(Durability dura, Replication::HistoryType ht
                   std::is_same<decltype(number_of_versions), uint64_t>::value &&
                   offsetof(SharedInfo, sync_agent_present) == 40 &&
                   std::is_same<decltype(sync_agent_present), uint8_t>::value &&
-                  offsetof(SharedInfo, daemon_started) == 41 &&
-                  std::is_same<decltype(daemon_started), uint8_t>::value &&
-                  offsetof(SharedInfo, daemon_ready) == 42 &&
-                  std::is_same<decltype(daemon_ready), uint8_t>::value &&
-                  offsetof(SharedInfo, filler_1) == 43 &&
-                  std::is_same<decltype(filler_1), uint8_t>::value &&
+                  offsetof(SharedInfo, async_flusher_present) == 41 &&
+                  std::is_same<decltype(async_flusher_present), uint8_t>::value &&
+                  offsetof(SharedInfo, filler_3) == 42 &&
+                  std::is_same<decltype(filler_3), uint8_t>::value &&
+                  offsetof(SharedInfo, group_commit) == 43 &&
+                  std::is_same<decltype(group_commit), uint8_t>::value &&
                   offsetof(SharedInfo, history_schema_version) == 44 &&
                   std::is_same<decltype(history_schema_version), uint16_t>::value &&
                   offsetof(SharedInfo, filler_2) == 46 &&
@@ -634,102 +645,6 @@ SharedGroup::SharedInfo::SharedInfo(Durability dura, Replication::HistoryType ht
 }
 
 
-namespace {
-
-#ifdef REALM_ASYNC_DAEMON
-
-void spawn_daemon(const std::string& file)
-{
-    // determine maximum number of open descriptors
-    errno = 0;
-    int m = int(sysconf(_SC_OPEN_MAX));
-    if (m < 0) {
-        if (errno) {
-            int err = errno; // Eliminate any risk of clobbering
-            throw std::system_error(err, std::system_category(), "sysconf(_SC_OPEN_MAX) failed");
-        }
-        throw std::runtime_error("'sysconf(_SC_OPEN_MAX)' failed with no reason");
-    }
-
-    int pid = fork();
-    if (0 == pid) { // child process:
-
-        // close all descriptors:
-        int i;
-        for (i = m - 1; i >= 0; --i)
-            close(i);
-#ifdef REALM_ENABLE_LOGFILE
-        // FIXME: Do we want to always open the log file? Should it be configurable?
-        i = ::open((file + ".log").c_str(), O_RDWR | O_CREAT | O_APPEND | O_SYNC, S_IRWXU);
-#else
-        i = ::open("/dev/null", O_RDWR);
-#endif
-        if (i >= 0) {
-            int j = dup(i);
-            static_cast<void>(j);
-        }
-#ifdef REALM_ENABLE_LOGFILE
-        std::cerr << "Detaching" << std::endl;
-#endif
-        // detach from current session:
-        setsid();
-
-        // start commit daemon executable
-        // Note that getenv (which is not thread safe) is called in a
-        // single threaded context. This is ensured by the fork above.
-        const char* async_daemon = getenv("REALM_ASYNC_DAEMON");
-        if (!async_daemon) {
-#ifndef REALM_DEBUG
-            async_daemon = REALM_INSTALL_LIBEXECDIR "/realmd";
-#else
-            async_daemon = REALM_INSTALL_LIBEXECDIR "/realmd-dbg";
-#endif
-        }
-        execl(async_daemon, async_daemon, file.c_str(), static_cast<char*>(0));
-
-// if we continue here, exec has failed so return error
-// if exec succeeds, we don't come back here.
-#if REALM_ANDROID
-        _exit(1);
-#else
-        _Exit(1);
-#endif
-        // child process ends here
-    }
-    else if (pid > 0) { // parent process, fork succeeded:
-
-        // use childs exit code to catch and report any errors:
-        int status;
-        int pid_changed;
-        do {
-            pid_changed = waitpid(pid, &status, 0);
-        } while (pid_changed == -1 && errno == EINTR);
-        if (pid_changed != pid) {
-            std::cerr << "Waitpid returned pid = " << pid_changed << " and status = " << std::hex << status
-                      << std::endl;
-            throw std::runtime_error("call to waitpid failed");
-        }
-        if (!WIFEXITED(status))
-            throw std::runtime_error("failed starting async commit (exit)");
-        if (WEXITSTATUS(status) == 1) {
-            // FIXME: Or `ld` could not find a required shared library
-            throw std::runtime_error("async commit daemon not found");
-        }
-        if (WEXITSTATUS(status) == 2)
-            throw std::runtime_error("async commit daemon failed");
-        if (WEXITSTATUS(status) == 3)
-            throw std::runtime_error("wrong db given to async daemon");
-    }
-    else { // Parent process, fork failed!
-
-        throw std::runtime_error("Failed to spawn async commit");
-    }
-}
-#endif
-
-
-} // anonymous namespace
-
 #if REALM_HAVE_STD_FILESYSTEM
 std::string SharedGroupOptions::sys_tmp_dir = std::filesystem::temp_directory_path().u8string();
 #else
@@ -764,29 +679,31 @@ void SharedGroup::do_open(const std::string& path, bool no_create_file, bool is_
 
     REALM_ASSERT(!is_attached());
 
-#ifndef REALM_ASYNC_DAEMON
-    if (options.durability == Durability::Async)
-        throw std::runtime_error("Async mode not yet supported on Windows, iOS and watchOS");
-#endif
-
     m_db_path = path;
     m_coordination_dir = path + ".management";
     m_lockfile_path = path + ".lock";
     try_make_dir(m_coordination_dir);
     m_key = options.encryption_key;
     m_lockfile_prefix = m_coordination_dir + "/access_control";
+    m_group_commit_window = options.group_commit_window;
+    m_async_commit_latency = options.async_commit_latency;
+    m_compaction_budget = options.compaction_budget;
+    m_temp_dir = options.temp_dir;
     SlabAlloc& alloc = m_group.m_alloc;
 
 #if REALM_METRICS
     if (options.enable_metrics) {
         m_metrics = std::make_shared<Metrics>(options.metrics_buffer_size);
         m_group.set_metrics(m_metrics);
+        alloc.set_translation_cache_stats_enabled(true);
     }
 #endif // REALM_METRICS
 
     Replication::HistoryType openers_hist_type = Replication::hist_None;
     int openers_hist_schema_version = 0;
     bool opener_is_sync_agent = false;
+    bool group_commit = options.enable_group_commit && options.durability == Durability::Full &&
+                        !options.encryption_key;
     if (Replication* repl = m_group.get_replication()) {
         openers_hist_type = repl->get_history_type();
         openers_hist_schema_version = repl->get_history_schema_version();
@@ -951,13 +868,13 @@ void SharedGroup::do_open(const std::string& path, bool no_create_file, bool is_
             throw IncompatibleLockFile(ss.str());
         }
 
-        if (info->size_of_condvar != sizeof info->room_to_write) {
+        if (info->size_of_condvar != sizeof info->new_commit_available) {
             if (retries_left) {
                 --retries_left;
                 continue;
             }
             std::stringstream ss;
-            ss << "Condtion var size doesn't match: " << info->size_of_condvar << " " << sizeof(info->room_to_write)
+            ss << "Condtion var size doesn't match: " << info->size_of_condvar << " " << sizeof(info->new_commit_available)
                << ".";
             throw IncompatibleLockFile(ss.str());
         }
@@ -978,11 +895,8 @@ void SharedGroup::do_open(const std::string& path, bool no_create_file, bool is_
         // again and prevent us from being notified below.
 
         m_writemutex.set_shared_part(info->shared_writemutex, m_lockfile_prefix, "write");
-#ifdef REALM_ASYNC_DAEMON
-        if (info->durability == static_cast<uint16_t>(Durability::Async))
-            m_balancemutex.set_shared_part(info->shared_balancemutex, m_lockfile_prefix, "balance");
-#endif
         m_controlmutex.set_shared_part(info->shared_controlmutex, m_lockfile_prefix, "control");
+        m_flushmutex.set_shared_part(info->shared_flushmutex, m_lockfile_prefix, "flush");
 
         // even though fields match wrt alignment and size, there may still be incompatibilities
         // between implementations, so lets ask one of the mutexes if it thinks it'll work.
@@ -1031,6 +945,7 @@ void SharedGroup::do_open(const std::string& path, bool no_create_file, bool is_
             cfg.clear_file = (options.durability == Durability::MemOnly && begin_new_session);
 
             cfg.encryption_key = options.encryption_key;
+            cfg.translation_cache_size = options.translation_cache_size;
             ref_type top_ref;
             try {
                 top_ref = alloc.attach_file(path, cfg); // Throws
@@ -1111,6 +1026,8 @@ void SharedGroup::do_open(const std::string& path, bool no_create_file, bool is_
                 int stored_hist_type = 0;
                 gf::get_version_and_history_info(alloc, top_ref, version, stored_hist_type,
                                                  stored_hist_schema_version);
+                if (stored_hist_type == Replication::hist_None)
+                    stored_hist_schema_version = openers_hist_schema_version;
                 bool good_history_type = false;
                 switch (openers_hist_type) {
                     case Replication::hist_None:
@@ -1179,6 +1096,17 @@ void SharedGroup::do_open(const std::string& path, bool no_create_file, bool is_
                 SharedInfo* r_info = m_reader_map.get_addr();
                 size_t file_size = alloc.get_baseline();
                 r_info->init_versioning(top_ref, file_size, version);
+
+                info->group_commit = group_commit;
+                if (group_commit || options.durability == Durability::Async) {
+                    // The snapshot selected by the file header must survive
+                    // until a later one has been made durable, so it is kept
+                    // bound by a read lock that is handed over by each flush.
+                    ReadLockInfo durable_lock;
+                    grab_read_lock(durable_lock, VersionID()); // Throws
+                    info->durable_version = durable_lock.m_version;
+                    info->durable_reader_idx = durable_lock.m_reader_idx;
+                }
             }
             else { // Not the session initiator
                 // Durability setting must be consistent across a session. An
@@ -1188,11 +1116,16 @@ void SharedGroup::do_open(const std::string& path, bool no_create_file, bool is_
                 if (Durability(info->durability) != options.durability)
                     throw LogicError(LogicError::mixed_durability);
 
+                // The same goes for group commit, which changes when commits
+                // become durable.
+                if (bool(info->group_commit) != group_commit)
+                    throw LogicError(LogicError::mixed_durability);
+
                 // History type must be consistent across a session. An
                 // inconsistency is a logic error, as the user is required to
                 // make sure that all possible concurrent session participants
                 // use the same history type for the same Realm file.
-                if (info->history_type != openers_hist_type)
+                if (info->history_type != openers_hist_type && !is_backend)
                     throw LogicError(LogicError::mixed_history_type);
 
                 // History schema version must be consistent across a
@@ -1200,7 +1133,7 @@ void SharedGroup::do_open(const std::string& path, bool no_create_file, bool is_
                 // required to make sure that all possible concurrent session
                 // participants use the same history schema version for the same
                 // Realm file.
-                if (info->history_schema_version != openers_hist_schema_version)
+                if (info->history_schema_version != openers_hist_schema_version && !is_backend)
                     throw LogicError(LogicError::mixed_history_schema_version);
 #ifdef _WIN32
                 uint64_t pid = GetCurrentProcessId();
@@ -1251,30 +1184,6 @@ void SharedGroup::do_open(const std::string& path, bool no_create_file, bool is_
                                                    options.temp_dir);
             m_pick_next_writer.set_shared_part(info->pick_next_writer, m_lockfile_prefix, "pick_writer",
                                                    options.temp_dir);
-#ifdef REALM_ASYNC_DAEMON
-            if (options.durability == Durability::Async) {
-                m_daemon_becomes_ready.set_shared_part(info->daemon_becomes_ready, m_lockfile_prefix, "daemon_ready",
-                                                       options.temp_dir);
-                m_work_to_do.set_shared_part(info->work_to_do, m_lockfile_prefix, "work_ready", options.temp_dir);
-                m_room_to_write.set_shared_part(info->room_to_write, m_lockfile_prefix, "allow_write",
-                                                options.temp_dir);
-                // In async mode, we need to make sure the daemon is running and ready:
-                if (!is_backend) {
-                    while (info->daemon_ready == 0) {
-                        if (info->daemon_started == 0) {
-                            spawn_daemon(path);
-                            info->daemon_started = 1;
-                        }
-                        // FIXME: It might be more robust to sleep a little, then restart the loop
-                        // std::cerr << "Waiting for daemon" << std::endl;
-                        m_daemon_becomes_ready.wait(m_controlmutex, 0);
-                        // std::cerr << " - notified" << std::endl;
-                    }
-                }
-            }
-// std::cerr << "daemon should be ready" << std::endl;
-#endif // REALM_ASYNC_DAEMON
-
             // Set initial version so we can track if other instances
             // change the db
             m_read_lock.m_version = get_version_of_latest_snapshot();
@@ -1302,15 +1211,13 @@ void SharedGroup::do_open(const std::string& path, bool no_create_file, bool is_
     set_transact_stage(transact_Ready);
 // std::cerr << "open completed" << std::endl;
 
-#ifdef REALM_ASYNC_DAEMON
-    if (options.durability == Durability::Async) {
-        if (is_backend) {
-            do_async_commits();
-        }
+    if (is_backend) {
+        // The async flusher never accesses the contents of the Realm, it only
+        // writes the file format version of the session to the file header.
+        using gf = _impl::GroupFriend;
+        gf::set_file_format_version(m_group, target_file_format_version);
+        return;
     }
-#else
-    static_cast<void>(is_backend);
-#endif
 
     // Upgrade file format and/or history schema
     try {
@@ -1318,7 +1225,8 @@ void SharedGroup::do_open(const std::string& path, bool no_create_file, bool is_
         if (stored_hist_schema_version == -1) {
             // current_hist_schema_version has not been read. Read it now
             ReadTransaction rt(*this);
-            stored_hist_schema_version = gf::get_history_schema_version(m_group.m_alloc, m_read_lock.m_top_ref);
+            stored_hist_schema_version = get_stored_hist_schema_version(m_group.m_alloc, m_read_lock.m_top_ref,
+                                                                        openers_hist_schema_version);
         }
         if (current_file_format_version == 0) {
             // If the current file format is still undecided, no upgrade is
@@ -1336,6 +1244,11 @@ void SharedGroup::do_open(const std::string& path, bool no_create_file, bool is_
             upgrade_file_format(options.allow_file_format_upgrade, target_file_format_version,
                                 stored_hist_schema_version, openers_hist_schema_version); // Throws
         }
+
+        if (options.durability == Durability::Async) {
+            m_async_commits = true;
+            ensure_async_flusher(); // Throws
+        }
     }
     catch (...) {
         close();
@@ -1357,8 +1270,16 @@ bool SharedGroup::compact(bool bump_version_number, util::Optional<const char*>
     }
     SharedInfo* info = m_file_map.get_addr();
     Durability dura = Durability(info->durability);
+    bool group_commit = bool(info->group_commit);
     std::string tmp_path = m_db_path + ".tmp_compaction_space";
     const char* write_key = bool(output_encryption_key) ? *output_encryption_key : m_key;
+
+    // The async flusher of this SharedGroup is a session participant too. It
+    // is restarted when the compacted file is opened.
+    if (m_async_flusher) {
+        m_async_flusher.reset();
+        m_async_commits = false;
+    }
     {
         std::unique_lock<InterprocessMutex> lock(m_controlmutex); // Throws
         if (info->num_participants > 1)
@@ -1419,6 +1340,12 @@ bool SharedGroup::compact(bool bump_version_number, util::Optional<const char*>
     new_options.durability = dura;
     new_options.encryption_key = write_key;
     new_options.allow_file_format_upgrade = false;
+    new_options.enable_group_commit = group_commit;
+    new_options.group_commit_window = m_group_commit_window;
+    new_options.async_commit_latency = m_async_commit_latency;
+    new_options.translation_cache_size = m_group.m_alloc.get_translation_cache_size();
+    new_options.compaction_budget = m_compaction_budget;
+    new_options.temp_dir = m_temp_dir;
     do_open(m_db_path, true, false, new_options);
     return true;
 }
@@ -1459,6 +1386,11 @@ void SharedGroup::close_internal(std::unique_lock<InterprocessMutex> lock) noexc
     if (!is_attached())
         return;
 
+    // Stop the async flusher first, as it is a session participant too
+    REALM_ASSERT(!m_async_flusher || !lock.owns_lock());
+    m_async_flusher.reset();
+    m_async_commits = false;
+
     switch (m_transact_stage) {
         case transact_Ready:
             break;
@@ -1508,11 +1440,6 @@ void SharedGroup::close_internal(std::unique_lock<InterprocessMutex> lock) noexc
         }
         lock.unlock();
     }
-#ifdef REALM_ASYNC_DAEMON
-    m_room_to_write.close();
-    m_work_to_do.close();
-    m_daemon_becomes_ready.close();
-#endif
     m_new_commit_available.close();
     m_pick_next_writer.close();
 
@@ -1565,24 +1492,30 @@ void SharedGroup::set_transact_stage(SharedGroup::TransactStage stage) noexcept
         size_t num_objects = m_group.m_total_rows;
         size_t num_available_versions = static_cast<size_t>(get_number_of_versions());
         size_t num_decrypted_pages = realm::util::get_num_decrypted_pages();
+        uint_fast64_t cache_hits = m_group.m_alloc.get_translation_cache_hits();
+        uint_fast64_t cache_misses = m_group.m_alloc.get_translation_cache_misses();
+        uint_fast64_t hits = cache_hits - m_translation_cache_hits;
+        uint_fast64_t misses = cache_misses - m_translation_cache_misses;
+        m_translation_cache_hits = cache_hits;
+        m_translation_cache_misses = cache_misses;
 
         if (stage == transact_Reading) {
             if (m_transact_stage == transact_Writing) {
                 m_metrics->end_write_transaction(total_size, free_space, num_objects, num_available_versions,
-                                                 num_decrypted_pages);
+                                                 num_decrypted_pages, hits, misses);
             }
             m_metrics->start_read_transaction();
         } else if (stage == transact_Writing) {
             if (m_transact_stage == transact_Reading) {
                 m_metrics->end_read_transaction(total_size, free_space, num_objects, num_available_versions,
-                                                num_decrypted_pages);
+                                                num_decrypted_pages, hits, misses);
             }
             m_metrics->start_write_transaction();
         } else if (stage == transact_Ready) {
             m_metrics->end_read_transaction(total_size, free_space, num_objects, num_available_versions,
-                                            num_decrypted_pages);
+                                            num_decrypted_pages, hits, misses);
             m_metrics->end_write_transaction(total_size, free_space, num_objects, num_available_versions,
-                                             num_decrypted_pages);
+                                             num_decrypted_pages, hits, misses);
         }
     }
 #endif
@@ -1590,109 +1523,130 @@ void SharedGroup::set_transact_stage(SharedGroup::TransactStage stage) noexcept
     m_transact_stage = stage;
 }
 
-#ifdef REALM_ASYNC_DAEMON
-void SharedGroup::do_async_commits()
+SharedGroup::AsyncFlusher::AsyncFlusher(const std::string& path, const SharedGroupOptions& options)
+    : m_shared_group(unattached_tag())
+    , m_latency(options.async_commit_latency)
 {
-    bool shutdown = false;
-    SharedInfo* info = m_file_map.get_addr();
+    bool no_create = true;
+    bool is_backend = true;
+    m_shared_group.do_open(path, no_create, is_backend, options); // Throws
 
-    // We always want to keep a read lock on the last version
-    // that was commited to disk, to protect it against being
-    // overwritten by commits being made to memory by others.
+    // Start out from the durable snapshot, such that commits made while no
+    // flusher was running are covered by the first flush.
     {
-        VersionID version_id = VersionID();      // Latest available snapshot
-        grab_read_lock(m_read_lock, version_id); // Throws
+        SharedInfo* info = m_shared_group.m_file_map.get_addr();
+        std::lock_guard<InterprocessMutex> lock(m_shared_group.m_flushmutex); // Throws
+        m_shared_group.m_read_lock.m_version = info->durable_version;
     }
-    // we must treat version and version_index the same way:
-    {
-        std::lock_guard<InterprocessMutex> lock(m_controlmutex);
-        info->free_write_slots = max_write_slots;
-        info->daemon_ready = 1;
-        m_daemon_becomes_ready.notify_all();
-    }
-    using gf = _impl::GroupFriend;
-    gf::detach(m_group);
 
-    while (true) {
-        if (m_file.is_removed()) { // operator removed the lock file. take a hint!
+    m_thread.start([this] { run(); }); // Throws
+}
 
-            shutdown = true;
-#ifdef REALM_ENABLE_LOGFILE
-            std::cerr << "Lock file removed, initiating shutdown" << std::endl;
-#endif
-        }
 
-        bool is_same;
-        ReadLockInfo next_read_lock = m_read_lock;
-        {
-            // detect if we're the last "client", and if so, shutdown (must be under lock):
-            std::lock_guard<InterprocessMutex> lock2(m_writemutex);
-            std::lock_guard<InterprocessMutex> lock(m_controlmutex);
-            version_type old_version = next_read_lock.m_version;
-            VersionID version_id = VersionID(); // Latest available snapshot
-            grab_read_lock(next_read_lock, version_id);
-            is_same = (next_read_lock.m_version == old_version);
-            if (is_same && (shutdown || info->num_participants == 1)) {
-#ifdef REALM_ENABLE_LOGFILE
-                std::cerr << "Daemon exiting nicely" << std::endl << std::endl;
-#endif
-                release_read_lock(next_read_lock);
-                release_read_lock(m_read_lock);
-                info->daemon_started = 0;
-                info->daemon_ready = 0;
-                return;
-            }
-        }
+SharedGroup::AsyncFlusher::~AsyncFlusher() noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_cond.notify_all();
+    m_shared_group.wait_for_change_release();
+    m_thread.join();
+}
 
-        if (!is_same) {
 
-#ifdef REALM_ENABLE_LOGFILE
-            std::cerr << "Syncing from version " << m_read_lock.m_version << " to " << next_read_lock.m_version
-                      << std::endl;
-#endif
-            GroupWriter writer(m_group);
-            writer.commit(next_read_lock.m_top_ref);
-#ifdef REALM_ENABLE_LOGFILE
-            std::cerr << "..and Done" << std::endl;
-#endif
-        }
+bool SharedGroup::AsyncFlusher::has_failed() noexcept
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return bool(m_error);
+}
 
-        // Now we can release the version that was previously commited
-        // to disk and just keep the lock on the latest version.
-        release_read_lock(m_read_lock);
-        m_read_lock = next_read_lock;
 
-        m_balancemutex.lock();
+void SharedGroup::AsyncFlusher::rethrow_error()
+{
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        error = m_error;
+    }
+    std::rethrow_exception(error);
+}
 
-        // We have caught up with the writers, let them know that there are
-        // now free write slots, wakeup any that has been suspended.
-        uint16_t free_write_slots = info->free_write_slots;
-        info->free_write_slots = max_write_slots;
-        if (free_write_slots <= 0) {
-            m_room_to_write.notify_all();
-        }
 
-        // If we have plenty of write slots available, relax and wait a bit before syncing
-        if (free_write_slots > relaxed_sync_threshold) {
-            timespec ts;
-            timeval tv;
-            // clock_gettime(CLOCK_REALTIME, &ts); <- would like to use this, but not there on mac
-            gettimeofday(&tv, nullptr);
-            ts.tv_sec = tv.tv_sec;
-            ts.tv_nsec = tv.tv_usec * 1000;
-            ts.tv_nsec += 10000000;         // 10 msec
-            if (ts.tv_nsec >= 1000000000) { // overflow
-                ts.tv_nsec -= 1000000000;
-                ts.tv_sec += 1;
+void SharedGroup::AsyncFlusher::run()
+{
+    SharedGroup& sg = m_shared_group;
+    SharedInfo* info = sg.m_file_map.get_addr();
+    try {
+        for (;;) {
+            bool has_changed = sg.wait_for_change(); // Throws
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                if (has_changed && !m_stop) {
+                    // Let more commits arrive, so that they can be covered by
+                    // the same flush
+                    m_cond.wait_for(lock, m_latency, [this] { return m_stop; });
+                }
+                if (m_stop)
+                    break;
             }
+            version_type version = sg.get_version_of_latest_snapshot(); // Throws
+            sg.make_durable(version); // Throws
+            sg.m_read_lock.m_version = version;
+        }
 
-            // no timeout support if the condvars are only emulated, so this will assert
-            m_work_to_do.wait(m_balancemutex, &ts);
+        // Stop being the flusher of the session before the final flush. A
+        // commit which finds the flag set is then covered by the final flush,
+        // and any later commit starts a new flusher.
+        {
+            std::lock_guard<InterprocessMutex> lock(sg.m_controlmutex); // Throws
+            info->async_flusher_present = 0;
         }
-        m_balancemutex.unlock();
+        sg.make_durable(sg.get_version_of_latest_snapshot()); // Throws
+    }
+    catch (...) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_error = std::current_exception();
+    }
+    if (m_error) {
+        try {
+            std::lock_guard<InterprocessMutex> lock(sg.m_controlmutex); // Throws
+            info->async_flusher_present = 0;
+        }
+        catch (...) {
+        }
+    }
+}
+
+
+void SharedGroup::ensure_async_flusher()
+{
+    if (m_async_flusher) {
+        if (!m_async_flusher->has_failed())
+            return;
+        std::unique_ptr<AsyncFlusher> flusher = std::move(m_async_flusher);
+        flusher->rethrow_error(); // Throws
+    }
+
+    SharedInfo* info = m_file_map.get_addr();
+    {
+        std::lock_guard<InterprocessMutex> lock(m_controlmutex); // Throws
+        if (info->async_flusher_present)
+            return;
+        info->async_flusher_present = 1;
+    }
+    try {
+        SharedGroupOptions options(Durability::Async, m_key);
+        options.temp_dir = m_temp_dir;
+        options.async_commit_latency = m_async_commit_latency;
+        m_async_flusher.reset(new AsyncFlusher(m_db_path, options)); // Throws
+    }
+    catch (...) {
+        std::lock_guard<InterprocessMutex> lock(m_controlmutex);
+        info->async_flusher_present = 0;
+        throw;
     }
 }
-#endif // REALM_ASYNC_DAEMON
 
 
 void SharedGroup::upgrade_file_format(bool allow_file_format_upgrade,
@@ -1761,7 +1715,8 @@ void SharedGroup::upgrade_file_format(bool allow_file_format_upgrade,
         }
 
         // History schema upgrade
-        int current_hist_schema_version_2 = gf::get_history_schema_version(m_group);
+        int current_hist_schema_version_2 =
+            get_stored_hist_schema_version(m_group.m_alloc, m_group.m_top.get_ref(), target_hist_schema_version);
         // The history must either still be using its initial schema or have
         // been upgraded already to the chosen target schema version via a
         // concurrent SharedGroup object.
@@ -1982,10 +1937,19 @@ SharedGroup::version_type SharedGroup::commit()
     // Free memory that was allocated during the write transaction.
     using gf = _impl::GroupFriend;
     gf::reset_free_space_tracking(m_group); // Throws
+    if (m_truncated_file_size) {
+        m_group.m_alloc.shrink_reader_view(m_truncated_file_size);
+        m_truncated_file_size = 0;
+    }
 
     do_end_read();
     m_read_lock = lock_after_commit;
     set_transact_stage(transact_Ready);
+
+    if (is_group_commit())
+        make_durable(new_version); // Throws
+    if (m_async_commits)
+        ensure_async_flusher(); // Throws
     return new_version;
 }
 
@@ -2151,24 +2115,6 @@ void SharedGroup::finish_begin_write()
         m_writemutex.unlock();
         throw std::runtime_error("Crash of other process detected, session restart required");
     }
-
-#ifdef REALM_ASYNC_DAEMON
-    if (info->durability == static_cast<uint16_t>(Durability::Async)) {
-
-        m_balancemutex.lock(); // Throws
-
-        // if we are running low on write slots, kick the sync daemon
-        if (info->free_write_slots < relaxed_sync_threshold)
-            m_work_to_do.notify();
-        // if we are out of write slots, wait for the sync daemon to catch up
-        while (info->free_write_slots <= 0) {
-            m_room_to_write.wait(m_balancemutex, 0);
-        }
-
-        info->free_write_slots--;
-        m_balancemutex.unlock();
-    }
-#endif // REALM_ASYNC_DAEMON
 }
 
 
@@ -2233,6 +2179,10 @@ SharedGroup::version_type SharedGroup::commit_and_continue_as_read()
     // Free memory that was allocated during the write transaction.
     using gf = _impl::GroupFriend;
     gf::reset_free_space_tracking(m_group); // Throws
+    if (m_truncated_file_size) {
+        m_group.m_alloc.shrink_reader_view(m_truncated_file_size);
+        m_truncated_file_size = 0;
+    }
 
     // Remap file if it has grown, and update refs in underlying node structure
     gf::remap_and_update_refs(m_group, m_read_lock.m_top_ref, m_read_lock.m_file_size); // Throws
@@ -2245,6 +2195,10 @@ SharedGroup::version_type SharedGroup::commit_and_continue_as_read()
 
     set_transact_stage(transact_Reading);
 
+    if (is_group_commit())
+        make_durable(version); // Throws
+    if (m_async_commits)
+        ensure_async_flusher(); // Throws
     return version;
 }
 
@@ -2337,6 +2291,8 @@ void SharedGroup::low_level_commit(uint_fast64_t new_version)
     // info->readers.dump();
     GroupWriter out(m_group, Durability(info->durability)); // Throws
     out.set_versions(new_version, oldest_version);
+    if (m_compaction_budget)
+        out.enable_incremental_compaction(m_compaction_budget, m_compaction_cursor);
     // Recursively write all changed arrays to end of file
     ref_type new_top_ref = out.write_group(); // Throws
     m_free_space = out.get_free_space_size();
@@ -2347,7 +2303,24 @@ void SharedGroup::low_level_commit(uint_fast64_t new_version)
     switch (Durability(info->durability)) {
         case Durability::Full:
         case Durability::Unsafe:
+            if (info->group_commit) {
+                // The new snapshot is made durable by make_durable()
+                // after the write mutex has been released. If other writers
+                // are already queued, the flush may wait for them to join.
+                uint32_t num_tickets = info->next_ticket.load(std::memory_order_relaxed) - info->next_served;
+                m_group_commit_linger = num_tickets > 1;
+                break;
+            }
             out.commit(new_top_ref); // Throws
+            if (m_compaction_budget) {
+                // Other session participants may have mapped the end of the
+                // file, so it is only truncated when there are none. Holding
+                // the control mutex keeps new participants from joining, and
+                // hence from mapping the file, meanwhile.
+                std::lock_guard<InterprocessMutex> lock(m_controlmutex); // Throws
+                if (info->num_participants == 1)
+                    m_truncated_file_size = out.shrink_file(); // Throws
+            }
             break;
         case Durability::MemOnly:
         case Durability::Async:
@@ -2395,6 +2368,56 @@ void SharedGroup::low_level_commit(uint_fast64_t new_version)
     }
 }
 
+
+bool SharedGroup::is_group_commit() const noexcept
+{
+    SharedInfo* info = m_file_map.get_addr();
+    return info->group_commit != 0;
+}
+
+
+SharedGroup::version_type SharedGroup::get_version_of_durable_snapshot()
+{
+    SharedInfo* info = m_file_map.get_addr();
+    if (!info->group_commit && Durability(info->durability) != Durability::Async)
+        return get_version_of_latest_snapshot(); // Throws
+    std::lock_guard<InterprocessMutex> lock(m_flushmutex); // Throws
+    return info->durable_version;
+}
+
+
+void SharedGroup::make_durable(version_type version)
+{
+    SharedInfo* info = m_file_map.get_addr();
+    std::lock_guard<InterprocessMutex> lock(m_flushmutex); // Throws
+
+    // A flush performed while we were waiting for the lock may already have
+    // covered our snapshot.
+    if (info->durable_version >= version)
+        return;
+
+    if (m_group_commit_linger && m_group_commit_window.count() > 0)
+        std::this_thread::sleep_for(m_group_commit_window);
+
+    // Everything committed so far is covered by syncing the file, so make the
+    // latest snapshot durable rather than just our own.
+    ReadLockInfo durable_lock;
+    grab_read_lock(durable_lock, VersionID()); // Throws
+    ReadLockUnlockGuard g(*this, durable_lock);
+    REALM_ASSERT_3(durable_lock.m_version, >=, version);
+    Durability dura = Durability(info->durability);
+    GroupWriter::sync_and_commit(m_group, durable_lock.m_top_ref, dura); // Throws
+    g.release();
+
+    // The previously durable snapshot is no longer needed for recovery
+    ReadLockInfo prev_durable_lock;
+    prev_durable_lock.m_reader_idx = info->durable_reader_idx;
+    release_read_lock(prev_durable_lock);
+    info->durable_version = durable_lock.m_version;
+    info->durable_reader_idx = durable_lock.m_reader_idx;
+}
+
+
 #ifdef REALM_DEBUG
 void SharedGroup::reserve(size_t size)
 {
@@ -19,8 +19,12 @@
 #ifndef REALM_GROUP_SHARED_HPP
 #define REALM_GROUP_SHARED_HPP
 
+#include <condition_variable>
+#include <exception>
 #include <functional>
 #include <limits>
+#include <mutex>
+#include <vector>
 #include <realm/util/features.h>
 #include <realm/util/thread.hpp>
 #include <realm/util/interprocess_condvar.hpp>
@@ -28,6 +32,7 @@
 #include <realm/group.hpp>
 #include <realm/group_shared_options.hpp>
 #include <realm/handover_defs.hpp>
+#include <realm/impl/instruction_buffer.hpp>
 #include <realm/impl/transact_log.hpp>
 #include <realm/metrics/metrics.hpp>
 #include <realm/replication.hpp>
@@ -394,6 +399,15 @@ public:
     /// a read transaction will not immediately release any versions.
     uint_fast64_t get_number_of_versions();
 
+    /// Get the version of the latest snapshot that is known to be on stable
+    /// storage, that is, the latest snapshot that would be found if the
+    /// Realm was reopened after a crash. With group commit and in
+    /// Durability::Async mode, snapshots become durable some time after they
+    /// were committed, and all snapshots up to and including the returned
+    /// version are durable. In other modes this is the version of the latest
+    /// snapshot.
+    version_type get_version_of_durable_snapshot();
+
     /// Get the approximate size of the data that would be written to the file if
     /// a commit were done at this point. The reported size will always be bigger
     /// than what will eventually be needed as we reserve a bit more memory that
@@ -593,21 +607,31 @@ private:
     const char* m_key;
     TransactStage m_transact_stage;
     util::InterprocessMutex m_writemutex;
-#ifdef REALM_ASYNC_DAEMON
-    util::InterprocessMutex m_balancemutex;
-#endif
     util::InterprocessMutex m_controlmutex;
-#ifdef REALM_ASYNC_DAEMON
-    util::InterprocessCondVar m_room_to_write;
-    util::InterprocessCondVar m_work_to_do;
-    util::InterprocessCondVar m_daemon_becomes_ready;
-#endif
+    util::InterprocessMutex m_flushmutex;
     util::InterprocessCondVar m_new_commit_available;
     util::InterprocessCondVar m_pick_next_writer;
     std::function<void(int, int)> m_upgrade_callback;
+    std::chrono::microseconds m_group_commit_window{0};
+    bool m_group_commit_linger = false;
+    class AsyncFlusher;
+    std::unique_ptr<AsyncFlusher> m_async_flusher;
+    std::chrono::milliseconds m_async_commit_latency{0};
+    std::string m_temp_dir;
+    bool m_async_commits = false;
+    size_t m_compaction_budget = 0;
+    // Where the next commit resumes the search for data to move during
+    // incremental compaction (see GroupWriter::enable_incremental_compaction())
+    std::vector<size_t> m_compaction_cursor;
+    // The size that a commit has truncated the file to, if any. The reader
+    // view is shrunk accordingly when the write transaction has ended.
+    size_t m_truncated_file_size = 0;
 
 #if REALM_METRICS
     std::shared_ptr<metrics::Metrics> m_metrics;
+    // Translation cache counters of the allocator when the current transaction began
+    uint_fast64_t m_translation_cache_hits = 0;
+    uint_fast64_t m_translation_cache_misses = 0;
 #endif // REALM_METRICS
 
     void do_open(const std::string& file, bool no_create, bool is_backend, const SharedGroupOptions options);
@@ -668,7 +692,17 @@ private:
     // mutex.
     void low_level_commit(uint_fast64_t new_version);
 
-    void do_async_commits();
+    bool is_group_commit() const noexcept;
+
+    /// Make the snapshot of the specified version, and all snapshots committed
+    /// before it, durable, unless a concurrent flush already did. Must not be
+    /// called by someone that has a lock on the write mutex.
+    void make_durable(version_type);
+
+    /// In Durability::Async mode, start a flusher thread owned by this
+    /// SharedGroup, unless a session participant already runs one. Rethrows
+    /// the error which made a previously started flusher thread fail.
+    void ensure_async_flusher();
 
     /// Upgrade file format and/or history schema
     void upgrade_file_format(bool allow_file_format_upgrade, int target_file_format_version,
@@ -823,6 +857,35 @@ private:
 struct SharedGroup::BadVersion : std::exception {
 };
 
+/// In Durability::Async mode, commits are made durable in batches by a
+/// background thread which is run by one of the session participants. The
+/// thread uses a SharedGroup of its own, and waits for new commits. Once one
+/// arrives, it waits for the configured latency bound
+/// (SharedGroupOptions::async_commit_latency) to let more commits arrive, and
+/// then makes the latest snapshot durable.
+///
+/// The thread is stopped when the owning SharedGroup is closed. Other
+/// participants then start a new one when they commit.
+class SharedGroup::AsyncFlusher {
+public:
+    AsyncFlusher(const std::string& path, const SharedGroupOptions&);
+    ~AsyncFlusher() noexcept;
+
+    bool has_failed() noexcept;
+    void rethrow_error();
+
+private:
+    SharedGroup m_shared_group;
+    std::chrono::milliseconds m_latency;
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    bool m_stop = false;
+    std::exception_ptr m_error;
+    util::Thread m_thread;
+
+    void run();
+};
+
 inline SharedGroup::SharedGroup(const std::string& file, bool no_create, const SharedGroupOptions options)
     : m_group(Group::shared_tag())
     , m_upgrade_callback(std::move(options.upgrade_callback))
@@ -1092,15 +1155,19 @@ inline bool SharedGroup::do_advance_read(O* observer, VersionID version_id, _imp
         hist.update_from_ref_and_version(hist_ref, new_version); // Throws
     }
 
+    // When there is an observer, the changesets are parsed only once. What is
+    // needed for updating the accessors is recorded along the way, unless
+    // there is too much of it.
+    _impl::InstructionBuffer instructions;
+    bool recorded = false;
     if (observer) {
         // This has to happen in the context of the originally bound snapshot
         // and while the read transaction is still in a fully functional state.
-        _impl::TransactLogParser parser;
         version_type old_version = m_read_lock.m_version;
         version_type new_version = new_read_lock.m_version;
         _impl::ChangesetInputStream in(hist, old_version, new_version);
-        parser.parse(in, *observer); // Throws
-        observer->parse_complete();  // Throws
+        recorded = instructions.record(in, *observer); // Throws
+        observer->parse_complete();                    // Throws
     }
 
     // The old read lock must be retained for as long as the change history is
@@ -1118,8 +1185,13 @@ inline bool SharedGroup::do_advance_read(O* observer, VersionID version_id, _imp
         version_type new_version = new_read_lock.m_version;
         ref_type new_top_ref = new_read_lock.m_top_ref;
         size_t new_file_size = new_read_lock.m_file_size;
-        _impl::ChangesetInputStream in(hist, old_version, new_version);
-        m_group.advance_transact(new_top_ref, new_file_size, in); // Throws
+        if (recorded) {
+            m_group.advance_transact(new_top_ref, new_file_size, instructions); // Throws
+        }
+        else {
+            _impl::ChangesetInputStream in(hist, old_version, new_version);
+            m_group.advance_transact(new_top_ref, new_file_size, in); // Throws
+        }
     }
 
     g.release();
@@ -1176,17 +1248,6 @@ public:
         sg.rollback_and_continue_as_read(obs); // Throws
     }
 
-    static void async_daemon_open(SharedGroup& sg, const std::string& file)
-    {
-        bool no_create = true;
-        bool is_backend = true;
-        SharedGroupOptions options;
-        options.durability = SharedGroupOptions::Durability::Async;
-        options.encryption_key = nullptr;
-        options.allow_file_format_upgrade = false;
-        sg.do_open(file, no_create, is_backend, options); // Throws
-    }
-
     static int get_file_format_version(const SharedGroup& sg) noexcept
     {
         return sg.get_file_format_version();
@@ -19,6 +19,7 @@
 #ifndef REALM_GROUP_SHARED_OPTIONS_HPP
 #define REALM_GROUP_SHARED_OPTIONS_HPP
 
+#include <chrono>
 #include <functional>
 #include <string>
 
@@ -31,7 +32,7 @@ struct SharedGroupOptions {
     enum class Durability : uint16_t {
         Full,
         MemOnly,
-        Async, ///< Not yet supported on windows.
+        Async,
         Unsafe  // If you use this, you loose ACID property
     };
 
@@ -102,6 +103,49 @@ struct SharedGroupOptions {
     /// is exceeded without being consumed, only the most recent entries will be stored.
     size_t metrics_buffer_size;
 
+    /// The number of entries in the cache of ref to address translations of
+    /// this SharedGroup, or zero to use the default size. Queries over large
+    /// Realm files may benefit from a larger cache. With metrics enabled, the
+    /// hits and misses of each transaction are reported.
+    size_t translation_cache_size = 0;
+
+    /// If true, and \a durability is Durability::Full, concurrent write
+    /// transactions share the synchronization of the Realm file to stable
+    /// storage (group commit). A writer publishes its snapshot and releases the
+    /// write mutex before the snapshot is made durable, and commit() then waits
+    /// for a single flush which covers every snapshot committed so far. commit()
+    /// still does not return until the new snapshot is durable, but other
+    /// session participants may observe it slightly earlier. Group commit is
+    /// not used for encrypted Realms. The setting must be the same for all
+    /// participants in a session.
+    bool enable_group_commit = false;
+
+    /// With group commit, how long the writer which performs a flush waits
+    /// before starting it, when other writers were queued for the write mutex
+    /// at the time it committed. This allows their snapshots to be covered by
+    /// the same flush. When zero, only commits which complete while an earlier
+    /// flush is in progress are grouped.
+    std::chrono::microseconds group_commit_window{0};
+
+    /// In Durability::Async mode, commits return without waiting for the file
+    /// to be synchronized. A background thread, of which there is one per
+    /// session, makes them durable in batches, and this is the longest time it
+    /// waits for more commits to arrive before starting a flush. See
+    /// SharedGroup::get_version_of_durable_snapshot(). If a flush fails, the
+    /// next commit() throws, although its snapshot has been committed.
+    std::chrono::milliseconds async_commit_latency{10};
+
+    /// If non-zero, write transactions compact the Realm file incrementally.
+    /// When much of the file is free space, each commit moves up to this many
+    /// bytes of unmodified data from the end of the file into free space closer
+    /// to its beginning, and once the end of the file is free, the file is
+    /// shrunk. Unlike SharedGroup::compact(), this requires no exclusive access.
+    /// The file is only truncated by commits with Durability::Full (or Unsafe)
+    /// without group commit, while no other SharedGroup has it open, and never
+    /// for encrypted Realms; otherwise the free space at the end is just no
+    /// longer counted as part of the file.
+    size_t compaction_budget = 0;
+
     /// sys_tmp_dir will be used if the temp_dir is empty when creating SharedGroupOptions.
     /// It must be writable and allowed to create pipe/fifo file on it.
     /// set_sys_tmp_dir is not a thread-safe call and it is only supposed to be called once
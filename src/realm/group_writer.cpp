@@ -17,6 +17,7 @@
  **************************************************************************/
 
 #include <algorithm>
+#include <limits>
 
 #ifdef REALM_DEBUG
 #include <iostream>
@@ -29,6 +30,7 @@
 #include <realm/alloc_slab.hpp>
 #include <realm/disable_sync_to_disk.hpp>
 #include <realm/metrics/metric_timer.hpp>
+#include <realm/utilities.hpp>
 
 using namespace realm;
 using namespace realm::util;
@@ -311,11 +313,14 @@ ref_type GroupWriter::write_group()
 #endif
 
     read_in_freelist();
-    // Now, 'm_size_map' holds all free elements candidate for recycling
+    // Now, 'm_free_space' holds all free elements candidate for recycling
+
+    if (m_compaction_limit)
+        move_arrays_from_tail(); // Throws
 
     Array& top = m_group.m_top;
 #if REALM_ALLOC_DEBUG
-    std::cout << "    In-file freelist after merge:  " << m_size_map.size() << std::endl;
+    std::cout << "    In-file freelist after merge:  " << m_free_space.size() << std::endl;
     std::cout << "    Allocating file space for data:" << std::endl;
 #endif
 
@@ -350,7 +355,7 @@ ref_type GroupWriter::write_group()
     }
 
 #if REALM_ALLOC_DEBUG
-    std::cout << "    Freelist size after allocations: " << m_size_map.size() << std::endl;
+    std::cout << "    Freelist size after allocations: " << m_free_space.size() << std::endl;
 #endif
 
     // We now have a bit of a chicken-and-egg problem. We need to write the
@@ -359,7 +364,7 @@ ref_type GroupWriter::write_group()
     // calculate an upper bound on the amount af space required for all of the
     // remaining arrays and allocate the space as one big chunk. This way we can
     // finalize the free-lists before writing them to the file.
-    size_t max_free_list_size = m_size_map.size();
+    size_t max_free_list_size = m_free_space.size() + m_tail_free_space.size();
 
     // We need to add to the free-list any space that was freed during the
     // current transaction, but to avoid clobering the previous version, we
@@ -408,9 +413,10 @@ ref_type GroupWriter::write_group()
     // maximum number that is required. This ensures that even if we end up
     // using the maximum size possible, we still do not end up with a zero size
     // free-space chunk as we deduct the actually used size from it.
-    auto reserve = reserve_free_space(max_free_space_needed + 8); // Throws
-    size_t reserve_pos = reserve->second;
-    size_t reserve_size = reserve->first;
+    Chunk reserve = reserve_free_space(max_free_space_needed + 8); // Throws
+    size_t reserve_pos = reserve.ref;
+    size_t reserve_size = reserve.size;
+    m_free_space.add(reserve_pos, reserve_size); // Throws
 
     // At this point we have allocated all the space we need, so we can add to
     // the free-lists any free space created during the current transaction (or
@@ -559,24 +565,265 @@ void GroupWriter::read_in_freelist()
     }
 
     free_in_file.merge_adjacent_entries_in_freelist();
-    // Previous step produces - potentially - some entries with size of zero. These
-    // entries will be skipped in the next step.
-    free_in_file.move_free_in_file_to_size_map(m_size_map);
+    if (m_compaction_budget)
+        prepare_compaction(free_in_file); // Throws
+
+    // Previous steps produce - potentially - some entries with size of zero. These
+    // entries are skipped.
+    for (auto& elem : free_in_file) {
+        if (elem.size) {
+            REALM_ASSERT_RELEASE_EX(!(elem.size & 7), elem.size);
+            REALM_ASSERT_RELEASE_EX(!(elem.ref & 7), elem.ref);
+            size_t end = elem.ref + elem.size;
+            if (m_compaction_limit && end > m_compaction_limit) {
+                // Keep the end of the file free while compacting
+                size_t tail_start = std::max(elem.ref, m_compaction_limit);
+                if (tail_start > elem.ref)
+                    m_free_space.add(elem.ref, tail_start - elem.ref); // Throws
+                m_tail_free_space.push_back({tail_start, end - tail_start}); // Throws
+                continue;
+            }
+            m_free_space.add(elem.ref, elem.size); // Throws
+        }
+    }
+}
+
+void GroupWriter::prepare_compaction(FreeList& free_in_file)
+{
+    SlabAlloc& alloc = m_group.m_alloc;
+    size_t logical_file_size = to_size_t(m_group.m_top.get(2) / 2);
+
+    // If the end of the file is free, shrink the file. The physical file is
+    // truncated by shrink_file(), and its size must be a section boundary.
+    auto last = std::find_if(free_in_file.rbegin(), free_in_file.rend(), [](auto& e) { return e.size != 0; });
+    if (last != free_in_file.rend() && last->ref + last->size == logical_file_size) {
+        size_t new_file_size = last->ref;
+        if (!alloc.matches_section_boundary(new_file_size))
+            new_file_size = alloc.get_upper_section_boundary(new_file_size);
+        if (new_file_size < logical_file_size) {
+            last->size = new_file_size - last->ref;
+            logical_file_size = new_file_size;
+            m_group.m_top.set(2, 1 + 2 * uint64_t(new_file_size)); // Throws
+        }
+    }
+
+    // Move data out of the end of the file if that would allow the file to
+    // shrink considerably. Some free space is left below the limit, so that
+    // the data does not have to be packed tightly.
+    size_t free_space_size = 0;
+    for (const auto& elem : free_in_file)
+        free_space_size += elem.size;
+    for (const auto& elem : m_not_free_in_file)
+        free_space_size += elem.size;
+    size_t used_space_size = logical_file_size - free_space_size;
+    size_t limit = alloc.get_upper_section_boundary(used_space_size + used_space_size / 4);
+    if (limit < logical_file_size)
+        m_compaction_limit = limit;
+}
+
+bool GroupWriter::compaction_budget_used() const noexcept
+{
+    // The search for arrays to move is bounded as well, as most of the file
+    // may have to be searched to find the last few.
+    return m_compaction_moved >= m_compaction_budget || m_compaction_visited >= 16 * m_compaction_budget;
+}
+
+bool GroupWriter::is_movable(ref_type ref, size_t size) const noexcept
+{
+    return ref >= m_compaction_limit && m_alloc.is_read_only(ref) && size <= m_max_move_size;
+}
+
+void GroupWriter::move_arrays_from_tail()
+{
+    // The top array and the free-lists are rewritten by every commit anyway.
+    // Everything else is moved through the accessors that own it, which are
+    // brought up to date afterwards: the table names and the tables through
+    // the group, each table through its table accessor, and the history
+    // through the history accessor of the replication.
+    static const size_t slots[] = {0, 1, 8};
+    m_max_move_size = get_max_move_size();
+    if (m_max_move_size == 0)
+        return;
+    Replication* repl = m_group.get_replication();
+    _impl::History* hist = repl ? repl->get_history() : nullptr; // Throws
+    std::vector<size_t>& cursor = *m_compaction_cursor;
+    Array& top = m_group.m_top;
+    size_t begin = cursor.empty() ? 0 : cursor[0];
+    for (size_t i = begin; i < sizeof slots / sizeof slots[0]; ++i) {
+        size_t slot = slots[i];
+        if (slot >= top.size())
+            break;
+        ref_type ref = top.get_as_ref(slot);
+        if (ref == 0)
+            continue;
+        bool resume = (i == begin);
+        bool stopped = false;
+        if (slot == 0) {
+            stopped = move_array_from_tail(m_group.m_table_names, 1, resume); // Throws
+        }
+        else if (slot == 1) {
+            stopped = move_tables_from_tail(resume); // Throws
+            Array& tables = m_group.m_tables;
+            if (is_movable(tables.get_ref(), tables.get_byte_size())) {
+                m_compaction_moved += tables.get_byte_size();
+                tables.copy_on_write(); // Throws
+            }
+        }
+        else if (hist) {
+            // A history without an accessor is left where it is
+            Array history(m_alloc);
+            history.init_from_ref(ref);
+            history.set_parent(&top, slot);
+            size_t moved = m_compaction_moved;
+            stopped = move_array_from_tail(history, 1, resume); // Throws
+            if (m_compaction_moved != moved)
+                hist->update_from_parent(m_current_version); // Throws
+        }
+        if (stopped) {
+            cursor[0] = i;
+            return;
+        }
+        if (compaction_budget_used()) {
+            cursor.resize(1);
+            cursor[0] = i + 1;
+            return;
+        }
+    }
+    // Everything was searched, so start from the beginning in the next commit
+    cursor.clear();
+}
+
+bool GroupWriter::move_tables_from_tail(bool resume)
+{
+    using tf = _impl::TableFriend;
+    std::vector<size_t>& cursor = *m_compaction_cursor;
+    size_t begin = (resume && cursor.size() > 1) ? cursor[1] : 0;
+    size_t n = m_group.size();
+    for (size_t i = begin; i < n; ++i) {
+        // The top array of the table is moved through the table accessor. The
+        // arrays below it are moved without accessors, so the accessors of the
+        // table are updated from its top array afterwards.
+        Table* table = m_group.do_get_table(i, nullptr); // Throws
+        size_t moved = m_compaction_moved;
+        bool stopped = move_array_from_tail(tf::get_top_array(*table), 2, resume && i == begin); // Throws
+        if (m_compaction_moved != moved)
+            tf::update_from_parent(*table, m_alloc.get_baseline());
+        if (stopped) {
+            cursor[1] = i;
+            return true;
+        }
+        if (compaction_budget_used()) {
+            cursor.resize(2);
+            cursor[1] = i + 1;
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t GroupWriter::get_max_move_size() const
+{
+    // Moving an array only to have it written near the end of the file again
+    // would be wasted effort, so arrays are only moved if they fit in one
+    // section of a free chunk below the compaction limit. The free space does
+    // not change while arrays are moved, so the largest such array is found
+    // once. Size classes are visited from the largest one down, until no chunk
+    // can hold a larger array than one already found.
+    SlabAlloc& alloc = m_group.m_alloc;
+    size_t max_size = 0;
+    for (size_t c = m_free_space.find_class_below(realm::npos); c != realm::npos;
+         c = m_free_space.find_class_below(c)) {
+        if (max_size != 0 && c < FreeSpaceMap::class_of(max_size))
+            break;
+        for (const auto& chunk : m_free_space.get_class(c)) {
+            size_t end = chunk.ref + chunk.size;
+            for (size_t pos = chunk.ref; pos < end;) {
+                size_t section_end = std::min(alloc.get_upper_section_boundary(pos), end);
+                max_size = std::max(max_size, section_end - pos);
+                pos = section_end;
+            }
+        }
+    }
+    return max_size;
+}
+
+bool GroupWriter::move_array_from_tail(Array& array, size_t depth, bool resume)
+{
+    bool stopped = false;
+    if (array.has_refs()) {
+        m_compaction_visited += array.get_byte_size();
+        stopped = move_children_from_tail(array, depth, resume); // Throws
+    }
+    // If any child was moved, the array has already been copied
+    if (is_movable(array.get_ref(), array.get_byte_size())) {
+        m_compaction_moved += array.get_byte_size();
+        array.copy_on_write(); // Throws
+    }
+    return stopped;
+}
+
+bool GroupWriter::move_children_from_tail(Array& parent, size_t depth, bool resume)
+{
+    std::vector<size_t>& cursor = *m_compaction_cursor;
+    size_t begin = (resume && depth < cursor.size()) ? cursor[depth] : 0;
+    size_t n = parent.size();
+    for (size_t i = begin; i < n; ++i) {
+        int_fast64_t value = parent.get(i);
+        // Skip null refs and tagged integers
+        if (value == 0 || (value & 1) != 0)
+            continue;
+        ref_type ref = to_ref(value);
+        ref_type new_ref = ref;
+        bool stopped = false;
+        char* header = m_alloc.translate(ref);
+        if (Array::get_hasrefs_from_header(header)) {
+            Array child(m_alloc);
+            child.init_from_mem(MemRef(header, ref, m_alloc));
+            stopped = move_array_from_tail(child, depth + 1, resume && i == begin); // Throws
+            new_ref = child.get_ref();
+        }
+        else if (is_movable(ref, Array::get_byte_size_from_header(header))) {
+            // Leaves are copied without an accessor, as their width type
+            // depends on their kind.
+            size_t size = Array::get_byte_size_from_header(header);
+            MemRef mem = m_alloc.alloc(size); // Throws
+            realm::safe_copy_n(header, size, mem.get_addr());
+            Array::set_header_capacity(size, mem.get_addr());
+            m_alloc.free_(ref, header);
+            m_compaction_moved += size;
+            new_ref = mem.get_ref();
+        }
+        if (new_ref != ref)
+            parent.set_as_ref(i, new_ref); // Throws
+        // Record where to resume. If the search stopped inside the child, the
+        // deeper levels have already been recorded.
+        if (stopped) {
+            cursor[depth] = i;
+            return true;
+        }
+        if (compaction_budget_used()) {
+            cursor.resize(depth + 1);
+            cursor[depth] = i + 1;
+            return true;
+        }
+    }
+    return false;
 }
 
 size_t GroupWriter::recreate_freelist(size_t reserve_pos)
 {
     std::vector<FreeSpaceEntry> free_in_file;
     auto& new_free_space = m_group.m_alloc.get_free_read_only(); // Throws
-    auto nb_elements = m_size_map.size() + m_not_free_in_file.size() + new_free_space.size();
+    auto nb_elements =
+        m_free_space.size() + m_tail_free_space.size() + m_not_free_in_file.size() + new_free_space.size();
     free_in_file.reserve(nb_elements);
 
     size_t reserve_ndx = realm::npos;
     bool is_shared = m_group.m_is_shared;
 
-    for (const auto& entry : m_size_map) {
-        free_in_file.emplace_back(entry.second, entry.first, 0);
-    }
+    m_free_space.for_each([&](const Chunk& chunk) { free_in_file.emplace_back(chunk.ref, chunk.size, 0); });
+    for (const auto& chunk : m_tail_free_space)
+        free_in_file.emplace_back(chunk.ref, chunk.size, 0);
 
     {
         size_t locked_space_size = 0;
@@ -648,119 +895,217 @@ void GroupWriter::FreeList::merge_adjacent_entries_in_freelist()
     }
 }
 
-void GroupWriter::FreeList::move_free_in_file_to_size_map(std::multimap<size_t, size_t>& size_map)
+constexpr size_t GroupWriter::FreeSpaceMap::exact_class_limit;
+constexpr size_t GroupWriter::FreeSpaceMap::num_classes;
+constexpr size_t GroupWriter::FreeSpaceMap::bits_per_word;
+
+size_t GroupWriter::FreeSpaceMap::class_of(size_t size) noexcept
+{
+    REALM_ASSERT_DEBUG(size > 0 && !(size & 7));
+    if (size <= exact_class_limit)
+        return size / 8;
+    // Above the limit, each power of two is divided into four classes
+    // according to the two bits following the most significant one.
+    int msb = log2(size);
+    size_t sub_class = (size >> (msb - 2)) & 3;
+    return exact_class_limit / 8 + 1 + 4 * size_t(msb - log2(exact_class_limit)) + sub_class;
+}
+
+size_t GroupWriter::FreeSpaceMap::find_class(size_t size_class) const noexcept
 {
-    for (auto& elem : *this) {
-        // Skip elements merged in 'merge_adjacent_entries_in_freelist'
-        if (elem.size) {
-            REALM_ASSERT_RELEASE_EX(!(elem.size & 7), elem.size);
-            REALM_ASSERT_RELEASE_EX(!(elem.ref & 7), elem.ref);
-            size_map.emplace(elem.size, elem.ref);
-        }
+    size_t word_ndx = size_class / bits_per_word;
+    size_t num_words = sizeof m_non_empty / sizeof m_non_empty[0];
+    if (word_ndx >= num_words)
+        return realm::npos;
+    uint64_t word = m_non_empty[word_ndx] & (~uint64_t(0) << (size_class % bits_per_word));
+    while (word == 0) {
+        if (++word_ndx == num_words)
+            return realm::npos;
+        word = m_non_empty[word_ndx];
     }
+    return word_ndx * bits_per_word + size_t(log2(size_t(word & (0 - word))));
+}
+
+size_t GroupWriter::FreeSpaceMap::find_class_below(size_t size_class) const noexcept
+{
+    size_t num_words = sizeof m_non_empty / sizeof m_non_empty[0];
+    size_t word_ndx = num_words - 1;
+    uint64_t word = m_non_empty[word_ndx];
+    if (size_class / bits_per_word < num_words) {
+        word_ndx = size_class / bits_per_word;
+        word = m_non_empty[word_ndx] & ((uint64_t(1) << (size_class % bits_per_word)) - 1);
+    }
+    while (word == 0) {
+        if (word_ndx == 0)
+            return realm::npos;
+        word = m_non_empty[--word_ndx];
+    }
+    return word_ndx * bits_per_word + size_t(log2(size_t(word)));
+}
+
+size_t GroupWriter::FreeSpaceMap::add(size_t ref, size_t size)
+{
+    size_t size_class = class_of(size);
+    REALM_ASSERT_3(size_class, <, num_classes);
+    m_classes[size_class].push_back({ref, size}); // Throws
+    m_non_empty[size_class / bits_per_word] |= uint64_t(1) << (size_class % bits_per_word);
+    ++m_size;
+    return size_class;
+}
+
+void GroupWriter::FreeSpaceMap::remove(size_t size_class, size_t ndx) noexcept
+{
+    auto& chunks = m_classes[size_class];
+    REALM_ASSERT_3(ndx, <, chunks.size());
+    chunks[ndx] = chunks.back();
+    chunks.pop_back();
+    if (chunks.empty())
+        m_non_empty[size_class / bits_per_word] &= ~(uint64_t(1) << (size_class % bits_per_word));
+    --m_size;
 }
 
 size_t GroupWriter::get_free_space(size_t size)
 {
     REALM_ASSERT_3(size % 8, ==, 0); // 8-byte alignment
 
-    auto p = reserve_free_space(size);
+    Chunk chunk = reserve_free_space(size);
 
     // Claim space from identified chunk
-    size_t chunk_pos = p->second;
-    size_t chunk_size = p->first;
-    REALM_ASSERT_3(chunk_size, >=, size);
-    REALM_ASSERT_RELEASE_EX(!(chunk_pos & 7), chunk_pos);
-    REALM_ASSERT_RELEASE_EX(!(chunk_size & 7), chunk_size);
+    REALM_ASSERT_3(chunk.size, >=, size);
+    REALM_ASSERT_RELEASE_EX(!(chunk.ref & 7), chunk.ref);
+    REALM_ASSERT_RELEASE_EX(!(chunk.size & 7), chunk.size);
 
-    size_t rest = chunk_size - size;
-    m_size_map.erase(p);
+    size_t rest = chunk.size - size;
     if (rest > 0) {
         // Allocating part of chunk - this alway happens from the beginning
         // of the chunk. The call to reserve_free_space may split chunks
         // in order to make sure that it returns a chunk from which allocation
         // can be done from the beginning
-        m_size_map.emplace(rest, chunk_pos + size);
+        m_free_space.add(chunk.ref + size, rest); // Throws
     }
-    return chunk_pos;
+    return chunk.ref;
 }
 
 
-inline GroupWriter::FreeListElement GroupWriter::split_freelist_chunk(FreeListElement it, size_t alloc_pos)
-{
-    size_t start_pos = it->second;
-    size_t chunk_size = it->first;
-    m_size_map.erase(it);
-    REALM_ASSERT_RELEASE_EX(alloc_pos > start_pos, alloc_pos, start_pos);
-
-    REALM_ASSERT_RELEASE_EX(!(alloc_pos & 7), alloc_pos);
-    size_t size_first = alloc_pos - start_pos;
-    size_t size_second = chunk_size - size_first;
-    m_size_map.emplace(size_first, start_pos);
-    return m_size_map.emplace(size_second, alloc_pos);
-}
-
-GroupWriter::FreeListElement GroupWriter::search_free_space_in_free_list_element(FreeListElement it, size_t size)
+bool GroupWriter::claim_free_space(size_t size_class, size_t ndx, size_t size, Chunk& found)
 {
     SlabAlloc& alloc = m_group.m_alloc;
-    size_t chunk_size = it->first;
+    Chunk chunk = m_free_space.get_class(size_class)[ndx];
 
     // search through the chunk, finding a place within it,
     // where an allocation will not cross a mmap boundary
-    size_t start_pos = it->second;
-    size_t alloc_pos = alloc.find_section_in_range(start_pos, chunk_size, size);
-    if (alloc_pos == 0) {
-        return m_size_map.end();
-    }
+    size_t alloc_pos = alloc.find_section_in_range(chunk.ref, chunk.size, size);
+    if (alloc_pos == 0)
+        return false;
+
+    m_free_space.remove(size_class, ndx);
     // we found a place - if it's not at the beginning of the chunk,
     // we split the chunk so that the allocation can be done from the
     // beginning of the second chunk.
-    if (alloc_pos != start_pos) {
-        it = split_freelist_chunk(it, alloc_pos);
+    if (alloc_pos != chunk.ref) {
+        REALM_ASSERT_RELEASE_EX(alloc_pos > chunk.ref, alloc_pos, chunk.ref);
+        REALM_ASSERT_RELEASE_EX(!(alloc_pos & 7), alloc_pos);
+        m_free_space.add(chunk.ref, alloc_pos - chunk.ref); // Throws
     }
     // Match found!
-    return it;
+    found.ref = alloc_pos;
+    found.size = chunk.ref + chunk.size - alloc_pos;
+    return true;
 }
 
-GroupWriter::FreeListElement GroupWriter::search_free_space_in_part_of_freelist(size_t size)
+bool GroupWriter::search_free_space_in_class(size_t size_class, size_t size, size_t min_size, size_t max_size,
+                                             Chunk& found)
 {
-    auto it = m_size_map.lower_bound(size);
-    while (it != m_size_map.end()) {
-        // Accept either a perfect match or a block that is twice the size. Tests have shown
-        // that this is a good strategy.
-        if (it->first == size || it->first >= 2 * size) {
-            auto ret = search_free_space_in_free_list_element(it, size);
-            if (ret != m_size_map.end()) {
-                return ret;
-            }
-            ++it;
-        }
-        else {
-            // If block was too small, search for the first that is at least twice as big.
-            it = m_size_map.lower_bound(2 * size);
+    const auto& chunks = m_free_space.get_class(size_class);
+    // Search from the back, so that the most recently added chunks (often the
+    // remainders of previous allocations) are used first.
+    for (size_t i = chunks.size(); i > 0; --i) {
+        size_t chunk_size = chunks[i - 1].size;
+        if (chunk_size >= min_size && chunk_size <= max_size) {
+            if (claim_free_space(size_class, i - 1, size, found))
+                return true;
         }
     }
+    return false;
+}
+
+bool GroupWriter::search_free_space_from_class(size_t size_class, size_t size, Chunk& found)
+{
+    for (size_t c = m_free_space.find_class(size_class); c != realm::npos; c = m_free_space.find_class(c + 1)) {
+        if (search_free_space_in_class(c, size, size, std::numeric_limits<size_t>::max(), found))
+            return true;
+    }
+    return false;
+}
+
+bool GroupWriter::search_free_space(size_t size, Chunk& found)
+{
+    // Accept either a perfect match or a block that is at least twice the
+    // size. Tests have shown that this is a good strategy. Perfect matches
+    // are preferred when they have a size class of their own.
+    size_t size_class = FreeSpaceMap::class_of(size);
+    bool exact = FreeSpaceMap::is_exact_class(size_class);
+    if (exact && search_free_space_in_class(size_class, size, size, size, found))
+        return true;
+
+    // All chunks in a class at or above the class of twice the size are big
+    // enough.
+    if (search_free_space_from_class(FreeSpaceMap::class_of(2 * size), size, found))
+        return true;
+
+    if (!exact && search_free_space_in_class(size_class, size, size, size, found))
+        return true;
+
     // No match
-    return m_size_map.end();
+    return false;
 }
 
 
-GroupWriter::FreeListElement GroupWriter::reserve_free_space(size_t size)
+GroupWriter::Chunk GroupWriter::reserve_free_space(size_t size)
 {
-    auto chunk = search_free_space_in_part_of_freelist(size);
-    while (chunk == m_size_map.end()) {
-        // No free space, so we have to extend the file.
-        auto new_chunk = extend_free_space(size);
-        chunk = search_free_space_in_free_list_element(new_chunk, size);
+    Chunk chunk;
+    if (search_free_space(size, chunk))
+        return chunk;
+    if (!m_tail_free_space.empty()) {
+        // Rather than using the end of the file, which is being freed, accept
+        // any chunk before the compaction limit which is big enough.
+        if (search_free_space_from_class(FreeSpaceMap::class_of(size), size, chunk))
+            return chunk;
+        // Large allocations may not fit in the smaller sections at the
+        // beginning of the file. Use the free space closest to the compaction
+        // limit then, so that the end of the file can still become free.
+        SlabAlloc& alloc = m_group.m_alloc;
+        std::sort(m_tail_free_space.begin(), m_tail_free_space.end(),
+                  [](const Chunk& a, const Chunk& b) { return a.ref < b.ref; });
+        for (auto it = m_tail_free_space.begin(); it != m_tail_free_space.end(); ++it) {
+            size_t alloc_pos = alloc.find_section_in_range(it->ref, it->size, size);
+            if (alloc_pos == 0)
+                continue;
+            chunk.ref = alloc_pos;
+            chunk.size = it->ref + it->size - alloc_pos;
+            if (alloc_pos == it->ref) {
+                m_tail_free_space.erase(it);
+            }
+            else {
+                it->size = alloc_pos - it->ref;
+            }
+            return chunk;
+        }
+    }
+    // No free space, so we have to extend the file.
+    for (;;) {
+        size_t size_class = extend_free_space(size);
+        size_t ndx = m_free_space.get_class(size_class).size() - 1;
+        if (claim_free_space(size_class, ndx, size, chunk))
+            return chunk;
     }
-    return chunk;
 }
 
 // Extend the free space with at least the requested size.
 // Due to mmap constraints, the extension can not be guaranteed to
 // allow an allocation of the requested size, so multiple calls to
 // extend_free_space may be needed, before an allocation can succeed.
-GroupWriter::FreeListElement GroupWriter::extend_free_space(size_t requested_size)
+size_t GroupWriter::extend_free_space(size_t requested_size)
 {
     SlabAlloc& alloc = m_group.m_alloc;
 
@@ -800,12 +1145,12 @@ GroupWriter::FreeListElement GroupWriter::extend_free_space(size_t requested_siz
     size_t chunk_size = new_file_size - logical_file_size;
     REALM_ASSERT_RELEASE_EX(!(chunk_size & 7), chunk_size);
     REALM_ASSERT_RELEASE(chunk_size != 0);
-    auto it = m_size_map.emplace(chunk_size, logical_file_size);
+    size_t size_class = m_free_space.add(logical_file_size, chunk_size); // Throws
 
     // Update the logical file size
     m_group.m_top.set(2, 1 + 2 * uint64_t(new_file_size)); // Throws
 
-    return it;
+    return size_class;
 }
 
 bool inline is_aligned(char* addr) {
@@ -848,26 +1193,34 @@ void GroupWriter::write_array_at(MapWindow* window, ref_type ref, const char* da
 }
 
 
-void GroupWriter::commit(ref_type new_top_ref)
+// One bit of the flags field selects which of the two top ref slots are in
+// use (same for file format version slots). The current value of the bit
+// reflects the currently bound snapshot, so we need to invert it for the new
+// snapshot. Other bits must remain unchanged. Returns the new flags, which
+// must not be written until the new snapshot is on stable storage.
+unsigned GroupWriter::prepare_file_header(char* header, ref_type new_top_ref, int file_format_version)
 {
-    MapWindow* window = get_window(0, sizeof(SlabAlloc::Header));
-    SlabAlloc::Header& file_header = *reinterpret_cast<SlabAlloc::Header*>(window->translate(0));
-    window->encryption_read_barrier(&file_header, sizeof file_header);
-
-    // One bit of the flags field selects which of the two top ref slots are in
-    // use (same for file format version slots). The current value of the bit
-    // reflects the currently bound snapshot, so we need to invert it for the
-    // new snapshot. Other bits must remain unchanged.
+    SlabAlloc::Header& file_header = *reinterpret_cast<SlabAlloc::Header*>(header);
     unsigned old_flags = file_header.m_flags;
     unsigned new_flags = old_flags ^ SlabAlloc::flags_SelectBit;
     int slot_selector = ((new_flags & SlabAlloc::flags_SelectBit) != 0 ? 1 : 0);
 
     // Update top ref and file format version
-    int file_format_version = m_group.get_file_format_version();
     using type_1 = std::remove_reference<decltype(file_header.m_file_format[0])>::type;
     REALM_ASSERT(!util::int_cast_has_overflow<type_1>(file_format_version));
     file_header.m_top_ref[slot_selector] = new_top_ref;
     file_header.m_file_format[slot_selector] = type_1(file_format_version);
+    return new_flags;
+}
+
+
+void GroupWriter::commit(ref_type new_top_ref)
+{
+    MapWindow* window = get_window(0, sizeof(SlabAlloc::Header));
+    SlabAlloc::Header& file_header = *reinterpret_cast<SlabAlloc::Header*>(window->translate(0));
+    window->encryption_read_barrier(&file_header, sizeof file_header);
+
+    unsigned new_flags = prepare_file_header(window->translate(0), new_top_ref, m_group.get_file_format_version());
 
     // When running the test suite, device synchronization is disabled
     bool disable_sync = get_disable_sync_to_disk() || m_durability == Durability::Unsafe;
@@ -893,6 +1246,63 @@ void GroupWriter::commit(ref_type new_top_ref)
         window->sync();
 }
 
+size_t GroupWriter::shrink_file()
+{
+#ifndef _WIN32 // A mapped file cannot be truncated on Windows
+    File& file = m_alloc.get_file();
+    // Truncating an encrypted file could leave pages which are cached by the
+    // encryption layer beyond its end.
+    if (file.get_encryption_key())
+        return 0;
+    size_t new_file_size = to_size_t(m_group.m_top.get(2) / 2);
+    if (!m_alloc.matches_section_boundary(new_file_size))
+        new_file_size = m_alloc.get_upper_section_boundary(new_file_size);
+    if (new_file_size >= get_file_size())
+        return 0;
+    // No snapshot which is still in use, or which is found in the file header
+    // refers to anything beyond the logical end of the latest one, and the
+    // windows of this writer have been synchronized.
+    m_map_windows.clear();
+    file.resize(new_file_size); // Throws
+    return new_file_size;
+#else
+    return 0;
+#endif
+}
+
+
+void GroupWriter::sync_and_commit(Group& group, ref_type new_top_ref, Durability dura)
+{
+    File& file = group.m_alloc.get_file();
+    File::Map<char> map(file, File::access_ReadWrite, sizeof(SlabAlloc::Header)); // Throws
+    SlabAlloc::Header& file_header = *reinterpret_cast<SlabAlloc::Header*>(map.get_addr());
+    util::encryption_read_barrier(&file_header, sizeof file_header, map.get_encrypted_mapping());
+
+    unsigned new_flags = prepare_file_header(map.get_addr(), new_top_ref, group.get_file_format_version());
+
+    // When running the test suite, device synchronization is disabled
+    bool disable_sync = get_disable_sync_to_disk() || dura == Durability::Unsafe;
+
+#if REALM_METRICS
+    std::unique_ptr<MetricTimer> fsync_timer = Metrics::report_fsync_time(group);
+#endif // REALM_METRICS
+
+    // The snapshots being made durable were written through memory mappings
+    // which may no longer exist, so synchronize the entire file rather than
+    // individual mappings.
+    util::encryption_write_barrier(&file_header, sizeof file_header, map.get_encrypted_mapping());
+    if (!disable_sync)
+        file.sync(); // Throws
+
+    // Flip the slot selector bit.
+    using type_2 = std::remove_reference<decltype(file_header.m_flags)>::type;
+    file_header.m_flags = type_2(new_flags);
+
+    util::encryption_write_barrier(&file_header, sizeof file_header, map.get_encrypted_mapping());
+    if (!disable_sync)
+        map.sync(); // Throws
+}
+
 
 #ifdef REALM_DEBUG
 
@@ -22,6 +22,7 @@
 #include <cstdint> // unint8_t etc
 #include <utility>
 #include <map>
+#include <vector>
 
 #include <realm/util/file.hpp>
 #include <realm/alloc.hpp>
@@ -58,6 +59,15 @@ public:
 
     void set_versions(uint64_t current, uint64_t read_lock) noexcept;
 
+    /// Make write_group() move up to \a budget bytes of unmodified arrays from
+    /// the end of the file into free space closer to the beginning, if enough
+    /// of the file is free, and reduce the logical size of the file once its
+    /// end is free (see shrink_file()). Arrays are moved by copy-on-write
+    /// through the accessors that own them, and the search for them is
+    /// bounded too. It resumes from \a cursor, which is updated, and must
+    /// therefore outlive this writer and be kept from one commit to the next.
+    void enable_incremental_compaction(size_t budget, std::vector<size_t>& cursor) noexcept;
+
     /// Write all changed array nodes into free space.
     ///
     /// Returns the new top ref. When in full durability mode, call
@@ -69,6 +79,20 @@ public:
     /// returned by write_group().
     void commit(ref_type new_top_ref);
 
+    /// After commit(), truncate the file if incremental compaction has freed
+    /// its end. Returns the new size of the file, or zero if it was not
+    /// truncated. It is an error to call this function while any other session
+    /// participant may have the file mapped, as accessing a mapping beyond the
+    /// end of a file is fatal.
+    size_t shrink_file();
+
+    /// Flush everything written to the file of the specified group to the
+    /// physical medium, then write the new top ref to the file header, then
+    /// flush again. Unlike commit(), this does not require a write transaction,
+    /// and it also covers snapshots that earlier writers have left unflushed
+    /// (group commit, see SharedGroupOptions::enable_group_commit).
+    static void sync_and_commit(Group&, ref_type new_top_ref, Durability dura = Durability::Full);
+
     size_t get_file_size() const noexcept;
 
     ref_type write_array(const char*, size_t, uint32_t) override;
@@ -117,15 +141,101 @@ private:
         FreeList() = default;
         // Merge adjacent chunks
         void merge_adjacent_entries_in_freelist();
-        // Copy free space entries to structure where entries are sorted by size
-        void move_free_in_file_to_size_map(std::multimap<size_t, size_t>& size_map);
     };
-    //  m_free_in_file;
+
+    /// Index of the free space that may be recycled during this commit.
+    ///
+    /// Chunks are kept in size classes: one class per size for chunks of up to
+    /// `exact_class_limit` bytes (which covers almost all array nodes), and
+    /// four classes per power of two above that. A bitmap of non-empty classes
+    /// lets the smallest non-empty class of at least a given size be found in
+    /// constant time, and a chunk is removed from its class by moving the last
+    /// chunk of the class into its place. Building the index from the in-file
+    /// free-lists is therefore linear, and allocation does not depend on the
+    /// number of free chunks.
+    class FreeSpaceMap {
+    public:
+        struct Chunk {
+            size_t ref;
+            size_t size;
+        };
+
+        static constexpr size_t exact_class_limit = 8192;
+
+        /// Returns the size class of a chunk of the specified size. Size
+        /// classes grow with the size.
+        static size_t class_of(size_t size) noexcept;
+        static bool is_exact_class(size_t size_class) noexcept
+        {
+            return size_class <= exact_class_limit / 8;
+        }
+
+        /// Returns the smallest non-empty size class not smaller than the
+        /// specified one, or `realm::npos` if there is none.
+        size_t find_class(size_t size_class) const noexcept;
+
+        /// Returns the largest non-empty size class smaller than the specified
+        /// one, or `realm::npos` if there is none.
+        size_t find_class_below(size_t size_class) const noexcept;
+
+        const std::vector<Chunk>& get_class(size_t size_class) const noexcept
+        {
+            return m_classes[size_class];
+        }
+
+        /// Returns the size class the chunk was added to.
+        size_t add(size_t ref, size_t size);
+        void remove(size_t size_class, size_t ndx) noexcept;
+
+        size_t size() const noexcept
+        {
+            return m_size;
+        }
+
+        template <class F>
+        void for_each(F func) const
+        {
+            for (const auto& chunks : m_classes) {
+                for (const auto& chunk : chunks)
+                    func(chunk);
+            }
+        }
+
+    private:
+        static constexpr size_t num_classes = exact_class_limit / 8 + 1 + 4 * 64;
+        static constexpr size_t bits_per_word = 64;
+
+        std::vector<std::vector<Chunk>> m_classes = std::vector<std::vector<Chunk>>(num_classes);
+        uint64_t m_non_empty[(num_classes + bits_per_word - 1) / bits_per_word] = {};
+        size_t m_size = 0;
+    };
+    using Chunk = FreeSpaceMap::Chunk;
+
     std::vector<FreeSpaceEntry> m_not_free_in_file;
-    std::multimap<size_t, size_t> m_size_map;
-    using FreeListElement = std::multimap<size_t, size_t>::iterator;
+    FreeSpaceMap m_free_space;
+
+    size_t m_compaction_budget = 0;
+    std::vector<size_t>* m_compaction_cursor = nullptr;
+    // While compacting, arrays at or beyond this position are moved, and free
+    // space beyond it is kept in m_tail_free_space rather than m_free_space.
+    // Zero when not compacting.
+    size_t m_compaction_limit = 0;
+    size_t m_compaction_moved = 0;
+    size_t m_compaction_visited = 0;
+    // The size of the largest array that can be moved below the compaction
+    // limit
+    size_t m_max_move_size = 0;
+    std::vector<Chunk> m_tail_free_space;
 
     void read_in_freelist();
+    void prepare_compaction(FreeList&);
+    void move_arrays_from_tail();
+    bool move_tables_from_tail(bool resume);
+    bool move_array_from_tail(Array&, size_t depth, bool resume);
+    bool move_children_from_tail(Array& parent, size_t depth, bool resume);
+    bool compaction_budget_used() const noexcept;
+    size_t get_max_move_size() const;
+    bool is_movable(ref_type, size_t size) const noexcept;
     size_t recreate_freelist(size_t reserve_pos);
     // Currently cached memory mappings. We keep as many as 16 1MB windows
     // open for writing. The allocator will favor sequential allocation
@@ -144,6 +254,10 @@ private:
     // Sync all cached memory mappings
     void sync_all_mappings();
 
+    // Store the new top ref in the unused slot of the file header, and return
+    // the flags value that selects it
+    static unsigned prepare_file_header(char* header, ref_type new_top_ref, int file_format_version);
+
     /// Allocate a chunk of free space of the specified size. The
     /// specified size must be 8-byte aligned. Extend the file if
     /// required. The returned chunk is removed from the amount of
@@ -158,33 +272,41 @@ private:
     /// specified size and which will allow an allocation that is mapped
     /// inside a contiguous address range. The specified size does not
     /// need to be 8-byte aligned. Extend the file if required.
-    /// The returned chunk is not removed from the amount of remaing
-    /// free space.
     ///
-    /// \return A pair (`chunk_ndx`, `chunk_size`) where `chunk_ndx`
-    /// is the index of a chunk whose size is at least the requestd
-    /// size, and `chunk_size` is the size of that chunk.
-    FreeListElement reserve_free_space(size_t size);
-
-    FreeListElement search_free_space_in_free_list_element(FreeListElement element, size_t size);
-
-    /// Search only a range of the free list for a block as big as the
-    /// specified size. Return a pair with index and size of the found chunk.
-    /// \param found indicates whether a suitable block was found.
-    FreeListElement search_free_space_in_part_of_freelist(size_t size);
+    /// \return The found chunk, which starts at the position where the
+    /// allocation must be made. The chunk is removed from the free space
+    /// index, so any part of it that is not used must be added back.
+    Chunk reserve_free_space(size_t size);
+
+    /// Search the free space index for a block as big as the specified size,
+    /// taking either a perfect match or a chunk that is at least twice as big.
+    /// \param found is set to the claimed chunk, see reserve_free_space().
+    bool search_free_space(size_t size, Chunk& found);
+
+    /// Search the size classes from the specified one and up for any chunk
+    /// which is big enough.
+    bool search_free_space_from_class(size_t size_class, size_t size, Chunk& found);
+
+    /// Search the chunks of one size class, considering only chunks of at
+    /// least \a min_size bytes.
+    bool search_free_space_in_class(size_t size_class, size_t size, size_t min_size, size_t max_size, Chunk& found);
+
+    /// Claim the chunk at the specified position in the free space index if
+    /// it allows an allocation of the specified size that does not cross a
+    /// mapping boundary. The part of the chunk before the allocation (if any)
+    /// stays in the index.
+    bool claim_free_space(size_t size_class, size_t ndx, size_t size, Chunk& found);
 
     /// Extend the file to ensure that a chunk of free space of the
     /// specified size is available. The specified size does not need
     /// to be 8-byte aligned. This function guarantees that it will
     /// add at most one entry to the free-lists.
     ///
-    /// \return A pair (`chunk_ndx`, `chunk_size`) where `chunk_ndx`
-    /// is the index of a chunk whose size is at least the requestd
-    /// size, and `chunk_size` is the size of that chunk.
-    FreeListElement extend_free_space(size_t requested_size);
+    /// \return The size class of the added chunk, which is the last chunk
+    /// of that class.
+    size_t extend_free_space(size_t requested_size);
 
     void write_array_at(MapWindow* window, ref_type, const char* data, size_t size);
-    FreeListElement split_freelist_chunk(FreeListElement, size_t alloc_pos);
 };
 
 
@@ -197,6 +319,12 @@ inline void GroupWriter::set_versions(uint64_t current, uint64_t read_lock) noex
     m_readlock_version = read_lock;
 }
 
+inline void GroupWriter::enable_incremental_compaction(size_t budget, std::vector<size_t>& cursor) noexcept
+{
+    m_compaction_budget = budget;
+    m_compaction_cursor = &cursor;
+}
+
 } // namespace realm
 
 #endif // REALM_GROUP_WRITER_HPP
@@ -17,6 +17,7 @@
  **************************************************************************/
 
 #include <realm/impl/cont_transact_hist.hpp>
+#include <realm/impl/input_stream.hpp>
 #include <realm/binary_data.hpp>
 #include <realm/group_shared.hpp>
 #include <realm/replication.hpp>
@@ -28,7 +29,18 @@ using namespace realm;
 namespace {
 
 // As new schema versions come into existsnece, describe them here.
+//
+// 0 Initial version
+//
+// 1 Changesets may be stored in compressed form (see
+//   _impl::compress_changeset()). Upgrading from 0 requires no changes, since
+//   uncompressed changesets remain valid.
+//
+// Only histories that compress their changesets use schema version 1, so that
+// Realm files that never contain a compressed changeset remain readable by
+// older versions of the core library.
 constexpr int g_history_schema_version = 0;
+constexpr int g_compressed_history_schema_version = 1;
 
 
 /// This class is a basis for implementing the Replication API for the purpose
@@ -41,6 +53,18 @@ constexpr int g_history_schema_version = 0;
 /// History::update_early_from_top_ref()).
 class InRealmHistory : public _impl::History {
 public:
+    /// If `compress_changesets` is true, changesets are stored in compressed
+    /// form whenever that is smaller.
+    InRealmHistory(bool compress_changesets) noexcept
+        : m_compress_changesets(compress_changesets)
+    {
+    }
+
+    int get_schema_version() const noexcept
+    {
+        return (m_compress_changesets ? g_compressed_history_schema_version : g_history_schema_version);
+    }
+
     void initialize(Group&);
 
     /// Must never be called more than once per transaction. Returns the version
@@ -55,6 +79,7 @@ public:
     void verify() const override;
 
 private:
+    const bool m_compress_changesets;
     Group* m_group = nullptr;
 
     /// Version on which the first changeset in the history is based, or if the
@@ -81,6 +106,8 @@ private:
     /// dynamically allocated root node accessor, and the type of the required
     /// root node accessor depends on the size of the B+-tree.
     std::unique_ptr<BinaryColumn> m_changesets;
+
+    util::Buffer<char> m_compressed_changeset;
 };
 
 
@@ -105,7 +132,7 @@ InRealmHistory::version_type InRealmHistory::add_changeset(BinaryData changeset)
         m_changesets = std::make_unique<BinaryColumn>(alloc, hist_ref, nullable); // Throws
         gf::prepare_history_parent(*m_group, *m_changesets->get_root_array(),
                                    Replication::hist_InRealm,
-                                   g_history_schema_version); // Throws
+                                   get_schema_version()); // Throws
         // Note: gf::prepare_history_parent() also ensures the the root array
         // has a slot for the history ref.
         m_changesets->get_root_array()->update_parent(); // Throws
@@ -119,6 +146,10 @@ InRealmHistory::version_type InRealmHistory::add_changeset(BinaryData changeset)
         m_changesets->add(BinaryData("", 0)); // Throws
     }
     else {
+        size_t size;
+        if (m_compress_changesets && _impl::compress_changeset(changeset, m_compressed_changeset, size)) { // Throws
+            changeset = BinaryData(m_compressed_changeset.data(), size);
+        }
         m_changesets->add(changeset); // Throws
     }
     ++m_size;
@@ -207,8 +238,9 @@ class InRealmHistoryImpl : public TrivialReplication, private InRealmHistory {
 public:
     using version_type = TrivialReplication::version_type;
 
-    InRealmHistoryImpl(std::string realm_path)
+    InRealmHistoryImpl(std::string realm_path, bool compress_changesets)
         : TrivialReplication(realm_path)
+        , InRealmHistory(compress_changesets)
     {
     }
 
@@ -250,22 +282,23 @@ public:
 
     int get_history_schema_version() const noexcept override
     {
-        return g_history_schema_version;
+        return get_schema_version();
     }
 
     bool is_upgradable_history_schema(int stored_schema_version) const noexcept override
     {
-        // Never called because only one schema version exists so far.
-        static_cast<void>(stored_schema_version);
-        REALM_ASSERT(false);
-        return false;
+        // Only called when compressing, in which case the stored schema
+        // version can be older
+        return stored_schema_version == g_history_schema_version;
     }
 
     void upgrade_history_schema(int stored_schema_version) override
     {
-        // Never called because only one schema version exists so far.
+        // Schema version 0 is a subset of schema version 1, so there is
+        // nothing to convert.
+        REALM_ASSERT(stored_schema_version == g_history_schema_version);
+        REALM_ASSERT(get_schema_version() == g_compressed_history_schema_version);
         static_cast<void>(stored_schema_version);
-        REALM_ASSERT(false);
     }
 
     _impl::History* get_history() override
@@ -284,9 +317,9 @@ public:
 
 namespace realm {
 
-std::unique_ptr<Replication> make_in_realm_history(const std::string& realm_path)
+std::unique_ptr<Replication> make_in_realm_history(const std::string& realm_path, bool compress_changesets)
 {
-    return std::unique_ptr<InRealmHistoryImpl>(new InRealmHistoryImpl(realm_path)); // Throws
+    return std::unique_ptr<InRealmHistoryImpl>(new InRealmHistoryImpl(realm_path, compress_changesets)); // Throws
 }
 
 } // namespace realm
@@ -27,7 +27,18 @@
 
 namespace realm {
 
-std::unique_ptr<Replication> make_in_realm_history(const std::string& realm_path);
+/// If `compress_changesets` is true, each changeset is stored in the history
+/// in compressed form, unless compression fails to make it smaller.
+///
+/// Compression requires history schema version 1, so opening an existing Realm
+/// file with compression enabled upgrades its history (see
+/// SharedGroupOptions::allow_file_format_upgrade). After that, the file can
+/// only be opened with compression enabled, and not by versions of the core
+/// library that do not know about history schema version 1. Without
+/// compression, the history schema is left alone, and all participants in a
+/// session must agree on whether to compress.
+std::unique_ptr<Replication> make_in_realm_history(const std::string& realm_path,
+                                                   bool compress_changesets = false);
 
 } // namespace realm
 
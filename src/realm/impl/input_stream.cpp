@@ -0,0 +1,147 @@
+/*************************************************************************
+ *
+ * Copyright 2018 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#include <realm/impl/input_stream.hpp>
+#include <realm/impl/transact_log.hpp>
+#include <realm/util/compression.hpp>
+
+using namespace realm;
+using namespace realm::util;
+using namespace realm::_impl;
+
+
+namespace {
+
+constexpr size_t block_header_size = 8;
+
+void write_u32(char* p, size_t value) noexcept
+{
+    for (int i = 0; i < 4; ++i)
+        p[i] = char((value >> (8 * i)) & 0xFF);
+}
+
+size_t read_u32(const char* p) noexcept
+{
+    size_t value = 0;
+    for (int i = 0; i < 4; ++i)
+        value |= size_t(static_cast<unsigned char>(p[i])) << (8 * i);
+    return value;
+}
+
+} // unnamed namespace
+
+
+bool _impl::compress_changeset(BinaryData changeset, Buffer<char>& buffer, size_t& size)
+{
+    size_t in_size = changeset.size();
+    if (in_size == 0)
+        return false;
+    // Everything past `in_size` bytes would be useless, so the compressor is
+    // only given that much space to work with.
+    buffer.reserve(0, in_size); // Throws
+    const char* in = changeset.data();
+    const char* in_end = in + in_size;
+    char* out = buffer.data();
+    char* out_end = out + in_size;
+    *out++ = 0;
+    while (in != in_end) {
+        size_t block_size = std::min(size_t(in_end - in), compression::max_block_size);
+        if (size_t(out_end - out) < block_header_size)
+            return false;
+        char* header = out;
+        out += block_header_size;
+        size_t available = size_t(out_end - out);
+        size_t stored_size = compression::compress_block(in, block_size, out, std::min(available, block_size - 1));
+        if (stored_size == 0) {
+            if (available < block_size)
+                return false;
+            std::copy(in, in + block_size, out);
+            out += block_size;
+        }
+        else {
+            out += stored_size;
+        }
+        write_u32(header, stored_size);
+        write_u32(header + 4, block_size);
+        in += block_size;
+    }
+    size = size_t(out - buffer.data());
+    return size < in_size;
+}
+
+
+bool ChangesetInputStream::next_decompressed_block(const char*& begin, const char*& end)
+{
+    if (m_chunk_begin == m_chunk_end) {
+        BinaryData chunk = m_changesets_begin->get_next();
+        if (chunk.size() == 0)
+            return false; // End of changeset
+        m_chunk_begin = chunk.data();
+        m_chunk_end = chunk.data() + chunk.size();
+    }
+
+    const char* header = read_contiguous(block_header_size); // Throws
+    size_t stored_size = read_u32(header);
+    size_t size = read_u32(header + 4);
+    if (REALM_UNLIKELY(size == 0 || size > compression::max_block_size || stored_size >= size))
+        throw TransactLogParser::BadTransactLog();
+
+    if (stored_size == 0) {
+        begin = read_contiguous(size); // Throws
+        end = begin + size;
+        return true;
+    }
+
+    const char* data = read_contiguous(stored_size); // Throws
+    if (m_block_buffer.size() < compression::max_block_size)
+        m_block_buffer.set_size(compression::max_block_size); // Throws
+    if (REALM_UNLIKELY(!compression::decompress_block(data, stored_size, m_block_buffer.data(), size)))
+        throw TransactLogParser::BadTransactLog();
+    begin = m_block_buffer.data();
+    end = begin + size;
+    return true;
+}
+
+
+// Blocks are normally contiguous in the stored changeset, in which case they are
+// used in place. Only a block that straddles two chunks of a large changeset
+// needs to be gathered.
+const char* ChangesetInputStream::read_contiguous(size_t size)
+{
+    if (REALM_LIKELY(size_t(m_chunk_end - m_chunk_begin) >= size)) {
+        const char* data = m_chunk_begin;
+        m_chunk_begin += size;
+        return data;
+    }
+    m_gather_buffer.reserve(0, size); // Throws
+    char* out = m_gather_buffer.data();
+    size_t n = 0;
+    for (;;) {
+        size_t n_2 = std::min(size - n, size_t(m_chunk_end - m_chunk_begin));
+        std::copy(m_chunk_begin, m_chunk_begin + n_2, out + n);
+        m_chunk_begin += n_2;
+        n += n_2;
+        if (n == size)
+            return out;
+        BinaryData chunk = m_changesets_begin->get_next();
+        if (REALM_UNLIKELY(chunk.size() == 0))
+            throw TransactLogParser::BadTransactLog();
+        m_chunk_begin = chunk.data();
+        m_chunk_end = chunk.data() + chunk.size();
+    }
+}
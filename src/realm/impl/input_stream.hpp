@@ -192,6 +192,21 @@ private:
 };
 
 
+/// Compress the specified changeset into the form that ChangesetInputStream
+/// recognizes and decompresses transparently. On success, the compressed
+/// changeset is placed at the beginning of `buffer`, and its size is assigned
+/// to `size`. Returns false, and leaves `size` unspecified, if the compressed
+/// form would not be smaller than the original changeset.
+///
+/// A compressed changeset starts with a zero byte, which is never the first
+/// byte of an uncompressed changeset, followed by a sequence of blocks of at
+/// most util::compression::max_block_size bytes of the original
+/// changeset. Each block is prefixed by its stored size and its original size
+/// as 4-byte little-endian integers. A stored size of zero means that the block
+/// is stored uncompressed.
+bool compress_changeset(BinaryData changeset, util::Buffer<char>& buffer, size_t& size);
+
+
 class ChangesetInputStream : public NoCopyInputStream {
 public:
     using version_type = History::version_type;
@@ -205,18 +220,40 @@ public:
         get_changeset();
     }
 
+    /// Compressed changesets (see compress_changeset()) are decompressed one
+    /// block at a time.
+    ///
+    /// \throw TransactLogParser::BadTransactLog If a compressed changeset is
+    /// malformed.
     bool next_block(const char*& begin, const char*& end) override
     {
         while (m_valid) {
-            BinaryData actual = m_changesets_begin->get_next();
-
-            if (actual.size() > 0) {
-                begin = actual.data();
-                end = actual.data() + actual.size();
-                return true;
+            if (REALM_UNLIKELY(m_compressed)) {
+                if (next_decompressed_block(begin, end)) // Throws
+                    return true;
+            }
+            else {
+                BinaryData actual = m_changesets_begin->get_next();
+
+                if (actual.size() > 0) {
+                    begin = actual.data();
+                    end = actual.data() + actual.size();
+                    if (!m_changeset_started) {
+                        m_changeset_started = true;
+                        if (REALM_UNLIKELY(*begin == 0)) {
+                            m_compressed = true;
+                            m_chunk_begin = begin + 1;
+                            m_chunk_end = end;
+                            continue;
+                        }
+                    }
+                    return true;
+                }
             }
 
             m_changesets_begin++;
+            m_changeset_started = false;
+            m_compressed = false;
 
             if (REALM_UNLIKELY(m_changesets_begin == m_changesets_end)) {
                 get_changeset();
@@ -233,6 +270,15 @@ private:
     BinaryIterator* m_changesets_end = nullptr;
     bool m_valid;
 
+    // State of the current changeset
+    bool m_changeset_started = false;
+    bool m_compressed = false;
+    const char* m_chunk_begin = nullptr; // Unconsumed part of the current chunk
+    const char* m_chunk_end = nullptr;   // of a compressed changeset
+
+    util::Buffer<char> m_block_buffer;  // Decompressed block
+    util::Buffer<char> m_gather_buffer; // Block that spans multiple chunks
+
     void get_changeset()
     {
         auto versions_to_get = m_end_version - m_begin_version;
@@ -247,6 +293,9 @@ private:
             m_changesets_end = m_changesets_begin + versions_to_get;
         }
     }
+
+    bool next_decompressed_block(const char*& begin, const char*& end);
+    const char* read_contiguous(size_t size);
 };
 
 } // namespace _impl
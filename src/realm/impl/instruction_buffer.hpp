@@ -0,0 +1,626 @@
+/*************************************************************************
+ *
+ * Copyright 2018 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#ifndef REALM_IMPL_INSTRUCTION_BUFFER_HPP
+#define REALM_IMPL_INSTRUCTION_BUFFER_HPP
+
+#include <vector>
+
+#include <realm/impl/input_stream.hpp>
+#include <realm/impl/transact_log.hpp>
+
+
+namespace realm {
+namespace _impl {
+
+/// The part of a sequence of changesets that is needed to bring the accessors
+/// of a group up to date (Group::advance_transact()), recorded while the
+/// changesets are parsed for a transaction log observer, such that they need
+/// not be parsed a second time.
+///
+/// Instructions that only change the values of cells (set_int(), set_string(),
+/// insert_substring(), and so on) are recorded as the rows that they modify,
+/// and are replayed as calls to `InstructionHandler::modify_rows(row_ndx,
+/// num_rows)`, with modifications of adjacent rows merged into one call. All
+/// other instructions are replayed as they were parsed, except that names and
+/// values are not recorded; they are replayed as empty strings and null
+/// values.
+///
+/// The path passed to `InstructionHandler::select_table()` and
+/// `InstructionHandler::select_descriptor()` during replay() remains valid for
+/// as long as the buffer is not modified.
+class InstructionBuffer {
+public:
+    static constexpr size_t default_max_size = 32 * 1024 * 1024L;
+
+    InstructionBuffer(size_t max_size = default_max_size) noexcept;
+
+    /// Parse the specified changesets, pass each instruction to the specified
+    /// observer, and record them in this buffer.
+    ///
+    /// Returns false if the recorded instructions would have taken up more
+    /// than the maximum size of this buffer. In that case, the observer still
+    /// sees all the instructions, but the buffer is left empty, and the
+    /// changesets must be parsed again to update the accessors.
+    template <class InstructionHandler>
+    bool record(NoCopyInputStream&, InstructionHandler& observer);
+
+    /// Pass the recorded instructions, in order, to the specified handler.
+    template <class InstructionHandler>
+    void replay(InstructionHandler&) const;
+
+    /// The number of recorded instructions.
+    size_t size() const noexcept;
+
+    bool empty() const noexcept;
+
+    void clear() noexcept;
+
+private:
+    template <class InstructionHandler>
+    class Recorder;
+
+    enum class Op : unsigned char {
+        select_table,
+        select_descriptor,
+        select_link_list,
+        insert_group_level_table,
+        erase_group_level_table,
+        rename_group_level_table,
+        insert_empty_rows,
+        add_row_with_key,
+        erase_rows,
+        swap_rows,
+        move_row,
+        merge_rows,
+        clear_table,
+        modify_rows,
+        set_table,
+        set_mixed,
+        set_link,
+        nullify_link,
+        optimize_table,
+        insert_link_column,
+        insert_column,
+        erase_link_column,
+        erase_column,
+        rename_column,
+        add_search_index,
+        remove_search_index,
+        set_link_type,
+        link_list_set,
+        link_list_insert,
+        link_list_move,
+        link_list_swap,
+        link_list_erase,
+        link_list_nullify,
+        link_list_clear,
+    };
+
+    // The meaning of `args` and `extra` depends on the operation. For
+    // select_table() and select_descriptor(), `extra` is the offset of the
+    // path in `m_paths`.
+    struct Entry {
+        Op op;
+        unsigned char variant; // Instruction, DataType or LinkType
+        bool flag;
+        size_t args[3];
+        size_t extra;
+    };
+
+    std::vector<Entry> m_entries;
+    std::vector<size_t> m_paths;
+    size_t m_max_size;
+    size_t m_size = 0; // Bytes in use
+    bool m_overflow = false;
+
+    Entry* add(Op, size_t arg_0 = 0, size_t arg_1 = 0, size_t arg_2 = 0, size_t extra = 0);
+    void add_path(Op, size_t arg_0, size_t arg_1, const size_t* path, size_t path_size);
+    void modify_row(size_t row_ndx);
+    bool reserve(size_t size) noexcept;
+
+    template <class InstructionHandler>
+    bool replay_one(const Entry&, InstructionHandler&) const;
+};
+
+
+/// Passes each instruction on to the observer, and records it.
+template <class InstructionHandler>
+class InstructionBuffer::Recorder {
+public:
+    Recorder(InstructionBuffer& buffer, InstructionHandler& observer) noexcept
+        : m_buffer(buffer)
+        , m_observer(observer)
+    {
+    }
+
+    bool select_table(size_t group_level_ndx, size_t levels, const size_t* path)
+    {
+        m_buffer.add_path(Op::select_table, group_level_ndx, levels, path, 2 * levels); // Throws
+        return m_observer.select_table(group_level_ndx, levels, path);                  // Throws
+    }
+
+    bool select_descriptor(size_t levels, const size_t* path)
+    {
+        m_buffer.add_path(Op::select_descriptor, levels, 0, path, levels); // Throws
+        return m_observer.select_descriptor(levels, path);                 // Throws
+    }
+
+    bool select_link_list(size_t col_ndx, size_t row_ndx, size_t link_target_group_level_ndx)
+    {
+        m_buffer.add(Op::select_link_list, col_ndx, row_ndx, link_target_group_level_ndx); // Throws
+        return m_observer.select_link_list(col_ndx, row_ndx, link_target_group_level_ndx); // Throws
+    }
+
+    bool insert_group_level_table(size_t table_ndx, size_t num_tables, StringData name)
+    {
+        m_buffer.add(Op::insert_group_level_table, table_ndx, num_tables);   // Throws
+        return m_observer.insert_group_level_table(table_ndx, num_tables, name); // Throws
+    }
+
+    bool erase_group_level_table(size_t table_ndx, size_t num_tables)
+    {
+        m_buffer.add(Op::erase_group_level_table, table_ndx, num_tables); // Throws
+        return m_observer.erase_group_level_table(table_ndx, num_tables); // Throws
+    }
+
+    bool rename_group_level_table(size_t table_ndx, StringData new_name)
+    {
+        m_buffer.add(Op::rename_group_level_table, table_ndx);          // Throws
+        return m_observer.rename_group_level_table(table_ndx, new_name); // Throws
+    }
+
+    bool insert_empty_rows(size_t row_ndx, size_t num_rows_to_insert, size_t prior_num_rows, bool unordered)
+    {
+        if (Entry* entry = m_buffer.add(Op::insert_empty_rows, row_ndx, num_rows_to_insert, prior_num_rows)) // Throws
+            entry->flag = unordered;
+        return m_observer.insert_empty_rows(row_ndx, num_rows_to_insert, prior_num_rows, unordered); // Throws
+    }
+
+    bool add_row_with_key(size_t row_ndx, size_t prior_num_rows, size_t key_col_ndx, int64_t key)
+    {
+        m_buffer.add(Op::add_row_with_key, row_ndx, prior_num_rows, key_col_ndx);          // Throws
+        return m_observer.add_row_with_key(row_ndx, prior_num_rows, key_col_ndx, key); // Throws
+    }
+
+    bool erase_rows(size_t row_ndx, size_t num_rows_to_erase, size_t prior_num_rows, bool unordered)
+    {
+        if (Entry* entry = m_buffer.add(Op::erase_rows, row_ndx, num_rows_to_erase, prior_num_rows)) // Throws
+            entry->flag = unordered;
+        return m_observer.erase_rows(row_ndx, num_rows_to_erase, prior_num_rows, unordered); // Throws
+    }
+
+    bool swap_rows(size_t row_ndx_1, size_t row_ndx_2)
+    {
+        m_buffer.add(Op::swap_rows, row_ndx_1, row_ndx_2); // Throws
+        return m_observer.swap_rows(row_ndx_1, row_ndx_2); // Throws
+    }
+
+    bool move_row(size_t from_ndx, size_t to_ndx)
+    {
+        m_buffer.add(Op::move_row, from_ndx, to_ndx);   // Throws
+        return m_observer.move_row(from_ndx, to_ndx); // Throws
+    }
+
+    bool merge_rows(size_t row_ndx, size_t new_row_ndx)
+    {
+        m_buffer.add(Op::merge_rows, row_ndx, new_row_ndx);   // Throws
+        return m_observer.merge_rows(row_ndx, new_row_ndx); // Throws
+    }
+
+    bool clear_table(size_t old_size)
+    {
+        m_buffer.add(Op::clear_table, old_size);   // Throws
+        return m_observer.clear_table(old_size); // Throws
+    }
+
+    bool set_int(size_t col_ndx, size_t row_ndx, int_fast64_t value, Instruction variant, size_t prior_num_rows)
+    {
+        m_buffer.modify_row(row_ndx);                                               // Throws
+        return m_observer.set_int(col_ndx, row_ndx, value, variant, prior_num_rows); // Throws
+    }
+
+    bool add_int(size_t col_ndx, size_t row_ndx, int_fast64_t value)
+    {
+        m_buffer.modify_row(row_ndx);                     // Throws
+        return m_observer.add_int(col_ndx, row_ndx, value); // Throws
+    }
+
+    bool set_bool(size_t col_ndx, size_t row_ndx, bool value, Instruction variant)
+    {
+        m_buffer.modify_row(row_ndx);                               // Throws
+        return m_observer.set_bool(col_ndx, row_ndx, value, variant); // Throws
+    }
+
+    bool set_float(size_t col_ndx, size_t row_ndx, float value, Instruction variant)
+    {
+        m_buffer.modify_row(row_ndx);                                // Throws
+        return m_observer.set_float(col_ndx, row_ndx, value, variant); // Throws
+    }
+
+    bool set_double(size_t col_ndx, size_t row_ndx, double value, Instruction variant)
+    {
+        m_buffer.modify_row(row_ndx);                                 // Throws
+        return m_observer.set_double(col_ndx, row_ndx, value, variant); // Throws
+    }
+
+    bool set_string(size_t col_ndx, size_t row_ndx, StringData value, Instruction variant, size_t prior_num_rows)
+    {
+        m_buffer.modify_row(row_ndx);                                                  // Throws
+        return m_observer.set_string(col_ndx, row_ndx, value, variant, prior_num_rows); // Throws
+    }
+
+    bool set_binary(size_t col_ndx, size_t row_ndx, BinaryData value, Instruction variant)
+    {
+        m_buffer.modify_row(row_ndx);                                 // Throws
+        return m_observer.set_binary(col_ndx, row_ndx, value, variant); // Throws
+    }
+
+    bool set_olddatetime(size_t col_ndx, size_t row_ndx, OldDateTime value, Instruction variant)
+    {
+        m_buffer.modify_row(row_ndx);                                      // Throws
+        return m_observer.set_olddatetime(col_ndx, row_ndx, value, variant); // Throws
+    }
+
+    bool set_timestamp(size_t col_ndx, size_t row_ndx, Timestamp value, Instruction variant)
+    {
+        m_buffer.modify_row(row_ndx);                                    // Throws
+        return m_observer.set_timestamp(col_ndx, row_ndx, value, variant); // Throws
+    }
+
+    bool set_table(size_t col_ndx, size_t row_ndx, Instruction variant)
+    {
+        if (Entry* entry = m_buffer.add(Op::set_table, col_ndx, row_ndx)) // Throws
+            entry->variant = variant;
+        return m_observer.set_table(col_ndx, row_ndx, variant); // Throws
+    }
+
+    bool set_mixed(size_t col_ndx, size_t row_ndx, const Mixed& value, Instruction variant)
+    {
+        if (Entry* entry = m_buffer.add(Op::set_mixed, col_ndx, row_ndx)) // Throws
+            entry->variant = variant;
+        return m_observer.set_mixed(col_ndx, row_ndx, value, variant); // Throws
+    }
+
+    bool set_link(size_t col_ndx, size_t row_ndx, size_t target_row_ndx, size_t target_group_level_ndx,
+                  Instruction variant)
+    {
+        Entry* entry = m_buffer.add(Op::set_link, col_ndx, row_ndx, target_row_ndx, target_group_level_ndx); // Throws
+        if (entry)
+            entry->variant = variant;
+        return m_observer.set_link(col_ndx, row_ndx, target_row_ndx, target_group_level_ndx, variant); // Throws
+    }
+
+    bool set_null(size_t col_ndx, size_t row_ndx, Instruction variant, size_t prior_num_rows)
+    {
+        m_buffer.modify_row(row_ndx);                                         // Throws
+        return m_observer.set_null(col_ndx, row_ndx, variant, prior_num_rows); // Throws
+    }
+
+    bool nullify_link(size_t col_ndx, size_t row_ndx, size_t target_group_level_ndx)
+    {
+        m_buffer.add(Op::nullify_link, col_ndx, row_ndx, target_group_level_ndx);   // Throws
+        return m_observer.nullify_link(col_ndx, row_ndx, target_group_level_ndx); // Throws
+    }
+
+    bool insert_substring(size_t col_ndx, size_t row_ndx, size_t pos, StringData value)
+    {
+        m_buffer.modify_row(row_ndx);                                      // Throws
+        return m_observer.insert_substring(col_ndx, row_ndx, pos, value); // Throws
+    }
+
+    bool erase_substring(size_t col_ndx, size_t row_ndx, size_t pos, size_t size)
+    {
+        m_buffer.modify_row(row_ndx);                                    // Throws
+        return m_observer.erase_substring(col_ndx, row_ndx, pos, size); // Throws
+    }
+
+    bool optimize_table()
+    {
+        m_buffer.add(Op::optimize_table);    // Throws
+        return m_observer.optimize_table(); // Throws
+    }
+
+    bool insert_link_column(size_t col_ndx, DataType type, StringData name, size_t link_target_table_ndx,
+                            size_t backlink_col_ndx)
+    {
+        Entry* entry = m_buffer.add(Op::insert_link_column, col_ndx, link_target_table_ndx, backlink_col_ndx); // Throws
+        if (entry)
+            entry->variant = static_cast<unsigned char>(type);
+        return m_observer.insert_link_column(col_ndx, type, name, link_target_table_ndx,
+                                             backlink_col_ndx); // Throws
+    }
+
+    bool insert_column(size_t col_ndx, DataType type, StringData name, bool nullable)
+    {
+        if (Entry* entry = m_buffer.add(Op::insert_column, col_ndx)) { // Throws
+            entry->variant = static_cast<unsigned char>(type);
+            entry->flag = nullable;
+        }
+        return m_observer.insert_column(col_ndx, type, name, nullable); // Throws
+    }
+
+    bool erase_link_column(size_t col_ndx, size_t link_target_table_ndx, size_t backlink_col_ndx)
+    {
+        m_buffer.add(Op::erase_link_column, col_ndx, link_target_table_ndx, backlink_col_ndx);   // Throws
+        return m_observer.erase_link_column(col_ndx, link_target_table_ndx, backlink_col_ndx); // Throws
+    }
+
+    bool erase_column(size_t col_ndx)
+    {
+        m_buffer.add(Op::erase_column, col_ndx);   // Throws
+        return m_observer.erase_column(col_ndx); // Throws
+    }
+
+    bool rename_column(size_t col_ndx, StringData name)
+    {
+        m_buffer.add(Op::rename_column, col_ndx);        // Throws
+        return m_observer.rename_column(col_ndx, name); // Throws
+    }
+
+    bool add_search_index(size_t col_ndx)
+    {
+        m_buffer.add(Op::add_search_index, col_ndx);   // Throws
+        return m_observer.add_search_index(col_ndx); // Throws
+    }
+
+    bool remove_search_index(size_t col_ndx)
+    {
+        m_buffer.add(Op::remove_search_index, col_ndx);   // Throws
+        return m_observer.remove_search_index(col_ndx); // Throws
+    }
+
+    bool set_link_type(size_t col_ndx, LinkType link_type)
+    {
+        if (Entry* entry = m_buffer.add(Op::set_link_type, col_ndx)) // Throws
+            entry->variant = static_cast<unsigned char>(link_type);
+        return m_observer.set_link_type(col_ndx, link_type); // Throws
+    }
+
+    bool link_list_set(size_t link_ndx, size_t value, size_t prior_size)
+    {
+        m_buffer.add(Op::link_list_set, link_ndx, value, prior_size);   // Throws
+        return m_observer.link_list_set(link_ndx, value, prior_size); // Throws
+    }
+
+    bool link_list_insert(size_t link_ndx, size_t value, size_t prior_size)
+    {
+        m_buffer.add(Op::link_list_insert, link_ndx, value, prior_size);   // Throws
+        return m_observer.link_list_insert(link_ndx, value, prior_size); // Throws
+    }
+
+    bool link_list_move(size_t from_link_ndx, size_t to_link_ndx)
+    {
+        m_buffer.add(Op::link_list_move, from_link_ndx, to_link_ndx);   // Throws
+        return m_observer.link_list_move(from_link_ndx, to_link_ndx); // Throws
+    }
+
+    bool link_list_swap(size_t link_ndx_1, size_t link_ndx_2)
+    {
+        m_buffer.add(Op::link_list_swap, link_ndx_1, link_ndx_2);   // Throws
+        return m_observer.link_list_swap(link_ndx_1, link_ndx_2); // Throws
+    }
+
+    bool link_list_erase(size_t link_ndx, size_t prior_size)
+    {
+        m_buffer.add(Op::link_list_erase, link_ndx, prior_size);   // Throws
+        return m_observer.link_list_erase(link_ndx, prior_size); // Throws
+    }
+
+    bool link_list_nullify(size_t link_ndx, size_t prior_size)
+    {
+        m_buffer.add(Op::link_list_nullify, link_ndx, prior_size);   // Throws
+        return m_observer.link_list_nullify(link_ndx, prior_size); // Throws
+    }
+
+    bool link_list_clear(size_t old_list_size)
+    {
+        m_buffer.add(Op::link_list_clear, old_list_size);   // Throws
+        return m_observer.link_list_clear(old_list_size); // Throws
+    }
+
+private:
+    InstructionBuffer& m_buffer;
+    InstructionHandler& m_observer;
+};
+
+
+// Implementation:
+
+inline InstructionBuffer::InstructionBuffer(size_t max_size) noexcept
+    : m_max_size(max_size)
+{
+}
+
+template <class InstructionHandler>
+bool InstructionBuffer::record(NoCopyInputStream& in, InstructionHandler& observer)
+{
+    Recorder<InstructionHandler> recorder(*this, observer);
+    TransactLogParser parser; // Throws
+    parser.parse(in, recorder); // Throws
+    if (m_overflow) {
+        clear();
+        return false;
+    }
+    return true;
+}
+
+template <class InstructionHandler>
+void InstructionBuffer::replay(InstructionHandler& handler) const
+{
+    for (const Entry& entry : m_entries) {
+        if (!replay_one(entry, handler)) // Throws
+            throw TransactLogParser::BadTransactLog();
+    }
+}
+
+inline size_t InstructionBuffer::size() const noexcept
+{
+    return m_entries.size();
+}
+
+inline bool InstructionBuffer::empty() const noexcept
+{
+    return m_entries.empty();
+}
+
+inline void InstructionBuffer::clear() noexcept
+{
+    m_entries.clear();
+    m_paths.clear();
+    m_size = 0;
+    m_overflow = false;
+}
+
+inline bool InstructionBuffer::reserve(size_t size) noexcept
+{
+    if (REALM_UNLIKELY(m_overflow || size > m_max_size - m_size)) {
+        m_overflow = true;
+        return false;
+    }
+    m_size += size;
+    return true;
+}
+
+inline auto InstructionBuffer::add(Op op, size_t arg_0, size_t arg_1, size_t arg_2, size_t extra) -> Entry*
+{
+    if (!reserve(sizeof(Entry)))
+        return nullptr;
+    Entry entry;
+    entry.op = op;
+    entry.variant = 0;
+    entry.flag = false;
+    entry.args[0] = arg_0;
+    entry.args[1] = arg_1;
+    entry.args[2] = arg_2;
+    entry.extra = extra;
+    m_entries.push_back(entry); // Throws
+    return &m_entries.back();
+}
+
+inline void InstructionBuffer::add_path(Op op, size_t arg_0, size_t arg_1, const size_t* path, size_t path_size)
+{
+    if (!reserve(path_size * sizeof(size_t)))
+        return;
+    if (add(op, arg_0, arg_1, 0, m_paths.size()))            // Throws
+        m_paths.insert(m_paths.end(), path, path + path_size); // Throws
+}
+
+inline void InstructionBuffer::modify_row(size_t row_ndx)
+{
+    // Extend the preceding range of modified rows if possible. Modifying a
+    // row that is already in the range changes nothing, since views only
+    // need to know which rows to reevaluate.
+    if (!m_entries.empty()) {
+        Entry& last = m_entries.back();
+        if (last.op == Op::modify_rows) {
+            size_t begin = last.args[0];
+            size_t end = begin + last.args[1];
+            if (row_ndx >= begin && row_ndx <= end) {
+                if (row_ndx == end)
+                    ++last.args[1];
+                return;
+            }
+        }
+    }
+    add(Op::modify_rows, row_ndx, 1); // Throws
+}
+
+template <class InstructionHandler>
+bool InstructionBuffer::replay_one(const Entry& e, InstructionHandler& handler) const
+{
+    const size_t* a = e.args;
+    Instruction variant = Instruction(e.variant);
+    StringData name("", 0);
+    switch (e.op) {
+        case Op::select_table:
+            return handler.select_table(a[0], a[1], m_paths.data() + e.extra); // Throws
+        case Op::select_descriptor:
+            return handler.select_descriptor(a[0], m_paths.data() + e.extra); // Throws
+        case Op::select_link_list:
+            return handler.select_link_list(a[0], a[1], a[2]); // Throws
+        case Op::insert_group_level_table:
+            return handler.insert_group_level_table(a[0], a[1], name); // Throws
+        case Op::erase_group_level_table:
+            return handler.erase_group_level_table(a[0], a[1]); // Throws
+        case Op::rename_group_level_table:
+            return handler.rename_group_level_table(a[0], name); // Throws
+        case Op::insert_empty_rows:
+            return handler.insert_empty_rows(a[0], a[1], a[2], e.flag); // Throws
+        case Op::add_row_with_key:
+            return handler.add_row_with_key(a[0], a[1], a[2], 0); // Throws
+        case Op::erase_rows:
+            return handler.erase_rows(a[0], a[1], a[2], e.flag); // Throws
+        case Op::swap_rows:
+            return handler.swap_rows(a[0], a[1]); // Throws
+        case Op::move_row:
+            return handler.move_row(a[0], a[1]); // Throws
+        case Op::merge_rows:
+            return handler.merge_rows(a[0], a[1]); // Throws
+        case Op::clear_table:
+            return handler.clear_table(a[0]); // Throws
+        case Op::modify_rows:
+            return handler.modify_rows(a[0], a[1]); // Throws
+        case Op::set_table:
+            return handler.set_table(a[0], a[1], variant); // Throws
+        case Op::set_mixed:
+            return handler.set_mixed(a[0], a[1], Mixed(), variant); // Throws
+        case Op::set_link:
+            return handler.set_link(a[0], a[1], a[2], e.extra, variant); // Throws
+        case Op::nullify_link:
+            return handler.nullify_link(a[0], a[1], a[2]); // Throws
+        case Op::optimize_table:
+            return handler.optimize_table(); // Throws
+        case Op::insert_link_column:
+            return handler.insert_link_column(a[0], DataType(e.variant), name, a[1], a[2]); // Throws
+        case Op::insert_column:
+            return handler.insert_column(a[0], DataType(e.variant), name, e.flag); // Throws
+        case Op::erase_link_column:
+            return handler.erase_link_column(a[0], a[1], a[2]); // Throws
+        case Op::erase_column:
+            return handler.erase_column(a[0]); // Throws
+        case Op::rename_column:
+            return handler.rename_column(a[0], name); // Throws
+        case Op::add_search_index:
+            return handler.add_search_index(a[0]); // Throws
+        case Op::remove_search_index:
+            return handler.remove_search_index(a[0]); // Throws
+        case Op::set_link_type:
+            return handler.set_link_type(a[0], LinkType(e.variant)); // Throws
+        case Op::link_list_set:
+            return handler.link_list_set(a[0], a[1], a[2]); // Throws
+        case Op::link_list_insert:
+            return handler.link_list_insert(a[0], a[1], a[2]); // Throws
+        case Op::link_list_move:
+            return handler.link_list_move(a[0], a[1]); // Throws
+        case Op::link_list_swap:
+            return handler.link_list_swap(a[0], a[1]); // Throws
+        case Op::link_list_erase:
+            return handler.link_list_erase(a[0], a[1]); // Throws
+        case Op::link_list_nullify:
+            return handler.link_list_nullify(a[0], a[1]); // Throws
+        case Op::link_list_clear:
+            return handler.link_list_clear(a[0]); // Throws
+    }
+    return false;
+}
+
+} // namespace _impl
+} // namespace realm
+
+#endif // REALM_IMPL_INSTRUCTION_BUFFER_HPP
@@ -622,6 +622,8 @@ private:
 
     template <class T>
     T read_int();
+    template <class T>
+    T read_int_2();
 
     void read_bytes(char* data, size_t size);
     BinaryData read_buffer(util::StringBuffer&, size_t size);
@@ -2141,6 +2143,48 @@ void TransactLogParser::parse_one(InstructionHandler& handler)
 
 template <class T>
 T TransactLogParser::read_int()
+{
+    // When the whole integer is known to be in the current chunk, its bytes can
+    // be decoded without checking for the end of the chunk, and without
+    // checking for overflow when the number of bytes shows that the value
+    // fits. Anything else is left to read_int_2().
+    const int max_bytes = (std::numeric_limits<T>::digits + 1 + 6) / 7;
+    if (REALM_LIKELY(m_input_end - m_input_begin >= max_bytes)) {
+        const unsigned char* in = reinterpret_cast<const unsigned char*>(m_input_begin);
+        // Most integers are small and non-negative
+        if ((in[0] & 0xC0) == 0) {
+            ++m_input_begin;
+            return T(in[0]);
+        }
+        uint_fast64_t magnitude = 0;
+        int i = 0;
+        unsigned part = in[0];
+        while (part & 0x80) {
+            magnitude |= uint_fast64_t(part & 0x7F) << (i * 7);
+            if (++i == max_bytes)
+                return read_int_2<T>(); // Throws
+            part = in[i];
+        }
+        magnitude |= uint_fast64_t(part & 0x3F) << (i * 7);
+        bool negative = (part & 0x40) != 0;
+        bool fits = (i * 7 + 6 <= std::numeric_limits<T>::digits && (!negative || std::is_signed<T>::value));
+        if (REALM_LIKELY(fits)) {
+            m_input_begin += i + 1;
+            T value = T(magnitude);
+            REALM_DIAG_PUSH();
+            REALM_DIAG_IGNORE_UNSIGNED_MINUS();
+            if (negative)
+                value = -value - 1;
+            REALM_DIAG_POP();
+            return value;
+        }
+    }
+    return read_int_2<T>(); // Throws
+}
+
+
+template <class T>
+T TransactLogParser::read_int_2()
 {
     T value = 0;
     int part = 0;
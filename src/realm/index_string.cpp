@@ -16,6 +16,7 @@
  *
  **************************************************************************/
 
+#include <algorithm>
 #include <cstdio>
 #include <iomanip>
 
@@ -158,6 +159,56 @@ size_t IndexArray::from_list<index_FindAll_nocopy>(StringData value, InternalFin
 }
 
 
+void IndexArray::update_prefix_path() const
+{
+    m_prefix_keys.clear();
+    ref_type node_ref = get_ref();
+    const char* header = get_header_from_data(m_data);
+
+    // Follow sub-index refs for as long as the node is a leaf holding a single
+    // key. A lookup passing through such a node either matches that key and
+    // descends into the sub-index, or fails right there.
+    while (!get_is_inner_bptree_node_from_header(header)) {
+        const char* data = get_data_from_header(header);
+        uint_least8_t width = get_width_from_header(header);
+        const char* offsets_header = m_alloc.translate(to_ref(get_direct(data, width, 0)));
+        if (get_size_from_header(offsets_header) != 1)
+            break;
+
+        int64_t ref = get_direct(data, width, 1);
+        if (ref & 1)
+            break;
+        const char* sub_header = m_alloc.translate(to_ref(ref));
+        if (!get_context_flag_from_header(sub_header))
+            break;
+
+        m_prefix_keys.push_back(int32_t(get_direct<32>(get_data_from_header(offsets_header), 0)));
+        node_ref = to_ref(ref);
+        header = sub_header;
+    }
+
+    m_prefix_node = node_ref;
+    m_prefix_root = get_ref();
+}
+
+
+// Returns the header of the node at which a lookup of `value` must continue,
+// with `stringoffset` advanced past the cached single key path, or null if
+// `value` cannot be in the index.
+const char* IndexArray::find_start_node(StringData value, size_t& stringoffset) const
+{
+    if (m_prefix_root != get_ref())
+        update_prefix_path(); // Throws
+
+    for (int32_t key : m_prefix_keys) {
+        if (StringIndex::create_key(value, stringoffset) != key)
+            return nullptr;
+        stringoffset += StringIndex::s_index_key_length;
+    }
+    return m_alloc.translate(m_prefix_node);
+}
+
+
 template <IndexMethod method>
 size_t IndexArray::index_string(StringData value, InternalFindResult& result_ref, ColumnBase* column) const
 {
@@ -174,12 +225,14 @@ size_t IndexArray::index_string(StringData value, InternalFindResult& result_ref
 
     constexpr size_t local_not_found = allnocopy ? size_t(FindRes_not_found) : first ? not_found : 0;
 
-    const char* data = m_data;
-    const char* header;
-    uint_least8_t width = m_width;
-    bool is_inner_node = m_is_inner_bptree_node;
     typedef StringIndex::key_type key_type;
     size_t stringoffset = 0;
+    const char* header = find_start_node(value, stringoffset);
+    if (!header)
+        return local_not_found;
+    const char* data = get_data_from_header(header);
+    uint_least8_t width = get_width_from_header(header);
+    bool is_inner_node = get_is_inner_bptree_node_from_header(header);
 
     // Create 4 byte index key
     key_type key = StringIndex::create_key(value, stringoffset);
@@ -511,11 +564,13 @@ void IndexArray::index_string_all_ins(StringData value, IntegerColumn& result, C
 
 void IndexArray::index_string_all(StringData value, IntegerColumn& result, ColumnBase* column) const
 {
-    const char* data = m_data;
-    const char* header;
-    uint_least8_t width = m_width;
-    bool is_inner_node = m_is_inner_bptree_node;
     size_t stringoffset = 0;
+    const char* header = find_start_node(value, stringoffset);
+    if (!header)
+        return;
+    const char* data = get_data_from_header(header);
+    uint_least8_t width = get_width_from_header(header);
+    bool is_inner_node = get_is_inner_bptree_node_from_header(header);
 
     // Create 4 byte index key
     key_type key = StringIndex::create_key(value, stringoffset);
@@ -661,6 +716,7 @@ StringIndex::key_type StringIndex::get_last_key() const
 
 void StringIndex::insert_with_offset(size_t row_ndx, StringData value, size_t offset)
 {
+    m_array->invalidate_prefix_path();
     // Create 4 byte index key
     key_type key = create_key(value, offset);
     TreeInsert(row_ndx, key, offset, value); // Throws
@@ -1178,9 +1234,9 @@ StringData StringIndex::get(size_t ndx, StringConversionBuffer& buffer) const
     return m_target_column->get_index_data(ndx, buffer);
 }
 
-void StringIndex::adjust_row_indexes(size_t min_row_ndx, int diff)
+void StringIndex::adjust_row_indexes(size_t min_row_ndx, int64_t diff)
 {
-    REALM_ASSERT(diff == 1 || diff == -1); // only used by insert and delete
+    m_array->invalidate_prefix_path();
 
     Allocator& alloc = m_array->get_alloc();
     const size_t array_size = m_array->size();
@@ -1200,7 +1256,7 @@ void StringIndex::adjust_row_indexes(size_t min_row_ndx, int diff)
             if (ref & 1) {
                 size_t r = size_t(uint64_t(ref) >> 1);
                 if (r >= min_row_ndx) {
-                    size_t adjusted_ref = ((r + diff) << 1) + 1;
+                    size_t adjusted_ref = (size_t(int64_t(r) + diff) << 1) + 1;
                     m_array->set(i, adjusted_ref);
                 }
             }
@@ -1222,8 +1278,81 @@ void StringIndex::adjust_row_indexes(size_t min_row_ndx, int diff)
 }
 
 
+void StringIndex::erase_rows(const std::vector<size_t>& row_ndxs)
+{
+    if (row_ndxs.empty())
+        return;
+
+    // Erase from the last row so that nothing has to be adjusted until all the
+    // rows are gone
+    for (auto i = row_ndxs.rbegin(); i != row_ndxs.rend(); ++i) {
+        bool is_last = true; // To avoid updating refs
+        erase<StringData>(*i, is_last); // Throws
+    }
+    adjust_row_indexes(row_ndxs); // Throws
+}
+
+void StringIndex::adjust_row_indexes(const std::vector<size_t>& erased_row_ndxs)
+{
+    m_array->invalidate_prefix_path();
+
+    auto adjusted = [&](size_t r) {
+        size_t num_erased_before = std::lower_bound(erased_row_ndxs.begin(), erased_row_ndxs.end(), r) -
+                                   erased_row_ndxs.begin();
+        return r - num_erased_before;
+    };
+    size_t min_row_ndx = erased_row_ndxs.front();
+
+    Allocator& alloc = m_array->get_alloc();
+    const size_t array_size = m_array->size();
+
+    if (m_array->is_inner_bptree_node()) {
+        for (size_t i = 1; i < array_size; ++i) {
+            size_t ref = m_array->get_as_ref(i);
+            StringIndex ndx(ref, m_array.get(), i, m_target_column, alloc);
+            ndx.adjust_row_indexes(erased_row_ndxs);
+        }
+    }
+    else {
+        for (size_t i = 1; i < array_size; ++i) {
+            int64_t ref = m_array->get(i);
+
+            // low bit set indicate literal ref (shifted)
+            if (ref & 1) {
+                size_t r = size_t(uint64_t(ref) >> 1);
+                if (r > min_row_ndx) {
+                    size_t adjusted_ref = (adjusted(r) << 1) + 1;
+                    m_array->set(i, adjusted_ref);
+                }
+            }
+            else {
+                // A real ref either points to a list or a subindex
+                char* header = alloc.translate(to_ref(ref));
+                if (Array::get_context_flag_from_header(header)) {
+                    StringIndex ndx(to_ref(ref), m_array.get(), i, m_target_column, alloc);
+                    ndx.adjust_row_indexes(erased_row_ndxs);
+                }
+                else {
+                    // The order of the list is preserved, since no two rows
+                    // can be adjusted past each other
+                    IntegerColumn sub(alloc, to_ref(ref)); // Throws
+                    sub.set_parent(m_array.get(), i);
+                    size_t sub_size = sub.size();
+                    for (size_t j = 0; j < sub_size; ++j) {
+                        size_t r = to_size_t(sub.get(j));
+                        if (r > min_row_ndx)
+                            sub.set(j, adjusted(r));
+                    }
+                }
+            }
+        }
+    }
+}
+
+
 void StringIndex::clear()
 {
+    m_array->invalidate_prefix_path();
     Array values(m_array->get_alloc());
     get_child(*m_array, 0, values);
     REALM_ASSERT(m_array->size() == values.size() + 1);
@@ -1240,6 +1369,7 @@ void StringIndex::clear()
 
 void StringIndex::do_delete(size_t row_ndx, StringData value, size_t offset)
 {
+    m_array->invalidate_prefix_path();
     Allocator& alloc = m_array->get_alloc();
     Array values(alloc);
     get_child(*m_array, 0, values);
@@ -1311,6 +1441,7 @@ void StringIndex::do_delete(size_t row_ndx, StringData value, size_t offset)
 
 void StringIndex::do_update_ref(StringData value, size_t row_ndx, size_t new_row_ndx, size_t offset)
 {
+    m_array->invalidate_prefix_path();
     Allocator& alloc = m_array->get_alloc();
     Array values(alloc);
     get_child(*m_array, 0, values);
@@ -22,6 +22,7 @@
 #include <cstring>
 #include <memory>
 #include <array>
+#include <vector>
 
 #include <realm/array.hpp>
 #include <realm/column_fwd.hpp>
@@ -79,7 +80,28 @@ public:
     FindRes index_string_find_all_no_copy(StringData value, ColumnBase* column, InternalFindResult& result) const;
     size_t index_string_count(StringData value, ColumnBase* column) const;
 
+    /// Must be called whenever the index tree below this node may have been
+    /// modified, to discard the cached single key path (see find_start_node()).
+    void invalidate_prefix_path() const noexcept
+    {
+        m_prefix_root = 0;
+    }
+
 private:
+    // Keys along the chain of single key sub-indexes hanging off the root, and
+    // the node at the end of that chain. Long strings sharing a common prefix
+    // (URLs, UUID-like ids) produce such a chain with one level per 4 bytes of
+    // prefix, and each level costs two dependent memory loads during a lookup.
+    // The chain is only cached in the accessor, so the file format is not
+    // affected. `m_prefix_root` is the ref of the root the path was computed
+    // for, or 0 if it needs to be recomputed.
+    mutable std::vector<int32_t> m_prefix_keys;
+    mutable ref_type m_prefix_node = 0;
+    mutable ref_type m_prefix_root = 0;
+
+    void update_prefix_path() const;
+    const char* find_start_node(StringData value, size_t& stringoffset) const;
+
     template <IndexMethod>
     size_t from_list(StringData value, InternalFindResult& result_ref, const IntegerColumn& rows,
                      ColumnBase* column) const;
@@ -135,6 +157,12 @@ public:
     template <class T>
     void insert(size_t row_ndx, util::Optional<T> value, size_t num_rows, bool is_append);
 
+    /// Insert `num_rows` consecutive rows, the values of which are given by
+    /// `get_value(i)`. The indexes of the rows that follow are adjusted once,
+    /// rather than once per inserted row.
+    template <class F>
+    void insert_rows(size_t row_ndx, size_t num_rows, bool is_append, F get_value);
+
     template <class T>
     void set(size_t row_ndx, T new_value);
     template <class T>
@@ -143,6 +171,11 @@ public:
     template <class T>
     void erase(size_t row_ndx, bool is_last);
 
+    /// Erase the specified rows, which must be in ascending order and unique,
+    /// and still be present in the target column. The indexes of the
+    /// remaining rows are adjusted in a single pass afterwards.
+    void erase_rows(const std::vector<size_t>& row_ndxs);
+
     template <class T>
     size_t find_first(T value) const;
     template <class T>
@@ -219,9 +252,14 @@ private:
                                           const IntegerColumnIterator& lower);
     key_type get_last_key() const;
 
-    /// Add small signed \a diff to all elements that are greater than, or equal
-    /// to \a min_row_ndx.
-    void adjust_row_indexes(size_t min_row_ndx, int diff);
+    /// Add signed \a diff to all elements that are greater than, or equal to
+    /// \a min_row_ndx. Used with a diff of the number of rows by insertion of
+    /// rows, and with -1 by removal of a row.
+    void adjust_row_indexes(size_t min_row_ndx, int64_t diff);
+
+    /// Subtract from every element the number of \a erased_row_ndxs that are
+    /// less than it.
+    void adjust_row_indexes(const std::vector<size_t>& erased_row_ndxs);
 
     struct NodeChange {
         size_t ref1;
@@ -464,6 +502,20 @@ void StringIndex::insert(size_t row_ndx, util::Optional<T> value, size_t num_row
     }
 }
 
+template <class F>
+void StringIndex::insert_rows(size_t row_ndx, size_t num_rows, bool is_append, F get_value)
+{
+    REALM_ASSERT_3(row_ndx, !=, npos);
+
+    if (!is_append && num_rows != 0)
+        adjust_row_indexes(row_ndx, int64_t(num_rows)); // Throws
+
+    for (size_t i = 0; i < num_rows; ++i) {
+        bool no_adjust = true; // Already done above
+        insert(row_ndx + i, get_value(i), 1, no_adjust); // Throws
+    }
+}
+
 template <class T>
 void StringIndex::set(size_t row_ndx, T new_value)
 {
@@ -563,6 +615,7 @@ void StringIndex::update_ref(T value, size_t old_row_ndx, size_t new_row_ndx)
 
 inline void StringIndex::destroy() noexcept
 {
+    m_array->invalidate_prefix_path();
     return m_array->destroy_deep();
 }
 
@@ -573,6 +626,7 @@ inline bool StringIndex::is_attached() const noexcept
 
 inline void StringIndex::refresh_accessor_tree(size_t, const Spec&)
 {
+    m_array->invalidate_prefix_path();
     m_array->init_from_parent();
 }
 
@@ -598,6 +652,7 @@ inline void StringIndex::set_ndx_in_parent(size_t ndx_in_parent) noexcept
 
 inline void StringIndex::update_from_parent(size_t old_baseline) noexcept
 {
+    m_array->invalidate_prefix_path();
     m_array->update_from_parent(old_baseline);
 }
 
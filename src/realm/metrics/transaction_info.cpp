@@ -28,6 +28,8 @@ TransactionInfo::TransactionInfo(TransactionInfo::TransactionType type)
     , m_type(type)
     , m_num_versions(0)
     , m_num_decrypted_pages(0)
+    , m_translation_cache_hits(0)
+    , m_translation_cache_misses(0)
 {
 #if REALM_METRICS
     if (m_type == write_transaction) {
@@ -92,14 +94,27 @@ size_t TransactionInfo::get_num_decrypted_pages() const
     return m_num_decrypted_pages;
 }
 
+uint_fast64_t TransactionInfo::get_translation_cache_hits() const
+{
+    return m_translation_cache_hits;
+}
+
+uint_fast64_t TransactionInfo::get_translation_cache_misses() const
+{
+    return m_translation_cache_misses;
+}
+
 void TransactionInfo::update_stats(size_t disk_size, size_t free_space, size_t total_objects,
-                                   size_t available_versions, size_t num_decrypted_pages)
+                                   size_t available_versions, size_t num_decrypted_pages,
+                                   uint_fast64_t translation_cache_hits, uint_fast64_t translation_cache_misses)
 {
     m_realm_disk_size = disk_size;
     m_realm_free_space = free_space;
     m_total_objects = total_objects;
     m_num_versions = available_versions;
     m_num_decrypted_pages = num_decrypted_pages;
+    m_translation_cache_hits = translation_cache_hits;
+    m_translation_cache_misses = translation_cache_misses;
 }
 
 void TransactionInfo::finish_timer()
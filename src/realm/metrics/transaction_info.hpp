@@ -50,6 +50,9 @@ public:
     size_t get_total_objects() const;
     size_t get_num_available_versions() const;
     size_t get_num_decrypted_pages() const;
+    // lookups in the ref translation cache of the Realm during the transaction
+    uint_fast64_t get_translation_cache_hits() const;
+    uint_fast64_t get_translation_cache_misses() const;
 
 private:
     MetricTimerResult m_transaction_time;
@@ -63,10 +66,13 @@ private:
     TransactionType m_type;
     size_t m_num_versions;
     size_t m_num_decrypted_pages;
+    uint_fast64_t m_translation_cache_hits;
+    uint_fast64_t m_translation_cache_misses;
 
     friend class Metrics;
     void update_stats(size_t disk_size, size_t free_space, size_t total_objects, size_t available_versions,
-                      size_t num_decrypted_pages);
+                      size_t num_decrypted_pages, uint_fast64_t translation_cache_hits,
+                      uint_fast64_t translation_cache_misses);
     void finish_timer();
 };
 
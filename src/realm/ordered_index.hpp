@@ -0,0 +1,209 @@
+/*************************************************************************
+ *
+ * Copyright 2016 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#ifndef REALM_ORDERED_INDEX_HPP
+#define REALM_ORDERED_INDEX_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <realm/array.hpp>
+#include <realm/query_conditions.hpp>
+
+namespace realm {
+
+/// An ordered index holds the non-null values of an integer or timestamp
+/// column together with their row indexes, sorted by value. The search index
+/// of such columns is keyed by the byte representation of the values, so it
+/// can only answer equality lookups. The query engine uses the ordered index to
+/// answer range conditions (`>`, `>=`, `<`, `<=`, and pairs of them such as
+/// `between`) on columns that have a search index.
+///
+/// Like zone maps, ordered indexes are not part of the file format. They are
+/// held by the column accessor and tagged with the version of the table that
+/// owns the column (Table::get_version_counter()), so any modification of the
+/// table makes them stale. Since building one means sorting the whole column,
+/// queries never build or rebuild them. They only use an ordered index built
+/// by Table::build_ordered_index() while it is current, and release it once it
+/// has become stale.
+template <class T>
+class OrderedIndex {
+public:
+    bool is_valid_for(uint_fast64_t version) const noexcept
+    {
+        return m_valid && m_version == version;
+    }
+
+    /// `get(row_ndx, value)` must store the value of the specified row in
+    /// `value` and return true, or return false if the value is null.
+    template <class Get>
+    void build(size_t size, Get get, uint_fast64_t version);
+
+    /// Positions [begin, end) in the sorted sequence of values.
+    struct Range {
+        size_t begin;
+        size_t end;
+    };
+
+    Range all() const noexcept
+    {
+        return {0, m_entries.size()};
+    }
+
+    /// Restricts `range` to the values which satisfy `Cond` with `value` as
+    /// right-hand side. Conditions that are not supported leave it unchanged.
+    template <class Cond>
+    void narrow(Range& range, T value) const;
+
+    /// Stores the rows holding the values in `range` in `rows`, in ascending
+    /// order.
+    void get_rows(Range range, std::vector<size_t>& rows) const;
+
+    /// True for the conditions supported by narrow().
+    template <class Cond>
+    static constexpr bool supports() noexcept
+    {
+        return std::is_same<Cond, Greater>::value || std::is_same<Cond, GreaterEqual>::value ||
+               std::is_same<Cond, Less>::value || std::is_same<Cond, LessEqual>::value;
+    }
+
+private:
+    struct Entry {
+        T value;
+        size_t row_ndx;
+    };
+
+    std::vector<Entry> m_entries;
+    uint_fast64_t m_version = 0;
+    bool m_valid = false;
+};
+
+/// Range conditions are only answered through an ordered index if at most one
+/// in this many rows match. Scanning the leaves is cheaper otherwise.
+const size_t ordered_index_selectivity = 16;
+
+/// The rows found through an ordered index on behalf of a query node, which
+/// asks for the first match in a sequence of mostly increasing row ranges. The
+/// rows are only collected when they are first asked for, so a node that turns
+/// out not to need them does not pay for sorting them.
+template <class T>
+class OrderedIndexMatches {
+public:
+    using Range = typename OrderedIndex<T>::Range;
+
+    void reset(const OrderedIndex<T>* index = nullptr, Range range = Range{0, 0})
+    {
+        m_index = index;
+        m_range = range;
+        m_rows.clear();
+        m_next = 0;
+        m_loaded = false;
+    }
+
+    bool is_active() const noexcept
+    {
+        return m_index != nullptr;
+    }
+
+    /// Returns the first matching row in [start, end), or npos.
+    size_t find_first(size_t start, size_t end)
+    {
+        if (!m_loaded) {
+            m_index->get_rows(m_range, m_rows); // Throws
+            m_loaded = true;
+        }
+        auto begin = m_rows.begin();
+        if (m_next > 0 && m_rows[m_next - 1] < start)
+            begin += m_next;
+        auto i = std::lower_bound(begin, m_rows.end(), start);
+        m_next = i - m_rows.begin();
+        if (i == m_rows.end() || *i >= end)
+            return npos;
+        ++m_next;
+        return *i;
+    }
+
+private:
+    const OrderedIndex<T>* m_index = nullptr;
+    Range m_range{0, 0};
+    std::vector<size_t> m_rows;
+    size_t m_next = 0;
+    bool m_loaded = false;
+};
+
+
+// Implementation:
+
+template <class T>
+template <class Get>
+void OrderedIndex<T>::build(size_t size, Get get, uint_fast64_t version)
+{
+    m_valid = false;
+    m_entries.clear();
+    m_entries.reserve(size); // Throws
+
+    for (size_t row_ndx = 0; row_ndx < size; ++row_ndx) {
+        Entry entry;
+        if (get(row_ndx, entry.value)) {
+            entry.row_ndx = row_ndx;
+            m_entries.push_back(entry);
+        }
+    }
+    std::sort(m_entries.begin(), m_entries.end(),
+              [](const Entry& a, const Entry& b) { return a.value < b.value; });
+
+    m_version = version;
+    m_valid = true;
+}
+
+template <class T>
+template <class Cond>
+void OrderedIndex<T>::narrow(Range& range, T value) const
+{
+    auto below = [](const Entry& entry, const T& v) { return entry.value < v; };
+    auto above = [](const T& v, const Entry& entry) { return v < entry.value; };
+    auto begin = m_entries.begin() + range.begin;
+    auto end = m_entries.begin() + range.end;
+    if (std::is_same<Cond, Greater>::value)
+        begin = std::upper_bound(begin, end, value, above);
+    else if (std::is_same<Cond, GreaterEqual>::value)
+        begin = std::lower_bound(begin, end, value, below);
+    else if (std::is_same<Cond, Less>::value)
+        end = std::lower_bound(begin, end, value, below);
+    else if (std::is_same<Cond, LessEqual>::value)
+        end = std::upper_bound(begin, end, value, above);
+    range.begin = begin - m_entries.begin();
+    range.end = end - m_entries.begin();
+}
+
+template <class T>
+void OrderedIndex<T>::get_rows(Range range, std::vector<size_t>& rows) const
+{
+    rows.clear();
+    rows.reserve(range.end - range.begin); // Throws
+    for (size_t i = range.begin; i < range.end; ++i)
+        rows.push_back(m_entries[i].row_ndx);
+    std::sort(rows.begin(), rows.end());
+}
+
+} // namespace realm
+
+#endif // REALM_ORDERED_INDEX_HPP
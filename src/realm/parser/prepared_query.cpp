@@ -0,0 +1,101 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2018 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "prepared_query.hpp"
+
+namespace realm {
+namespace parser {
+
+PreparedQuery::PreparedQuery(StringData query)
+: m_query(query)
+, m_result(parse(query))
+{
+}
+
+Query PreparedQuery::bind(ConstTableRef table, query_builder::Arguments& arguments, KeyPathMapping mapping) const
+{
+    Query query = table->where();
+    query_builder::apply_predicate(query, m_result.predicate, arguments, std::move(mapping));
+    return query;
+}
+
+void PreparedQuery::bind_ordering(DescriptorOrdering& ordering, ConstTableRef table,
+                                  query_builder::Arguments& arguments, KeyPathMapping mapping) const
+{
+    query_builder::apply_ordering(ordering, table, m_result.ordering, arguments, std::move(mapping));
+}
+
+
+QueryCache::QueryCache(size_t capacity)
+: m_capacity(capacity)
+{
+    REALM_ASSERT(capacity > 0);
+}
+
+std::shared_ptr<const PreparedQuery> QueryCache::get(StringData query)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_index.find(query);
+        if (it != m_index.end()) {
+            m_entries.splice(m_entries.begin(), m_entries, it->second);
+            return *it->second;
+        }
+    }
+
+    // Parse without holding the lock, so that a query which is seen for the
+    // first time does not hold up threads which find theirs in the cache
+    auto prepared = std::make_shared<const PreparedQuery>(query); // Throws
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_index.find(query);
+    if (it != m_index.end()) {
+        // another thread prepared the same query in the meantime
+        m_entries.splice(m_entries.begin(), m_entries, it->second);
+        return *it->second;
+    }
+    m_entries.push_front(prepared); // Throws
+    try {
+        m_index.emplace(StringData(prepared->get_query_string()), m_entries.begin()); // Throws
+    }
+    catch (...) {
+        m_entries.pop_front();
+        throw;
+    }
+    if (m_entries.size() > m_capacity) {
+        m_index.erase(StringData(m_entries.back()->get_query_string()));
+        m_entries.pop_back();
+    }
+    return prepared;
+}
+
+size_t QueryCache::size() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_entries.size();
+}
+
+void QueryCache::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_index.clear();
+    m_entries.clear();
+}
+
+} // namespace parser
+} // namespace realm
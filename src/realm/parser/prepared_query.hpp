@@ -0,0 +1,103 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2018 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#ifndef REALM_PREPARED_QUERY_HPP
+#define REALM_PREPARED_QUERY_HPP
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include <realm/parser/keypath_mapping.hpp>
+#include <realm/parser/parser.hpp>
+#include <realm/parser/query_builder.hpp>
+#include <realm/query.hpp>
+#include <realm/string_data.hpp>
+
+namespace realm {
+namespace parser {
+
+// A query string which has been parsed once, and can then be applied to any
+// number of queries with different arguments ($0, $1, ...). The parsed
+// predicate refers to properties by name only, so it does not depend on the
+// schema: key paths are resolved against the table every time it is bound,
+// which also means that a prepared query stays valid across schema changes.
+class PreparedQuery {
+public:
+    // throws if the query string is not a valid predicate
+    explicit PreparedQuery(StringData query);
+
+    const std::string& get_query_string() const noexcept
+    {
+        return m_query;
+    }
+    const ParserResult& get_result() const noexcept
+    {
+        return m_result;
+    }
+
+    // builds a new query on `table` from the predicate and the arguments
+    Query bind(ConstTableRef table, query_builder::Arguments& arguments,
+               KeyPathMapping mapping = KeyPathMapping()) const;
+    // adds the sort, distinct, limit and include clauses of the query string
+    void bind_ordering(DescriptorOrdering& ordering, ConstTableRef table, query_builder::Arguments& arguments,
+                       KeyPathMapping mapping = KeyPathMapping()) const;
+
+private:
+    std::string m_query;
+    ParserResult m_result;
+};
+
+// A thread safe cache of prepared queries keyed by their query string. When
+// it is full, the least recently used query is evicted. Applications which
+// issue the same predicates with different arguments over and over only pay
+// for parsing them the first time.
+class QueryCache {
+public:
+    static const size_t default_capacity = 256;
+
+    explicit QueryCache(size_t capacity = default_capacity);
+
+    // returns the prepared query for the query string, parsing it if it is not
+    // in the cache already, throws if the query string is not valid
+    std::shared_ptr<const PreparedQuery> get(StringData query);
+
+    size_t size() const;
+    size_t capacity() const noexcept
+    {
+        return m_capacity;
+    }
+    void clear();
+
+private:
+    using EntryList = std::list<std::shared_ptr<const PreparedQuery>>;
+
+    const size_t m_capacity;
+    mutable std::mutex m_mutex;
+    // most recently used first
+    EntryList m_entries;
+    // the keys refer to the query strings owned by the prepared queries
+    std::unordered_map<StringData, EntryList::iterator> m_index;
+};
+
+} // namespace parser
+} // namespace realm
+
+#endif // REALM_PREPARED_QUERY_HPP
@@ -26,8 +26,14 @@
 #include <realm/query_engine.hpp>
 #include <realm/query_expression.hpp>
 #include <realm/table_view.hpp>
+#include <realm/util/scope_exit.hpp>
+#include <realm/util/thread.hpp>
 
 #include <algorithm>
+#include <atomic>
+#include <exception>
+#include <system_error>
+#include <thread>
 
 
 using namespace realm;
@@ -100,6 +106,7 @@ Query::Query(const Query& source)
     , m_groups(source.m_groups)
     , m_current_descriptor(source.m_current_descriptor)
     , m_table(source.m_table)
+    , m_threadcount(source.m_threadcount)
 {
     if (source.m_owned_source_table_view) {
         m_owned_source_table_view = source.m_owned_source_table_view->clone();
@@ -121,6 +128,7 @@ Query& Query::operator=(const Query& source)
     if (this != &source) {
         m_groups = source.m_groups;
         m_table = source.m_table;
+        m_threadcount = source.m_threadcount;
 
         if (source.m_owned_source_table_view) {
             m_owned_source_table_view = source.m_owned_source_table_view->clone();
@@ -153,6 +161,7 @@ Query::~Query() noexcept = default;
 Query::Query(Query& source, HandoverPatch& patch, MutableSourcePayload mode)
     : m_table(TableRef())
     , m_source_link_view(LinkViewRef())
+    , m_threadcount(source.m_threadcount)
 {
     Table::generate_patch(source.m_table.get(), patch.m_table);
     if (source.m_source_table_view) {
@@ -173,6 +182,7 @@ Query::Query(Query& source, HandoverPatch& patch, MutableSourcePayload mode)
 Query::Query(const Query& source, HandoverPatch& patch, ConstSourcePayload mode)
     : m_table(TableRef())
     , m_source_link_view(LinkViewRef())
+    , m_threadcount(source.m_threadcount)
 {
     Table::generate_patch(source.m_table.get(), patch.m_table);
     if (source.m_source_table_view) {
@@ -801,6 +811,15 @@ Query& Query::less(size_t column_ndx, Timestamp value)
     return add_condition<Less>(column_ndx, value);
 }
 
+Query& Query::between(size_t column_ndx, Timestamp from, Timestamp to)
+{
+    group();
+    greater_equal(column_ndx, from);
+    less_equal(column_ndx, to);
+    end_group();
+    return *this;
+}
+
 // ------------- size
 Query& Query::size_equal(size_t column_ndx, int64_t value)
 {
@@ -887,6 +906,133 @@ Query& Query::like(size_t column_ndx, StringData value, bool case_sensitive)
 }
 
 
+// Parallel execution =======================================================================
+
+namespace {
+
+// Number of rows searched by one parallel query task. Large enough to amortize
+// the per-task overhead, small enough to balance the load between threads when
+// matches are unevenly distributed.
+const size_t parallel_chunk_size = 4 * REALM_MAX_BPNODE_SIZE;
+
+size_t num_parallel_chunks(size_t start, size_t end)
+{
+    return (end - start + parallel_chunk_size - 1) / parallel_chunk_size;
+}
+
+} // anonymous namespace
+
+size_t Query::parallel_thread_count(size_t start, size_t end, size_t limit, unsigned int threadcount) const
+{
+    if (threadcount == 0)
+        threadcount = std::thread::hardware_concurrency();
+    if (threadcount <= 1 || m_view || limit != size_t(-1) || !has_conditions() || end <= start)
+        return 1;
+    if (!root_node()->is_parallelizable())
+        return 1;
+    return std::min(size_t(threadcount), num_parallel_chunks(start, end));
+}
+
+// Calls `func(query, chunk_ndx, chunk_start, chunk_end)` once for every chunk
+// of the range [start, end) from `num_threads` threads (the calling thread
+// included), each of which uses its own clone of this query. Chunks are handed
+// out in increasing order from a shared counter. The first exception thrown by
+// `func` is rethrown once all threads have finished.
+template <class F>
+void Query::run_parallel(size_t start, size_t end, size_t num_threads, F func) const
+{
+    // Clones are created, initialized and destroyed by the calling thread only,
+    // since the table accessors are not thread-safe.
+    std::vector<std::unique_ptr<Query>> clones;
+    clones.reserve(num_threads);
+    for (size_t i = 0; i < num_threads; ++i) {
+        clones.emplace_back(new Query(*this));                 // Throws
+        clones.back()->init();                                 // Throws
+        clones.back()->root_node()->prepare_parallel_search(); // Throws
+    }
+
+    const size_t num_chunks = num_parallel_chunks(start, end);
+    std::atomic<size_t> next_chunk(0);
+    std::exception_ptr error;
+    util::Mutex error_mutex;
+
+    auto work = [&](const Query& query) noexcept {
+        try {
+            for (;;) {
+                size_t chunk_ndx = next_chunk.fetch_add(1, std::memory_order_relaxed);
+                if (chunk_ndx >= num_chunks)
+                    break;
+                size_t chunk_start = start + chunk_ndx * parallel_chunk_size;
+                size_t chunk_end = std::min(end, chunk_start + parallel_chunk_size);
+                func(query, chunk_ndx, chunk_start, chunk_end); // Throws
+            }
+        }
+        catch (...) {
+            util::LockGuard lock(error_mutex);
+            if (!error)
+                error = std::current_exception();
+            next_chunk = num_chunks;
+        }
+    };
+
+    std::vector<util::Thread> threads(num_threads - 1);
+    for (size_t i = 0; i < threads.size(); ++i) {
+        const Query& query = *clones[i + 1];
+        try {
+            threads[i].start([&work, &query] { work(query); });
+        }
+        catch (std::system_error&) {
+            // Continue with the threads that could be started
+            break;
+        }
+    }
+    work(*clones[0]);
+    for (auto& thread : threads) {
+        if (thread.joinable())
+            thread.join();
+    }
+
+    if (error)
+        std::rethrow_exception(error);
+}
+
+void Query::find_all_parallel(TableViewBase& ret, size_t start, size_t end, size_t num_threads) const
+{
+    Allocator& alloc = Allocator::get_default();
+    std::vector<ref_type> results(num_parallel_chunks(start, end), 0);
+    auto destroy_results = util::make_scope_exit([&]() noexcept {
+        for (ref_type ref : results) {
+            if (ref)
+                Array::destroy_deep(ref, alloc);
+        }
+    });
+
+    run_parallel(start, end, num_threads, [&](const Query& query, size_t chunk_ndx, size_t chunk_start,
+                                              size_t chunk_end) {
+        IntegerColumn matches(alloc, IntegerColumn::create(alloc)); // Throws
+        try {
+            QueryState<int64_t> st;
+            st.init(act_FindAll, &matches, size_t(-1));
+            query.aggregate_internal(act_FindAll, ColumnTypeTraits<int64_t>::id, false, query.root_node(), &st,
+                                     chunk_start, chunk_end, nullptr); // Throws
+        }
+        catch (...) {
+            matches.destroy();
+            throw;
+        }
+        results[chunk_ndx] = matches.get_ref();
+    });
+
+    // Chunks are merged in table order
+    IntegerColumn& refs = ret.m_row_indexes;
+    for (ref_type ref : results) {
+        IntegerColumn matches(alloc, ref);
+        for (size_t i = 0, n = matches.size(); i < n; ++i)
+            refs.add(matches.get(i)); // Throws
+    }
+}
+
+
 // Aggregates =================================================================================
 
 size_t Query::peek_tablerow(size_t tablerow) const
@@ -937,7 +1083,34 @@ R Query::aggregate(R (ColType::*aggregateMethod)(size_t start, size_t end, size_
 
         SequentialGetter<ColType> source_column(*m_table, column_ndx);
 
-        if (!m_view) {
+        size_t num_threads = parallel_thread_count(start, end, limit, m_threadcount);
+        if (num_threads > 1) {
+            std::vector<QueryState<R>> states(num_parallel_chunks(start, end));
+            run_parallel(start, end, num_threads, [&](const Query& query, size_t chunk_ndx, size_t chunk_start,
+                                                      size_t chunk_end) {
+                QueryState<R>& chunk_st = states[chunk_ndx];
+                chunk_st.init(action, nullptr, size_t(-1));
+                SequentialGetter<ColType> chunk_source_column(*query.m_table, column_ndx);
+                query.aggregate_internal(action, ColumnTypeTraits<T>::id, ColType::nullable, query.root_node(),
+                                         &chunk_st, chunk_start, chunk_end, &chunk_source_column); // Throws
+            });
+
+            // Merge in table order, so that min/max report the first row holding the extreme value, as they
+            // do when executed serially
+            for (const QueryState<R>& chunk_st : states) {
+                if (action == act_Sum) {
+                    st.m_state += chunk_st.m_state;
+                }
+                else if (chunk_st.m_match_count > 0 &&
+                         (st.m_match_count == 0 || (action == act_Max ? chunk_st.m_state > st.m_state
+                                                                      : chunk_st.m_state < st.m_state))) {
+                    st.m_state = chunk_st.m_state;
+                    st.m_minmax_index = chunk_st.m_minmax_index;
+                }
+                st.m_match_count += chunk_st.m_match_count;
+            }
+        }
+        else if (!m_view) {
             aggregate_internal(action, ColumnTypeTraits<T>::id, ColType::nullable, root_node(), &st, start, end,
                                &source_column);
         }
@@ -1384,6 +1557,11 @@ void Query::find_all(TableViewBase& ret, size_t begin, size_t end, size_t limit)
             }
         }
         else {
+            size_t num_threads = parallel_thread_count(begin, end, limit, m_threadcount);
+            if (num_threads > 1) {
+                find_all_parallel(ret, begin, end, num_threads);
+                return;
+            }
             QueryState<int64_t> st;
             st.init(act_FindAll, &ret.m_row_indexes, limit);
             aggregate_internal(act_FindAll, ColumnTypeTraits<int64_t>::id, false, root_node(), &st, begin, end,
@@ -1433,6 +1611,19 @@ size_t Query::do_count(size_t start, size_t end, size_t limit) const
         }
     }
     else {
+        size_t num_threads = parallel_thread_count(start, end, limit, m_threadcount);
+        if (num_threads > 1) {
+            std::atomic<size_t> total(0);
+            run_parallel(start, end, num_threads, [&](const Query& query, size_t, size_t chunk_start,
+                                                      size_t chunk_end) {
+                QueryState<int64_t> st;
+                st.init(act_Count, nullptr, size_t(-1));
+                query.aggregate_internal(act_Count, ColumnTypeTraits<int64_t>::id, false, query.root_node(), &st,
+                                         chunk_start, chunk_end, nullptr); // Throws
+                total += size_t(st.m_state);
+            });
+            return total;
+        }
         QueryState<int64_t> st;
         st.init(act_Count, nullptr, limit);
         aggregate_internal(act_Count, ColumnTypeTraits<int64_t>::id, false, root_node(), &st, start, end, nullptr);
@@ -1527,136 +1718,22 @@ size_t Query::remove()
     return rows;
 }
 
-#if REALM_MULTITHREAD_QUERY
-TableView Query::find_all_multi(size_t start, size_t end)
+Query& Query::set_threads(unsigned int threadcount)
 {
-    static_cast<void>(start);
-    static_cast<void>(end);
-
-    // Initialization
-    init();
-    ts.next_job = start;
-    ts.end_job = end;
-    ts.done_job = 0;
-    ts.count = 0;
-    ts.table = &table;
-    ts.node = first[0];
-
-    // Signal all threads to start
-    pthread_mutex_unlock(&ts.jobs_mutex);
-    pthread_cond_broadcast(&ts.jobs_cond);
-
-    // Wait until all threads have completed
-    pthread_mutex_lock(&ts.completed_mutex);
-    while (ts.done_job < ts.end_job)
-        pthread_cond_wait(&ts.completed_cond, &ts.completed_mutex);
-    pthread_mutex_lock(&ts.jobs_mutex);
-    pthread_mutex_unlock(&ts.completed_mutex);
-
-    TableView tv(*m_table);
-
-    // Sort search results because user expects ascending order
-    sort(ts.chunks.begin(), ts.chunks.end(), &Query::comp);
-    for (size_t i = 0; i < ts.chunks.size(); ++i) {
-        const size_t from = ts.chunks[i].m_root_node;
-        const size_t upto = (i == ts.chunks.size() - 1) ? size_t(-1) : ts.chunks[i + 1].m_root_node;
-        size_t first = ts.chunks[i].second;
-
-        while (first < ts.results.size() && ts.results[first] < upto && ts.results[first] >= from) {
-            tv.get_ref_column().add(ts.results[first]);
-            ++first;
-        }
-    }
-
-    return move(tv);
-}
-
-int Query::set_threads(unsigned int threadcount)
-{
-#if defined(_WIN32) || defined(__WIN32__) || defined(_WIN64)
-    pthread_win32_process_attach_np();
-#endif
-    pthread_mutex_init(&ts.result_mutex, nullptr);
-    pthread_cond_init(&ts.completed_cond, nullptr);
-    pthread_mutex_init(&ts.jobs_mutex, nullptr);
-    pthread_mutex_init(&ts.completed_mutex, nullptr);
-    pthread_cond_init(&ts.jobs_cond, nullptr);
-
-    pthread_mutex_lock(&ts.jobs_mutex);
-
-    for (size_t i = 0; i < m_threadcount; ++i)
-        pthread_detach(threads[i]);
-
-    for (size_t i = 0; i < threadcount; ++i) {
-        int r = pthread_create(&threads[i], nullptr, query_thread, (void*)&ts);
-        if (r != 0)
-            REALM_ASSERT(false); // todo
-    }
     m_threadcount = threadcount;
-    return 0;
+    return *this;
 }
 
-
-void* Query::query_thread(void* arg)
+TableView Query::find_all_multi(size_t start, size_t end)
 {
-    static_cast<void>(arg);
-    thread_state* ts = static_cast<thread_state*>(arg);
-
-    std::vector<size_t> res;
-    std::vector<pair<size_t, size_t>> chunks;
-
-    for (;;) {
-        // Main waiting loop that waits for a query to start
-        pthread_mutex_lock(&ts->jobs_mutex);
-        while (ts->next_job == ts->end_job)
-            pthread_cond_wait(&ts->jobs_cond, &ts->jobs_mutex);
-        pthread_mutex_unlock(&ts->jobs_mutex);
-
-        for (;;) {
-            // Pick a job
-            pthread_mutex_lock(&ts->jobs_mutex);
-            if (ts->next_job == ts->end_job)
-                break;
-            const size_t chunk = min(ts->end_job - ts->next_job, thread_chunk_size);
-            const size_t mine = ts->next_job;
-            ts->next_job += chunk;
-            size_t r = mine - 1;
-            const size_t end = mine + chunk;
-
-            pthread_mutex_unlock(&ts->jobs_mutex);
-
-            // Execute job
-            for (;;) {
-                r = ts->node->find_first(r + 1, end);
-                if (r == end)
-                    break;
-                res.push_back(r);
-            }
-
-            // Append result in common queue shared by all threads.
-            pthread_mutex_lock(&ts->result_mutex);
-            ts->done_job += chunk;
-            if (res.size() > 0) {
-                ts->chunks.push_back(std::pair<size_t, size_t>(mine, ts->results.size()));
-                ts->count += res.size();
-                for (size_t i = 0; i < res.size(); i++) {
-                    ts->results.push_back(res[i]);
-                }
-                res.clear();
-            }
-            pthread_mutex_unlock(&ts->result_mutex);
-
-            // Signal main thread that we might have compleeted
-            pthread_mutex_lock(&ts->completed_mutex);
-            pthread_cond_signal(&ts->completed_cond);
-            pthread_mutex_unlock(&ts->completed_mutex);
-        }
-    }
-    return 0;
+    // The view keeps its own copy of the query, so that it is also re-run in
+    // parallel when synchronized.
+    Query query(*this);
+    if (m_threadcount <= 1)
+        query.set_threads(0);
+    return query.find_all(start, end);
 }
 
-#endif // REALM_MULTITHREADQUERY
-
 std::string Query::validate()
 {
     if (!m_groups.size())
@@ -1697,6 +1774,12 @@ void Query::init() const
         root->init();
         std::vector<ParentNode*> v;
         root->gather_children(v);
+
+        // Estimates only matter when there is a choice of conditions
+        if (v.size() > 1) {
+            for (ParentNode* node : v)
+                node->estimate_cost();
+        }
     }
 }
 
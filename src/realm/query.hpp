@@ -26,14 +26,6 @@
 #include <string>
 #include <vector>
 
-#define REALM_MULTITHREAD_QUERY 0
-
-#if REALM_MULTITHREAD_QUERY
-// FIXME: Use our C++ thread abstraction API since it provides a much
-// higher level of encapsulation and safety.
-#include <pthread.h>
-#endif
-
 #include <realm/views.hpp>
 #include <realm/table_ref.hpp>
 #include <realm/binary_data.hpp>
@@ -177,6 +169,7 @@ public:
     Query& greater_equal(size_t column_ndx, Timestamp value);
     Query& less_equal(size_t column_ndx, Timestamp value);
     Query& less(size_t column_ndx, Timestamp value);
+    Query& between(size_t column_ndx, Timestamp from, Timestamp to);
 
     // Conditions: size
     Query& size_equal(size_t column_ndx, int64_t value);
@@ -322,12 +315,25 @@ public:
     // Deletion
     size_t remove();
 
-#if REALM_MULTITHREAD_QUERY
     // Multi-threading
+    //
+    // When the thread count is greater than one, find_all(), count() and the
+    // aggregate functions split the searched row range into chunks which are
+    // searched concurrently by clones of the query, and then merge the
+    // partial results in table order. This only happens for queries which are
+    // not restricted by a view or a limit, and whose conditions are all safe
+    // to evaluate concurrently (queries involving links or subtables are
+    // always executed by the calling thread). A thread count of zero selects
+    // the number of hardware threads. The default is one.
+    Query& set_threads(unsigned int threadcount);
+    unsigned int get_threads() const noexcept
+    {
+        return m_threadcount;
+    }
+
+    // Same as find_all(), but uses all hardware threads if no thread count
+    // greater than one has been set with set_threads().
     TableView find_all_multi(size_t start = 0, size_t end = size_t(-1));
-    ConstTableView find_all_multi(size_t start = 0, size_t end = size_t(-1)) const;
-    int set_threads(unsigned int threadcount);
-#endif
 
     const TableRef& get_table()
     {
@@ -427,6 +433,11 @@ private:
 
     void find_all(TableViewBase& tv, size_t start = 0, size_t end = size_t(-1), size_t limit = size_t(-1)) const;
     size_t do_count(size_t start = 0, size_t end = size_t(-1), size_t limit = size_t(-1)) const;
+
+    size_t parallel_thread_count(size_t start, size_t end, size_t limit, unsigned int threadcount) const;
+    template <class F>
+    void run_parallel(size_t start, size_t end, size_t num_threads, F func) const;
+    void find_all_parallel(TableViewBase& tv, size_t start, size_t end, size_t num_threads) const;
     void delete_nodes() noexcept;
 
     bool has_conditions() const
@@ -464,6 +475,8 @@ private:
     LinkViewRef m_source_link_view;               // link views are refcounted and shared.
     TableViewBase* m_source_table_view = nullptr; // table views are not refcounted, and not owned by the query.
     std::unique_ptr<TableViewBase> m_owned_source_table_view; // <--- except when indicated here
+
+    unsigned int m_threadcount = 1;
 };
 
 // Implementation:
@@ -29,6 +29,12 @@ size_t ParentNode::find_first(size_t start, size_t end)
     size_t current_cond = 0;
     size_t nb_cond_to_test = sz;
 
+    // Start with the condition expected to skip the most rows
+    for (size_t c = 1; c < sz; c++) {
+        if (m_children[c]->cost() < m_children[current_cond]->cost())
+            current_cond = c;
+    }
+
     while (REALM_LIKELY(start < end)) {
         size_t m = m_children[current_cond]->find_first_local(start, end);
 
@@ -219,6 +225,8 @@ void StringNodeEqualBase::init()
         if (m_index_matches) {
             m_index_getter.reset(new SequentialGetter<IntegerColumn>(m_index_matches.get()));
         }
+        size_t num_matches = m_index_matches ? m_results_end - m_results_start : 0;
+        m_dD = m_condition_column->size() / (num_matches + 1.0);
     }
     else if (m_column_type != col_type_String) {
         REALM_ASSERT_DEBUG(dynamic_cast<const StringEnumColumn*>(m_condition_column));
@@ -326,6 +334,36 @@ void StringNode<Equal>::_search_index_init()
     }
 }
 
+void StringNode<Equal>::estimate_cost()
+{
+    // The matches found through the index have been counted by init()
+    if (m_condition_column->has_search_index())
+        return;
+
+    // Enumerated strings are estimated by their keys
+    uint_fast64_t change_count = m_table->get_local_change_count();
+    auto estimate = [&](StringData value) {
+        if (m_column_type == col_type_StringEnum) {
+            auto column = static_cast<const StringEnumColumn*>(m_condition_column);
+            size_t key_ndx = column->get_key_ndx(value);
+            if (key_ndx == not_found)
+                return 0.0;
+            return column->get_statistics(change_count)->estimate<Equal>(int64_t(key_ndx), false);
+        }
+        auto column = static_cast<const StringColumn*>(m_condition_column);
+        return column->get_statistics(change_count)->estimate<Equal>(value, value.is_null());
+    };
+
+    if (m_needles.empty()) {
+        set_estimated_matches(estimate(m_value ? StringData(*m_value) : StringData()));
+        return;
+    }
+    double fraction = 0;
+    for (StringData needle : m_needles)
+        fraction += estimate(needle);
+    set_estimated_matches(std::min(fraction, 1.0));
+}
+
 void StringNode<Equal>::consume_condition(StringNode<Equal>* other)
 {
     // If a search index is present, don't try to combine conditions since index search is most likely faster.
@@ -663,6 +701,12 @@ void ExpressionNode::verify_column() const
     m_expression->verify_column();
 }
 
+void ExpressionNode::init()
+{
+    ParentNode::init();
+    m_expression->init();
+}
+
 size_t ExpressionNode::find_first_local(size_t start, size_t end)
 {
     return m_expression->find_first(start, end);
@@ -691,6 +735,9 @@ size_t TimestampNode<Greater>::find_first_local(size_t start, size_t end)
 {
     REALM_ASSERT(this->m_table);
 
+    if (m_index_matches.is_active())
+        return m_index_matches.find_first(start, end);
+
     if (this->m_value.is_null()) {
         return not_found;
     }
@@ -725,6 +772,9 @@ size_t TimestampNode<Less>::find_first_local(size_t start, size_t end)
 {
     REALM_ASSERT(this->m_table);
 
+    if (m_index_matches.is_active())
+        return m_index_matches.find_first(start, end);
+
     if (this->m_value.is_null()) {
         return not_found;
     }
@@ -759,6 +809,9 @@ size_t TimestampNode<GreaterEqual>::find_first_local(size_t start, size_t end)
 {
     REALM_ASSERT(this->m_table);
 
+    if (m_index_matches.is_active())
+        return m_index_matches.find_first(start, end);
+
     while (start < end) {
         size_t ret = this->find_first_local_seconds<GreaterEqual>(start, end);
 
@@ -793,6 +846,9 @@ size_t TimestampNode<LessEqual>::find_first_local(size_t start, size_t end)
 {
     REALM_ASSERT(this->m_table);
 
+    if (m_index_matches.is_active())
+        return m_index_matches.find_first(start, end);
+
     while (start < end) {
         size_t ret = this->find_first_local_seconds<LessEqual>(start, end);
 
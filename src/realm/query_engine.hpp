@@ -138,6 +138,10 @@ const size_t bestdist = 512;
 // value can spent too much time in a bad node (with high match frequency). Too low value gives inaccurate statistics.
 const size_t probe_matches = 4;
 
+// Equality conditions on integer columns with a search index are only answered through the index if at most one in
+// this many rows match. Copying the matches out of the index is slower than scanning the column otherwise.
+const size_t search_index_selectivity = 64;
+
 const size_t bitwidth_time_unit = 64;
 
 typedef bool (*CallbackDummy)(int64_t);
@@ -182,6 +186,15 @@ public:
         m_column_action_specializer = nullptr;
     }
 
+    // Refines the initial m_dD of this condition from statistics about the
+    // values of its column (see ColumnStatistics), so that the most selective
+    // condition is searched first. Called after init() if there is more than
+    // one condition to choose from, as building the statistics reads a sample
+    // of the column.
+    virtual void estimate_cost()
+    {
+    }
+
     void set_table(const Table& table)
     {
         if (&table == m_table)
@@ -270,6 +283,34 @@ public:
 
     virtual void verify_column() const = 0;
 
+    // True if this node and all nodes chained after it only read their columns through accessors which are
+    // safe to use from several threads at once, so that clones of the node tree may search disjoint row
+    // ranges concurrently (see Query::set_threads()).
+    bool is_parallelizable() const
+    {
+        return is_parallelizable_local() && (!m_child || m_child->is_parallelizable());
+    }
+
+    virtual bool is_parallelizable_local() const
+    {
+        return false;
+    }
+
+    // Builds what this node and the nodes chained after it would otherwise
+    // build lazily while searching, such as zone maps. Called from a single
+    // thread on each clone of a query before the clones search concurrently,
+    // since building them modifies the shared column accessors.
+    void prepare_parallel_search()
+    {
+        prepare_parallel_search_local(); // Throws
+        if (m_child)
+            m_child->prepare_parallel_search(); // Throws
+    }
+
+    virtual void prepare_parallel_search_local()
+    {
+    }
+
     virtual std::string describe(util::serializer::SerialisationState&) const
     {
         return "";
@@ -303,6 +344,16 @@ public:
 
 protected:
     typedef bool (ParentNode::*Column_action_specialized)(QueryStateBase*, SequentialGetterBase*, size_t);
+
+    // Sets m_dD from an estimated fraction of the rows matching this
+    // condition, unless the estimate is negative (unknown)
+    void set_estimated_matches(double fraction)
+    {
+        size_t size = m_table->size();
+        if (fraction >= 0 && size > 0)
+            m_dD = size / (fraction * size + 1.0);
+    }
+
     Column_action_specialized m_column_action_specializer;
     ConstTableRef m_table;
     std::string error_code;
@@ -585,9 +636,11 @@ protected:
     using LeafType = typename ColType::LeafType;
     using LeafInfo = typename ColType::LeafInfo;
 
+    template <class TConditionFunction>
     size_t aggregate_local_impl(QueryStateBase* st, size_t start, size_t end, size_t local_limit,
-                                SequentialGetterBase* source_column, int c)
+                                SequentialGetterBase* source_column)
     {
+        constexpr int c = TConditionFunction::condition;
         REALM_ASSERT(m_children.size() > 0);
         m_local_matches = 0;
         m_local_limit = local_limit;
@@ -599,6 +652,9 @@ protected:
         // column only, with no references to other columns:
         bool fastmode = should_run_in_fastmode(source_column);
         for (size_t s = start; s < end;) {
+            s = skip_leaves<TConditionFunction>(s, end);
+            if (s == end)
+                break;
             cache_leaf(s);
 
             size_t end_in_leaf;
@@ -667,6 +723,11 @@ protected:
         do_verify_column(m_condition_column);
     }
 
+    bool is_parallelizable_local() const override
+    {
+        return true;
+    }
+
     void init() override
     {
         ColumnNodeBase::init();
@@ -678,6 +739,92 @@ protected:
         m_leaf_end = 0;
         m_array_ptr.reset(); // Explicitly destroy the old one first, because we're reusing the memory.
         m_array_ptr.reset(new (&m_leaf_cache_storage) LeafType(m_table->get_alloc()));
+
+        m_zones.reset();
+    }
+
+    void prepare_parallel_search_local() override
+    {
+        m_zones.load([this] { return get_zone_map(); }); // Throws
+    }
+
+    // Selective range conditions on an indexed column are answered by the
+    // ordered index of the column instead of scanning it, if that index is
+    // current. A stale one is not rebuilt here (see OrderedIndex).
+    template <class TConditionFunction>
+    void init_index()
+    {
+        m_index_matches.reset();
+        m_index_counted = false;
+        util::Optional<int64_t> value = m_value;
+        if (!OrderedIndex<int64_t>::supports<TConditionFunction>() || !value ||
+            !m_condition_column->has_search_index())
+            return;
+
+        auto index = m_condition_column->get_current_ordered_index(m_table->get_version_counter());
+        if (!index)
+            return;
+        auto range = index->all();
+        index->template narrow<TConditionFunction>(range, *value);
+
+        // Only the rows satisfying all the conditions on this column need to be
+        // found. Those conditions are then cheaper to check row by row.
+        for (ParentNode* node = m_child.get(); node; node = node->m_child.get()) {
+            auto other = dynamic_cast<ThisType*>(node);
+            if (other && other->m_condition_column == m_condition_column &&
+                other->narrow_index_range(*index, range)) {
+                other->m_index_matches.reset();
+                other->m_dT = _impl::CostHeuristic<ColType>::dT();
+                other->m_dD = _impl::CostHeuristic<ColType>::dD();
+            }
+        }
+
+        // The number of matches is known exactly whether or not they are found
+        // through the index
+        size_t size = m_condition_column->size();
+        size_t num_matches = range.end - range.begin;
+        m_dD = size / (num_matches + 1.0);
+        m_index_counted = true;
+        if (num_matches <= size / ordered_index_selectivity) {
+            m_index_matches.reset(index, range);
+            m_dT = 0.0;
+        }
+    }
+
+    // Estimates the number of matches of conditions whose matches have not
+    // been counted through the ordered index by init_index()
+    template <class TConditionFunction>
+    void estimate_cost_from_statistics()
+    {
+        if (m_index_counted)
+            return;
+
+        util::Optional<int64_t> value = m_value;
+        auto statistics = m_condition_column->get_statistics(m_table->get_local_change_count());
+        set_estimated_matches(statistics->template estimate<TConditionFunction>(value.value_or(0), !value));
+    }
+
+    // Restricts `range` to the values of the ordered index of the condition
+    // column which satisfy the condition of this node. Returns false if the
+    // condition cannot be expressed as a range.
+    virtual bool narrow_index_range(const OrderedIndex<int64_t>&, OrderedIndex<int64_t>::Range&) const
+    {
+        return false;
+    }
+
+    // Returns the first row in [s, end) which is not in a leaf that is known
+    // to contain no matches, or `end` if there is no such row.
+    template <class TConditionFunction>
+    size_t skip_leaves(size_t s, size_t end)
+    {
+        util::Optional<int64_t> value = m_value;
+        return m_zones.template next<TConditionFunction>(s, end, value.value_or(0), !value,
+                                                         [this] { return get_zone_map(); }); // Throws
+    }
+
+    const typename ColType::ZoneMapType* get_zone_map() const
+    {
+        return m_condition_column->get_zone_map(m_table->get_version_counter()); // Throws
     }
 
     void get_leaf(const ColType& col, size_t ndx)
@@ -721,6 +868,13 @@ protected:
     size_t m_leaf_end = 0;
     size_t m_local_end;
 
+    // Leaf summaries of the condition column
+    ZoneMapCursor<int64_t> m_zones;
+
+    // Rows matching a selective range condition on an indexed column
+    OrderedIndexMatches<int64_t> m_index_matches;
+    bool m_index_counted = false; // Whether init_index() set m_dD exactly
+
     // Aggregate optimization
     using TFind_callback_specialized = bool (ThisType::*)(size_t, size_t);
     TFind_callback_specialized m_find_callback_specialized = nullptr;
@@ -745,8 +899,32 @@ public:
     {
     }
 
+    void init() override
+    {
+        BaseType::init();
+
+        this->template init_index<TConditionFunction>();
+    }
+
+    void estimate_cost() override
+    {
+        this->template estimate_cost_from_statistics<TConditionFunction>();
+    }
+
+    bool narrow_index_range(const OrderedIndex<int64_t>& index, OrderedIndex<int64_t>::Range& range) const override
+    {
+        util::Optional<int64_t> value = this->m_value;
+        if (!OrderedIndex<int64_t>::supports<TConditionFunction>() || !value)
+            return false;
+        index.template narrow<TConditionFunction>(range, *value);
+        return true;
+    }
+
     void aggregate_local_prepare(Action action, DataType col_id, bool is_nullable) override
     {
+        // The generic aggregation is used when the matches come from the ordered index
+        ParentNode::aggregate_local_prepare(action, col_id, is_nullable);
+
         this->m_fastmode_disabled = (col_id == type_Float || col_id == type_Double);
         this->m_action = action;
         this->m_find_callback_specialized = get_specialized_callback(action, col_id, is_nullable);
@@ -755,15 +933,22 @@ public:
     size_t aggregate_local(QueryStateBase* st, size_t start, size_t end, size_t local_limit,
                            SequentialGetterBase* source_column) override
     {
-        constexpr int cond = TConditionFunction::condition;
-        return this->aggregate_local_impl(st, start, end, local_limit, source_column, cond);
+        if (this->m_index_matches.is_active())
+            return ParentNode::aggregate_local(st, start, end, local_limit, source_column);
+        return this->template aggregate_local_impl<TConditionFunction>(st, start, end, local_limit, source_column);
     }
 
     size_t find_first_local(size_t start, size_t end) override
     {
         REALM_ASSERT(this->m_table);
 
+        if (this->m_index_matches.is_active())
+            return this->m_index_matches.find_first(start, end);
+
         while (start < end) {
+            start = this->template skip_leaves<TConditionFunction>(start, end);
+            if (start == end)
+                break;
 
             // Cache internal leaves
             if (start >= this->m_leaf_end || start < this->m_leaf_start) {
@@ -897,7 +1082,17 @@ public:
         BaseType::init();
         m_nb_needles = m_needles.size();
 
+        m_use_index = false;
         if (has_search_index()) {
+            // Copying many matches out of the index is slower than scanning
+            // the column, so count them first
+            size_t size = this->m_condition_column->size();
+            size_t num_matches = this->m_condition_column->count(this->m_value);
+            this->m_dD = size / (num_matches + 1.0);
+            if (num_matches > size / search_index_selectivity)
+                return;
+
+            m_use_index = true;
             if (m_result) {
                 m_result->clear();
             }
@@ -910,9 +1105,29 @@ public:
             IntegerNodeBase<ColType>::m_condition_column->find_all(*m_result, this->m_value, 0, realm::npos);
             m_index_get = 0;
             m_index_end = m_result->size();
+            this->m_dT = 0.0;
         }
     }
 
+    void estimate_cost() override
+    {
+        // The matches found through the index have been counted by init()
+        if (has_search_index())
+            return;
+        if (m_needles.empty()) {
+            this->template estimate_cost_from_statistics<Equal>();
+            return;
+        }
+
+        auto statistics = this->m_condition_column->get_statistics(this->m_table->get_local_change_count());
+        double fraction = 0;
+        for (const auto& needle : m_needles) {
+            util::Optional<int64_t> value = needle;
+            fraction += statistics->template estimate<Equal>(value.value_or(0), !value);
+        }
+        this->set_estimated_matches(std::min(fraction, 1.0));
+    }
+
     void consume_condition(IntegerNode<ColType, Equal>* other)
     {
         REALM_ASSERT(this->m_condition_column == other->m_condition_column);
@@ -932,7 +1147,7 @@ public:
     {
         REALM_ASSERT(this->m_table);
 
-        if (has_search_index()) {
+        if (m_use_index) {
             if (m_index_end == 0)
                 return not_found;
 
@@ -958,6 +1173,12 @@ public:
 
 
         while (start < end) {
+            if (!m_nb_needles) {
+                start = this->template skip_leaves<Equal>(start, end);
+                if (start == end)
+                    break;
+            }
+
             // Cache internal leaves
             this->cache_leaf(start);
 
@@ -1023,6 +1244,7 @@ public:
 private:
     std::unordered_set<TConditionValue> m_needles;
     std::unique_ptr<IntegerColumn> m_result;
+    bool m_use_index = false;
     size_t m_nb_needles = 0;
     size_t m_index_get = 0;
     size_t m_index_last_start = 0;
@@ -1092,10 +1314,28 @@ public:
         do_verify_column(m_condition_column.m_column);
     }
 
+    bool is_parallelizable_local() const override
+    {
+        return true;
+    }
+
     void init() override
     {
         ParentNode::init();
         m_dD = 100.0;
+        m_zones.reset();
+    }
+
+    void prepare_parallel_search_local() override
+    {
+        m_zones.load([this] { return get_zone_map(); }); // Throws
+    }
+
+    void estimate_cost() override
+    {
+        auto statistics = m_condition_column.m_column->get_statistics(m_table->get_local_change_count());
+        set_estimated_matches(
+            statistics->template estimate<TConditionFunction>(m_value, null::is_null_float(m_value)));
     }
 
     size_t find_first_local(size_t start, size_t end) override
@@ -1105,6 +1345,10 @@ public:
         auto find = [&](bool nullability) {
             bool m_value_nan = nullability ? null::is_null_float(m_value) : false;
             for (size_t s = start; s < end; ++s) {
+                s = m_zones.template next<TConditionFunction>(s, end, m_value, m_value_nan,
+                                                              [this] { return get_zone_map(); }); // Throws
+                if (s == end)
+                    break;
                 TConditionValue v = m_condition_column.get_next(s);
                 REALM_ASSERT(!(null::is_null_float(v) && !nullability));
                 if (cond(v, m_value, nullability ? null::is_null_float<TConditionValue>(v) : false, m_value_nan))
@@ -1146,6 +1390,12 @@ public:
 protected:
     TConditionValue m_value;
     SequentialGetter<ColType> m_condition_column;
+    ZoneMapCursor<TConditionValue> m_zones;
+
+    const ZoneMap<TConditionValue>* get_zone_map() const
+    {
+        return m_condition_column.m_column->get_zone_map(m_table->get_version_counter()); // Throws
+    }
 };
 
 template <class ColType, class TConditionFunction>
@@ -1237,6 +1487,11 @@ public:
         do_verify_column(m_condition_column);
     }
 
+    bool is_parallelizable_local() const override
+    {
+        return true;
+    }
+
     void init() override
     {
         ParentNode::init();
@@ -1315,6 +1570,11 @@ public:
         do_verify_column(m_condition_column);
     }
 
+    bool is_parallelizable_local() const override
+    {
+        return true;
+    }
+
     void init() override
     {
         ParentNode::init();
@@ -1329,9 +1589,20 @@ public:
         m_array_ptr_nanos.reset(); // Explicitly destroy the old one first, because we're reusing the memory.
         m_array_ptr_nanos.reset(new (&m_leaf_cache_storage_nanos) LeafTypeNanos(m_table->get_alloc()));
         m_condition_column_is_nullable = m_condition_column->is_nullable();
+        m_zones.reset();
+    }
+
+    void prepare_parallel_search_local() override
+    {
+        m_zones.load([this] { return get_zone_map(); }); // Throws
     }
 
 protected:
+    const ZoneMap<int64_t>* get_zone_map() const
+    {
+        return m_condition_column->get_seconds_zone_map(m_table->get_version_counter()); // Throws
+    }
+
     void get_leaf_seconds(const TimestampColumn& col, size_t ndx)
     {
         size_t ndx_in_leaf;
@@ -1401,6 +1672,67 @@ protected:
     const LeafTypeNanos* m_leaf_ptr_nanos = nullptr;
     size_t m_leaf_start_nanos = npos;
     size_t m_leaf_end_nanos = 0;
+
+    // Leaf summaries of the seconds part of the condition column
+    ZoneMapCursor<int64_t> m_zones;
+
+    // Rows matching a selective range condition on an indexed column
+    OrderedIndexMatches<Timestamp> m_index_matches;
+    bool m_index_counted = false; // Whether init_index() set m_dD exactly
+
+    // See IntegerNodeBase::init_index()
+    template <class Condition>
+    void init_index()
+    {
+        m_index_matches.reset();
+        m_index_counted = false;
+        if (!OrderedIndex<Timestamp>::supports<Condition>() || m_value.is_null() ||
+            !m_condition_column->has_search_index())
+            return;
+
+        auto index = m_condition_column->get_current_ordered_index(m_table->get_version_counter());
+        if (!index)
+            return;
+        auto range = index->all();
+        index->template narrow<Condition>(range, m_value);
+
+        for (ParentNode* node = m_child.get(); node; node = node->m_child.get()) {
+            auto other = dynamic_cast<TimestampNodeBase*>(node);
+            if (other && other->m_condition_column == m_condition_column &&
+                other->narrow_index_range(*index, range)) {
+                other->m_index_matches.reset();
+                other->m_dT = 0.0;
+                other->m_dD = 100.0;
+            }
+        }
+
+        size_t size = m_condition_column->size();
+        size_t num_matches = range.end - range.begin;
+        m_dD = size / (num_matches + 1.0);
+        m_index_counted = true;
+        if (num_matches <= size / ordered_index_selectivity) {
+            m_index_matches.reset(index, range);
+            m_dT = 0.0;
+        }
+    }
+
+    // See IntegerNodeBase::estimate_cost_from_statistics(). The estimates are
+    // based on the seconds part of the values.
+    template <class Condition>
+    void estimate_cost_from_statistics()
+    {
+        if (m_index_counted)
+            return;
+
+        auto statistics = m_condition_column->get_seconds_statistics(m_table->get_local_change_count());
+        set_estimated_matches(
+            statistics->template estimate<Condition>(m_needle_seconds.value_or(0), !m_needle_seconds));
+    }
+
+    virtual bool narrow_index_range(const OrderedIndex<Timestamp>&, OrderedIndex<Timestamp>::Range&) const
+    {
+        return false;
+    }
 };
 
 template <class TConditionFunction>
@@ -1408,10 +1740,35 @@ class TimestampNode : public TimestampNodeBase {
 public:
     using TimestampNodeBase::TimestampNodeBase;
 
+    void init() override
+    {
+        TimestampNodeBase::init();
+        init_index<TConditionFunction>();
+    }
+
+    void estimate_cost() override
+    {
+        estimate_cost_from_statistics<TConditionFunction>();
+    }
+
+    bool narrow_index_range(const OrderedIndex<Timestamp>& index,
+                            OrderedIndex<Timestamp>::Range& range) const override
+    {
+        if (!OrderedIndex<Timestamp>::supports<TConditionFunction>() || m_value.is_null())
+            return false;
+        index.template narrow<TConditionFunction>(range, m_value);
+        return true;
+    }
+
     template <class Condition>
     size_t find_first_local_seconds(size_t start, size_t end)
     {
         while (start < end) {
+            start = m_zones.template next<Condition>(start, end, m_needle_seconds.value_or(0), !m_needle_seconds,
+                                                     [this] { return get_zone_map(); }); // Throws
+            if (start == end)
+                break;
+
             // Cache internal leaves
             if (start >= this->m_leaf_end_seconds || start < this->m_leaf_start_seconds) {
                 this->get_leaf_seconds(*this->m_condition_column, start);
@@ -1494,6 +1851,11 @@ public:
         do_verify_column(m_condition_column);
     }
 
+    bool is_parallelizable_local() const override
+    {
+        return true;
+    }
+
     bool has_search_index() const
     {
         return m_condition_column->has_search_index();
@@ -1516,6 +1878,45 @@ public:
         m_leaf.reset(nullptr);
     }
 
+    // Conditions that can only be satisfied by values containing all of
+    // `trigrams` only check the candidate rows found through the trigram index
+    // of the condition column, if they are few enough
+    void init_trigram_index(const std::vector<uint32_t>& trigrams)
+    {
+        m_candidates.reset();
+        if (trigrams.empty())
+            return;
+
+        const TrigramIndex* index;
+        uint_fast64_t version = m_table->get_version_counter();
+        if (m_column_type == col_type_StringEnum)
+            index = static_cast<const StringEnumColumn*>(m_condition_column)->get_trigram_index(version, trigrams);
+        else
+            index = static_cast<const StringColumn*>(m_condition_column)->get_trigram_index(version, trigrams);
+        if (!index)
+            return;
+
+        // The number of candidates bounds the number of matches
+        size_t size = m_condition_column->size();
+        size_t num_candidates = index->count_candidates(trigrams);
+        m_dD = size / (num_candidates + 1.0);
+        if (num_candidates > size / trigram_index_selectivity)
+            return;
+        m_candidates.reset(*index, trigrams);
+        m_dT = 0.0;
+        m_dD = size / (m_candidates.size() + 1.0);
+    }
+
+    // Returns the first row in [start, end) which may satisfy the condition, or
+    // `end` if there is no such row
+    size_t next_candidate(size_t start, size_t end)
+    {
+        if (!m_candidates.is_active())
+            return start;
+        size_t s = m_candidates.find_first(start, end);
+        return s == npos ? end : s;
+    }
+
     StringNodeBase(const StringNodeBase& from, QueryNodeHandoverPatches* patches)
         : ParentNode(from, patches)
         , m_value(from.m_value)
@@ -1550,6 +1951,9 @@ protected:
     size_t m_end_s = 0;
     size_t m_leaf_start = 0;
     size_t m_leaf_end = 0;
+
+    // Rows found through the trigram index of the condition column
+    TrigramIndexCandidates m_candidates;
     
     inline StringData get_string(size_t s)
     {
@@ -1614,13 +2018,29 @@ public:
         m_dD = 100.0;
 
         StringNodeBase::init();
+
+        std::vector<uint32_t> trigrams;
+        if (m_value) {
+            StringData value = *m_value;
+            if (std::is_same<TConditionFunction, BeginsWith>::value ||
+                std::is_same<TConditionFunction, EndsWith>::value)
+                TrigramIndex::get_trigrams(value, trigrams);
+            else if (std::is_same<TConditionFunction, BeginsWithIns>::value ||
+                     std::is_same<TConditionFunction, EndsWithIns>::value)
+                TrigramIndex::get_trigrams(m_ucase, m_lcase, trigrams);
+            else if (std::is_same<TConditionFunction, Like>::value)
+                TrigramIndex::get_like_trigrams(value, value, trigrams);
+            else if (std::is_same<TConditionFunction, LikeIns>::value)
+                TrigramIndex::get_like_trigrams(m_ucase, m_lcase, trigrams);
+        }
+        init_trigram_index(trigrams);
     }
 
     size_t find_first_local(size_t start, size_t end) override
     {
         TConditionFunction cond;
 
-        for (size_t s = start; s < end; ++s) {
+        for (size_t s = next_candidate(start, end); s < end; s = next_candidate(s + 1, end)) {
             StringData t = get_string(s);
             
             if (cond(StringData(m_value), m_ucase.c_str(), m_lcase.c_str(), t))
@@ -1680,6 +2100,11 @@ public:
         m_dD = 100.0;
         
         StringNodeBase::init();
+
+        std::vector<uint32_t> trigrams;
+        if (m_value)
+            TrigramIndex::get_trigrams(*m_value, trigrams);
+        init_trigram_index(trigrams);
     }
     
     
@@ -1687,7 +2112,7 @@ public:
     {
         Contains cond;
         
-        for (size_t s = start; s < end; ++s) {
+        for (size_t s = next_candidate(start, end); s < end; s = next_candidate(s + 1, end)) {
             StringData t = get_string(s);
             
             if (cond(StringData(m_value), m_charmap, t))
@@ -1759,6 +2184,11 @@ public:
         m_dD = 100.0;
 
         StringNodeBase::init();
+
+        std::vector<uint32_t> trigrams;
+        if (m_value)
+            TrigramIndex::get_trigrams(m_ucase, m_lcase, trigrams);
+        init_trigram_index(trigrams);
     }
 
 
@@ -1766,7 +2196,7 @@ public:
     {
         ContainsIns cond;
 
-        for (size_t s = start; s < end; ++s) {
+        for (size_t s = next_candidate(start, end); s < end; s = next_candidate(s + 1, end)) {
             StringData t = get_string(s);
             // The current behaviour is to return all results when querying for a null string.
             // See comment above Query_NextGen_StringConditions on why every string including "" contains null.
@@ -1861,6 +2291,7 @@ public:
     using StringNodeEqualBase::StringNodeEqualBase;
 
     void _search_index_init() override;
+    void estimate_cost() override;
 
     void consume_condition(StringNode<Equal>* other);
 
@@ -1979,6 +2410,15 @@ public:
         }
     }
 
+    bool is_parallelizable_local() const override
+    {
+        for (auto& condition : m_conditions) {
+            if (!condition->is_parallelizable())
+                return false;
+        }
+        return true;
+    }
+
     std::string describe(util::serializer::SerialisationState& state) const override
     {
         std::string s;
@@ -2001,6 +2441,7 @@ public:
         ParentNode::init();
 
         m_dD = 10.0;
+        m_dT = 50.0;
 
         std::sort(m_conditions.begin(), m_conditions.end(),
                   [](auto& a, auto& b) { return a->m_condition_column_idx < b->m_condition_column_idx; });
@@ -2023,9 +2464,38 @@ public:
             condition->init();
             v.clear();
             condition->gather_children(v);
+            if (v.size() > 1) {
+                for (ParentNode* node : v)
+                    node->estimate_cost();
+            }
         }
     }
 
+    void estimate_cost() override
+    {
+        // Each condition matches at most as many rows as the most selective
+        // node of its AND chain, and the OR at most as many as all of them
+        // together. If every condition is searched through an index, the OR
+        // is the union of their index lookups, and only visits rows they find.
+        double fraction = 0;
+        bool indexed = true;
+        for (auto& condition : m_conditions) {
+            double dD = 0;
+            bool condition_indexed = false;
+            for (ParentNode* node : condition->m_children) {
+                if (condition->m_children.size() == 1)
+                    node->estimate_cost();
+                dD = std::max(dD, node->m_dD);
+                condition_indexed = condition_indexed || node->m_dT == 0.0;
+            }
+            fraction += 1 / dD;
+            indexed = indexed && condition_indexed;
+        }
+        m_dD = 1 / std::min(fraction, 1.0);
+        if (indexed)
+            m_dT = 0.0;
+    }
+
     size_t find_first_local(size_t start, size_t end) override
     {
         if (start >= end)
@@ -2155,6 +2625,11 @@ public:
         m_condition->verify_column();
     }
 
+    bool is_parallelizable_local() const override
+    {
+        return m_condition->is_parallelizable();
+    }
+
     void init() override
     {
         ParentNode::init();
@@ -2270,6 +2745,11 @@ public:
         do_verify_column(m_getter2.m_column, m_condition_column_idx2);
     }
 
+    bool is_parallelizable_local() const override
+    {
+        return true;
+    }
+
     virtual std::string describe(util::serializer::SerialisationState& state) const override
     {
         REALM_ASSERT(m_getter1.m_column != nullptr && m_getter2.m_column != nullptr);
@@ -2287,6 +2767,10 @@ public:
     {
         ParentNode::init();
         m_dD = 100.0;
+
+        // The leaves loaded by a previous execution may have been modified
+        m_getter1.m_leaf_start = m_getter1.m_leaf_end = 0;
+        m_getter2.m_leaf_start = m_getter2.m_leaf_end = 0;
     }
 
     size_t find_first_local(size_t start, size_t end) override
@@ -2294,12 +2778,16 @@ public:
         size_t s = start;
 
         while (s < end) {
-            if (std::is_same<TConditionValue, int64_t>::value) {
-                // For int64_t we've created an array intrinsics named compare_leafs which template expands bitwidths
-                // of boths arrays to make Get faster.
+            // The table is not modified while the query executes, so the leaves
+            // can be kept for as long as they contain the rows searched
+            if (s < m_getter1.m_leaf_start || s >= m_getter1.m_leaf_end)
                 m_getter1.cache_next(s);
+            if (s < m_getter2.m_leaf_start || s >= m_getter2.m_leaf_end)
                 m_getter2.cache_next(s);
 
+            if (std::is_same<TConditionValue, int64_t>::value) {
+                // For int64_t we've created an array intrinsics named compare_leafs which template expands bitwidths
+                // of boths arrays to make Get faster.
                 QueryState<int64_t> qs;
                 bool resume = m_getter1.m_leaf_ptr->template compare_leafs<TConditionFunction, act_ReturnFirst>(
                     m_getter2.m_leaf_ptr, s - m_getter1.m_leaf_start, m_getter1.local_end(end), 0, &qs,
@@ -2324,14 +2812,16 @@ public:
 // 475 (more bandwidth bound). Tests against SSE have not been performed; AVX may not pay off. Please benchmark
 #endif
 
-                TConditionValue v1 = m_getter1.get_next(s);
-                TConditionValue v2 = m_getter2.get_next(s);
+                size_t leaf_end = std::min(end, std::min(m_getter1.m_leaf_end, m_getter2.m_leaf_end));
                 TConditionFunction C;
 
-                if (C(v1, v2))
-                    return s;
-                else
-                    s++;
+                for (; s < leaf_end; s++) {
+                    TConditionValue v1 = m_getter1.m_leaf_ptr->get(s - m_getter1.m_leaf_start);
+                    TConditionValue v2 = m_getter2.m_leaf_ptr->get(s - m_getter2.m_leaf_start);
+
+                    if (C(v1, v2))
+                        return s;
+                }
             }
         }
         return not_found;
@@ -2374,6 +2864,7 @@ class ExpressionNode : public ParentNode {
 public:
     ExpressionNode(std::unique_ptr<Expression>);
 
+    void init() override;
     size_t find_first_local(size_t start, size_t end) override;
 
     void table_changed() override;
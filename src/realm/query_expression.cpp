@@ -20,6 +20,11 @@
 
 namespace realm {
 
+// Definitions for the in-class initialized constants, which are bound to
+// references by std::min() and std::max().
+const size_t ValueBase::chunk_size;
+const size_t ValueBase::max_batch_size;
+
 void Columns<Link>::evaluate(size_t index, ValueBase& destination)
 {
     std::vector<size_t> links = m_link_map.get_links(index);
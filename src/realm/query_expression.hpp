@@ -349,6 +349,10 @@ private:
 
 struct ValueBase {
     static const size_t chunk_size = 8;
+    // Upper bound on the number of rows evaluated at a time by
+    // Subexpr::evaluate_batch(). Larger batches amortize the virtual calls and
+    // leaf lookups of each evaluation over more rows.
+    static const size_t max_batch_size = 1024;
     virtual void export_bool(ValueBase& destination) const = 0;
     virtual void export_Timestamp(ValueBase& destination) const = 0;
     virtual void export_int(ValueBase& destination) const = 0;
@@ -378,6 +382,11 @@ public:
     {
     }
 
+    // Called before each execution of the query
+    virtual void init()
+    {
+    }
+
     virtual size_t find_first(size_t start, size_t end) const = 0;
     virtual void set_base_table(const Table* table) = 0;
     virtual void verify_column() const = 0;
@@ -435,6 +444,15 @@ public:
     }
 
     virtual void evaluate(size_t index, ValueBase& destination) = 0;
+
+    // Like evaluate(), but a subexpression that can produce the values of more
+    // than ValueBase::chunk_size rows at a time may produce up to `max_rows` of
+    // them. Subexpressions that can't just produce as many as evaluate() does.
+    virtual void evaluate_batch(size_t index, ValueBase& destination, size_t max_rows)
+    {
+        static_cast<void>(max_rows);
+        evaluate(index, destination);
+    }
 };
 
 template <typename T, typename... Args>
@@ -938,17 +956,14 @@ struct NullableVector {
 
     void init(size_t size)
     {
-        if (size == m_size)
-            return;
-
-        dealloc();
-        m_size = size;
-        if (m_size > 0) {
-            if (m_size > prealloc)
-                m_first = reinterpret_cast<t_storage*>(new t_storage[m_size]);
-            else
-                m_first = m_cache;
+        // Storage is kept when shrinking, so vectors reused for successive
+        // batches of rows are only allocated once
+        if (size > m_capacity) {
+            dealloc();
+            m_first = reinterpret_cast<t_storage*>(new t_storage[size]);
+            m_capacity = size;
         }
+        m_size = size;
     }
 
     void init(size_t size, T values)
@@ -959,16 +974,26 @@ struct NullableVector {
 
     void dealloc()
     {
-        if (m_first) {
-            if (m_size > prealloc)
-                delete[] m_first;
-            m_first = nullptr;
+        if (m_first != m_cache)
+            delete[] m_first;
+        m_first = m_cache;
+        m_capacity = prealloc;
+        m_size = 0;
+    }
+
+    bool has_null() const
+    {
+        for (size_t t = 0; t < m_size; t++) {
+            if (is_null(t))
+                return true;
         }
+        return false;
     }
 
     t_storage m_cache[prealloc];
     t_storage* m_first = &m_cache[0];
     size_t m_size = 0;
+    size_t m_capacity = prealloc;
 
     int64_t m_null = reinterpret_cast<int64_t>(&m_null); // choose magic value to represent nulls
 };
@@ -1248,6 +1273,8 @@ public:
             size_t min = std::min(left->m_values, right->m_values);
             init(false, min);
 
+            if (fun_without_nulls<TOperator, false, false>(left, right))
+                return;
             for (size_t i = 0; i < min; i++) {
                 m_storage.set(i, o(left->m_storage.get(i), right->m_storage.get(i)));
             }
@@ -1278,6 +1305,55 @@ public:
         }
     }
 
+    // Same as fun(), but one of the operands is a constant, holding a single
+    // value which is combined with each of the values of the other operand
+    template <class TOperator>
+    REALM_FORCEINLINE void fun_const(const Value* left, const Value* right, bool left_is_const)
+    {
+        OperatorOptionalAdapter<TOperator> o;
+        const Value* values = left_is_const ? right : left;
+        init(values->m_from_link_list, values->m_values);
+
+        if (left_is_const) {
+            if (fun_without_nulls<TOperator, true, false>(left, right))
+                return;
+            auto left_value = left->m_storage.get(0);
+            for (size_t i = 0; i < right->m_values; i++)
+                m_storage.set(i, o(left_value, right->m_storage.get(i)));
+        }
+        else {
+            if (fun_without_nulls<TOperator, false, true>(left, right))
+                return;
+            auto right_value = right->m_storage.get(0);
+            for (size_t i = 0; i < left->m_values; i++)
+                m_storage.set(i, o(left->m_storage.get(i), right_value));
+        }
+    }
+
+    // Computes the m_values results of fun() in a loop the compiler can
+    // vectorize. Only numbers stored as themselves are handled, and only if
+    // there are no nulls involved. Returns false if the caller must compute the
+    // results one by one.
+    template <class TOperator, bool left_is_const, bool right_is_const>
+    REALM_FORCEINLINE bool fun_without_nulls(const Value* left, const Value* right)
+    {
+        if (!realm::is_any<T, int64_t, float, double>::value)
+            return false;
+        if (left->m_storage.has_null() || right->m_storage.has_null())
+            return false;
+
+        TOperator o;
+        const auto* l = left->m_storage.m_first;
+        const auto* r = right->m_storage.m_first;
+        auto* dest = m_storage.m_first;
+        for (size_t i = 0; i < ValueBase::m_values; i++)
+            dest[i] = o(l[left_is_const ? 0 : i], r[right_is_const ? 0 : i]);
+
+        // A result that happens to equal the representation of null must be
+        // stored through NullableVector::set()
+        return !m_storage.has_null();
+    }
+
     template <class TOperator>
     REALM_FORCEINLINE void fun(const Value* value)
     {
@@ -1388,15 +1464,29 @@ public:
             REALM_ASSERT_DEBUG(false);
     }
 
-    // Given a TCond (==, !=, >, <, >=, <=) and two Value<T>, return index of first match
+    // True if neither `left` nor `right` hold any nulls. Only determined for
+    // numbers, false otherwise.
+    static bool without_nulls(const Value<T>* left, const Value<T>* right)
+    {
+        return std::is_arithmetic<T>::value && !left->m_storage.has_null() && !right->m_storage.has_null();
+    }
+
+    // Given a TCond (==, !=, >, <, >=, <=) and two Value<T>, return index of first match at or after `begin`.
+    // `no_nulls` is the result of without_nulls(left, right), if known.
     template <class TCond>
-    REALM_FORCEINLINE static size_t compare_const(const Value<T>* left, Value<T>* right)
+    REALM_FORCEINLINE static size_t compare_const(const Value<T>* left, Value<T>* right, size_t begin = 0,
+                                                  bool no_nulls = false)
     {
         TCond c;
 
         size_t sz = right->ValueBase::m_values;
         bool left_is_null = left->m_storage.is_null(0);
-        for (size_t m = 0; m < sz; m++) {
+        if (no_nulls && !right->m_from_link_list) {
+            auto left_value = left->m_storage[0];
+            return find_first_match(begin, sz,
+                                    [&](size_t m) { return c(left_value, right->m_storage[m], false, false); });
+        }
+        for (size_t m = begin; m < sz; m++) {
             if (c(left->m_storage[0], right->m_storage[m], left_is_null, right->m_storage.is_null(m)))
                 return right->m_from_link_list ? 0 : m;
         }
@@ -1405,14 +1495,19 @@ public:
     }
 
     template <class TCond>
-    REALM_FORCEINLINE static size_t compare(Value<T>* left, Value<T>* right)
+    REALM_FORCEINLINE static size_t compare(Value<T>* left, Value<T>* right, size_t begin = 0, bool no_nulls = false)
     {
         TCond c;
 
         if (!left->m_from_link_list && !right->m_from_link_list) {
             // Compare values one-by-one (one value is one row; no link lists)
             size_t min = minimum(left->ValueBase::m_values, right->ValueBase::m_values);
-            for (size_t m = 0; m < min; m++) {
+            if (no_nulls) {
+                return find_first_match(begin, min, [&](size_t m) {
+                    return c(left->m_storage[m], right->m_storage[m], false, false);
+                });
+            }
+            for (size_t m = begin; m < min; m++) {
 
                 if (c(left->m_storage[m], right->m_storage[m], left->m_storage.is_null(m),
                       right->m_storage.is_null(m)))
@@ -1452,6 +1547,28 @@ public:
     }
 
     NullableVector<T> m_storage;
+
+private:
+    // Returns the first of [begin, end) for which `match` is true, or
+    // not_found. The rows are tested a chunk at a time without branching on the
+    // individual results, so the compiler can vectorize the tests.
+    template <class Match>
+    REALM_FORCEINLINE static size_t find_first_match(size_t begin, size_t end, Match match)
+    {
+        size_t m = begin;
+        for (; m + ValueBase::chunk_size <= end; m += ValueBase::chunk_size) {
+            bool any = false;
+            for (size_t i = 0; i < ValueBase::chunk_size; i++)
+                any |= match(m + i);
+            if (any)
+                break;
+        }
+        for (; m < end; m++) {
+            if (match(m))
+                return m;
+        }
+        return not_found;
+    }
 };
 
 class ConstantStringValue : public Value<StringData> {
@@ -3110,6 +3227,8 @@ template <class T>
 class Columns : public Subexpr2<T> {
 public:
     using ColType = typename ColumnTypeTraits<T>::column_type;
+    using NullableColType = typename std::conditional<std::is_same<typename ColType::value_type, int64_t>::value,
+                                                      IntNullColumn, ColType>::type;
 
     Columns(size_t column, const Table* table, std::vector<size_t> links = {})
         : m_link_map(table, std::move(links))
@@ -3202,7 +3321,7 @@ public:
     }
 
     template <class ColType2 = ColType>
-    void evaluate_internal(size_t index, ValueBase& destination)
+    void evaluate_internal(size_t index, ValueBase& destination, size_t max_rows)
     {
         REALM_ASSERT_DEBUG(m_sg.get());
         REALM_ASSERT_DEBUG(dynamic_cast<SequentialGetter<ColType2>*>(m_sg.get()));
@@ -3233,33 +3352,45 @@ public:
             // Not a Link column
             // make sequential getter load the respective leaf to access data at column row 'index'
             sgc->cache_next(index);
-            size_t colsize = sgc->m_column->size();
 
-            // Now load `ValueBase::chunk_size` rows from from the leaf into m_storage. If it's an integer
-            // leaf, then it contains the method get_chunk() which copies these values in a super fast way (first
-            // case of the `if` below. Otherwise, copy the values one by one in a for-loop (the `else` case).
-            if (std::is_same<U, int64_t>::value && index + ValueBase::chunk_size <= sgc->m_leaf_end) {
-                Value<int64_t> v(false, ValueBase::chunk_size);
+            // Now load up to `max_rows` rows, but at least `ValueBase::chunk_size` rows like evaluate() does,
+            // from the leaf into m_batch. The batch ends at the end of the leaf, so the values can be read
+            // from the leaf directly.
+            size_t rows = std::max(max_rows, ValueBase::chunk_size);
+            if (rows > sgc->m_leaf_end - index)
+                rows = sgc->m_leaf_end - index;
+            m_batch.init(false, rows);
+            load_leaf(*sgc->m_leaf_ptr, index - sgc->m_leaf_start, m_batch.m_storage);
 
-                // If you want to modify 'default_size' then update Array::get_chunk()
-                REALM_ASSERT_3(ValueBase::chunk_size, ==, 8);
+            destination.import(m_batch);
+        }
+    }
 
-                auto sgc_2 = static_cast<SequentialGetter<ColType>*>(m_sg.get());
-                sgc_2->m_leaf_ptr->get_chunk(index - sgc->m_leaf_start, v.m_storage.m_first);
+    // Copy `storage.m_size` values of `leaf`, starting at `ndx_in_leaf`, into `storage`
+    template <class L, class S>
+    static void load_leaf(const L& leaf, size_t ndx_in_leaf, NullableVector<S>& storage)
+    {
+        for (size_t t = 0; t < storage.m_size; t++)
+            storage.set(t, leaf.get(ndx_in_leaf + t));
+    }
 
-                destination.import(v);
-            }
-            else {
-                size_t rows = colsize - index;
-                if (rows > ValueBase::chunk_size)
-                    rows = ValueBase::chunk_size;
-                Value<typename util::RemoveOptional<U>::type> v(false, rows);
+    // Integer leaves contain the method get_chunk() which copies `ValueBase::chunk_size` values in a super fast
+    // way
+    static void load_leaf(const ArrayInteger& leaf, size_t ndx_in_leaf, NullableVector<int64_t>& storage)
+    {
+        // If you want to modify 'default_size' then update Array::get_chunk()
+        REALM_ASSERT_3(ValueBase::chunk_size, ==, 8);
 
-                for (size_t t = 0; t < rows; t++)
-                    v.m_storage.set(t, sgc->get_next(index + t));
+        size_t t = 0;
+        for (; t + ValueBase::chunk_size <= storage.m_size; t += ValueBase::chunk_size)
+            leaf.get_chunk(ndx_in_leaf + t, storage.m_first + t);
+        for (; t < storage.m_size; t++)
+            storage.m_first[t] = leaf.get(ndx_in_leaf + t);
 
-                destination.import(v);
-            }
+        // A value that happens to equal the representation of null must be stored through set()
+        if (REALM_UNLIKELY(storage.has_null())) {
+            for (t = 0; t < storage.m_size; t++)
+                storage.set(t, leaf.get(ndx_in_leaf + t));
         }
     }
 
@@ -3270,12 +3401,17 @@ public:
 
     // Load values from Column into destination
     void evaluate(size_t index, ValueBase& destination) override
+    {
+        evaluate_batch(index, destination, ValueBase::chunk_size);
+    }
+
+    void evaluate_batch(size_t index, ValueBase& destination, size_t max_rows) override
     {
         if (m_nullable && std::is_same<typename ColType::value_type, int64_t>::value) {
-            evaluate_internal<IntNullColumn>(index, destination);
+            evaluate_internal<NullableColType>(index, destination, max_rows);
         }
         else {
-            evaluate_internal<ColType>(index, destination);
+            evaluate_internal<ColType>(index, destination, max_rows);
         }
     }
 
@@ -3317,6 +3453,9 @@ private:
     // or oclumn. Call init() to update it or use a constructor that takes table + column index as argument.
     bool m_nullable = false;
 
+    // Values of the rows loaded by the last evaluation
+    Value<typename util::RemoveOptional<typename ColType::value_type>::type> m_batch;
+
     const ColumnBase& get_column_base() const noexcept
     {
         if (m_nullable && std::is_same<int64_t, T>::value)
@@ -3737,11 +3876,14 @@ public:
     // destination = operator(left)
     void evaluate(size_t index, ValueBase& destination) override
     {
-        Value<T> result;
-        Value<T> left;
-        m_left->evaluate(index, left);
-        result.template fun<oper>(&left);
-        destination.import(result);
+        evaluate_batch(index, destination, ValueBase::chunk_size);
+    }
+
+    void evaluate_batch(size_t index, ValueBase& destination, size_t max_rows) override
+    {
+        m_left->evaluate_batch(index, m_left_value, max_rows);
+        m_result.template fun<oper>(&m_left_value);
+        destination.import(m_result);
     }
 
     virtual std::string description(util::serializer::SerialisationState& state) const override
@@ -3765,6 +3907,10 @@ public:
 private:
     typedef typename oper::type T;
     std::unique_ptr<TLeft> m_left;
+
+    // Operand and result values of the last evaluation
+    Value<T> m_left_value;
+    Value<T> m_result;
 };
 
 
@@ -3775,12 +3921,14 @@ public:
         : m_left(std::move(left))
         , m_right(std::move(right))
     {
+        init_constants();
     }
 
     Operator(const Operator& other, QueryNodeHandoverPatches* patches)
         : m_left(other.m_left->clone(patches))
         , m_right(other.m_right->clone(patches))
     {
+        init_constants();
     }
 
     Operator& operator=(const Operator& other)
@@ -3788,6 +3936,7 @@ public:
         if (this != &other) {
             m_left = other.m_left->clone();
             m_right = other.m_right->clone();
+            init_constants();
         }
         return *this;
     }
@@ -3826,13 +3975,27 @@ public:
     // destination = operator(left, right)
     void evaluate(size_t index, ValueBase& destination) override
     {
-        Value<T> result;
-        Value<T> left;
-        Value<T> right;
-        m_left->evaluate(index, left);
-        m_right->evaluate(index, right);
-        result.template fun<oper>(&left, &right);
-        destination.import(result);
+        evaluate_batch(index, destination, ValueBase::chunk_size);
+    }
+
+    void evaluate_batch(size_t index, ValueBase& destination, size_t max_rows) override
+    {
+        // A constant operand is combined with each of the values of the other
+        // operand, so it doesn't limit the number of rows evaluated at a time
+        if (m_left_is_const) {
+            m_right->evaluate_batch(index, m_right_value, max_rows);
+            m_result.template fun_const<oper>(&m_left_value, &m_right_value, true);
+        }
+        else if (m_right_is_const) {
+            m_left->evaluate_batch(index, m_left_value, max_rows);
+            m_result.template fun_const<oper>(&m_left_value, &m_right_value, false);
+        }
+        else {
+            m_left->evaluate_batch(index, m_left_value, max_rows);
+            m_right->evaluate_batch(index, m_right_value, max_rows);
+            m_result.template fun<oper>(&m_left_value, &m_right_value);
+        }
+        destination.import(m_result);
     }
 
     virtual std::string description(util::serializer::SerialisationState& state) const override
@@ -3863,6 +4026,24 @@ private:
     typedef typename oper::type T;
     std::unique_ptr<TLeft> m_left;
     std::unique_ptr<TRight> m_right;
+
+    // Operand values of the last evaluation, or the value of a constant
+    // operand, which is only evaluated once
+    bool m_left_is_const = false;
+    bool m_right_is_const = false;
+    Value<T> m_left_value;
+    Value<T> m_right_value;
+    Value<T> m_result;
+
+    void init_constants()
+    {
+        m_left_is_const = m_left->has_constant_evaluation();
+        if (m_left_is_const)
+            m_left->evaluate(-1 /*unused*/, m_left_value);
+        m_right_is_const = m_right->has_constant_evaluation();
+        if (m_right_is_const)
+            m_right->evaluate(-1 /*unused*/, m_right_value);
+    }
 };
 
 template <class TCond, class T, class TLeft, class TRight>
@@ -3905,30 +4086,40 @@ public:
         return l ? l : r;
     }
 
-    size_t find_first(size_t start, size_t end) const override
+    void init() override
     {
-        size_t match;
-
-        Value<T> left;
-        Value<T> right;
+        m_batch_start = npos;
+        m_batch_rows = 0;
+        m_batch_size = ValueBase::chunk_size;
+    }
 
-        for (; start < end;) {
-            if (m_left_is_const) {
-                m_right->evaluate(start, right);
-                match = Value<T>::template compare_const<TCond>(&m_left_value, &right);
-            }
-            else {
-                m_left->evaluate(start, left);
-                m_right->evaluate(start, right);
-                match = Value<T>::template compare<TCond>(&left, &right);
+    size_t find_first(size_t start, size_t end) const override
+    {
+        while (start < end) {
+            if (start < m_batch_start || start >= m_batch_start + m_batch_rows) {
+                // A search continuing where the previous batch ended gets a
+                // larger batch, while a search elsewhere, typically at the next
+                // match of another condition of the query, starts over with a
+                // single chunk, so a match close to `start` is found cheaply
+                if (start == m_batch_start + m_batch_rows)
+                    m_batch_size = std::min(m_batch_size * 2, ValueBase::max_batch_size);
+                else
+                    m_batch_size = ValueBase::chunk_size;
+                evaluate_batch(start, std::min(m_batch_size, end - start));
             }
 
-            if (match != not_found && match + start < end)
-                return start + match;
+            size_t begin = start - m_batch_start;
+            size_t match;
+            if (m_left_is_const)
+                match = Value<T>::template compare_const<TCond>(&m_left_value, &m_right_batch, begin,
+                                                                m_batch_without_nulls);
+            else
+                match = Value<T>::template compare<TCond>(&m_left_batch, &m_right_batch, begin,
+                                                          m_batch_without_nulls);
 
-            size_t rows =
-                (left.m_from_link_list || right.m_from_link_list) ? 1 : minimum(right.m_values, left.m_values);
-            start += rows;
+            if (match != not_found)
+                return m_batch_start + match < end ? m_batch_start + match : not_found;
+            start = m_batch_start + m_batch_rows;
         }
 
         return not_found; // no match
@@ -3979,6 +4170,33 @@ private:
     std::unique_ptr<TRight> m_right;
     bool m_left_is_const;
     Value<T> m_left_value;
+
+    // The values of the rows [m_batch_start, m_batch_start + m_batch_rows)
+    // evaluated by find_first(). They stay valid until the next execution of
+    // the query, so successive searches through the same rows reuse them.
+    mutable Value<T> m_left_batch;
+    mutable Value<T> m_right_batch;
+    mutable size_t m_batch_start = npos;
+    mutable size_t m_batch_rows = 0;
+    mutable size_t m_batch_size = ValueBase::chunk_size;
+    mutable bool m_batch_without_nulls = false;
+
+    void evaluate_batch(size_t start, size_t max_rows) const
+    {
+        m_right->evaluate_batch(start, m_right_batch, max_rows);
+        if (m_left_is_const) {
+            m_batch_rows = m_right_batch.m_from_link_list ? 1 : m_right_batch.m_values;
+            m_batch_without_nulls = Value<T>::without_nulls(&m_left_value, &m_right_batch);
+        }
+        else {
+            m_left->evaluate_batch(start, m_left_batch, max_rows);
+            m_batch_rows = (m_left_batch.m_from_link_list || m_right_batch.m_from_link_list)
+                               ? 1
+                               : minimum(m_left_batch.m_values, m_right_batch.m_values);
+            m_batch_without_nulls = Value<T>::without_nulls(&m_left_batch, &m_right_batch);
+        }
+        m_batch_start = start;
+    }
 };
 
 }
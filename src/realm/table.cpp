@@ -1603,6 +1603,89 @@ bool Table::has_search_index(size_t col_ndx) const noexcept
 }
 
 
+bool Table::has_trigram_index(size_t col_ndx) const noexcept
+{
+    // Utilize the guarantee that m_cols.size() == 0 for a detached table accessor.
+    if (REALM_UNLIKELY(col_ndx >= m_cols.size()))
+        return false;
+    switch (get_real_column_type(col_ndx)) {
+        case col_type_String:
+            return get_column_string(col_ndx).has_trigram_index();
+        case col_type_StringEnum:
+            return get_column_string_enum(col_ndx).has_trigram_index();
+        default:
+            return false;
+    }
+}
+
+
+void Table::set_trigram_index(size_t col_ndx, bool enable)
+{
+    if (REALM_UNLIKELY(!is_attached()))
+        throw LogicError(LogicError::detached_accessor);
+    if (REALM_UNLIKELY(col_ndx >= m_cols.size()))
+        throw LogicError(LogicError::column_index_out_of_range);
+
+    switch (get_real_column_type(col_ndx)) {
+        case col_type_String:
+            get_column_string(col_ndx).set_trigram_index(enable); // Throws
+            return;
+        case col_type_StringEnum:
+            get_column_string_enum(col_ndx).set_trigram_index(enable); // Throws
+            return;
+        default:
+            throw LogicError(LogicError::type_mismatch);
+    }
+}
+
+
+bool Table::has_ordered_index(size_t col_ndx) const noexcept
+{
+    // Utilize the guarantee that m_cols.size() == 0 for a detached table accessor.
+    if (REALM_UNLIKELY(col_ndx >= m_cols.size()))
+        return false;
+    uint_fast64_t version = get_version_counter();
+    switch (get_real_column_type(col_ndx)) {
+        case col_type_Int:
+            if (is_nullable(col_ndx))
+                return get_column_int_null(col_ndx).get_current_ordered_index(version);
+            return get_column(col_ndx).get_current_ordered_index(version);
+        case col_type_Timestamp:
+            return get_column_timestamp(col_ndx).get_current_ordered_index(version);
+        default:
+            return false;
+    }
+}
+
+
+void Table::build_ordered_index(size_t col_ndx)
+{
+    if (REALM_UNLIKELY(!is_attached()))
+        throw LogicError(LogicError::detached_accessor);
+    if (REALM_UNLIKELY(col_ndx >= m_cols.size()))
+        throw LogicError(LogicError::column_index_out_of_range);
+    if (REALM_UNLIKELY(!has_search_index(col_ndx)))
+        throw LogicError(LogicError::no_search_index);
+
+    uint_fast64_t version = get_version_counter();
+    switch (get_real_column_type(col_ndx)) {
+        case col_type_Int:
+            if (is_nullable(col_ndx)) {
+                get_column_int_null(col_ndx).build_ordered_index(version); // Throws
+            }
+            else {
+                get_column(col_ndx).build_ordered_index(version); // Throws
+            }
+            return;
+        case col_type_Timestamp:
+            get_column_timestamp(col_ndx).build_ordered_index(version); // Throws
+            return;
+        default:
+            throw LogicError(LogicError::type_mismatch);
+    }
+}
+
+
 void Table::rebuild_search_index(size_t current_file_format_version)
 {
     for (size_t col_ndx = 0; col_ndx < get_column_count(); col_ndx++) {
@@ -2215,6 +2298,223 @@ void Table::insert_empty_row(size_t row_ndx, size_t num_rows)
     }
 }
 
+void Table::insert_rows(size_t row_ndx, size_t num_rows, const std::vector<BulkColumn>& columns)
+{
+    if (REALM_UNLIKELY(!is_attached()))
+        throw LogicError(LogicError::detached_accessor);
+    if (REALM_UNLIKELY(row_ndx > m_size))
+        throw LogicError(LogicError::row_index_out_of_range);
+    REALM_ASSERT_DEBUG(num_rows <= std::numeric_limits<size_t>::max() - row_ndx);
+
+    size_t num_cols = m_spec->get_column_count();
+    if (REALM_UNLIKELY(num_cols == 0)) {
+        throw LogicError(LogicError::table_has_no_columns);
+    }
+
+    // Validate all the values before anything is modified
+    size_t num_public_cols = m_spec->get_public_column_count();
+    std::vector<const BulkColumn*> values(num_cols, nullptr); // Throws
+    for (const BulkColumn& column : columns) {
+        size_t col_ndx = column.get_column_index();
+        if (REALM_UNLIKELY(col_ndx >= num_public_cols))
+            throw LogicError(LogicError::column_index_out_of_range);
+        if (REALM_UNLIKELY(values[col_ndx]))
+            throw LogicError(LogicError::illegal_combination);
+        if (REALM_UNLIKELY(column.get_type() != get_column_type(col_ndx)))
+            throw LogicError(LogicError::type_mismatch);
+        bool nullable = is_nullable(col_ndx);
+        for (size_t i = 0; i < num_rows; ++i) {
+            if (REALM_UNLIKELY(!nullable && column.is_null(i)))
+                throw LogicError(LogicError::column_not_nullable);
+        }
+        if (column.get_type() == type_String) {
+            const StringData* strings = column.get_values<StringData>();
+            for (size_t i = 0; i < num_rows; ++i) {
+                if (REALM_UNLIKELY(strings[i].size() > max_string_size))
+                    throw LogicError(LogicError::string_too_big);
+            }
+        }
+        else if (column.get_type() == type_Binary) {
+            const BinaryData* binaries = column.get_values<BinaryData>();
+            for (size_t i = 0; i < num_rows; ++i) {
+                if (REALM_UNLIKELY(binaries[i].size() > ArrayBlob::max_binary_size))
+                    throw LogicError(LogicError::binary_too_big);
+            }
+        }
+        values[col_ndx] = &column;
+    }
+
+    bump_version();
+
+    for (size_t col_ndx = 0; col_ndx != num_cols; ++col_ndx) {
+        if (values[col_ndx]) {
+            do_insert_values(row_ndx, num_rows, *values[col_ndx]); // Throws
+        }
+        else {
+            ColumnBase& col = get_column_base(col_ndx);
+            bool insert_nulls = is_nullable(col_ndx);
+            col.insert_rows(row_ndx, num_rows, m_size, insert_nulls); // Throws
+        }
+    }
+    if (row_ndx < m_size)
+        adj_row_acc_insert_rows(row_ndx, num_rows);
+    m_size += num_rows;
+
+    if (Replication* repl = get_repl()) {
+        size_t num_rows_to_insert = num_rows;
+        size_t prior_num_rows = m_size - num_rows;
+        repl->insert_empty_rows(this, row_ndx, num_rows_to_insert, prior_num_rows); // Throws
+        for (const BulkColumn& column : columns)
+            replicate_values(row_ndx, num_rows, column); // Throws
+    }
+}
+
+
+void Table::do_insert_values(size_t row_ndx, size_t num_rows, const BulkColumn& column)
+{
+    size_t col_ndx = column.get_column_index();
+    bool nullable = is_nullable(col_ndx);
+    switch (get_real_column_type(col_ndx)) {
+        case col_type_Int:
+        case col_type_Bool: {
+            auto insert = [&](auto get_int) {
+                if (nullable) {
+                    auto get_value = [&](size_t i) {
+                        return column.is_null(i) ? util::Optional<int64_t>() : util::make_optional(get_int(i));
+                    };
+                    get_column_int_null(col_ndx).insert_values(row_ndx, num_rows, get_value); // Throws
+                }
+                else {
+                    get_column(col_ndx).insert_values(row_ndx, num_rows, get_int); // Throws
+                }
+            };
+            if (column.get_type() == type_Bool) {
+                const bool* bools = column.get_values<bool>();
+                insert([&](size_t i) { return int64_t(bools[i] ? 1 : 0); }); // Throws
+            }
+            else {
+                const int64_t* ints = column.get_values<int64_t>();
+                insert([&](size_t i) { return ints[i]; }); // Throws
+            }
+            return;
+        }
+        case col_type_Float: {
+            const float* floats = column.get_values<float>();
+            auto get_value = [&](size_t i) { return column.is_null(i) ? null::get_null_float<float>() : floats[i]; };
+            get_column_float(col_ndx).insert_values(row_ndx, num_rows, get_value); // Throws
+            return;
+        }
+        case col_type_Double: {
+            const double* doubles = column.get_values<double>();
+            auto get_value = [&](size_t i) {
+                return column.is_null(i) ? null::get_null_float<double>() : doubles[i];
+            };
+            get_column_double(col_ndx).insert_values(row_ndx, num_rows, get_value); // Throws
+            return;
+        }
+        case col_type_String: {
+            const StringData* strings = column.get_values<StringData>();
+            auto get_value = [&](size_t i) { return strings[i]; };
+            get_column_string(col_ndx).insert_values(row_ndx, num_rows, get_value); // Throws
+            return;
+        }
+        case col_type_StringEnum: {
+            const StringData* strings = column.get_values<StringData>();
+            auto get_value = [&](size_t i) { return strings[i]; };
+            get_column_string_enum(col_ndx).insert_values(row_ndx, num_rows, get_value); // Throws
+            return;
+        }
+        case col_type_Binary: {
+            // Binary columns have no search index, so there is nothing to be
+            // gained from inserting the values in one go
+            const BinaryData* binaries = column.get_values<BinaryData>();
+            BinaryColumn& col = get_column_binary(col_ndx);
+            for (size_t i = 0; i < num_rows; ++i)
+                col.insert(row_ndx + i, binaries[i]); // Throws
+            return;
+        }
+        case col_type_Timestamp: {
+            const Timestamp* timestamps = column.get_values<Timestamp>();
+            auto get_value = [&](size_t i) { return timestamps[i]; };
+            get_column_timestamp(col_ndx).insert_values(row_ndx, num_rows, get_value); // Throws
+            return;
+        }
+        case col_type_OldDateTime:
+        case col_type_Table:
+        case col_type_Mixed:
+        case col_type_Reserved4:
+        case col_type_Link:
+        case col_type_LinkList:
+        case col_type_BackLink:
+            break;
+    }
+    REALM_ASSERT(false);
+}
+
+
+// Records the values of a bulk insertion as individual set instructions, after
+// the instruction which inserted the rows with default values. Values that are
+// equal to the default are left out.
+void Table::replicate_values(size_t row_ndx, size_t num_rows, const BulkColumn& column)
+{
+    Replication* repl = get_repl();
+    size_t col_ndx = column.get_column_index();
+    bool nullable = is_nullable(col_ndx);
+    auto variant = _impl::instr_Set;
+    for (size_t i = 0; i < num_rows; ++i) {
+        size_t row_ndx_2 = row_ndx + i;
+        if (column.is_null(i))
+            continue; // Null is the default in nullable columns
+        switch (column.get_type()) {
+            case type_Int: {
+                int64_t value = column.get_values<int64_t>()[i];
+                if (nullable || value != 0)
+                    repl->set_int(this, col_ndx, row_ndx_2, value, variant); // Throws
+                break;
+            }
+            case type_Bool: {
+                bool value = column.get_values<bool>()[i];
+                if (nullable || value)
+                    repl->set_bool(this, col_ndx, row_ndx_2, value, variant); // Throws
+                break;
+            }
+            case type_Float: {
+                float value = column.get_values<float>()[i];
+                if (nullable || value != 0)
+                    repl->set_float(this, col_ndx, row_ndx_2, value, variant); // Throws
+                break;
+            }
+            case type_Double: {
+                double value = column.get_values<double>()[i];
+                if (nullable || value != 0)
+                    repl->set_double(this, col_ndx, row_ndx_2, value, variant); // Throws
+                break;
+            }
+            case type_String: {
+                StringData value = column.get_values<StringData>()[i];
+                if (nullable || value.size() != 0)
+                    repl->set_string(this, col_ndx, row_ndx_2, value, variant); // Throws
+                break;
+            }
+            case type_Binary: {
+                BinaryData value = column.get_values<BinaryData>()[i];
+                if (nullable || value.size() != 0)
+                    repl->set_binary(this, col_ndx, row_ndx_2, value, variant); // Throws
+                break;
+            }
+            case type_Timestamp: {
+                Timestamp value = column.get_values<Timestamp>()[i];
+                if (nullable || value != Timestamp(0, 0))
+                    repl->set_timestamp(this, col_ndx, row_ndx_2, value, variant); // Throws
+                break;
+            }
+            default:
+                REALM_ASSERT(false);
+        }
+    }
+}
+
+
 size_t Table::add_row_with_key(size_t key_col_ndx, util::Optional<int64_t> key)
 {
     size_t num_cols = m_spec->get_column_count();
@@ -2417,18 +2717,18 @@ void Table::batch_erase_rows(const IntegerColumn& row_indexes, bool is_move_last
         }
         sort(rows.begin(), rows.end());
         rows.erase(unique(rows.begin(), rows.end()), rows.end());
+        if (!is_move_last_over) {
+            bool broken_reciprocal_backlinks = false;
+            do_remove_rows(rows, broken_reciprocal_backlinks); // Throws
+            return;
+        }
         // Remove in reverse order to prevent invalidation of recorded row
         // indexes.
         auto rend = rows.rend();
         for (auto i = rows.rbegin(); i != rend; ++i) {
             size_t row_ndx = *i;
             bool broken_reciprocal_backlinks = false;
-            if (is_move_last_over) {
-                do_move_last_over(row_ndx, broken_reciprocal_backlinks); // Throws
-            }
-            else {
-                do_remove(row_ndx, broken_reciprocal_backlinks); // Throws
-            }
+            do_move_last_over(row_ndx, broken_reciprocal_backlinks); // Throws
         }
         return;
     }
@@ -2513,6 +2813,53 @@ void Table::do_remove(size_t row_ndx, bool broken_reciprocal_backlinks)
 }
 
 
+// Only called by batch_erase_rows(), for ordered removals that cannot cascade.
+//
+// Has the same effect as calling do_remove() for each of the specified rows,
+// starting with the last one, but each column is compacted in a single pass,
+// and search indexes, links and row accessors are adjusted only once. The row
+// indexes must be sorted and unique.
+void Table::do_remove_rows(const std::vector<size_t>& row_ndxs, bool broken_reciprocal_backlinks)
+{
+    if (row_ndxs.empty())
+        return;
+    REALM_ASSERT_3(row_ndxs.back(), <, m_size);
+
+    size_t num_cols = m_spec->get_column_count();
+    size_t num_public_cols = m_spec->get_public_column_count();
+
+    // See do_remove() for the reason behind this order
+    for (size_t col_ndx = num_cols; col_ndx > num_public_cols; --col_ndx) {
+        ColumnBase& col = get_column_base(col_ndx - 1);
+        size_t prior_num_rows = m_size;
+        col.batch_erase_rows(row_ndxs, prior_num_rows, broken_reciprocal_backlinks); // Throws
+    }
+
+    if (Replication* repl = get_repl()) {
+        // One instruction per row, starting with the last one, such that each
+        // row is still found at its original index. Consumers of the
+        // transaction log, such as the sync client, only accept ordered
+        // erase-rows instructions for a single row.
+        size_t prior_num_rows = m_size;
+        for (size_t i = row_ndxs.size(); i > 0; --i) {
+            size_t num_rows_to_erase = 1;
+            bool is_move_last_over = false;
+            repl->erase_rows(this, row_ndxs[i - 1], num_rows_to_erase, prior_num_rows, is_move_last_over); // Throws
+            --prior_num_rows;
+        }
+    }
+
+    for (size_t col_ndx = num_public_cols; col_ndx > 0; --col_ndx) {
+        ColumnBase& col = get_column_base(col_ndx - 1);
+        size_t prior_num_rows = m_size;
+        col.batch_erase_rows(row_ndxs, prior_num_rows, broken_reciprocal_backlinks); // Throws
+    }
+    adj_row_acc_erase_rows(row_ndxs);
+    m_size -= row_ndxs.size();
+    bump_version();
+}
+
+
 // Replication instruction 'erase-row(unordered=true)' calls this function
 // directly with broken_reciprocal_backlinks=false.
 void Table::do_move_last_over(size_t row_ndx, bool broken_reciprocal_backlinks)
@@ -4904,10 +5251,13 @@ void Table::optimize(bool enforce)
             if (info.m_has_search_index) {
                 e->install_search_index(column_i->release_search_index());
             }
+            bool has_trigram_index = column_i->has_trigram_index();
 
             // Clean up the old column
             column_i->destroy();
             delete column_i;
+
+            e->set_trigram_index(has_trigram_index); // Throws
         }
     }
 
@@ -5903,6 +6253,19 @@ void Table::adj_acc_merge_rows(size_t old_row_ndx, size_t new_row_ndx) noexcept
 }
 
 
+void Table::adj_acc_modify_rows(size_t row_ndx, size_t num_rows) noexcept
+{
+    // This function must assume no more than minimal consistency of the
+    // accessor hierarchy. This means in particular that it cannot access the
+    // underlying node structure. See AccessorConsistencyLevels.
+
+    LockGuard lock(m_accessor_mutex);
+    for (auto& view : m_views) {
+        view->adj_row_acc_modify_rows(row_ndx, num_rows);
+    }
+}
+
+
 void Table::adj_acc_move_over(size_t from_row_ndx, size_t to_row_ndx) noexcept
 {
     // This function must assume no more than minimal consistency of the
@@ -6071,6 +6434,34 @@ void Table::adj_row_acc_merge_rows(size_t old_row_ndx, size_t new_row_ndx) noexc
 }
 
 
+void Table::adj_row_acc_erase_rows(const std::vector<size_t>& row_ndxs) noexcept
+{
+    // This function must assume no more than minimal consistency of the
+    // accessor hierarchy. This means in particular that it cannot access the
+    // underlying node structure. See AccessorConsistencyLevels.
+
+    // Adjust row accessors after removal of the sorted rows `row_ndxs`
+    LockGuard lock(m_accessor_mutex);
+    RowBase* row = m_row_accessors;
+    while (row) {
+        RowBase* next = row->m_next;
+        auto i = std::lower_bound(row_ndxs.begin(), row_ndxs.end(), row->m_row_ndx);
+        if (i != row_ndxs.end() && *i == row->m_row_ndx) {
+            row->m_table.reset();
+            do_unregister_row_accessor(row);
+        }
+        else {
+            row->m_row_ndx -= size_t(i - row_ndxs.begin());
+        }
+        row = next;
+    }
+
+    // Adjust rows in tableviews after removal of rows
+    for (auto& view : m_views) {
+        view->adj_row_acc_erase_rows(row_ndxs);
+    }
+}
+
 void Table::adj_row_acc_move_over(size_t from_row_ndx, size_t to_row_ndx) noexcept
 {
     // This function must assume no more than minimal consistency of the
@@ -6104,6 +6495,15 @@ void Table::adj_insert_column(size_t col_ndx)
     // means in particular that it cannot access the underlying node
     // structure. See AccessorConsistencyLevels.
 
+    {
+        // The column indexes held by the queries of incremental views are now
+        // off, so they must fall back to rerunning their query
+        LockGuard lock(m_accessor_mutex);
+        for (auto& view : m_views) {
+            view->adj_acc_discard_changes();
+        }
+    }
+
     REALM_ASSERT(is_attached());
     bool not_degenerate = m_columns.is_attached();
     if (not_degenerate) {
@@ -6119,6 +6519,15 @@ void Table::adj_erase_column(size_t col_ndx) noexcept
     // accessor hierarchy. This means in particular that it cannot access the
     // underlying node structure. See AccessorConsistencyLevels.
 
+    {
+        // The column indexes held by the queries of incremental views are now
+        // off, so they must fall back to rerunning their query
+        LockGuard lock(m_accessor_mutex);
+        for (auto& view : m_views) {
+            view->adj_acc_discard_changes();
+        }
+    }
+
     REALM_ASSERT(is_attached());
     bool not_degenerate = m_columns.is_attached();
     if (not_degenerate) {
@@ -29,6 +29,7 @@
 #include <realm/util/features.h>
 #include <realm/util/thread.hpp>
 #include <realm/table_ref.hpp>
+#include <realm/bulk_column.hpp>
 #include <realm/link_view_fwd.hpp>
 #include <realm/row.hpp>
 #include <realm/descriptor_fwd.hpp>
@@ -255,6 +256,50 @@ public:
 
     //@}
 
+    //@{
+
+    /// set_trigram_index() enables or disables the trigram index of the
+    /// specified string column. Queries for values that contain, begin with,
+    /// end with or are like a string then find their candidate rows through it
+    /// (see TrigramIndex). has_trigram_index() returns true if, and only if the
+    /// trigram index of the specified column is enabled.
+    ///
+    /// Unlike a search index, a trigram index is held in memory by the column
+    /// accessor only. It is neither persisted nor replicated, so it has to be
+    /// enabled in every table accessor that should use it. It is carried over
+    /// by optimize().
+    ///
+    /// \param column_ndx The index of a string column of the table.
+
+    bool has_trigram_index(size_t column_ndx) const noexcept;
+    void set_trigram_index(size_t column_ndx, bool enable);
+
+    //@}
+
+    //@{
+
+    /// build_ordered_index() sorts the values of the specified integer or
+    /// timestamp column into an ordered index (see OrderedIndex). Until the
+    /// table is modified again, queries answer selective `>`, `>=`, `<` and
+    /// `<=` conditions on the column through it. has_ordered_index() returns
+    /// true if, and only if the column has an ordered index that is still
+    /// current.
+    ///
+    /// Queries never build or rebuild an ordered index themselves, because
+    /// that takes a sort of the whole column. Once the table has been
+    /// modified, either by this accessor or by another transaction, range
+    /// conditions scan the column until build_ordered_index() is called again.
+    /// Like a trigram index, an ordered index is held in memory by the column
+    /// accessor only.
+    ///
+    /// \param column_ndx The index of an integer or timestamp column of the
+    /// table. The column must have a search index.
+
+    bool has_ordered_index(size_t column_ndx) const noexcept;
+    void build_ordered_index(size_t column_ndx);
+
+    //@}
+
     //@{
     /// Get the dynamic type descriptor for this table.
     ///
@@ -391,9 +436,20 @@ public:
     /// may also cause linked rows to be cascade-removed, but in this respect,
     /// the effect is exactly as if each row had been removed individually. See
     /// Descriptor::set_link_type() for details.
+    ///
+    /// add_rows() and insert_rows() insert rows whose values are taken from
+    /// column-major buffers, one for each of the specified columns (see
+    /// BulkColumn), while the remaining columns get their default values. This
+    /// has the same effect as inserting empty rows and then setting each value
+    /// individually, but columns and search indexes are populated in bulk, and
+    /// only the values that differ from the defaults are recorded in the
+    /// transaction log. Link, link list, subtable and mixed columns cannot be
+    /// specified. add_rows() returns the index of the first added row.
 
     size_t add_empty_row(size_t num_rows = 1);
     void insert_empty_row(size_t row_ndx, size_t num_rows = 1);
+    size_t add_rows(size_t num_rows, const std::vector<BulkColumn>& columns);
+    void insert_rows(size_t row_ndx, size_t num_rows, const std::vector<BulkColumn>& columns);
     size_t add_row_with_key(size_t col_ndx, util::Optional<int64_t> key);
     size_t add_row_with_keys(size_t col_1_ndx, int64_t key1, size_t col_2_ndx, StringData key2);
     void remove(size_t row_ndx);
@@ -726,6 +782,12 @@ public:
     /// without any apparent reason.
     uint_fast64_t get_version_counter() const noexcept;
 
+    /// Returns the number of changes made to this table through its own
+    /// accessor (as opposed to changes made by other transactions). This is
+    /// used to decide when estimates derived from the contents of the table,
+    /// such as column statistics (see ColumnStatistics), are too stale.
+    uint_fast64_t get_local_change_count() const noexcept;
+
 private:
     template <class T>
     TableView find_all(size_t column_ndx, T value);
@@ -1095,9 +1157,17 @@ private:
 
     mutable uint_fast64_t m_version;
 
+    /// Incremented whenever this table is changed through its own accessor, as
+    /// opposed to changes replayed by Group::advance_transact(). Incremental
+    /// TableViews use this to detect changes they have not been told about.
+    mutable uint_fast64_t m_local_change_count = 0;
+
     void erase_row(size_t row_ndx, bool is_move_last_over);
     void batch_erase_rows(const IntegerColumn& row_indexes, bool is_move_last_over);
+    void do_insert_values(size_t row_ndx, size_t num_rows, const BulkColumn&);
+    void replicate_values(size_t row_ndx, size_t num_rows, const BulkColumn&);
     void do_remove(size_t row_ndx, bool broken_reciprocal_backlinks);
+    void do_remove_rows(const std::vector<size_t>& row_ndxs, bool broken_reciprocal_backlinks);
     void do_move_last_over(size_t row_ndx, bool broken_reciprocal_backlinks);
     void do_swap_rows(size_t row_ndx_1, size_t row_ndx_2);
     void do_move_row(size_t from_ndx, size_t to_ndx);
@@ -1481,6 +1551,11 @@ private:
     void adj_acc_move_row(size_t from_ndx, size_t to_ndx) noexcept;
     void adj_acc_merge_rows(size_t old_row_ndx, size_t new_row_ndx) noexcept;
 
+    /// Called when the value of one or more cells of the specified rows has
+    /// been changed by a replayed transaction log, so that incremental
+    /// TableViews can reevaluate their query for those rows.
+    void adj_acc_modify_rows(size_t row_ndx, size_t num_rows) noexcept;
+
     /// Adjust this table accessor and its subordinates after move_last_over()
     /// (or its inverse).
     ///
@@ -1518,6 +1593,7 @@ private:
     void adj_acc_clear_nonroot_table() noexcept;
     void adj_row_acc_insert_rows(size_t row_ndx, size_t num_rows) noexcept;
     void adj_row_acc_erase_row(size_t row_ndx) noexcept;
+    void adj_row_acc_erase_rows(const std::vector<size_t>& row_ndxs) noexcept;
     void adj_row_acc_swap_rows(size_t row_ndx_1, size_t row_ndx_2) noexcept;
     void adj_row_acc_move_row(size_t from_ndx, size_t to_ndx) noexcept;
     void adj_row_acc_merge_rows(size_t old_row_ndx, size_t new_row_ndx) noexcept;
@@ -1659,6 +1735,11 @@ inline uint_fast64_t Table::get_version_counter() const noexcept
     return observe_version();
 }
 
+inline uint_fast64_t Table::get_local_change_count() const noexcept
+{
+    return m_local_change_count;
+}
+
 inline uint64_t Table::observe_version() const noexcept
 {
     m_top.get_alloc().observe_version();
@@ -1672,6 +1753,7 @@ inline void Table::bump_version(bool bump_global) const noexcept
         // table.  recursive calls (via parent or via backlinks) must be done
         // with bump_global=false.
         m_top.get_alloc().bump_global_version();
+        ++m_local_change_count;
     }
     if (m_top.get_alloc().should_propagate_version(m_version)) {
         if (const Table* parent = get_parent_table_ptr())
@@ -2083,6 +2165,13 @@ inline size_t Table::add_empty_row(size_t num_rows)
     return row_ndx;                      // Return index of first new row
 }
 
+inline size_t Table::add_rows(size_t num_rows, const std::vector<BulkColumn>& columns)
+{
+    size_t row_ndx = m_size;
+    insert_rows(row_ndx, num_rows, columns); // Throws
+    return row_ndx;                          // Return index of first new row
+}
+
 inline ConstTableRef Table::get_subtable_tableref(size_t col_ndx, size_t row_ndx) const
 {
     return const_cast<Table*>(this)->get_subtable_tableref(col_ndx, row_ndx); // Throws
@@ -2456,6 +2545,11 @@ public:
         table.m_top.set_parent(parent, ndx_in_parent);
     }
 
+    static Array& get_top_array(Table& table) noexcept
+    {
+        return table.m_top;
+    }
+
     static void update_from_parent(Table& table, size_t old_baseline) noexcept
     {
         table.update_from_parent(old_baseline);
@@ -2671,6 +2765,11 @@ public:
         table.adj_acc_move_over(from_row_ndx, to_row_ndx);
     }
 
+    static void adj_acc_modify_rows(Table& table, size_t row_ndx, size_t num_rows) noexcept
+    {
+        table.adj_acc_modify_rows(row_ndx, num_rows);
+    }
+
     static void adj_acc_clear_root_table(Table& table) noexcept
     {
         table.adj_acc_clear_root_table();
@@ -22,7 +22,9 @@
 #include <realm/column_timestamp.hpp>
 #include <realm/column_tpl.hpp>
 #include <realm/impl/sequential_getter.hpp>
+#include <realm/query_engine.hpp>
 
+#include <algorithm>
 #include <unordered_set>
 
 using namespace realm;
@@ -50,6 +52,7 @@ TableViewBase::TableViewBase(TableViewBase& src, HandoverPatch& patch, MutableSo
     m_start = src.m_start;
     m_end = src.m_end;
     m_limit = src.m_limit;
+    m_incremental_sync = src.m_incremental_sync;
 }
 
 TableViewBase::TableViewBase(const TableViewBase& src, HandoverPatch& patch, ConstSourcePayload mode)
@@ -73,6 +76,7 @@ TableViewBase::TableViewBase(const TableViewBase& src, HandoverPatch& patch, Con
     m_start = src.m_start;
     m_end = src.m_end;
     m_limit = src.m_limit;
+    m_incremental_sync = src.m_incremental_sync;
 }
 
 void TableViewBase::apply_patch(HandoverPatch& patch, Group& group)
@@ -552,9 +556,33 @@ uint_fast64_t TableViewBase::sync_if_needed() const
 }
 
 
+void TableViewBase::set_incremental_sync(bool enable) noexcept
+{
+    m_incremental_sync = enable;
+    if (!enable) {
+        adj_acc_discard_changes();
+    }
+    else if (!m_tracking_changes && is_in_sync()) {
+        // The view is up to date, so the changes can be tracked from here
+        // rather than from the next sync
+        m_modified_rows.clear();
+        m_tracking_changes = true;
+        m_tracked_local_change_count = m_table->m_local_change_count;
+    }
+}
+
+
 void TableViewBase::adj_row_acc_insert_rows(size_t row_ndx, size_t num_rows) noexcept
 {
     m_row_indexes.adjust_ge(int_fast64_t(row_ndx), num_rows);
+
+    if (is_tracking_changes()) {
+        for (size_t& modified : m_modified_rows) {
+            if (modified >= row_ndx)
+                modified += num_rows;
+        }
+        adj_row_acc_modify_rows(row_ndx, num_rows);
+    }
 }
 
 
@@ -569,9 +597,55 @@ void TableViewBase::adj_row_acc_erase_row(size_t row_ndx) noexcept
         m_row_indexes.set(it, -1);
     }
     m_row_indexes.adjust_ge(int_fast64_t(row_ndx) + 1, -1);
+
+    if (is_tracking_changes()) {
+        m_modified_rows.erase(std::remove(m_modified_rows.begin(), m_modified_rows.end(), row_ndx),
+                              m_modified_rows.end());
+        for (size_t& modified : m_modified_rows) {
+            if (modified > row_ndx)
+                --modified;
+        }
+    }
 }
 
 
+void TableViewBase::adj_row_acc_erase_rows(const std::vector<size_t>& row_ndxs) noexcept
+{
+    // Maps a row index to the number of erased rows before it, or to npos if
+    // the row itself was erased
+    auto num_erased_before = [&](size_t row_ndx) {
+        auto it = std::lower_bound(row_ndxs.begin(), row_ndxs.end(), row_ndx);
+        if (it != row_ndxs.end() && *it == row_ndx)
+            return npos;
+        return size_t(it - row_ndxs.begin());
+    };
+
+    size_t num_rows = m_row_indexes.size();
+    for (size_t i = 0; i < num_rows; ++i) {
+        int64_t row_ndx = m_row_indexes.get(i);
+        if (row_ndx < int64_t(row_ndxs.front()))
+            continue; // Detached, or not affected
+        size_t shift = num_erased_before(size_t(row_ndx));
+        if (shift == npos) {
+            ++m_num_detached_refs;
+            m_row_indexes.set(i, -1);
+        }
+        else if (shift != 0) {
+            m_row_indexes.set(i, row_ndx - int64_t(shift));
+        }
+    }
+
+    if (is_tracking_changes()) {
+        auto out = m_modified_rows.begin();
+        for (size_t modified : m_modified_rows) {
+            size_t shift = num_erased_before(modified);
+            if (shift != npos)
+                *out++ = modified - shift;
+        }
+        m_modified_rows.erase(out, m_modified_rows.end());
+    }
+}
+
 void TableViewBase::adj_row_acc_move_over(size_t from_row_ndx, size_t to_row_ndx) noexcept
 {
     size_t it = 0;
@@ -591,6 +665,12 @@ void TableViewBase::adj_row_acc_move_over(size_t from_row_ndx, size_t to_row_ndx
             break;
         m_row_indexes.set(it, to_row_ndx);
     }
+
+    if (is_tracking_changes()) {
+        m_modified_rows.erase(std::remove(m_modified_rows.begin(), m_modified_rows.end(), to_row_ndx),
+                              m_modified_rows.end());
+        std::replace(m_modified_rows.begin(), m_modified_rows.end(), from_row_ndx, to_row_ndx);
+    }
 }
 
 
@@ -610,6 +690,15 @@ void TableViewBase::adj_row_acc_swap_rows(size_t row_ndx_1, size_t row_ndx_2) no
             it_2 = m_row_indexes.find_first(row_ndx_2, it_2);
         }
     }
+
+    if (is_tracking_changes()) {
+        for (size_t& modified : m_modified_rows) {
+            if (modified == row_ndx_1)
+                modified = row_ndx_2;
+            else if (modified == row_ndx_2)
+                modified = row_ndx_1;
+        }
+    }
 }
 
 
@@ -625,6 +714,17 @@ void TableViewBase::adj_row_acc_move_row(size_t from_row_ndx, size_t to_row_ndx)
     while ((it = m_row_indexes.find_first(from_row_ndx, it)) != not_found)
         m_row_indexes.set(it, to_row_ndx);
     m_row_indexes.adjust_ge(int_fast64_t(from_row_ndx), -1);
+
+    if (is_tracking_changes()) {
+        for (size_t& modified : m_modified_rows) {
+            if (modified >= to_row_ndx)
+                ++modified;
+            if (modified == from_row_ndx)
+                modified = to_row_ndx;
+            if (modified >= from_row_ndx)
+                --modified;
+        }
+    }
 }
 
 
@@ -633,6 +733,51 @@ void TableViewBase::adj_row_acc_clear() noexcept
     m_num_detached_refs = m_row_indexes.size();
     for (size_t i = 0, num_rows = m_row_indexes.size(); i < num_rows; ++i)
         m_row_indexes.set(i, -1);
+    m_modified_rows.clear();
+}
+
+
+void TableViewBase::adj_row_acc_modify_rows(size_t row_ndx, size_t num_rows) noexcept
+{
+    if (!is_tracking_changes())
+        return;
+
+    // Once more rows have changed than can_sync_incrementally() accepts, the
+    // query will be rerun in full anyway, so stop paying for the bookkeeping.
+    // The table accessor still has its size from before the changes, so this
+    // may give up a little earlier than necessary when rows were inserted.
+    if (m_modified_rows.size() + num_rows > m_table->size() / 4) {
+        adj_acc_discard_changes();
+        return;
+    }
+    try {
+        for (size_t i = 0; i < num_rows; ++i)
+            m_modified_rows.push_back(row_ndx + i);
+    }
+    catch (...) {
+        adj_acc_discard_changes();
+    }
+}
+
+
+void TableViewBase::adj_acc_discard_changes() noexcept
+{
+    m_tracking_changes = false;
+    m_modified_rows.clear();
+}
+
+
+bool TableViewBase::is_tracking_changes() noexcept
+{
+    if (!m_tracking_changes)
+        return false;
+    // A local change makes the next sync rerun the query anyway, so there is
+    // no point in keeping the modified rows up to date after that
+    if (m_table->m_local_change_count != m_tracked_local_change_count) {
+        adj_acc_discard_changes();
+        return false;
+    }
+    return true;
 }
 
 
@@ -754,7 +899,10 @@ void TableViewBase::do_sync()
     // - Table::get_backlink_view()
     // Here we sync with the respective source.
 
-    if (m_linkview_source) {
+    if (can_sync_incrementally()) {
+        apply_tracked_changes();
+    }
+    else if (m_linkview_source) {
         m_row_indexes.clear();
         for (size_t t = 0; t < m_linkview_source->size(); t++)
             m_row_indexes.add(m_linkview_source->get(t).get_index());
@@ -795,9 +943,81 @@ void TableViewBase::do_sync()
 
     do_sort(m_descriptor_ordering);
 
+    m_modified_rows.clear();
+    m_tracking_changes = m_incremental_sync && m_table;
+    if (m_tracking_changes)
+        m_tracked_local_change_count = m_table->m_local_change_count;
+
     m_last_seen_version = outside_version();
 }
 
+bool TableViewBase::can_sync_incrementally() const
+{
+    if (!m_tracking_changes || !m_table || m_table->m_local_change_count != m_tracked_local_change_count)
+        return false;
+
+    // Only views holding the plain result of a query can be patched
+    if (!m_query.m_table || m_query.m_view || m_linkview_source || m_distinct_column_source != npos ||
+        m_linked_column || !m_row_indexes.is_attached())
+        return false;
+    if (m_start != 0 || m_end != size_t(-1) || m_limit != size_t(-1))
+        return false;
+    if (m_descriptor_ordering.will_apply_distinct() || m_descriptor_ordering.will_apply_limit())
+        return false;
+
+    // Reevaluating the query row by row only pays off for small changes
+    if (m_modified_rows.size() > m_table->size() / 4)
+        return false;
+
+    // The query may depend on the contents of other tables, and changes to
+    // those are not tracked
+    const Spec& spec = _impl::TableFriend::get_spec(*m_table);
+    for (size_t i = 0; i < spec.get_column_count(); ++i) {
+        ColumnType type = spec.get_column_type(i);
+        if (type == col_type_Link || type == col_type_LinkList || type == col_type_BackLink ||
+            type == col_type_Table || type == col_type_Mixed)
+            return false;
+    }
+    return true;
+}
+
+void TableViewBase::apply_tracked_changes()
+{
+    std::sort(m_modified_rows.begin(), m_modified_rows.end());
+    m_modified_rows.erase(std::unique(m_modified_rows.begin(), m_modified_rows.end()), m_modified_rows.end());
+
+    // Keep the rows which are still in the view and were not modified, and
+    // add the modified rows which now match. The result is put back in table
+    // order, which is what rerunning the query would produce.
+    std::vector<size_t> rows;
+    rows.reserve(m_row_indexes.size() + m_modified_rows.size());
+    for (size_t i = 0, size = m_row_indexes.size(); i < size; ++i) {
+        int64_t row_ndx = m_row_indexes.get(i);
+        if (row_ndx == detached_ref)
+            continue;
+        if (std::binary_search(m_modified_rows.begin(), m_modified_rows.end(), size_t(row_ndx)))
+            continue;
+        rows.push_back(size_t(row_ndx));
+    }
+    // The query is initialized once, and then evaluated on each modified row
+    // in turn
+    size_t table_size = m_table->size();
+    ParentNode* root = m_query.root_node();
+    if (root)
+        m_query.init(); // Throws
+    for (size_t row_ndx : m_modified_rows) {
+        if (row_ndx >= table_size)
+            continue;
+        if (!root || root->find_first(row_ndx, row_ndx + 1) != not_found) // Throws
+            rows.push_back(row_ndx);
+    }
+    std::sort(rows.begin(), rows.end());
+
+    m_row_indexes.clear();
+    for (size_t row_ndx : rows)
+        m_row_indexes.add(row_ndx);
+}
+
 bool TableViewBase::is_in_table_order() const
 {
     if (!m_table) {
@@ -287,6 +287,20 @@ public:
     // if the TableView depends on an object (LinkView or row) that has been deleted.
     uint_fast64_t sync_if_needed() const;
 
+    // Keep the view up to date incrementally. When enabled, a sync after the
+    // read transaction has been advanced reevaluates the query only for the
+    // rows which the new transactions inserted or modified, and patches the
+    // view instead of rerunning the query over the whole table. The view falls
+    // back to rerunning the query whenever that cannot be done safely: when it
+    // was not created by a query directly on a table, when distinct or limit
+    // is applied, when the table has link, backlink or subtable columns, and
+    // when the table was modified through this group's own accessors.
+    void set_incremental_sync(bool enable) noexcept;
+
+    // Returns true if the next sync will patch the view from the tracked
+    // changes rather than rerun the query.
+    bool can_sync_incrementally() const;
+
     // Sort m_row_indexes according to one column
     void sort(size_t column, bool ascending = true);
 
@@ -362,6 +376,16 @@ protected:
     mutable util::Optional<uint_fast64_t> m_last_seen_version;
 
     size_t m_num_detached_refs = 0;
+
+    // Incremental synchronization, see set_incremental_sync(). While
+    // m_tracking_changes is true, m_modified_rows holds every row inserted or
+    // modified since the last sync, as long as Table::m_local_change_count
+    // still equals m_tracked_local_change_count.
+    bool m_incremental_sync = false;
+    bool m_tracking_changes = false;
+    uint_fast64_t m_tracked_local_change_count = 0;
+    std::vector<size_t> m_modified_rows;
+
     /// Construct null view (no memory allocated).
     TableViewBase();
 
@@ -430,10 +454,16 @@ private:
     // Called by table to adjust any row references:
     void adj_row_acc_insert_rows(size_t row_ndx, size_t num_rows) noexcept;
     void adj_row_acc_erase_row(size_t row_ndx) noexcept;
+    void adj_row_acc_erase_rows(const std::vector<size_t>& row_ndxs) noexcept;
     void adj_row_acc_move_over(size_t from_row_ndx, size_t to_row_ndx) noexcept;
     void adj_row_acc_swap_rows(size_t row_ndx_1, size_t row_ndx_2) noexcept;
     void adj_row_acc_move_row(size_t from_row_ndx, size_t to_row_ndx) noexcept;
     void adj_row_acc_clear() noexcept;
+    void adj_row_acc_modify_rows(size_t row_ndx, size_t num_rows) noexcept;
+    void adj_acc_discard_changes() noexcept;
+    bool is_tracking_changes() noexcept;
+
+    void apply_tracked_changes();
 };
 
 
@@ -792,6 +822,10 @@ inline TableViewBase::TableViewBase(const TableViewBase& tv)
     , m_limit(tv.m_limit)
     , m_last_seen_version(tv.m_last_seen_version)
     , m_num_detached_refs(tv.m_num_detached_refs)
+    , m_incremental_sync(tv.m_incremental_sync)
+    , m_tracking_changes(tv.m_tracking_changes)
+    , m_tracked_local_change_count(tv.m_tracked_local_change_count)
+    , m_modified_rows(tv.m_modified_rows)
 {
     // FIXME: This code is unreasonably complicated because it uses `IntegerColumn` as
     // a free-standing container, and because `IntegerColumn` does not conform to the
@@ -823,6 +857,10 @@ inline TableViewBase::TableViewBase(TableViewBase&& tv) noexcept
     // version number so that we can later trigger a sync if needed.
     m_last_seen_version(tv.m_last_seen_version)
     , m_num_detached_refs(tv.m_num_detached_refs)
+    , m_incremental_sync(tv.m_incremental_sync)
+    , m_tracking_changes(tv.m_tracking_changes)
+    , m_tracked_local_change_count(tv.m_tracked_local_change_count)
+    , m_modified_rows(std::move(tv.m_modified_rows))
 {
     RowIndexes::m_limit_count = tv.m_limit_count;
     if (m_table)
@@ -859,6 +897,10 @@ inline TableViewBase& TableViewBase::operator=(TableViewBase&& tv) noexcept
     m_linkview_source = std::move(tv.m_linkview_source);
     m_descriptor_ordering = std::move(tv.m_descriptor_ordering);
     m_distinct_column_source = tv.m_distinct_column_source;
+    m_incremental_sync = tv.m_incremental_sync;
+    m_tracking_changes = tv.m_tracking_changes;
+    m_tracked_local_change_count = tv.m_tracked_local_change_count;
+    m_modified_rows = std::move(tv.m_modified_rows);
 
     return *this;
 }
@@ -895,6 +937,10 @@ inline TableViewBase& TableViewBase::operator=(const TableViewBase& tv)
     m_linkview_source = tv.m_linkview_source;
     m_descriptor_ordering = tv.m_descriptor_ordering;
     m_distinct_column_source = tv.m_distinct_column_source;
+    m_incremental_sync = tv.m_incremental_sync;
+    m_tracking_changes = tv.m_tracking_changes;
+    m_tracked_local_change_count = tv.m_tracked_local_change_count;
+    m_modified_rows = tv.m_modified_rows;
 
     return *this;
 }
@@ -0,0 +1,191 @@
+/*************************************************************************
+ *
+ * Copyright 2016 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#include <algorithm>
+#include <utility>
+
+#include <realm/trigram_index.hpp>
+
+using namespace realm;
+
+const size_t TrigramIndex::max_size;
+const size_t TrigramIndex::max_postings;
+const size_t TrigramIndex::sample_size;
+
+namespace {
+
+inline uint32_t fold(char c) noexcept
+{
+    uint32_t b = static_cast<unsigned char>(c);
+    return (b >= 'A' && b <= 'Z') ? b + ('a' - 'A') : b;
+}
+
+inline uint32_t make_trigram(const char* s) noexcept
+{
+    return fold(s[0]) << 16 | fold(s[1]) << 8 | fold(s[2]);
+}
+
+} // unnamed namespace
+
+
+void TrigramIndex::get_trigrams(StringData needle, std::vector<uint32_t>& trigrams)
+{
+    get_trigrams(needle, needle, trigrams); // Throws
+}
+
+void TrigramIndex::get_trigrams(StringData upper, StringData lower, std::vector<uint32_t>& trigrams)
+{
+    REALM_ASSERT_3(upper.size(), ==, lower.size());
+
+    // Number of bytes before position i that fold to the same byte in both
+    // forms of the needle
+    size_t run = 0;
+    for (size_t i = 0; i < upper.size(); ++i) {
+        if (fold(upper[i]) != fold(lower[i])) {
+            run = 0;
+            continue;
+        }
+        if (++run >= 3)
+            trigrams.push_back(make_trigram(lower.data() + i - 2)); // Throws
+    }
+}
+
+void TrigramIndex::get_like_trigrams(StringData upper, StringData lower, std::vector<uint32_t>& trigrams)
+{
+    REALM_ASSERT_3(upper.size(), ==, lower.size());
+
+    // The parts between wildcards must occur verbatim in a matching string
+    size_t begin = 0;
+    for (size_t i = 0; i <= upper.size(); ++i) {
+        if (i < upper.size() && upper[i] != '*' && upper[i] != '?')
+            continue;
+        get_trigrams(upper.substr(begin, i - begin), lower.substr(begin, i - begin), trigrams); // Throws
+        begin = i + 1;
+    }
+}
+
+void TrigramIndex::clear() noexcept
+{
+    // Shrink the vectors by swapping them with empty ones
+    std::vector<uint32_t>().swap(m_keys);
+    std::vector<size_t>().swap(m_offsets);
+    std::vector<uint32_t>().swap(m_rows);
+    m_valid = false;
+    m_too_large = false;
+}
+
+size_t TrigramIndex::count_candidates(const std::vector<uint32_t>& trigrams) const noexcept
+{
+    size_t count = m_rows.size();
+    for (uint32_t trigram : trigrams) {
+        size_t i = find_key(trigram);
+        if (i == npos)
+            return 0;
+        count = std::min(count, m_offsets[i + 1] - m_offsets[i]);
+    }
+    return count;
+}
+
+void TrigramIndex::find_candidates(const std::vector<uint32_t>& trigrams, std::vector<size_t>& rows) const
+{
+    REALM_ASSERT(!trigrams.empty());
+    rows.clear();
+
+    // Intersect the row lists of the trigrams, starting with the shortest
+    std::vector<std::pair<size_t, size_t>> lists;
+    lists.reserve(trigrams.size()); // Throws
+    for (uint32_t trigram : trigrams) {
+        size_t i = find_key(trigram);
+        if (i == npos)
+            return;
+        lists.emplace_back(m_offsets[i], m_offsets[i + 1]);
+    }
+    std::sort(lists.begin(), lists.end(), [](const std::pair<size_t, size_t>& a, const std::pair<size_t, size_t>& b) {
+        return a.second - a.first < b.second - b.first;
+    });
+    lists.erase(std::unique(lists.begin(), lists.end()), lists.end());
+
+    rows.assign(m_rows.begin() + lists[0].first, m_rows.begin() + lists[0].second); // Throws
+    for (size_t i = 1; i < lists.size() && !rows.empty(); ++i) {
+        auto begin = m_rows.begin() + lists[i].first;
+        auto end = m_rows.begin() + lists[i].second;
+        size_t num_rows = 0;
+        for (size_t row_ndx : rows) {
+            begin = std::lower_bound(begin, end, row_ndx);
+            if (begin == end)
+                break;
+            if (*begin == row_ndx)
+                rows[num_rows++] = row_ndx;
+        }
+        rows.resize(num_rows);
+    }
+}
+
+void TrigramIndex::add_postings(StringData value, uint32_t row_ndx, std::vector<uint64_t>& postings)
+{
+    if (value.size() < 3)
+        return;
+
+    // Only one posting per distinct trigram of the value
+    size_t first = postings.size();
+    for (size_t i = 0; i + 3 <= value.size(); ++i)
+        postings.push_back(uint64_t(make_trigram(value.data() + i)) << 32 | row_ndx); // Throws
+    std::sort(postings.begin() + first, postings.end());
+    postings.erase(std::unique(postings.begin() + first, postings.end()), postings.end());
+}
+
+void TrigramIndex::build_from_postings(std::vector<uint64_t>& postings)
+{
+    std::sort(postings.begin(), postings.end());
+
+    m_keys.clear();
+    m_offsets.clear();
+    m_rows.clear();
+    m_rows.reserve(postings.size()); // Throws
+    for (uint64_t posting : postings) {
+        uint32_t trigram = uint32_t(posting >> 32);
+        if (m_keys.empty() || m_keys.back() != trigram) {
+            m_keys.push_back(trigram); // Throws
+            m_offsets.push_back(m_rows.size()); // Throws
+        }
+        m_rows.push_back(uint32_t(posting));
+    }
+    m_offsets.push_back(m_rows.size()); // Throws
+}
+
+size_t TrigramIndex::find_key(uint32_t trigram) const noexcept
+{
+    auto i = std::lower_bound(m_keys.begin(), m_keys.end(), trigram);
+    if (i == m_keys.end() || *i != trigram)
+        return npos;
+    return i - m_keys.begin();
+}
+
+
+size_t TrigramIndexCandidates::find_first(size_t start, size_t end) noexcept
+{
+    auto begin = m_rows.begin();
+    if (m_next > 0 && m_rows[m_next - 1] < start)
+        begin += m_next;
+    auto i = std::lower_bound(begin, m_rows.end(), start);
+    m_next = i - m_rows.begin();
+    if (i == m_rows.end() || *i >= end)
+        return npos;
+    ++m_next;
+    return *i;
+}
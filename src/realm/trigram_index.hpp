@@ -0,0 +1,221 @@
+/*************************************************************************
+ *
+ * Copyright 2016 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#ifndef REALM_TRIGRAM_INDEX_HPP
+#define REALM_TRIGRAM_INDEX_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include <realm/array.hpp>
+#include <realm/string_data.hpp>
+
+namespace realm {
+
+/// A trigram index maps every sequence of three consecutive bytes (trigram)
+/// occurring in the values of a string column to the rows containing it. A
+/// string can only contain, begin with, end with or be like a pattern if it
+/// contains all the trigrams of the literal parts of the pattern, so the
+/// query engine uses the index to find the candidate rows for such conditions
+/// on columns that have a search index, and only checks the condition on
+/// those.
+///
+/// ASCII letters are folded to lower case before they are indexed, so the
+/// same index serves both the case sensitive and the case insensitive
+/// conditions.
+///
+/// Trigram indexes are enabled per column with Table::set_trigram_index().
+/// Like zone maps and ordered indexes, they are not part of the file format.
+/// They are held by the column accessor and tagged with the version of the
+/// table that owns the column (Table::get_version_counter()), so any
+/// modification of the table makes them stale. Since building one takes a
+/// pass over the whole column, a stale trigram index is only rebuilt when a
+/// query needs it, and when a sample of the rows suggests that the needle of
+/// the query is selective. Otherwise it is released (see refresh()).
+class TrigramIndex {
+public:
+    /// Rows are stored as 32-bit indexes, so columns with more rows than this
+    /// are never indexed.
+    static const size_t max_size = uint32_t(-1);
+
+    /// Columns whose values have more distinct trigrams than this in total are
+    /// never indexed, which bounds the memory used by an index to 64 MiB (and
+    /// twice that while it is built).
+    static const size_t max_postings = size_t(1) << 24;
+
+    /// The number of rows sampled by refresh().
+    static const size_t sample_size = 256;
+
+    bool is_valid_for(uint_fast64_t version) const noexcept
+    {
+        return m_valid && m_version == version;
+    }
+
+    /// Brings this index up to date with the specified version of the table if
+    /// it is stale, and returns true if it may be used to find the rows
+    /// containing all of `trigrams`. A stale index is only rebuilt if at most
+    /// one in trigram_index_selectivity of sample_size rows sampled at equal
+    /// strides contains all of them. Otherwise, and if the column is too large
+    /// to be indexed, the index is released and false is returned.
+    ///
+    /// `get(row_ndx)` must return the value of the specified row.
+    template <class Get>
+    bool refresh(size_t size, Get get, uint_fast64_t version, const std::vector<uint32_t>& trigrams);
+
+    /// Releases the memory held by this index, which becomes stale.
+    void clear() noexcept;
+
+    /// Adds the trigrams of `needle` to `trigrams`.
+    static void get_trigrams(StringData needle, std::vector<uint32_t>& trigrams);
+
+    /// Adds the trigrams of a case insensitive needle, given in upper and lower
+    /// case, to `trigrams`. Trigrams containing a byte whose upper and lower
+    /// case forms are not folded to the same byte are skipped.
+    static void get_trigrams(StringData upper, StringData lower, std::vector<uint32_t>& trigrams);
+
+    /// Adds the trigrams of the literal parts of a pattern as accepted by
+    /// StringData::like() (and its upper and lower case forms for a case
+    /// insensitive match) to `trigrams`.
+    static void get_like_trigrams(StringData upper, StringData lower, std::vector<uint32_t>& trigrams);
+
+    /// Returns the number of rows containing the least frequent of the
+    /// specified trigrams. This is an upper bound on the number of rows
+    /// find_candidates() will find.
+    size_t count_candidates(const std::vector<uint32_t>& trigrams) const noexcept;
+
+    /// Stores the rows containing all the specified trigrams in `rows`, in
+    /// ascending order. `trigrams` must not be empty.
+    void find_candidates(const std::vector<uint32_t>& trigrams, std::vector<size_t>& rows) const;
+
+private:
+    // Distinct trigrams in ascending order. The rows containing m_keys[i] are
+    // m_rows[m_offsets[i]] to m_rows[m_offsets[i + 1] - 1], in ascending order.
+    std::vector<uint32_t> m_keys;
+    std::vector<size_t> m_offsets;
+    std::vector<uint32_t> m_rows;
+    uint_fast64_t m_version = 0;
+    bool m_valid = false;
+    bool m_too_large = false; // The column could not be indexed at m_version
+
+    template <class Get>
+    static bool is_selective(size_t size, Get get, const std::vector<uint32_t>& trigrams);
+    template <class Get>
+    void build(size_t size, Get get, uint_fast64_t version);
+
+    // Appends (trigram << 32 | row_ndx) for the trigrams of `value`.
+    static void add_postings(StringData value, uint32_t row_ndx, std::vector<uint64_t>& postings);
+    void build_from_postings(std::vector<uint64_t>& postings);
+    size_t find_key(uint32_t trigram) const noexcept;
+};
+
+/// Trigram indexes are only used if a needle selects at most one in this many
+/// rows. Scanning the leaves is cheaper otherwise.
+const size_t trigram_index_selectivity = 8;
+
+/// The candidate rows found through a trigram index on behalf of a query node,
+/// which asks for the first candidate in a sequence of mostly increasing row
+/// ranges.
+class TrigramIndexCandidates {
+public:
+    void reset() noexcept
+    {
+        m_rows.clear();
+        m_next = 0;
+        m_active = false;
+    }
+
+    void reset(const TrigramIndex& index, const std::vector<uint32_t>& trigrams)
+    {
+        reset();
+        index.find_candidates(trigrams, m_rows); // Throws
+        m_active = true;
+    }
+
+    bool is_active() const noexcept
+    {
+        return m_active;
+    }
+
+    size_t size() const noexcept
+    {
+        return m_rows.size();
+    }
+
+    /// Returns the first candidate row in [start, end), or npos.
+    size_t find_first(size_t start, size_t end) noexcept;
+
+private:
+    std::vector<size_t> m_rows;
+    size_t m_next = 0;
+    bool m_active = false;
+};
+
+
+// Implementation:
+
+template <class Get>
+bool TrigramIndex::refresh(size_t size, Get get, uint_fast64_t version, const std::vector<uint32_t>& trigrams)
+{
+    if (is_valid_for(version))
+        return !m_too_large;
+    clear();
+    if (size > max_size || !is_selective(size, get, trigrams)) // Throws
+        return false;
+    build(size, get, version); // Throws
+    return !m_too_large;
+}
+
+template <class Get>
+bool TrigramIndex::is_selective(size_t size, Get get, const std::vector<uint32_t>& trigrams)
+{
+    size_t num_samples = std::min(size, sample_size);
+    size_t num_matches = 0;
+    std::vector<uint64_t> postings;
+    for (size_t i = 0; i < num_samples; ++i) {
+        postings.clear();
+        add_postings(get(i * size / num_samples), 0, postings); // Throws
+        auto contains = [&](uint32_t trigram) {
+            return std::binary_search(postings.begin(), postings.end(), uint64_t(trigram) << 32);
+        };
+        if (std::all_of(trigrams.begin(), trigrams.end(), contains))
+            ++num_matches;
+    }
+    return num_matches * trigram_index_selectivity <= num_samples;
+}
+
+template <class Get>
+void TrigramIndex::build(size_t size, Get get, uint_fast64_t version)
+{
+    REALM_ASSERT(size <= max_size);
+    m_valid = false;
+
+    std::vector<uint64_t> postings;
+    for (size_t row_ndx = 0; row_ndx < size && postings.size() <= max_postings; ++row_ndx)
+        add_postings(get(row_ndx), uint32_t(row_ndx), postings); // Throws
+    m_too_large = postings.size() > max_postings;
+    if (!m_too_large)
+        build_from_postings(postings); // Throws
+
+    m_version = version;
+    m_valid = true;
+}
+
+} // namespace realm
+
+#endif // REALM_TRIGRAM_INDEX_HPP
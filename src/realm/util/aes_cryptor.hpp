@@ -50,6 +50,9 @@ public:
 
     void set_file_size(off_t new_size);
 
+    /// Decrypts `size` bytes of data starting at `pos`. Blocks which have
+    /// never been written are skipped, leaving the corresponding part of
+    /// `dst` unmodified. Returns false if any block was skipped.
     bool read(FileDesc fd, off_t pos, char* dst, size_t size);
     void write(FileDesc fd, off_t pos, const char* src, size_t size) noexcept;
 
@@ -73,8 +76,12 @@ private:
 #elif defined(_WIN32)
     BCRYPT_KEY_HANDLE m_aes_key_handle;
 #else
-    uint8_t m_aesKey[32];
-    EVP_CIPHER_CTX* m_ctx;
+    // The key schedules are set up once, and only the IV is reset per block
+    EVP_CIPHER_CTX* m_encr;
+    EVP_CIPHER_CTX* m_decr;
+    // Hash states after absorbing the inner and outer HMAC pads
+    SHA256_CTX m_hmac_inner;
+    SHA256_CTX m_hmac_outer;
 #endif
 
     uint8_t m_hmacKey[32];
@@ -82,8 +89,9 @@ private:
     std::unique_ptr<char[]> m_rw_buffer;
     std::unique_ptr<char[]> m_dst_buffer;
 
-    void calc_hmac(const void* src, size_t len, uint8_t* dst, const uint8_t* key) const;
+    void calc_hmac(const void* src, size_t len, uint8_t* dst) const;
     bool check_hmac(const void* data, size_t len, const uint8_t* hmac) const;
+    bool decrypt_block(off_t pos, char* dst, const char* src, size_t len, iv_table& iv);
     void crypt(EncryptionMode mode, off_t pos, char* dst, const char* src, const char* stored_iv) noexcept;
     iv_table& get_iv_table(FileDesc fd, off_t data_pos) noexcept;
     void handle_error();
@@ -0,0 +1,208 @@
+/*************************************************************************
+ *
+ * Copyright 2018 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#include <realm/util/compression.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include <realm/util/assert.hpp>
+
+using namespace realm;
+using namespace realm::util;
+
+
+namespace {
+
+constexpr size_t min_match = 4;
+constexpr int hash_bits = 12;
+
+inline uint32_t read_u32(const char* p) noexcept
+{
+    uint32_t value;
+    std::memcpy(&value, p, sizeof value);
+    return value;
+}
+
+inline size_t hash(uint32_t value) noexcept
+{
+    return size_t((value * 2654435761U) >> (32 - hash_bits));
+}
+
+// Returns null if the length does not fit
+char* write_length(char* out, char* out_end, size_t length) noexcept
+{
+    for (;;) {
+        if (out == out_end)
+            return nullptr;
+        if (length < 255) {
+            *out++ = char(length);
+            return out;
+        }
+        *out++ = char(255);
+        length -= 255;
+    }
+}
+
+// Writes the literals followed by the match, or only the literals if
+// `match_length` is zero. Returns null if it does not fit.
+char* write_pair(char* out, char* out_end, const char* literals, size_t num_literals, size_t offset,
+                 size_t match_length) noexcept
+{
+    if (out == out_end)
+        return nullptr;
+    char* token = out++;
+    size_t literals_nibble = std::min(num_literals, size_t(15));
+    size_t match_nibble = (match_length == 0 ? 0 : std::min(match_length - min_match, size_t(15)));
+    *token = char(literals_nibble << 4 | match_nibble);
+    if (literals_nibble == 15) {
+        out = write_length(out, out_end, num_literals - 15);
+        if (!out)
+            return nullptr;
+    }
+    if (size_t(out_end - out) < num_literals)
+        return nullptr;
+    std::copy(literals, literals + num_literals, out);
+    out += num_literals;
+    if (match_length == 0)
+        return out;
+    if (out_end - out < 2)
+        return nullptr;
+    *out++ = char(offset & 0xFF);
+    *out++ = char(offset >> 8);
+    if (match_nibble == 15)
+        out = write_length(out, out_end, match_length - min_match - 15);
+    return out;
+}
+
+bool read_length(const unsigned char*& in, const unsigned char* in_end, size_t& length) noexcept
+{
+    for (;;) {
+        if (in == in_end)
+            return false;
+        unsigned char byte = *in++;
+        length += byte;
+        if (byte != 255)
+            return true;
+    }
+}
+
+} // unnamed namespace
+
+
+size_t compression::compress_block(const char* in, size_t in_size, char* out, size_t out_size) noexcept
+{
+    REALM_ASSERT(in_size <= max_block_size);
+
+    // Offsets into `in` of the last seen occurrence of each hashed sequence of
+    // four bytes
+    int32_t table[size_t(1) << hash_bits];
+    std::fill(std::begin(table), std::end(table), -1);
+
+    const char* in_end = in + in_size;
+    const char* anchor = in; // Start of pending literals
+    char* out_end = out + out_size;
+    char* out_2 = out;
+    if (in_size >= min_match) {
+        const char* in_limit = in_end - min_match;
+        const char* i = in;
+        size_t num_misses = 0;
+        while (i <= in_limit) {
+            uint32_t value = read_u32(i);
+            size_t h = hash(value);
+            int32_t candidate = table[h];
+            table[h] = int32_t(i - in);
+            if (candidate < 0 || read_u32(in + candidate) != value) {
+                // Move faster through data that does not compress
+                i += 1 + (num_misses++ >> 6);
+                continue;
+            }
+            num_misses = 0;
+            const char* match = in + candidate;
+            while (i > anchor && match > in && i[-1] == match[-1]) {
+                --i;
+                --match;
+            }
+            const char* i_2 = i + min_match;
+            const char* match_2 = match + min_match;
+            while (i_2 < in_end && *i_2 == *match_2) {
+                ++i_2;
+                ++match_2;
+            }
+            out_2 = write_pair(out_2, out_end, anchor, size_t(i - anchor), size_t(i - match), size_t(i_2 - i));
+            if (!out_2)
+                return 0;
+            i = i_2;
+            anchor = i_2;
+        }
+    }
+    out_2 = write_pair(out_2, out_end, anchor, size_t(in_end - anchor), 0, 0);
+    if (!out_2)
+        return 0;
+    return size_t(out_2 - out);
+}
+
+
+bool compression::decompress_block(const char* in, size_t in_size, char* out, size_t out_size) noexcept
+{
+    const unsigned char* in_2 = reinterpret_cast<const unsigned char*>(in);
+    const unsigned char* in_end = in_2 + in_size;
+    char* out_2 = out;
+    char* out_end = out + out_size;
+    for (;;) {
+        // Every block ends with a pair that has only literals
+        if (in_2 == in_end)
+            return false;
+        unsigned char token = *in_2++;
+        size_t num_literals = token >> 4;
+        if (num_literals == 15 && !read_length(in_2, in_end, num_literals))
+            return false;
+        if (size_t(in_end - in_2) < num_literals || size_t(out_end - out_2) < num_literals)
+            return false;
+        std::copy(in_2, in_2 + num_literals, out_2);
+        in_2 += num_literals;
+        out_2 += num_literals;
+        if (in_2 == in_end)
+            return out_2 == out_end;
+
+        if (in_end - in_2 < 2)
+            return false;
+        size_t offset = size_t(in_2[0]) | size_t(in_2[1]) << 8;
+        in_2 += 2;
+        if (offset == 0 || offset > size_t(out_2 - out))
+            return false;
+        size_t match_length = token & 0x0F;
+        if (match_length == 15 && !read_length(in_2, in_end, match_length))
+            return false;
+        match_length += min_match;
+        if (size_t(out_end - out_2) < match_length)
+            return false;
+        const char* match = out_2 - offset;
+        if (offset >= match_length) {
+            std::copy(match, match + match_length, out_2);
+            out_2 += match_length;
+        }
+        else {
+            // The match overlaps the output, which repeats the last `offset`
+            // bytes
+            for (size_t i = 0; i < match_length; ++i)
+                *out_2++ = *match++;
+        }
+    }
+}
@@ -0,0 +1,63 @@
+/*************************************************************************
+ *
+ * Copyright 2018 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#ifndef REALM_UTIL_COMPRESSION_HPP
+#define REALM_UTIL_COMPRESSION_HPP
+
+#include <cstddef>
+
+namespace realm {
+namespace util {
+namespace compression {
+
+/// A fast block compressor in the style of LZ4, which favours compression and
+/// decompression speed over compression ratio.
+///
+/// A compressed block is a sequence of (literals, match) pairs. Each pair
+/// starts with a token byte holding the number of literals in the upper four
+/// bits and the length of the match minus four in the lower four bits. A value
+/// of 15 in either half is followed by extra length bytes, which are added to
+/// it, until one that is less than 255. Then follow the literals, and then the
+/// match as a two byte little-endian offset backwards from the current output
+/// position. The last pair of a block has no match, and ends the block.
+///
+/// The format is not compatible with LZ4, since the end of a block is given by
+/// the size of the compressed data rather than by the rules that LZ4 imposes on
+/// the last pairs.
+
+/// The largest block that can be compressed, which keeps every match offset
+/// within two bytes.
+constexpr size_t max_block_size = 0xFFFF;
+
+/// Compress the specified block, which must not be larger than
+/// `max_block_size`. Returns the size of the compressed block, or zero if it
+/// did not fit within `out_size` bytes. Passing an `out_size` that is less than
+/// `in_size` therefore makes the compressor give up as soon as it becomes
+/// clear that the data is not compressible.
+size_t compress_block(const char* in, size_t in_size, char* out, size_t out_size) noexcept;
+
+/// Decompress the specified block, which must decompress to exactly
+/// `out_size` bytes. Returns false if the compressed block is malformed or
+/// decompresses to any other number of bytes.
+bool decompress_block(const char* in, size_t in_size, char* out, size_t out_size) noexcept;
+
+} // namespace compression
+} // namespace util
+} // namespace realm
+
+#endif // REALM_UTIL_COMPRESSION_HPP
@@ -93,6 +93,10 @@ const size_t block_size = 4096;
 const size_t metadata_size = sizeof(iv_table);
 const size_t blocks_per_metadata_block = block_size / metadata_size;
 
+// Consecutive blocks are read and written with a single system call, up to
+// this many at a time
+const size_t max_batch_blocks = 16;
+
 // map an offset in the data to the actual location in the file
 template <typename Int>
 Int real_offset(Int pos)
@@ -140,10 +144,21 @@ size_t check_read(FileDesc fd, off_t pos, void* dst, size_t len)
     return ret;
 }
 
+// The number of blocks starting at the data position `pos` which can be
+// transferred in one go. The data of consecutive blocks is only contiguous in
+// the file up to the next metadata block, and the IV table entries are only
+// contiguous within one metadata block.
+size_t blocks_in_batch(off_t pos, size_t size)
+{
+    const size_t index = static_cast<size_t>(pos) / block_size;
+    const size_t blocks_to_metadata = blocks_per_metadata_block - index % blocks_per_metadata_block;
+    return std::min(std::min(size / block_size, blocks_to_metadata), max_batch_blocks);
+}
+
 } // anonymous namespace
 
 AESCryptor::AESCryptor(const uint8_t* key)
-    : m_rw_buffer(new char[block_size]),
+    : m_rw_buffer(new char[block_size * max_batch_blocks]),
       m_dst_buffer(new char[block_size])
 {
 #if REALM_PLATFORM_APPLE
@@ -168,14 +183,38 @@ AESCryptor::AESCryptor(const uint8_t* key)
     ret = BCryptGenerateSymmetricKey(hAesAlg, &m_aes_key_handle, nullptr, 0, (PBYTE)key, 32, 0);
     REALM_ASSERT_RELEASE_EX(ret == 0 && "BCryptGenerateSymmetricKey()", ret);
 #else
-    m_ctx = EVP_CIPHER_CTX_new();
+    m_encr = EVP_CIPHER_CTX_new();
+    m_decr = EVP_CIPHER_CTX_new();
 
-    if (!m_ctx)
+    if (!m_encr || !m_decr)
         handle_error();
 
-    memcpy(m_aesKey, key, 32);
+    if (!EVP_CipherInit_ex(m_encr, EVP_aes_256_cbc(), NULL, key, NULL, mode_Encrypt) ||
+        !EVP_CipherInit_ex(m_decr, EVP_aes_256_cbc(), NULL, key, NULL, mode_Decrypt))
+        handle_error();
+
+    // Use zero padding - we always write a whole page
+    EVP_CIPHER_CTX_set_padding(m_encr, 0);
+    EVP_CIPHER_CTX_set_padding(m_decr, 0);
 #endif
     memcpy(m_hmacKey, key + 32, 32);
+
+#if !REALM_PLATFORM_APPLE && !defined(_WIN32)
+    uint8_t ipad[64];
+    for (size_t i = 0; i < 32; ++i)
+        ipad[i] = m_hmacKey[i] ^ 0x36;
+    memset(ipad + 32, 0x36, 32);
+
+    uint8_t opad[64];
+    for (size_t i = 0; i < 32; ++i)
+        opad[i] = m_hmacKey[i] ^ 0x5C;
+    memset(opad + 32, 0x5C, 32);
+
+    SHA224_Init(&m_hmac_inner);
+    SHA256_Update(&m_hmac_inner, ipad, 64);
+    SHA224_Init(&m_hmac_outer);
+    SHA256_Update(&m_hmac_outer, opad, 64);
+#endif
 }
 
 AESCryptor::~AESCryptor() noexcept
@@ -185,8 +224,8 @@ AESCryptor::~AESCryptor() noexcept
     CCCryptorRelease(m_decr);
 #elif defined(_WIN32)
 #else
-    EVP_CIPHER_CTX_cleanup(m_ctx);
-    EVP_CIPHER_CTX_free(m_ctx);
+    EVP_CIPHER_CTX_free(m_encr);
+    EVP_CIPHER_CTX_free(m_decr);
 #endif
 }
 
@@ -228,7 +267,7 @@ iv_table& AESCryptor::get_iv_table(FileDesc fd, off_t data_pos) noexcept
 bool AESCryptor::check_hmac(const void* src, size_t len, const uint8_t* hmac) const
 {
     uint8_t buffer[224 / 8];
-    calc_hmac(src, len, buffer, m_hmacKey);
+    calc_hmac(src, len, buffer);
 
     // Constant-time memcmp to avoid timing attacks
     uint8_t result = 0;
@@ -240,66 +279,77 @@ bool AESCryptor::check_hmac(const void* src, size_t len, const uint8_t* hmac) co
 bool AESCryptor::read(FileDesc fd, off_t pos, char* dst, size_t size)
 {
     REALM_ASSERT(size % block_size == 0);
+    bool all_decrypted = true;
     while (size > 0) {
-        ssize_t bytes_read = check_read(fd, real_offset(pos), m_rw_buffer.get(), block_size);
-
+        size_t count = blocks_in_batch(pos, size);
+        size_t bytes_read = check_read(fd, real_offset(pos), m_rw_buffer.get(), count * block_size);
         if (bytes_read == 0)
             return false;
 
-        iv_table& iv = get_iv_table(fd, pos);
-        if (iv.iv1 == 0) {
-            // This block has never been written to, so we've just read pre-allocated
-            // space. No memset() since the code using this doesn't rely on
-            // pre-allocated space being zeroed.
-            return false;
+        iv_table* iv = &get_iv_table(fd, pos);
+        for (size_t i = 0; i < count; ++i) {
+            size_t offset = i * block_size;
+            size_t len = bytes_read > offset ? std::min(bytes_read - offset, block_size) : 0;
+            if (len == 0 || !decrypt_block(pos, dst, m_rw_buffer.get() + offset, len, iv[i]))
+                all_decrypted = false;
+            pos += block_size;
+            dst += block_size;
         }
+        size -= count * block_size;
+    }
+    return all_decrypted;
+}
 
-        if (!check_hmac(m_rw_buffer.get(), bytes_read, iv.hmac1)) {
-            // Either the DB is corrupted or we were interrupted between writing the
-            // new IV and writing the data
-            if (iv.iv2 == 0) {
-                // Very first write was interrupted
-                return false;
-            }
+bool AESCryptor::decrypt_block(off_t pos, char* dst, const char* src, size_t len, iv_table& iv)
+{
+    if (iv.iv1 == 0) {
+        // This block has never been written to, so we've just read pre-allocated
+        // space. No memset() since the code using this doesn't rely on
+        // pre-allocated space being zeroed.
+        return false;
+    }
 
-            if (check_hmac(m_rw_buffer.get(), bytes_read, iv.hmac2)) {
-                // Un-bump the IV since the write with the bumped IV never actually
-                // happened
-                memcpy(&iv.iv1, &iv.iv2, 32);
-            }
-            else {
-                // If the file has been shrunk and then re-expanded, we may have
-                // old hmacs that don't go with this data. ftruncate() is
-                // required to fill any added space with zeroes, so assume that's
-                // what happened if the buffer is all zeroes
-                for (ssize_t i = 0; i < bytes_read; ++i) {
-                    if (m_rw_buffer[i] != 0)
-                        throw DecryptionFailed();
-                }
-                return false;
-            }
+    if (!check_hmac(src, len, iv.hmac1)) {
+        // Either the DB is corrupted or we were interrupted between writing the
+        // new IV and writing the data
+        if (iv.iv2 == 0) {
+            // Very first write was interrupted
+            return false;
         }
 
-        // We may expect some adress ranges of the destination buffer of
-        // AESCryptor::read() to stay unmodified, i.e. being overwritten with
-        // the same bytes as already present, and may have read-access to these
-        // from other threads while decryption is taking place.
-        //
-        // However, some implementations of AES_cbc_encrypt(), in particular
-        // OpenSSL, will put garbled bytes as an intermediate step during the
-        // operation which will lead to incorrect data being read by other
-        // readers concurrently accessing that page. Incorrect data leads to
-        // crashes.
-        //
-        // We therefore decrypt to a temporary buffer first and then copy the
-        // completely decrypted data after.
-        crypt(mode_Decrypt, pos, m_dst_buffer.get(), m_rw_buffer.get(), reinterpret_cast<const char*>(&iv.iv1));
-        memcpy(dst, m_dst_buffer.get(), block_size);
-
-        pos += block_size;
-        dst += block_size;
-        size -= block_size;
+        if (check_hmac(src, len, iv.hmac2)) {
+            // Un-bump the IV since the write with the bumped IV never actually
+            // happened
+            memcpy(&iv.iv1, &iv.iv2, 32);
+        }
+        else {
+            // If the file has been shrunk and then re-expanded, we may have
+            // old hmacs that don't go with this data. ftruncate() is
+            // required to fill any added space with zeroes, so assume that's
+            // what happened if the buffer is all zeroes
+            for (size_t i = 0; i < len; ++i) {
+                if (src[i] != 0)
+                    throw DecryptionFailed();
+            }
+            return false;
+        }
     }
+
+    // We may expect some adress ranges of the destination buffer of
+    // AESCryptor::read() to stay unmodified, i.e. being overwritten with
+    // the same bytes as already present, and may have read-access to these
+    // from other threads while decryption is taking place.
+    //
+    // However, some implementations of AES_cbc_encrypt(), in particular
+    // OpenSSL, will put garbled bytes as an intermediate step during the
+    // operation which will lead to incorrect data being read by other
+    // readers concurrently accessing that page. Incorrect data leads to
+    // crashes.
+    //
+    // We therefore decrypt to a temporary buffer first and then copy the
+    // completely decrypted data after.
+    crypt(mode_Decrypt, pos, m_dst_buffer.get(), src, reinterpret_cast<const char*>(&iv.iv1));
+    memcpy(dst, m_dst_buffer.get(), block_size);
     return true;
 }
 
@@ -307,28 +357,35 @@ void AESCryptor::write(FileDesc fd, off_t pos, const char* src, size_t size) noe
 {
     REALM_ASSERT(size % block_size == 0);
     while (size > 0) {
-        iv_table& iv = get_iv_table(fd, pos);
+        size_t count = blocks_in_batch(pos, size);
+        iv_table* iv = &get_iv_table(fd, pos);
+
+        for (size_t i = 0; i < count; ++i) {
+            char* dst = m_rw_buffer.get() + i * block_size;
+            memcpy(&iv[i].iv2, &iv[i].iv1, 32);
+            do {
+                ++iv[i].iv1;
+                // 0 is reserved for never-been-used, so bump if we just wrapped around
+                if (iv[i].iv1 == 0)
+                    ++iv[i].iv1;
+
+                crypt(mode_Encrypt, pos + off_t(i * block_size), dst, src + i * block_size,
+                      reinterpret_cast<const char*>(&iv[i].iv1));
+                calc_hmac(dst, block_size, iv[i].hmac1);
+                // In the extremely unlikely case that both the old and new versions have
+                // the same hash we won't know which IV to use, so bump the IV until
+                // they're different.
+            } while (REALM_UNLIKELY(memcmp(iv[i].hmac1, iv[i].hmac2, 4) == 0));
+        }
 
-        memcpy(&iv.iv2, &iv.iv1, 32);
-        do {
-            ++iv.iv1;
-            // 0 is reserved for never-been-used, so bump if we just wrapped around
-            if (iv.iv1 == 0)
-                ++iv.iv1;
-
-            crypt(mode_Encrypt, pos, m_rw_buffer.get(), src, reinterpret_cast<const char*>(&iv.iv1));
-            calc_hmac(m_rw_buffer.get(), block_size, iv.hmac1, m_hmacKey);
-            // In the extremely unlikely case that both the old and new versions have
-            // the same hash we won't know which IV to use, so bump the IV until
-            // they're different.
-        } while (REALM_UNLIKELY(memcmp(iv.hmac1, iv.hmac2, 4) == 0));
-
-        check_write(fd, iv_table_pos(pos), &iv, sizeof(iv));
-        check_write(fd, real_offset(pos), m_rw_buffer.get(), block_size);
-
-        pos += block_size;
-        src += block_size;
-        size -= block_size;
+        // All IVs of the batch are written before any of the data, so the
+        // recovery in decrypt_block() applies to each block individually
+        check_write(fd, iv_table_pos(pos), iv, count * sizeof(iv_table));
+        check_write(fd, real_offset(pos), m_rw_buffer.get(), count * block_size);
+
+        pos += count * block_size;
+        src += count * block_size;
+        size -= count * block_size;
     }
 }
 
@@ -367,40 +424,38 @@ void AESCryptor::crypt(EncryptionMode mode, off_t pos, char* dst, const char* sr
     }
 
 #else
-    if (!EVP_CipherInit_ex(m_ctx, EVP_aes_256_cbc(), NULL, m_aesKey, iv, mode))
+    EVP_CIPHER_CTX* ctx = mode == mode_Encrypt ? m_encr : m_decr;
+    // Passing no cipher and no key keeps the expanded key and only resets the IV
+    if (!EVP_CipherInit_ex(ctx, NULL, NULL, NULL, iv, -1))
         handle_error();
 
     int len;
-    // Use zero padding - we always write a whole page
-    EVP_CIPHER_CTX_set_padding(m_ctx, 0);
-
-    if (!EVP_CipherUpdate(m_ctx, reinterpret_cast<uint8_t*>(dst), &len, reinterpret_cast<const uint8_t*>(src),
+    if (!EVP_CipherUpdate(ctx, reinterpret_cast<uint8_t*>(dst), &len, reinterpret_cast<const uint8_t*>(src),
                           block_size))
         handle_error();
 
     // Finalize the encryption. Should not output further data.
-    if (!EVP_CipherFinal_ex(m_ctx, reinterpret_cast<uint8_t*>(dst) + len, &len))
+    if (!EVP_CipherFinal_ex(ctx, reinterpret_cast<uint8_t*>(dst) + len, &len))
         handle_error();
 #endif
 }
 
-void AESCryptor::calc_hmac(const void* src, size_t len, uint8_t* dst, const uint8_t* key) const
+void AESCryptor::calc_hmac(const void* src, size_t len, uint8_t* dst) const
 {
 #if REALM_PLATFORM_APPLE
-    CCHmac(kCCHmacAlgSHA224, key, 32, src, len, dst);
-#else
+    CCHmac(kCCHmacAlgSHA224, m_hmacKey, 32, src, len, dst);
+#elif defined(_WIN32)
     uint8_t ipad[64];
     for (size_t i = 0; i < 32; ++i)
-        ipad[i] = key[i] ^ 0x36;
+        ipad[i] = m_hmacKey[i] ^ 0x36;
     memset(ipad + 32, 0x36, 32);
 
     uint8_t opad[64] = {0};
     for (size_t i = 0; i < 32; ++i)
-        opad[i] = key[i] ^ 0x5C;
+        opad[i] = m_hmacKey[i] ^ 0x5C;
     memset(opad + 32, 0x5C, 32);
 
     // Full hmac operation is sha224(opad + sha224(ipad + data))
-#ifdef _WIN32
     sha224_state s;
     sha_init(s);
     sha_process(s, ipad, 64);
@@ -412,19 +467,16 @@ void AESCryptor::calc_hmac(const void* src, size_t len, uint8_t* dst, const uint
     sha_process(s, dst, 28); // 28 == SHA224_DIGEST_LENGTH
     sha_done(s, dst);
 #else
-    SHA256_CTX ctx;
-    SHA224_Init(&ctx);
-    SHA256_Update(&ctx, ipad, 64);
+    // Full hmac operation is sha224(opad + sha224(ipad + data)), where the
+    // pads have been absorbed by the constructor
+    SHA256_CTX ctx = m_hmac_inner;
     SHA256_Update(&ctx, static_cast<const uint8_t*>(src), len);
     SHA256_Final(dst, &ctx);
 
-    SHA224_Init(&ctx);
-    SHA256_Update(&ctx, opad, 64);
+    ctx = m_hmac_outer;
     SHA256_Update(&ctx, dst, SHA224_DIGEST_LENGTH);
     SHA256_Final(dst, &ctx);
 #endif
-
-#endif
 }
 
 EncryptedFileMapping::EncryptedFileMapping(SharedFileInfo& file, size_t file_offset, void* addr, size_t size,
@@ -502,13 +554,22 @@ void EncryptedFileMapping::refresh_page(size_t local_page_ndx)
 {
     REALM_ASSERT_EX(local_page_ndx < m_page_state.size(), local_page_ndx, m_page_state.size());
 
-    char* addr = page_addr(local_page_ndx);
+    if (!copy_up_to_date_page(local_page_ndx))
+        decrypt_pages(local_page_ndx, 1);
+    mark_up_to_date(local_page_ndx);
+}
+
+void EncryptedFileMapping::decrypt_pages(size_t local_page_ndx, size_t count)
+{
+    REALM_ASSERT_EX(local_page_ndx + count <= m_page_state.size(), local_page_ndx, count, m_page_state.size());
 
-    if (!copy_up_to_date_page(local_page_ndx)) {
-        size_t page_ndx_in_file = local_page_ndx + m_first_page;
-        m_file.cryptor.read(m_file.fd, off_t(page_ndx_in_file << m_page_shift),
-                            addr, static_cast<size_t>(1ULL << m_page_shift));
-    }
+    size_t page_ndx_in_file = local_page_ndx + m_first_page;
+    m_file.cryptor.read(m_file.fd, off_t(page_ndx_in_file << m_page_shift), page_addr(local_page_ndx),
+                        count << m_page_shift);
+}
+
+void EncryptedFileMapping::mark_up_to_date(size_t local_page_ndx) noexcept
+{
     if (is_not(m_page_state[local_page_ndx], UpToDate | PartiallyUpToDate))
         m_num_decrypted++;
     clear(m_page_state[local_page_ndx], PartiallyUpToDate);
@@ -694,10 +755,17 @@ void EncryptedFileMapping::flush() noexcept
             continue;
         }
 
+        // Consecutive dirty pages are encrypted and written in one go
+        size_t end_ndx = local_page_ndx;
+        do {
+            clear(m_page_state[end_ndx], Dirty);
+            ++end_ndx;
+        } while (end_ndx < num_dirty_pages && is(m_page_state[end_ndx], Dirty));
+
         size_t page_ndx_in_file = local_page_ndx + m_first_page;
         m_file.cryptor.write(m_file.fd, off_t(page_ndx_in_file << m_page_shift), page_addr(local_page_ndx),
-                             static_cast<size_t>(1ULL << m_page_shift));
-        clear(m_page_state[local_page_ndx], Dirty);
+                             (end_ndx - local_page_ndx) << m_page_shift);
+        local_page_ndx = end_ndx - 1;
     }
 
     validate();
@@ -748,46 +816,64 @@ void EncryptedFileMapping::write_barrier(const void* addr, size_t size) noexcept
 void EncryptedFileMapping::read_barrier(const void* addr, size_t size, Header_to_size header_to_size)
 {
     size_t first_accessed_local_page = get_local_index_of_address(addr);
+    size_t first_idx = first_accessed_local_page;
 
-    {
+    if (header_to_size) {
         // make sure the first page is available
         PageState& ps = m_page_state[first_accessed_local_page];
         if (is_not(ps, Touched))
             set(ps, Touched);
         if (is_not(ps, UpToDate))
             refresh_page(first_accessed_local_page);
-    }
-
-    // force the page reclaimer to look into pages in this chunk:
-    size_t chunk_ndx = first_accessed_local_page >> page_to_chunk_shift;
-    if (m_chunk_dont_scan[chunk_ndx])
-        m_chunk_dont_scan[chunk_ndx] = 0;
-
-    if (header_to_size) {
 
         // We know it's an array, and array headers are 8-byte aligned, so it is
         // included in the first page which was handled above.
         size = header_to_size(static_cast<const char*>(addr));
+        ++first_idx;
     }
 
     size_t last_idx = get_local_index_of_address(addr, size == 0 ? 0 : size - 1);
     size_t pages_size = m_page_state.size();
 
-    // We already checked first_accessed_local_page above, so we start the loop
-    // at first_accessed_local_page + 1 to check the following page.
-    for (size_t idx = first_accessed_local_page + 1; idx <= last_idx && idx < pages_size; ++idx) {
+    // Pages which are not up to date in any other mapping either are
+    // collected into runs of consecutive pages, each of which is decrypted
+    // with a single call to the cryptor.
+    size_t run_begin = first_idx;
+    size_t run_end = first_idx;
+    auto decrypt_run = [&] {
+        if (run_begin == run_end)
+            return;
+        decrypt_pages(run_begin, run_end - run_begin);
+        for (size_t i = run_begin; i < run_end; ++i)
+            mark_up_to_date(i);
+    };
+
+    for (size_t idx = first_accessed_local_page; idx <= last_idx && idx < pages_size; ++idx) {
 
         // force the page reclaimer to look into pages in this chunk
-        chunk_ndx = idx >> page_to_chunk_shift;
+        size_t chunk_ndx = idx >> page_to_chunk_shift;
         if (m_chunk_dont_scan[chunk_ndx])
             m_chunk_dont_scan[chunk_ndx] = 0;
 
+        if (idx < first_idx)
+            continue;
+
         PageState& ps = m_page_state[idx];
         if (is_not(ps, Touched))
             set(ps, Touched);
-        if (is_not(ps, UpToDate))
-            refresh_page(idx);
+        if (is(ps, UpToDate))
+            continue;
+        if (copy_up_to_date_page(idx)) {
+            mark_up_to_date(idx);
+            continue;
+        }
+        if (run_end != idx) {
+            decrypt_run();
+            run_begin = idx;
+        }
+        run_end = idx + 1;
     }
+    decrypt_run();
 }
 
 
@@ -135,6 +135,8 @@ private:
     void mark_outdated(size_t local_page_ndx) noexcept;
     bool copy_up_to_date_page(size_t local_page_ndx) noexcept;
     void refresh_page(size_t local_page_ndx);
+    void decrypt_pages(size_t local_page_ndx, size_t count);
+    void mark_up_to_date(size_t local_page_ndx) noexcept;
     void write_page(size_t local_page_ndx) noexcept;
     void reclaim_page(size_t page_ndx);
     void validate_page(size_t local_page_ndx) noexcept;
@@ -61,6 +61,19 @@ inline unsigned long long _xgetbv(unsigned index)
 }
 
 #endif
+
+// Fills `info` with EAX, EBX, ECX and EDX of the given CPUID leaf and sub-leaf
+inline void cpuidex(int info[4], int leaf, int subleaf)
+{
+#ifdef _MSC_VER
+    __cpuidex(info, leaf, subleaf);
+#else
+    __asm__ __volatile__("cpuid"
+                         : "=a"(info[0]), "=b"(info[1]), "=c"(info[2]), "=d"(info[3])
+                         : "a"(leaf), "c"(subleaf));
+#endif
+}
+
 #endif
 #endif
 
@@ -106,6 +119,8 @@ void cpuid_init()
     }
 
     bool avxSupported = false;
+    bool avx2Supported = false;
+    bool avx512Supported = false;
 
 // seems like in jenkins builds, __GNUC__ is defined for clang?! todo fixme
 #if !defined __clang__ && ((defined(_MSC_FULL_VER) && _MSC_FULL_VER >= 160040219) || defined __GNUC__)
@@ -116,18 +131,36 @@ void cpuid_init()
         // Check if the OS will save the YMM registers
         unsigned long long xcrFeatureMask = _xgetbv(_XCR_XFEATURE_ENABLED_MASK);
         avxSupported = (xcrFeatureMask & 0x6) || false;
+
+        if (avxSupported) {
+            int leaf_info[4];
+            cpuidex(leaf_info, 0, 0);
+            if (leaf_info[0] >= 7) {
+                // Structured extended feature flags are in EBX of leaf 7, sub-leaf 0
+                cpuidex(leaf_info, 7, 0);
+                unsigned int features = unsigned(leaf_info[1]);
+                avx2Supported = (features & (1 << 5)) != 0;
+                // AVX-512 additionally requires the OS to save the opmask and upper ZMM state (XCR0 bits 5-7)
+                avx512Supported = avx2Supported && (features & (1 << 16)) && (features & (1 << 30)) &&
+                                  (xcrFeatureMask & 0xe6) == 0xe6;
+            }
+        }
     }
 #endif
 
-    if (avxSupported) {
+    if (avx512Supported) {
+        avx_support = 2; // AVX-512 F and BW supported
+    }
+    else if (avx2Supported) {
+        avx_support = 1; // AVX2 supported
+    }
+    else if (avxSupported) {
         avx_support = 0; // AVX1 supported
     }
     else {
         avx_support = -1; // No AVX supported
     }
 
-// 1 is reserved for AVX2
-
 #endif
 }
 
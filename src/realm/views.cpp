@@ -19,6 +19,9 @@
 #include <realm/views.hpp>
 
 #include <realm/column_link.hpp>
+#include <realm/column_string.hpp>
+#include <realm/column_string_enum.hpp>
+#include <realm/column_timestamp.hpp>
 #include <realm/exceptions.hpp>
 #include <realm/group.hpp>
 #include <realm/table.hpp>
@@ -30,6 +33,53 @@ using namespace realm;
 
 namespace {
 
+// Views smaller than this are sorted with std::sort, as the fixed cost of the
+// radix passes outweighs the savings
+const size_t radix_sort_threshold = 256;
+
+template <class T>
+int compare_keys(const T& a, const T& b)
+{
+    return a == b ? 0 : a < b ? 1 : -1;
+}
+
+int compare_keys(StringData a, StringData b)
+{
+    return a == b ? 0 : utf8_compare(a, b) ? 1 : -1;
+}
+
+// Maps a signed integer onto an unsigned one with the same ordering, inverted
+// for descending sorts
+uint64_t radix_key(int64_t value, bool ascending)
+{
+    uint64_t key = uint64_t(value) ^ (uint64_t(1) << 63);
+    return ascending ? key : ~key;
+}
+
+// Stable LSD radix sort of `rows` on the 64-bit keys, one byte per pass.
+// Passes in which all keys have the same byte are skipped.
+void radix_sort(std::vector<std::pair<uint64_t, ColumnsDescriptor::IndexPair>>& rows)
+{
+    std::vector<std::pair<uint64_t, ColumnsDescriptor::IndexPair>> buffer(rows.size());
+    for (unsigned shift = 0; shift < 64; shift += 8) {
+        size_t offsets[256] = {0};
+        for (auto& row : rows)
+            ++offsets[(row.first >> shift) & 0xFF];
+        if (offsets[(rows.front().first >> shift) & 0xFF] == rows.size())
+            continue;
+
+        size_t offset = 0;
+        for (size_t& count : offsets) {
+            size_t next = offset + count;
+            count = offset;
+            offset = next;
+        }
+        for (auto& row : rows)
+            buffer[offsets[(row.first >> shift) & 0xFF]++] = row;
+        rows.swap(buffer);
+    }
+}
+
 } // anonymous namespace
 
 ColumnsDescriptor::ColumnsDescriptor(Table const& table, std::vector<std::vector<size_t>> column_indices)
@@ -106,6 +156,27 @@ public:
 
     bool operator()(IndexPair i, IndexPair j, bool total_ordering = true) const;
 
+    // Sort `rows` into the order defined by operator(). Single integer
+    // columns are radix sorted on the extracted keys.
+    void sort(std::vector<IndexPair>& rows) const;
+
+    // Sort only the first `count` rows into place, leaving the rest in
+    // unspecified order
+    void partial_sort(std::vector<IndexPair>& rows, size_t count) const;
+
+    // Whether distinct() can be used, which requires keys to have been
+    // extracted for all columns
+    bool can_hash() const
+    {
+        return std::all_of(m_columns.begin(), m_columns.end(),
+                           [](auto&& col) { return col.key_type != KeyType::unsupported; });
+    }
+
+    // Remove all rows which are equal to a row with a lower index_in_view,
+    // leaving the remaining rows in index_in_view order. Rows with null links
+    // must have been removed first.
+    void distinct(std::vector<IndexPair>& rows) const;
+
     bool has_links() const
     {
         return std::any_of(m_columns.begin(), m_columns.end(),
@@ -119,13 +190,30 @@ public:
     }
 
 private:
+    // The values of the sorted column are copied into one of the key vectors
+    // up front, indexed by index_in_view, so that comparisons do not have to
+    // look them up in the column. Columns of other types are compared through
+    // ColumnBase::compare_values().
+    enum class KeyType { unsupported, integer, floating, timestamp, string };
+
     struct SortColumn {
         std::vector<bool> is_null;
         std::vector<size_t> translated_row;
         const ColumnBase* column;
         bool ascending;
+        KeyType key_type;
+        std::vector<bool> key_is_null;
+        std::vector<int64_t> int_keys;
+        std::vector<double> double_keys;
+        std::vector<Timestamp> timestamp_keys;
+        std::vector<StringData> string_keys;
     };
     std::vector<SortColumn> m_columns;
+
+    static KeyType get_key_type(const ColumnBase& column);
+    static void extract_keys(SortColumn& col, std::vector<IndexPair> const& rows);
+    static int compare_keys(const SortColumn& col, size_t i, size_t j);
+    static uint64_t hash_key(const SortColumn& col, size_t i);
 };
 
 ColumnsDescriptor::Sorter::Sorter(std::vector<std::vector<const ColumnBase*>> const& columns,
@@ -136,9 +224,11 @@ ColumnsDescriptor::Sorter::Sorter(std::vector<std::vector<const ColumnBase*>> co
 
     m_columns.reserve(columns.size());
     for (size_t i = 0; i < columns.size(); ++i) {
-        m_columns.push_back({{}, {}, columns[i].back(), ascending[i]});
+        m_columns.push_back({{}, {}, columns[i].back(), ascending[i], get_key_type(*columns[i].back()),
+                             {}, {}, {}, {}, {}});
         REALM_ASSERT_EX(!columns[i].empty(), i);
         if (columns[i].size() == 1) { // no link chain
+            extract_keys(m_columns.back(), rows);
             continue;
         }
 
@@ -163,9 +253,195 @@ ColumnsDescriptor::Sorter::Sorter(std::vector<std::vector<const ColumnBase*>> co
             }
             translated_rows[index_in_view] = translated_index;
         }
+        extract_keys(m_columns.back(), rows);
     }
 }
 
+ColumnsDescriptor::Sorter::KeyType ColumnsDescriptor::Sorter::get_key_type(const ColumnBase& column)
+{
+    // Only exact types qualify, as several column types derive from
+    // IntegerColumn and compare their values differently
+    const std::type_info& type = typeid(column);
+    if (type == typeid(IntegerColumn) || type == typeid(IntNullColumn))
+        return KeyType::integer;
+    if (type == typeid(DoubleColumn) || type == typeid(FloatColumn))
+        return KeyType::floating;
+    if (type == typeid(TimestampColumn))
+        return KeyType::timestamp;
+    if (type == typeid(StringColumn) || type == typeid(StringEnumColumn))
+        return KeyType::string;
+    return KeyType::unsupported;
+}
+
+void ColumnsDescriptor::Sorter::extract_keys(SortColumn& col, std::vector<IndexPair> const& rows)
+{
+    if (col.key_type == KeyType::unsupported || rows.empty())
+        return;
+
+    size_t max_index = std::max_element(rows.begin(), rows.end(), [](auto&& a, auto&& b) {
+                           return a.index_in_view < b.index_in_view;
+                       })->index_in_view;
+    col.key_is_null.resize(max_index + 1);
+    switch (col.key_type) {
+        case KeyType::integer:
+            col.int_keys.resize(max_index + 1);
+            break;
+        case KeyType::floating:
+            col.double_keys.resize(max_index + 1);
+            break;
+        case KeyType::timestamp:
+            col.timestamp_keys.resize(max_index + 1);
+            break;
+        case KeyType::string:
+            col.string_keys.resize(max_index + 1);
+            break;
+        case KeyType::unsupported:
+            break;
+    }
+
+    const ColumnBase& column = *col.column;
+    for (auto& row : rows) {
+        size_t i = row.index_in_view;
+        size_t ndx = row.index_in_column;
+        if (!col.translated_row.empty()) {
+            if (col.is_null[i])
+                continue;
+            ndx = col.translated_row[i];
+        }
+        switch (col.key_type) {
+            case KeyType::integer:
+                if (column.is_null(ndx))
+                    col.key_is_null[i] = true;
+                else if (typeid(column) == typeid(IntegerColumn))
+                    col.int_keys[i] = static_cast<const IntegerColumn&>(column).get(ndx);
+                else
+                    col.int_keys[i] = *static_cast<const IntNullColumn&>(column).get(ndx);
+                break;
+            case KeyType::floating:
+                if (column.is_null(ndx))
+                    col.key_is_null[i] = true;
+                else if (typeid(column) == typeid(DoubleColumn))
+                    col.double_keys[i] = static_cast<const DoubleColumn&>(column).get(ndx);
+                else
+                    col.double_keys[i] = static_cast<const FloatColumn&>(column).get(ndx);
+                break;
+            case KeyType::timestamp:
+                if (column.is_null(ndx))
+                    col.key_is_null[i] = true;
+                else
+                    col.timestamp_keys[i] = static_cast<const TimestampColumn&>(column).get(ndx);
+                break;
+            case KeyType::string: {
+                StringData value = typeid(column) == typeid(StringColumn)
+                                       ? static_cast<const StringColumn&>(column).get(ndx)
+                                       : static_cast<const StringEnumColumn&>(column).get(ndx);
+                if (value.is_null())
+                    col.key_is_null[i] = true;
+                else
+                    col.string_keys[i] = value;
+                break;
+            }
+            case KeyType::unsupported:
+                break;
+        }
+    }
+}
+
+uint64_t ColumnsDescriptor::Sorter::hash_key(const SortColumn& col, size_t i)
+{
+    if (col.key_is_null[i])
+        return 0;
+
+    switch (col.key_type) {
+        case KeyType::integer:
+            return uint64_t(col.int_keys[i]);
+        case KeyType::floating: {
+            // 0.0 and -0.0 compare equal, so they must hash equal too
+            double value = col.double_keys[i] == 0 ? 0.0 : col.double_keys[i];
+            uint64_t bits;
+            memcpy(&bits, &value, sizeof(bits));
+            return bits;
+        }
+        case KeyType::timestamp:
+            return uint64_t(col.timestamp_keys[i].get_seconds()) * 1000000007 +
+                   uint64_t(col.timestamp_keys[i].get_nanoseconds());
+        case KeyType::string:
+            return std::hash<StringData>()(col.string_keys[i]);
+        case KeyType::unsupported:
+            break;
+    }
+    REALM_UNREACHABLE();
+}
+
+int ColumnsDescriptor::Sorter::compare_keys(const SortColumn& col, size_t i, size_t j)
+{
+    // Same convention as ColumnBase::compare_values(): positive if the value
+    // at `i` comes first, and null before everything else
+    bool null_i = col.key_is_null[i];
+    bool null_j = col.key_is_null[j];
+    if (null_i || null_j)
+        return null_i == null_j ? 0 : null_i ? 1 : -1;
+
+    switch (col.key_type) {
+        case KeyType::integer:
+            return ::compare_keys(col.int_keys[i], col.int_keys[j]);
+        case KeyType::floating:
+            return ::compare_keys(col.double_keys[i], col.double_keys[j]);
+        case KeyType::timestamp:
+            return ::compare_keys(col.timestamp_keys[i], col.timestamp_keys[j]);
+        case KeyType::string:
+            return ::compare_keys(col.string_keys[i], col.string_keys[j]);
+        case KeyType::unsupported:
+            break;
+    }
+    REALM_UNREACHABLE();
+}
+
+void ColumnsDescriptor::Sorter::sort(std::vector<IndexPair>& rows) const
+{
+    if (m_columns.size() != 1 || m_columns[0].key_type != KeyType::integer || rows.size() < radix_sort_threshold) {
+        std::sort(rows.begin(), rows.end(), std::ref(*this));
+        return;
+    }
+
+    // The radix sort is stable, so ties are left in index_in_view order as
+    // operator() requires if the input is in that order to begin with
+    auto by_index_in_view = [](auto&& a, auto&& b) { return a.index_in_view < b.index_in_view; };
+    if (!std::is_sorted(rows.begin(), rows.end(), by_index_in_view))
+        std::sort(rows.begin(), rows.end(), by_index_in_view);
+
+    // Null values come first in ascending order and last in descending
+    // order, and null links the other way around
+    const SortColumn& col = m_columns[0];
+    std::vector<IndexPair> null_values;
+    std::vector<IndexPair> null_links;
+    std::vector<std::pair<uint64_t, IndexPair>> keyed;
+    keyed.reserve(rows.size());
+    for (auto& row : rows) {
+        size_t i = row.index_in_view;
+        if (!col.is_null.empty() && col.is_null[i])
+            null_links.push_back(row);
+        else if (col.key_is_null[i])
+            null_values.push_back(row);
+        else
+            keyed.push_back({radix_key(col.int_keys[i], col.ascending), row});
+    }
+    if (!keyed.empty())
+        radix_sort(keyed);
+
+    auto out = rows.begin();
+    if (!col.ascending)
+        out = std::copy(null_links.begin(), null_links.end(), out);
+    if (col.ascending)
+        out = std::copy(null_values.begin(), null_values.end(), out);
+    for (auto& row : keyed)
+        *out++ = row.second;
+    if (!col.ascending)
+        out = std::copy(null_values.begin(), null_values.end(), out);
+    if (col.ascending)
+        out = std::copy(null_links.begin(), null_links.end(), out);
+}
+
 DescriptorExport ColumnsDescriptor::export_for_handover() const
 {
     std::vector<std::vector<DescriptorLinkPath>> column_indices;
@@ -289,6 +565,12 @@ bool SortDescriptor::Sorter::operator()(IndexPair i, IndexPair j, bool total_ord
             index_j = m_columns[t].translated_row[j.index_in_view];
         }
 
+        if (m_columns[t].key_type != KeyType::unsupported) {
+            if (int c = compare_keys(m_columns[t], i.index_in_view, j.index_in_view))
+                return m_columns[t].ascending ? c > 0 : c < 0;
+            continue;
+        }
+
         if (int c = m_columns[t].column->compare_values(index_i, index_j))
             return m_columns[t].ascending ? c > 0 : c < 0;
     }
@@ -296,6 +578,63 @@ bool SortDescriptor::Sorter::operator()(IndexPair i, IndexPair j, bool total_ord
     return total_ordering ? i.index_in_view < j.index_in_view : 0;
 }
 
+void ColumnsDescriptor::Sorter::partial_sort(std::vector<IndexPair>& rows, size_t count) const
+{
+    // A bounded heap costs O(n log count) against O(n log n) for a full sort,
+    // and since operator() is a total ordering the first `count` rows come
+    // out the same either way
+    if (count >= rows.size() / 2) {
+        sort(rows);
+        return;
+    }
+    std::partial_sort(rows.begin(), rows.begin() + count, rows.end(), std::ref(*this));
+}
+
+void ColumnsDescriptor::Sorter::distinct(std::vector<IndexPair>& rows) const
+{
+    REALM_ASSERT(can_hash());
+    if (rows.empty())
+        return;
+
+    auto by_index_in_view = [](auto&& a, auto&& b) { return a.index_in_view < b.index_in_view; };
+    if (!std::is_sorted(rows.begin(), rows.end(), by_index_in_view))
+        std::sort(rows.begin(), rows.end(), by_index_in_view);
+
+    auto equal = [&](IndexPair a, IndexPair b) {
+        for (auto& col : m_columns) {
+            if (compare_keys(col, a.index_in_view, b.index_in_view) != 0)
+                return false;
+        }
+        return true;
+    };
+
+    // Open addressing with linear probing. The slots hold positions in
+    // `rows` of the rows kept so far, which are compacted to the front as
+    // we go, so the table never refers to a position not yet written.
+    int bits = 1;
+    while ((size_t(1) << bits) < rows.size() * 2)
+        ++bits;
+    const size_t mask = (size_t(1) << bits) - 1;
+    std::vector<size_t> slots(mask + 1, npos);
+
+    size_t kept = 0;
+    for (size_t pos = 0; pos < rows.size(); ++pos) {
+        IndexPair row = rows[pos];
+        uint64_t hash = 0;
+        for (auto& col : m_columns)
+            hash = (hash ^ hash_key(col, row.index_in_view)) * 0x9E3779B97F4A7C15ULL;
+        size_t slot = size_t(hash >> (64 - bits));
+        while (slots[slot] != npos && !equal(rows[slots[slot]], row))
+            slot = (slot + 1) & mask;
+        if (slots[slot] != npos)
+            continue; // duplicate of a row with a lower index_in_view
+
+        slots[slot] = kept;
+        rows[kept++] = row;
+    }
+    rows.resize(kept);
+}
+
 LimitDescriptor::LimitDescriptor(size_t limit)
     : m_limit(limit)
 {
@@ -824,7 +1163,16 @@ void RowIndexes::do_sort(const DescriptorOrdering& ordering) {
                 const auto* sort_descr = static_cast<const SortDescriptor*>(ordering[desc_ndx]);
                 SortDescriptor::Sorter sort_predicate = sort_descr->sorter(v);
 
-                std::sort(v.begin(), v.end(), std::ref(sort_predicate));
+                // When the sort is followed by a limit only the rows which
+                // survive the limit need to be put in order. The limit step
+                // then drops the rest.
+                bool is_limited = desc_ndx + 1 < num_descriptors && ordering.descriptor_is_limit(desc_ndx + 1);
+                size_t limit = is_limited ? static_cast<const LimitDescriptor*>(ordering[desc_ndx + 1])->get_limit()
+                                          : v.size();
+                if (limit < v.size())
+                    sort_predicate.partial_sort(v, limit);
+                else
+                    sort_predicate.sort(v);
 
                 bool is_last_ordering = desc_ndx == num_descriptors - 1;
                 // not doing this on the last step is an optimisation
@@ -851,8 +1199,15 @@ void RowIndexes::do_sort(const DescriptorOrdering& ordering) {
                             v.end());
                 }
 
+                if (distinct_predicate.can_hash()) {
+                    // Keeps the first of each set of equal rows in a single
+                    // pass, and leaves the rows in their original order
+                    distinct_predicate.distinct(v);
+                    break;
+                }
+
                 // Sort by the columns to distinct on
-                std::sort(v.begin(), v.end(), std::ref(distinct_predicate));
+                distinct_predicate.sort(v);
 
                 // Remove all duplicates
                 v.erase(std::unique(v.begin(), v.end(),
@@ -0,0 +1,295 @@
+/*************************************************************************
+ *
+ * Copyright 2016 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#ifndef REALM_ZONE_MAP_HPP
+#define REALM_ZONE_MAP_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include <realm/array_basic.hpp>
+#include <realm/array_integer.hpp>
+#include <realm/null.hpp>
+#include <realm/query_conditions.hpp>
+#include <realm/util/optional.hpp>
+
+namespace realm {
+
+/// A zone map summarizes every leaf of a B+-tree of ordered values (integers,
+/// timestamp seconds, floats and doubles) by the smallest and largest non-null
+/// value and the number of nulls in it. The query engine uses it to skip
+/// leaves which cannot contain a match without opening them.
+///
+/// Zone maps are not part of the file format. They are built on demand by the
+/// column accessor and tagged with the version of the table that owns the
+/// column (Table::get_version_counter()), so any modification of the table
+/// makes them stale, and they are rebuilt the next time a query scans enough of
+/// the column to need them (see ZoneMapCursor).
+template <class T>
+class ZoneMap {
+public:
+    struct Zone {
+        size_t end; // One past the last row of the leaf
+        size_t size;
+        size_t null_count;
+        T min; // Undefined if all values are null
+        T max; // Undefined if all values are null
+    };
+
+    bool is_valid_for(uint_fast64_t version) const noexcept
+    {
+        return m_valid && m_version == version;
+    }
+
+    template <class Tree>
+    void build(const Tree& tree, bool nullable, uint_fast64_t version);
+
+    /// Returns the first row in [ndx, end) which lies in a zone for which
+    /// `may_match` returns true, or `end` if there is no such row. Upon return
+    /// [zone_begin, zone_end) is the zone containing the returned row.
+    template <class Pred>
+    size_t skip(size_t ndx, size_t end, Pred may_match, size_t& zone_begin, size_t& zone_end) const noexcept;
+
+    /// Returns false if no row of `zone` can satisfy `Cond` with `value` as
+    /// right-hand side. Conditions for which that cannot be decided from the
+    /// summary always return true.
+    template <class Cond>
+    static bool may_match(const Zone& zone, T value, bool value_is_null) noexcept;
+
+private:
+    std::vector<Zone> m_zones;
+    uint_fast64_t m_version = 0;
+    bool m_valid = false;
+
+    static void summarize(const ArrayInteger&, bool nullable, Zone&);
+    static void summarize(const ArrayIntNull&, bool nullable, Zone&);
+    template <class L>
+    static void summarize(const BasicArray<L>&, bool nullable, Zone&);
+};
+
+/// Zone map lookups of a single query node. Remembers the last zone found to
+/// possibly contain matches, so that consecutive lookups within it are cheap.
+///
+/// The zone map is only requested from the column the first time a lookup
+/// covers at least a leaf worth of rows. Queries that never scan more than a
+/// few rows of the column, such as those answered through an index or
+/// evaluated one row at a time, therefore never build it.
+template <class T>
+class ZoneMapCursor {
+public:
+    void reset() noexcept
+    {
+        m_zone_map = nullptr;
+        m_loaded = false;
+        m_zone_begin = 0;
+        m_zone_end = 0;
+    }
+
+    /// Requests the zone map through `get_zone_map()`, which returns null if
+    /// the column has none, unless that has been done since the last reset.
+    template <class Get>
+    void load(Get get_zone_map)
+    {
+        if (m_loaded)
+            return;
+        m_zone_map = get_zone_map(); // Throws
+        m_loaded = true;
+    }
+
+    /// Returns the first row in [ndx, end) which is not in a zone that is
+    /// known not to contain matches for `Cond`, or `end` if there is none.
+    template <class Cond, class Get>
+    size_t next(size_t ndx, size_t end, T value, bool value_is_null, Get get_zone_map)
+    {
+        if (ndx >= m_zone_begin && ndx < m_zone_end)
+            return ndx;
+        if (!m_loaded) {
+            // Less than a leaf is scanned quicker than the zone map is built
+            if (end - ndx < REALM_MAX_BPNODE_SIZE)
+                return ndx;
+            load(get_zone_map); // Throws
+        }
+        if (!m_zone_map)
+            return ndx;
+        auto may_match = [=](const typename ZoneMap<T>::Zone& zone) {
+            return ZoneMap<T>::template may_match<Cond>(zone, value, value_is_null);
+        };
+        return m_zone_map->skip(ndx, end, may_match, m_zone_begin, m_zone_end);
+    }
+
+private:
+    const ZoneMap<T>* m_zone_map = nullptr;
+    bool m_loaded = false;
+    size_t m_zone_begin = 0;
+    size_t m_zone_end = 0;
+};
+
+template <class T>
+struct ZoneMapType {
+    using type = T;
+};
+
+template <>
+struct ZoneMapType<util::Optional<int64_t>> {
+    using type = int64_t;
+};
+
+
+// Implementation:
+
+template <class T>
+template <class Tree>
+void ZoneMap<T>::build(const Tree& tree, bool nullable, uint_fast64_t version)
+{
+    m_valid = false;
+    m_zones.clear();
+
+    using LeafType = typename Tree::LeafType;
+    LeafType fallback(tree.get_alloc());
+    const LeafType* leaf = nullptr;
+    typename Tree::LeafInfo leaf_info{&leaf, &fallback};
+
+    size_t size = tree.size();
+    for (size_t ndx = 0; ndx < size;) {
+        size_t ndx_in_leaf;
+        tree.get_leaf(ndx, ndx_in_leaf, leaf_info);
+        REALM_ASSERT_DEBUG(ndx_in_leaf == 0);
+        Zone zone;
+        zone.size = leaf->size();
+        zone.null_count = 0;
+        summarize(*leaf, nullable, zone);
+        ndx += zone.size;
+        zone.end = ndx;
+        m_zones.push_back(zone); // Throws
+    }
+
+    m_version = version;
+    m_valid = true;
+}
+
+template <class T>
+template <class Pred>
+size_t ZoneMap<T>::skip(size_t ndx, size_t end, Pred may_match, size_t& zone_begin, size_t& zone_end) const
+    noexcept
+{
+    auto compare = [](size_t row_ndx, const Zone& zone) { return row_ndx < zone.end; };
+    auto i = std::upper_bound(m_zones.begin(), m_zones.end(), ndx, compare);
+    while (ndx < end && i != m_zones.end()) {
+        if (may_match(*i)) {
+            zone_begin = i == m_zones.begin() ? 0 : (i - 1)->end;
+            zone_end = i->end;
+            return ndx;
+        }
+        ndx = i->end;
+        ++i;
+    }
+    return end;
+}
+
+template <class T>
+template <class Cond>
+bool ZoneMap<T>::may_match(const Zone& zone, T value, bool value_is_null) noexcept
+{
+    size_t non_null_count = zone.size - zone.null_count;
+    if (std::is_same<Cond, NotNull>::value)
+        return non_null_count > 0;
+
+    if (value_is_null) {
+        if (std::is_same<Cond, Equal>::value)
+            return zone.null_count > 0;
+        if (std::is_same<Cond, NotEqual>::value)
+            return non_null_count > 0;
+        return true;
+    }
+
+    if (std::is_same<Cond, Equal>::value)
+        return non_null_count > 0 && !(value < zone.min) && !(zone.max < value);
+    if (std::is_same<Cond, NotEqual>::value)
+        return zone.null_count > 0 || (non_null_count > 0 && !(zone.min == value && zone.max == value));
+    if (std::is_same<Cond, Greater>::value)
+        return non_null_count > 0 && zone.max > value;
+    if (std::is_same<Cond, GreaterEqual>::value)
+        return non_null_count > 0 && zone.max >= value;
+    if (std::is_same<Cond, Less>::value)
+        return non_null_count > 0 && zone.min < value;
+    if (std::is_same<Cond, LessEqual>::value)
+        return non_null_count > 0 && zone.min <= value;
+    return true;
+}
+
+template <class T>
+void ZoneMap<T>::summarize(const ArrayInteger& leaf, bool, Zone& zone)
+{
+    leaf.minimum(zone.min);
+    leaf.maximum(zone.max);
+}
+
+template <class T>
+void ZoneMap<T>::summarize(const ArrayIntNull& leaf, bool, Zone& zone)
+{
+    zone.min = std::numeric_limits<int64_t>::max();
+    zone.max = std::numeric_limits<int64_t>::min();
+    for (size_t i = 0; i < zone.size; ++i) {
+        util::Optional<int64_t> v = leaf.get(i);
+        if (!v) {
+            ++zone.null_count;
+            continue;
+        }
+        if (*v < zone.min)
+            zone.min = *v;
+        if (*v > zone.max)
+            zone.max = *v;
+    }
+}
+
+template <class T>
+template <class L>
+void ZoneMap<T>::summarize(const BasicArray<L>& leaf, bool nullable, Zone& zone)
+{
+    zone.min = std::numeric_limits<T>::infinity();
+    zone.max = -std::numeric_limits<T>::infinity();
+    bool has_nan = false;
+    for (size_t i = 0; i < zone.size; ++i) {
+        L v = leaf.get(i);
+        if (nullable && null::is_null_float(v)) {
+            ++zone.null_count;
+            continue;
+        }
+        if (std::isnan(v)) {
+            has_nan = true;
+            continue;
+        }
+        if (v < zone.min)
+            zone.min = v;
+        if (v > zone.max)
+            zone.max = v;
+    }
+    if (has_nan) {
+        // NaN is unordered, so the bounds cannot exclude anything
+        zone.min = -std::numeric_limits<T>::infinity();
+        zone.max = std::numeric_limits<T>::infinity();
+    }
+}
+
+} // namespace realm
+
+#endif // REALM_ZONE_MAP_HPP
@@ -66,6 +66,23 @@ inline void erase(TableRef table, const std::vector<size_t>& order)
         table->remove(order[i]);
 }
 
+// Create and destroy arrays of the sizes that are typical for small B+-tree
+// leaves, the way a write transaction that modifies many leaves would
+inline void alloc_free(SlabAlloc& alloc, const std::vector<size_t>& sizes, const std::vector<size_t>& order)
+{
+    size_t n = sizes.size();
+    std::vector<MemRef> mems(n);
+    int_fast64_t value = 0x7FFFFFFF; // 32 bits per element
+    for (size_t i = 0; i != n; ++i)
+        mems[i] = Array::create_array(Array::type_Normal, false, sizes[i], value, alloc);
+    for (size_t i = 0; i != n; i += 2)
+        alloc.free_(mems[order[i]]);
+    for (size_t i = 0; i != n; i += 2)
+        mems[order[i]] = Array::create_array(Array::type_Normal, false, sizes[order[i]], value, alloc);
+    for (size_t i = 0; i != n; ++i)
+        alloc.free_(mems[order[i]]);
+}
+
 } // anonymous namepsace
 
 
@@ -216,6 +233,23 @@ int main()
         results.finish(id, desc);
     }
 
+    {
+        id = "alloc_free_small";
+        desc = "Small alloc and free";
+        std::vector<size_t> sizes;
+        for (size_t i = 0; i != target_size; ++i)
+            sizes.push_back(1 + random_order[i] % 200);
+        SlabAlloc alloc;
+        alloc.attach_empty();
+        for (int i = 0; i != num_tables / 10; ++i) {
+            timer.reset();
+            alloc_free(alloc, sizes, random_order);
+            results.submit(id, timer);
+            alloc.reset_free_space_tracking();
+        }
+        results.finish(id, desc);
+    }
+
     results.submit_single("crud_total_time", "Total time", timer_total);
 
     std::cout << "dummy = " << dummy << " (to avoid over-optimization)\n";
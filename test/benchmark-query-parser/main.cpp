@@ -0,0 +1,232 @@
+/*************************************************************************
+ *
+ * Copyright 2018 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <realm.hpp>
+#include <realm/parser/parser.hpp>
+#include <realm/parser/prepared_query.hpp>
+#include <realm/parser/query_builder.hpp>
+#include <realm/util/any.hpp>
+
+#include "../util/timer.hpp"
+#include "../util/random.hpp"
+#include "../util/benchmark_results.hpp"
+
+using namespace realm;
+using namespace realm::util;
+using namespace realm::test_util;
+
+
+namespace {
+
+// The predicates of a typical application: a fixed set of shapes which are
+// issued over and over with different arguments. $0 is always an integer, $1
+// a string, $2 a double and $3 a bool.
+const char* predicates[] = {
+    "age == $0",
+    "age != $0",
+    "age > $0",
+    "age >= $0 && age < 50",
+    "age <= $0",
+    "name == $1",
+    "name ==[c] $1",
+    "name BEGINSWITH $1",
+    "name CONTAINS[c] $1",
+    "name ENDSWITH $1",
+    "name LIKE '*' && name != $1",
+    "score > $2",
+    "score <= $2 && age > $0",
+    "active == $3",
+    "active == $3 && age > $0",
+    "active == $3 && name == $1",
+    "age == $0 || name == $1",
+    "age == $0 || age == 1 || age == 2 || age == 3",
+    "(age > $0 && score < $2) || name BEGINSWITH $1",
+    "NOT (age > $0)",
+    "age > $0 SORT(age ASC)",
+    "age > $0 SORT(name DESC, age ASC)",
+    "name != $1 DISTINCT(name)",
+    "age < $0 SORT(score DESC) LIMIT(10)",
+    "score > $2 && active == $3 && age < $0",
+    "name == 'a' || name == 'b' || name == 'c' || age == $0",
+    "age > $0 && age < 100 && name != $1 && score > $2",
+    "TRUEPREDICATE SORT(age ASC) LIMIT(5)",
+    "name == $1 && age == $0 && active == $3",
+    "age > $0 || score > $2",
+};
+const size_t num_predicates = sizeof predicates / sizeof predicates[0];
+
+} // anonymous namespace
+
+
+int main()
+{
+    const size_t num_rows = 1000;
+    const int num_rounds = 500;
+    std::cout << "Number of predicates: " << num_predicates << "\n";
+    std::cout << "Rows per table: " << num_rows << "\n";
+
+    Group group;
+    TableRef table = group.add_table("person");
+    size_t age_col = table->add_column(type_Int, "age");
+    size_t name_col = table->add_column(type_String, "name");
+    size_t score_col = table->add_column(type_Double, "score");
+    size_t active_col = table->add_column(type_Bool, "active");
+    Random random;
+    table->add_empty_row(num_rows);
+    for (size_t i = 0; i != num_rows; ++i) {
+        table->set_int(age_col, i, random.draw_int(0, 100));
+        std::string name = util::to_string(random.draw_int(0, 200));
+        table->set_string(name_col, i, name);
+        table->set_double(score_col, i, random.draw_int(0, 1000) / 10.0);
+        table->set_bool(active_col, i, random.draw_bool());
+    }
+
+    // The string arguments refer to `names`, which must outlive the queries
+    std::vector<std::string> names;
+    for (int i = 0; i != num_rounds; ++i)
+        names.push_back(util::to_string(random.draw_int(0, 200)));
+    std::vector<std::vector<Any>> arguments;
+    for (int i = 0; i != num_rounds; ++i) {
+        arguments.push_back({Int(random.draw_int(0, 100)), StringData(names[i]),
+                             Double(random.draw_int(0, 1000) / 10.0), Bool(random.draw_bool())});
+    }
+    auto get_arguments = [&](query_builder::AnyContext& ctx, int round) {
+        std::vector<Any>& args = arguments[round];
+        return query_builder::ArgumentConverter<Any, query_builder::AnyContext>(ctx, args.data(), args.size());
+    };
+
+    size_t dummy = 0;
+
+    int max_lead_text_size = 34;
+    BenchmarkResults results(max_lead_text_size);
+
+    Timer timer(Timer::type_UserTime);
+    const char *id, *desc;
+    query_builder::AnyContext ctx;
+    {
+        id = "parse";
+        desc = "Parse";
+        for (int i = 0; i != num_rounds; ++i) {
+            timer.reset();
+            for (size_t j = 0; j != num_predicates; ++j)
+                dummy += parser::parse(predicates[j]).ordering.orderings.size();
+            results.submit(id, timer);
+        }
+        results.finish(id, desc);
+
+        std::vector<parser::ParserResult> parsed;
+        for (size_t j = 0; j != num_predicates; ++j)
+            parsed.push_back(parser::parse(predicates[j]));
+
+        id = "build";
+        desc = "Build query from parsed predicate";
+        for (int i = 0; i != num_rounds; ++i) {
+            auto args = get_arguments(ctx, i);
+            timer.reset();
+            for (size_t j = 0; j != num_predicates; ++j) {
+                Query query = table->where();
+                query_builder::apply_predicate(query, parsed[j].predicate, args);
+                DescriptorOrdering ordering;
+                query_builder::apply_ordering(ordering, table, parsed[j].ordering, args);
+                dummy += ordering.size();
+            }
+            results.submit(id, timer);
+        }
+        results.finish(id, desc);
+
+        // The counterpart of parsing and building when the predicate shape
+        // has been seen before
+        id = "bind";
+        desc = "Bind cached prepared query";
+        parser::QueryCache cache;
+        for (size_t j = 0; j != num_predicates; ++j)
+            cache.get(predicates[j]);
+        for (int i = 0; i != num_rounds; ++i) {
+            auto args = get_arguments(ctx, i);
+            timer.reset();
+            for (size_t j = 0; j != num_predicates; ++j) {
+                std::shared_ptr<const parser::PreparedQuery> prepared = cache.get(predicates[j]);
+                Query query = prepared->bind(table, args);
+                DescriptorOrdering ordering;
+                prepared->bind_ordering(ordering, table, args);
+                dummy += ordering.size();
+            }
+            results.submit(id, timer);
+        }
+        results.finish(id, desc);
+
+        std::vector<Query> queries;
+        for (size_t j = 0; j != num_predicates; ++j) {
+            auto args = get_arguments(ctx, 0);
+            queries.push_back(table->where());
+            query_builder::apply_predicate(queries.back(), parsed[j].predicate, args);
+        }
+
+        id = "execute";
+        desc = "Execute built query";
+        for (int i = 0; i != num_rounds; ++i) {
+            timer.reset();
+            for (size_t j = 0; j != num_predicates; ++j)
+                dummy += queries[j].count();
+            results.submit(id, timer);
+        }
+        results.finish(id, desc);
+    }
+
+    {
+        id = "parse_build_execute";
+        desc = "Parse, build and execute";
+        for (int i = 0; i != num_rounds; ++i) {
+            auto args = get_arguments(ctx, i);
+            timer.reset();
+            for (size_t j = 0; j != num_predicates; ++j) {
+                parser::ParserResult result = parser::parse(predicates[j]);
+                Query query = table->where();
+                query_builder::apply_predicate(query, result.predicate, args);
+                DescriptorOrdering ordering;
+                query_builder::apply_ordering(ordering, table, result.ordering, args);
+                dummy += query.count();
+            }
+            results.submit(id, timer);
+        }
+        results.finish(id, desc);
+
+        id = "prepared_build_execute";
+        desc = "Prepared, build and execute";
+        parser::QueryCache cache;
+        for (int i = 0; i != num_rounds; ++i) {
+            auto args = get_arguments(ctx, i);
+            timer.reset();
+            for (size_t j = 0; j != num_predicates; ++j) {
+                std::shared_ptr<const parser::PreparedQuery> prepared = cache.get(predicates[j]);
+                Query query = prepared->bind(table, args);
+                DescriptorOrdering ordering;
+                prepared->bind_ordering(ordering, table, args);
+                dummy += query.count();
+            }
+            results.submit(id, timer);
+        }
+        results.finish(id, desc);
+    }
+
+    std::cout << "dummy = " << dummy << " (to avoid over-optimization)\n";
+}
@@ -31,6 +31,8 @@ function bench {
 }
 
 bench "realm"
+bench "realm-async"
+bench "realm-memonly"
 bench "sqlite"
 bench "mysql"
 bench "sqlite-wal"
@@ -58,6 +58,7 @@ struct thread_info {
 
 
 static bool verbose;
+static SharedGroupOptions::Durability realm_durability = SharedGroupOptions::Durability::Full;
 
 // Shared variables and mutex to protect them
 static bool runnable = true;
@@ -81,7 +82,7 @@ void usage(const char* msg)
     std::cout << " -w   : number of writers" << std::endl;
     std::cout << " -r   : number of readers" << std::endl;
     std::cout << " -f   : database file" << std::endl;
-    std::cout << " -d   : database (realm, sqlite, sqlite-wal or mysql)" << std::endl;
+    std::cout << " -d   : database (realm, realm-async, realm-memonly, sqlite, sqlite-wal or mysql)" << std::endl;
     std::cout << " -t   : duration (in secs)" << std::endl;
     std::cout << " -n   : number of rows" << std::endl;
     std::cout << " -v   : verbose" << std::endl;
@@ -275,7 +276,7 @@ static void* realm_reader(void* arg)
     size_t c = 0;
     srandom(tinfo->thread_num);
     clock_gettime(CLOCK_REALTIME, &ts_1);
-    SharedGroup sg(tinfo->datfile);
+    SharedGroup sg(tinfo->datfile, false, SharedGroupOptions(realm_durability));
     while (true) {
         pthread_mutex_lock(&mtx_runnable);
         bool local_runnable = runnable;
@@ -401,7 +402,7 @@ static void* realm_writer(void* arg)
     struct timespec ts_1, ts_2;
     struct thread_info* tinfo = (struct thread_info*)arg;
     srandom(tinfo->thread_num);
-    SharedGroup sg(tinfo->datfile);
+    SharedGroup sg(tinfo->datfile, false, SharedGroupOptions(realm_durability));
     while (true) {
         pthread_mutex_lock(&mtx_runnable);
         bool local_runnable = runnable;
@@ -493,13 +494,15 @@ void mysql_create(const char* f, long n)
     mysql_close(db);
 }
 
-void realm_create(const char* f, long n)
+// The returned SharedGroup keeps the session alive for the duration of the
+// benchmark, which matters for Durability::MemOnly
+std::unique_ptr<SharedGroup> realm_create(const char* f, long n)
 {
     util::File::try_remove(f);
     util::File::try_remove(std::string(f) + ".lock");
-    SharedGroup sg(f);
+    std::unique_ptr<SharedGroup> sg(new SharedGroup(f, false, SharedGroupOptions(realm_durability)));
     {
-        WriteTransaction wt(sg);
+        WriteTransaction wt(*sg);
         BasicTableRef<TestTable> t = wt.get_or_add_table<TestTable>("test");
 
         srandom(1);
@@ -510,6 +513,7 @@ void realm_create(const char* f, long n)
         }
         wt.commit();
     }
+    return sg;
 }
 
 
@@ -653,6 +657,14 @@ int main(int argc, char* argv[])
                 if (strcmp(optarg, "realm") == 0) {
                     database = DB_REALM;
                 }
+                if (strcmp(optarg, "realm-async") == 0) {
+                    database = DB_REALM;
+                    realm_durability = SharedGroupOptions::Durability::Async;
+                }
+                if (strcmp(optarg, "realm-memonly") == 0) {
+                    database = DB_REALM;
+                    realm_durability = SharedGroupOptions::Durability::MemOnly;
+                }
                 if (strcmp(optarg, "sqlite") == 0) {
                     database = DB_SQLITE;
                 }
@@ -693,9 +705,10 @@ int main(int argc, char* argv[])
 
     if (verbose)
         std::cout << "Creating test data for " << database << std::endl;
+    std::unique_ptr<SharedGroup> realm_session;
     switch (database) {
         case DB_REALM:
-            realm_create(datfile, n_records);
+            realm_session = realm_create(datfile, n_records);
             break;
         case DB_SQLITE:
         case DB_SQLITE_WAL:
@@ -335,6 +335,43 @@ public:
 } // end anonymous namespace
 
 
+TEST(Alloc_TranslationCache)
+{
+    SlabAlloc alloc;
+    CHECK_EQUAL(SlabAlloc::default_translation_cache_size, alloc.get_translation_cache_size());
+    alloc.set_translation_cache_size(4097);
+    CHECK_EQUAL(8192, alloc.get_translation_cache_size());
+
+    // A single set, so that most translations evict each other
+    alloc.set_translation_cache_size(1);
+    CHECK_EQUAL(SlabAlloc::translation_cache_ways, alloc.get_translation_cache_size());
+    alloc.attach_empty();
+    alloc.set_translation_cache_stats_enabled(true);
+
+    std::vector<MemRef> refs;
+    for (size_t i = 0; i < 100; ++i) {
+        MemRef r = alloc.alloc(16);
+        set_capacity(r.get_addr(), 16);
+        refs.push_back(r);
+    }
+    uint_fast64_t hits = alloc.get_translation_cache_hits();
+    uint_fast64_t misses = alloc.get_translation_cache_misses();
+    for (int pass = 0; pass < 2; ++pass) {
+        for (MemRef& r : refs)
+            CHECK_EQUAL(static_cast<void*>(r.get_addr()), static_cast<void*>(alloc.translate(r.get_ref())));
+    }
+    // Repeated lookups of the same ref are cache hits
+    for (int i = 0; i < 10; ++i)
+        CHECK_EQUAL(static_cast<void*>(refs[0].get_addr()), static_cast<void*>(alloc.translate(refs[0].get_ref())));
+    CHECK_EQUAL(hits + misses + 210, alloc.get_translation_cache_hits() + alloc.get_translation_cache_misses());
+    CHECK_GREATER_EQUAL(alloc.get_translation_cache_hits(), hits + 9);
+    CHECK_GREATER_EQUAL(alloc.get_translation_cache_misses(), misses + 200 - 2 * SlabAlloc::translation_cache_ways);
+
+    for (MemRef& r : refs)
+        alloc.free_(r.get_ref(), r.get_addr());
+}
+
+
 TEST(Alloc_MaxSectionBoundaryOverflow)
 {
     TestSlabAlloc alloc;
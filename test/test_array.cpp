@@ -1554,4 +1554,96 @@ TEST(Array_Sum)
     c.destroy();
 }
 
+
+// Compare find/count/sum/min/max against naive results for all byte sized and wider element widths, with enough
+// elements and varying sub ranges to exercise the unaligned head and tail around the AVX2/AVX-512 kernels
+TEST(Array_VectorizedAggregates)
+{
+    Random random(random_int<unsigned long>()); // Seed from slow global generator
+    Array a(Allocator::get_default());
+    a.create(Array::type_Normal);
+
+    // The last one needs 64 bit elements while leaving room to sum 1000 of them
+    const int64_t limits[] = {0x7f, 0x7fff, 0x7fffffffLL, 0x7fffffffffffLL};
+    for (int64_t limit : limits) {
+        a.clear();
+        std::vector<int64_t> values;
+        for (size_t i = 0; i < 1000; ++i) {
+            // Draw from a small set so that there are plenty of duplicates
+            int64_t v = random.draw_int<int64_t>(-3, 3) * (limit / 3);
+            a.add(v);
+            values.push_back(v);
+        }
+        a.set(0, limit);
+        values[0] = limit;
+
+        for (size_t begin = 0; begin < 70; begin += 3) {
+            size_t end = values.size() - begin / 2;
+            int64_t needle = values[begin + 7];
+
+            size_t expected_count = 0;
+            size_t expected_greater = 0;
+            size_t expected_less = 0;
+            size_t expected_first_ne = not_found;
+            size_t expected_min_ndx = begin;
+            size_t expected_max_ndx = begin;
+            for (size_t i = begin; i < end; ++i) {
+                if (values[i] == needle)
+                    ++expected_count;
+                if (values[i] > needle)
+                    ++expected_greater;
+                if (values[i] < needle)
+                    ++expected_less;
+                if (values[i] != needle && expected_first_ne == not_found)
+                    expected_first_ne = i;
+                if (values[i] < values[expected_min_ndx])
+                    expected_min_ndx = i;
+                if (values[i] > values[expected_max_ndx])
+                    expected_max_ndx = i;
+            }
+
+            QueryState<int64_t> state;
+            state.init(act_Count, nullptr, size_t(-1));
+            a.find<Equal>(act_Count, needle, begin, end, 0, &state);
+            CHECK_EQUAL(int64_t(expected_count), state.m_state);
+            state.init(act_Count, nullptr, size_t(-1));
+            a.find<Greater>(act_Count, needle, begin, end, 0, &state);
+            CHECK_EQUAL(int64_t(expected_greater), state.m_state);
+            state.init(act_Count, nullptr, size_t(-1));
+            a.find<Less>(act_Count, needle, begin, end, 0, &state);
+            CHECK_EQUAL(int64_t(expected_less), state.m_state);
+            CHECK_EQUAL(expected_first_ne, a.find_first<NotEqual>(needle, begin, end));
+
+            ref_type results_ref = IntegerColumn::create(Allocator::get_default());
+            IntegerColumn results(Allocator::get_default(), results_ref);
+            a.find_all(&results, needle, 0, begin, end);
+            CHECK_EQUAL(expected_count, results.size());
+            for (size_t i = 0; i < results.size(); ++i)
+                CHECK_EQUAL(needle, values[to_size_t(results.get(i))]);
+            results.destroy();
+
+            int64_t sum = 0;
+            for (size_t i = begin; i < end; ++i)
+                sum += values[i];
+            CHECK_EQUAL(sum, a.sum(begin, end));
+
+            int64_t result;
+            size_t ndx;
+            CHECK(a.minimum(result, begin, end, &ndx));
+            CHECK_EQUAL(values[expected_min_ndx], result);
+            if (expected_min_ndx != begin)
+                CHECK_EQUAL(expected_min_ndx, ndx);
+            CHECK(a.maximum(result, begin, end, &ndx));
+            CHECK_EQUAL(values[expected_max_ndx], result);
+            if (expected_max_ndx != begin)
+                CHECK_EQUAL(expected_max_ndx, ndx);
+        }
+
+        size_t expected = std::count(values.begin(), values.end(), values[10]);
+        CHECK_EQUAL(expected, a.count(values[10]));
+    }
+
+    a.destroy();
+}
+
 #endif // TEST_ARRAY
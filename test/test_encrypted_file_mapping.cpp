@@ -184,5 +184,44 @@ TEST(EncryptedFile_LargePages)
     close(fd);
 }
 
+TEST(EncryptedFile_MultipleBlocks)
+{
+    TEST_PATH(path);
+
+    // Spans the metadata block which follows the first 64 data blocks
+    const size_t num_blocks = 100;
+    std::unique_ptr<char[]> data(new char[num_blocks * 4096]);
+    std::unique_ptr<char[]> buffer(new char[num_blocks * 4096]);
+    for (size_t i = 0; i < num_blocks * 4096; ++i)
+        data[i] = static_cast<char>(i / 4096 + i);
+
+    AESCryptor cryptor(test_key);
+    cryptor.set_file_size(off_t(num_blocks * 4096));
+
+    int fd = open(path.c_str(), O_CREAT | O_RDWR, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+    // Leave block 10 unwritten
+    cryptor.write(fd, 0, data.get(), 10 * 4096);
+    cryptor.write(fd, 11 * 4096, data.get() + 11 * 4096, (num_blocks - 11) * 4096);
+
+    memset(buffer.get(), 0, num_blocks * 4096);
+    CHECK_NOT(cryptor.read(fd, 0, buffer.get(), num_blocks * 4096));
+    CHECK(memcmp(buffer.get(), data.get(), 10 * 4096) == 0);
+    CHECK(memcmp(buffer.get() + 11 * 4096, data.get() + 11 * 4096, (num_blocks - 11) * 4096) == 0);
+
+    cryptor.write(fd, 10 * 4096, data.get() + 10 * 4096, 4096);
+    CHECK(cryptor.read(fd, 0, buffer.get(), num_blocks * 4096));
+    CHECK(memcmp(buffer.get(), data.get(), num_blocks * 4096) == 0);
+
+    // A separate cryptor reads the IV tables written in batches from the file
+    {
+        AESCryptor cryptor_2(test_key);
+        cryptor_2.set_file_size(off_t(num_blocks * 4096));
+        memset(buffer.get(), 0, num_blocks * 4096);
+        CHECK(cryptor_2.read(fd, 60 * 4096, buffer.get(), 40 * 4096));
+        CHECK(memcmp(buffer.get(), data.get() + 60 * 4096, 40 * 4096) == 0);
+    }
+    close(fd);
+}
+
 #endif // REALM_ENABLE_ENCRYPTION
 #endif // TEST_ENCRYPTED_FILE_MAPPING
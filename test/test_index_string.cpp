@@ -1918,4 +1918,64 @@ TEST_TYPES(StringIndex_Rover, string_column, nullable_string_column, enum_column
 }
 
 
+TEST_TYPES(StringIndex_CommonPrefix, string_column, nullable_string_column, enum_column, nullable_enum_column)
+{
+    TEST_TYPE test_resources;
+    typename TEST_TYPE::ColumnTestType& col = test_resources.get_column();
+
+    const StringIndex& ndx = *col.create_search_index();
+
+    // Long shared prefixes turn into a chain of single key sub-indexes, which
+    // lookups skip. Check that modifications anywhere along the chain are seen.
+    const char prefix[] = "https://www.example.com/items/";
+    std::vector<std::string> items;
+    for (int i = 0; i < 10; ++i)
+        items.push_back(prefix + util::to_string(i));
+    for (const std::string& item : items)
+        col.add(item);
+
+    CHECK_EQUAL(3, col.find_first(items[3]));
+    CHECK_EQUAL(1, ndx.count(StringData(items[1])));
+    CHECK_EQUAL(not_found, col.find_first(prefix));
+    CHECK_EQUAL(not_found, col.find_first("https"));
+    CHECK_EQUAL(not_found, col.find_first(""));
+    CHECK_EQUAL(not_found, col.find_first("https://www.example.org/items/3"));
+
+    // Diverge in the middle of the chain
+    col.add("https://www.example.org/items/3");
+    CHECK_EQUAL(10, col.find_first("https://www.example.org/items/3"));
+    CHECK_EQUAL(3, col.find_first(items[3]));
+
+    // Diverge at the root
+    col.add("http");
+    CHECK_EQUAL(11, col.find_first("http"));
+    CHECK_EQUAL(4, col.find_first(items[4]));
+
+    // Back to a single chain
+    col.erase(11);
+    col.erase(10);
+    CHECK_EQUAL(not_found, col.find_first("http"));
+    CHECK_EQUAL(not_found, col.find_first("https://www.example.org/items/3"));
+    CHECK_EQUAL(5, col.find_first(items[5]));
+
+    col.set(5, items[1]);
+    CHECK_EQUAL(not_found, col.find_first(items[5]));
+    CHECK_EQUAL(2, ndx.count(StringData(items[1])));
+
+    ref_type results_ref = IntegerColumn::create(Allocator::get_default());
+    IntegerColumn results(Allocator::get_default(), results_ref);
+    ndx.find_all(results, StringData(items[1]));
+    CHECK_EQUAL(2, results.size());
+    if (results.size() == 2) {
+        CHECK_EQUAL(1, results.get(0));
+        CHECK_EQUAL(5, results.get(1));
+    }
+    results.destroy();
+
+    col.clear();
+    CHECK_EQUAL(not_found, col.find_first(items[1]));
+    col.add(items[1]);
+    CHECK_EQUAL(0, col.find_first(items[1]));
+}
+
 #endif // TEST_INDEX_STRING
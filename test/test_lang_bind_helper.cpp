@@ -32,6 +32,7 @@
 #include <realm/util/to_string.hpp>
 #include <realm/replication.hpp>
 #include <realm/history.hpp>
+#include <realm/impl/instruction_buffer.hpp>
 
 // Need fork() and waitpid() for Shared_RobustAgainstDeathDuringWrite
 #ifndef _WIN32
@@ -13702,4 +13703,492 @@ TEST(LangBindHelper_getCoreFiles)
     CHECK(core_files.size() == 0);
 }
 
+
+TEST(LangBindHelper_IncrementalTableViewSync)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    std::unique_ptr<Replication> hist(make_in_realm_history(path));
+    SharedGroup sg(*hist, SharedGroupOptions(crypt_key()));
+    std::unique_ptr<Replication> hist_w(make_in_realm_history(path));
+    SharedGroup sg_w(*hist_w, SharedGroupOptions(crypt_key()));
+    {
+        WriteTransaction wt(sg_w);
+        TableRef table = wt.add_table("table");
+        table->add_column(type_Int, "int");
+        table->add_column(type_String, "str");
+        table->add_empty_row(100);
+        for (size_t i = 0; i < 100; ++i)
+            table->set_int(0, i, i % 10);
+        wt.commit();
+    }
+
+    Group& g = const_cast<Group&>(sg.begin_read());
+    ConstTableRef table = g.get_table("table");
+    TableView tv = table->where().greater(0, 5).find_all();
+    tv.set_incremental_sync(true);
+    TableView sorted = table->where().greater(0, 5).find_all();
+    sorted.sort(0, false);
+    sorted.set_incremental_sync(true);
+
+    auto check_views = [&] {
+        tv.sync_if_needed();
+        sorted.sync_if_needed();
+        TableView expected = table->where().greater(0, 5).find_all();
+        TableView expected_sorted = table->where().greater(0, 5).find_all();
+        expected_sorted.sort(0, false);
+        CHECK_EQUAL(tv.size(), expected.size());
+        CHECK_EQUAL(sorted.size(), expected.size());
+        for (size_t i = 0; i < expected.size() && i < tv.size() && i < sorted.size(); ++i) {
+            CHECK_EQUAL(tv.get_source_ndx(i), expected.get_source_ndx(i));
+            CHECK_EQUAL(sorted.get_source_ndx(i), expected_sorted.get_source_ndx(i));
+        }
+    };
+
+    Random random(random_int<unsigned long>()); // Seed from slow global generator
+    for (int i = 0; i < 20; ++i) {
+        {
+            WriteTransaction wt(sg_w);
+            TableRef t = wt.get_table("table");
+            for (int j = 0; j < 5; ++j) {
+                size_t row_ndx = random.draw_int_mod(t->size());
+                switch (random.draw_int_mod(5)) {
+                    case 0:
+                        t->set_int(0, row_ndx, random.draw_int_mod(10));
+                        break;
+                    case 1:
+                        t->insert_empty_row(row_ndx);
+                        t->set_int(0, row_ndx, random.draw_int_mod(10));
+                        break;
+                    case 2:
+                        t->move_last_over(row_ndx);
+                        break;
+                    case 3:
+                        t->remove(row_ndx);
+                        break;
+                    case 4:
+                        t->swap_rows(row_ndx, random.draw_int_mod(t->size()));
+                        break;
+                }
+            }
+            // A change which does not affect the result
+            t->set_string(1, random.draw_int_mod(t->size()), "x");
+            wt.commit();
+        }
+        LangBindHelper::advance_read(sg);
+        CHECK(tv.can_sync_incrementally());
+        CHECK(sorted.can_sync_incrementally());
+        check_views();
+    }
+
+    // Local changes make the view rerun the query
+    LangBindHelper::promote_to_write(sg);
+    TableRef t = g.get_table("table");
+    t->set_int(0, 0, 9);
+    t->add_empty_row();
+    CHECK(!tv.can_sync_incrementally());
+    CHECK(!sorted.can_sync_incrementally());
+    check_views();
+    LangBindHelper::rollback_and_continue_as_read(sg);
+    check_views();
+}
+
+TEST(LangBindHelper_AdvanceReadWithObserver_Accessors)
+{
+    // With an observer, the changesets are parsed once, and the accessors are
+    // updated from what was recorded along the way
+    SHARED_GROUP_TEST_PATH(path);
+    std::unique_ptr<Replication> hist(make_in_realm_history(path));
+    SharedGroup sg(*hist, SharedGroupOptions(crypt_key()));
+    std::unique_ptr<Replication> hist_2(make_in_realm_history(path));
+    SharedGroup sg_2(*hist_2, SharedGroupOptions(crypt_key()));
+    std::unique_ptr<Replication> hist_w(make_in_realm_history(path));
+    SharedGroup sg_w(*hist_w, SharedGroupOptions(crypt_key()));
+    {
+        WriteTransaction wt(sg_w);
+        TableRef table = wt.add_table("table");
+        table->add_column(type_Int, "int");
+        table->add_column(type_String, "str");
+        table->add_empty_row(100);
+        for (size_t i = 0; i < 100; ++i)
+            table->set_int(0, i, i % 10);
+        wt.commit();
+    }
+
+    struct Observer : _impl::NullInstructionObserver {
+        size_t num_set_int = 0;
+        size_t num_set_string = 0;
+        size_t num_insert_column = 0;
+        bool set_int(size_t, size_t, int_fast64_t, _impl::Instruction, size_t)
+        {
+            ++num_set_int;
+            return true;
+        }
+        bool set_string(size_t, size_t, StringData, _impl::Instruction, size_t)
+        {
+            ++num_set_string;
+            return true;
+        }
+        bool insert_column(size_t, DataType, StringData, bool)
+        {
+            ++num_insert_column;
+            return true;
+        }
+    } observer;
+
+    // `sg` is advanced with the observer, `sg_2` without it, and the accessors
+    // of both must end up the same
+    Group& g = const_cast<Group&>(sg.begin_read());
+    Group& g_2 = const_cast<Group&>(sg_2.begin_read());
+    ConstTableRef table = g.get_table("table");
+    ConstTableRef table_2 = g_2.get_table("table");
+    TableView tv = table->where().greater(0, 5).find_all();
+    tv.set_incremental_sync(true);
+    std::vector<ConstRow> rows, rows_2;
+    for (size_t i = 0; i < 100; i += 7) {
+        rows.push_back(table->get(i));
+        rows_2.push_back(table_2->get(i));
+    }
+
+    size_t expected_set_int = 0;
+    Random random(random_int<unsigned long>()); // Seed from slow global generator
+    for (int i = 0; i < 20; ++i) {
+        {
+            WriteTransaction wt(sg_w);
+            TableRef t = wt.get_table("table");
+            for (int j = 0; j < 5; ++j) {
+                size_t row_ndx = random.draw_int_mod(t->size());
+                switch (random.draw_int_mod(4)) {
+                    case 0:
+                        // Modifications of adjacent rows
+                        for (size_t k = row_ndx; k < t->size() && k < row_ndx + 10; ++k) {
+                            t->set_int(0, k, random.draw_int_mod(10));
+                            ++expected_set_int;
+                        }
+                        break;
+                    case 1:
+                        t->insert_empty_row(row_ndx);
+                        t->set_int(0, row_ndx, random.draw_int_mod(10));
+                        ++expected_set_int;
+                        break;
+                    case 2:
+                        t->move_last_over(row_ndx);
+                        break;
+                    case 3:
+                        t->remove(row_ndx);
+                        break;
+                }
+            }
+            t->set_string(1, random.draw_int_mod(t->size()), "x");
+            if (i == 10)
+                t->add_column(type_Bool, "bool");
+            wt.commit();
+        }
+        LangBindHelper::advance_read(sg, observer);
+        LangBindHelper::advance_read(sg_2);
+
+        CHECK_EQUAL(table->get_column_count(), table_2->get_column_count());
+        CHECK_EQUAL(table->size(), table_2->size());
+        for (size_t k = 0; k < rows.size(); ++k) {
+            CHECK_EQUAL(rows[k].is_attached(), rows_2[k].is_attached());
+            if (rows[k].is_attached() && rows_2[k].is_attached())
+                CHECK_EQUAL(rows[k].get_index(), rows_2[k].get_index());
+        }
+        tv.sync_if_needed();
+        TableView expected = table->where().greater(0, 5).find_all();
+        CHECK_EQUAL(tv.size(), expected.size());
+        for (size_t k = 0; k < expected.size() && k < tv.size(); ++k)
+            CHECK_EQUAL(tv.get_source_ndx(k), expected.get_source_ndx(k));
+    }
+    CHECK_EQUAL(expected_set_int, observer.num_set_int);
+    CHECK_EQUAL(20, observer.num_set_string);
+    CHECK_EQUAL(1, observer.num_insert_column);
+}
+
+
+TEST(LangBindHelper_InstructionBuffer)
+{
+    _impl::TransactLogBufferStream stream;
+    _impl::TransactLogEncoder encoder(stream);
+    size_t path[] = {0, 0};
+    encoder.select_table(1, 0, path);
+    for (size_t i = 0; i < 10; ++i)
+        encoder.set_int(0, i, i);
+    encoder.set_string(1, 3, "x");
+    encoder.set_int(0, 20, 1);
+    encoder.insert_empty_rows(5, 2, 30, false);
+    encoder.set_int(0, 5, 1);
+    size_t size = encoder.write_position() - stream.transact_log_data();
+
+    struct Handler : _impl::NullInstructionObserver {
+        size_t num_set_int = 0;
+        std::vector<std::pair<size_t, size_t>> modified;
+        size_t num_inserted = 0;
+        bool set_int(size_t, size_t, int_fast64_t, _impl::Instruction, size_t)
+        {
+            ++num_set_int;
+            return true;
+        }
+        bool insert_empty_rows(size_t, size_t num_rows, size_t, bool)
+        {
+            num_inserted += num_rows;
+            return true;
+        }
+        bool modify_rows(size_t row_ndx, size_t num_rows)
+        {
+            modified.emplace_back(row_ndx, num_rows);
+            return true;
+        }
+    };
+
+    {
+        _impl::SimpleInputStream in(stream.transact_log_data(), size);
+        std::vector<char> input_buffer(64);
+        _impl::NoCopyInputStreamAdaptor in_2(in, input_buffer.data(), input_buffer.size());
+        Handler observer;
+        _impl::InstructionBuffer buffer;
+        CHECK(buffer.record(in_2, observer));
+        CHECK_EQUAL(12, observer.num_set_int);
+        CHECK_EQUAL(2, observer.num_inserted);
+
+        // Adjacent modifications are merged, and the values are left out
+        Handler handler;
+        buffer.replay(handler);
+        CHECK_EQUAL(0, handler.num_set_int);
+        CHECK_EQUAL(2, handler.num_inserted);
+        CHECK_EQUAL(3, handler.modified.size());
+        if (handler.modified.size() == 3) {
+            CHECK(handler.modified[0] == std::make_pair(size_t(0), size_t(10)));
+            CHECK(handler.modified[1] == std::make_pair(size_t(20), size_t(1)));
+            CHECK(handler.modified[2] == std::make_pair(size_t(5), size_t(1)));
+        }
+    }
+
+    // When the buffer is too small, the observer still sees everything
+    {
+        _impl::SimpleInputStream in(stream.transact_log_data(), size);
+        std::vector<char> input_buffer(64);
+        _impl::NoCopyInputStreamAdaptor in_2(in, input_buffer.data(), input_buffer.size());
+        Handler observer;
+        _impl::InstructionBuffer buffer(100);
+        CHECK_NOT(buffer.record(in_2, observer));
+        CHECK_EQUAL(12, observer.num_set_int);
+        CHECK(buffer.empty());
+    }
+}
+
+
+
+TEST(LangBindHelper_TransactLogIntegers)
+{
+    std::vector<int_fast64_t> values = {0, 1, -1, 63, 64, -64, -65, 8191, 8192, -8192, -8193};
+    for (int i = 14; i < 63; i += 7) {
+        int_fast64_t v = int_fast64_t(1) << i;
+        values.insert(values.end(), {v - 1, v, -v, -v - 1});
+    }
+    values.push_back(std::numeric_limits<int_fast64_t>::max());
+    values.push_back(std::numeric_limits<int_fast64_t>::min());
+
+    _impl::TransactLogBufferStream stream;
+    _impl::TransactLogEncoder encoder(stream);
+    size_t path[] = {0, 0};
+    encoder.select_table(1, 0, path);
+    for (size_t i = 0; i < values.size(); ++i)
+        encoder.set_int(i % 3, size_t(values[values.size() - 1 - i]) >> 1, values[i]);
+    size_t size = encoder.write_position() - stream.transact_log_data();
+
+    struct Handler : _impl::NullInstructionObserver {
+        std::vector<int_fast64_t> values;
+        std::vector<size_t> rows;
+        bool set_int(size_t, size_t row_ndx, int_fast64_t value, _impl::Instruction, size_t)
+        {
+            rows.push_back(row_ndx);
+            values.push_back(value);
+            return true;
+        }
+    };
+
+    // Small input blocks make integers cross block boundaries
+    for (size_t block_size : {size_t(1), size_t(3), size}) {
+        _impl::SimpleInputStream in(stream.transact_log_data(), size);
+        std::vector<char> input_buffer(block_size);
+        _impl::NoCopyInputStreamAdaptor in_2(in, input_buffer.data(), input_buffer.size());
+        Handler handler;
+        _impl::TransactLogParser parser;
+        parser.parse(in_2, handler);
+        CHECK(handler.values == values);
+        CHECK_EQUAL(values.size(), handler.rows.size());
+        for (size_t i = 0; i < handler.rows.size(); ++i)
+            CHECK_EQUAL(size_t(values[values.size() - 1 - i]) >> 1, handler.rows[i]);
+    }
+
+    // An integer with too many bytes
+    {
+        std::string log = {char(_impl::instr_Set), char(type_Int), 0, 0};
+        log.append(10, char(0x80));
+        log.append(1, 0);
+        log.append(8, 0);
+        _impl::SimpleInputStream in(log.data(), log.size());
+        std::vector<char> input_buffer(log.size());
+        _impl::NoCopyInputStreamAdaptor in_2(in, input_buffer.data(), input_buffer.size());
+        Handler handler;
+        _impl::TransactLogParser parser;
+        CHECK_THROW(parser.parse(in_2, handler), _impl::TransactLogParser::BadTransactLog);
+    }
+}
+
+TEST(LangBindHelper_CompressedHistory)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    auto make_options = [](bool allow_upgrade) {
+        SharedGroupOptions options(crypt_key());
+        options.allow_file_format_upgrade = allow_upgrade;
+        return options;
+    };
+
+    // Without compression, the history schema is not upgraded
+    {
+        std::unique_ptr<Replication> hist_w(make_in_realm_history(path));
+        SharedGroup sg_w(*hist_w, make_options(false));
+        WriteTransaction wt(sg_w);
+        TableRef table = wt.add_table("table");
+        table->add_column(type_Int, "int");
+        table->add_column(type_String, "str");
+        table->add_empty_row();
+        wt.commit();
+    }
+    {
+        std::unique_ptr<Replication> hist(make_in_realm_history(path));
+        SharedGroup sg(*hist, make_options(false));
+    }
+    {
+        std::unique_ptr<Replication> hist(make_in_realm_history(path, true));
+        CHECK_THROW(SharedGroup(*hist, make_options(false)), FileFormatUpgradeRequired);
+    }
+
+    {
+        std::unique_ptr<Replication> hist(make_in_realm_history(path, true));
+        SharedGroup sg(*hist, make_options(true));
+        std::unique_ptr<Replication> hist_w(make_in_realm_history(path, true));
+        SharedGroup sg_w(*hist_w, make_options(false));
+        const Group& group = sg.begin_read();
+
+        // Small changesets are not made smaller by compression, so compressed
+        // and uncompressed changesets are mixed in the history
+        for (int i = 0; i < 20; ++i) {
+            WriteTransaction wt(sg_w);
+            TableRef table = wt.get_table("table");
+            size_t row = table->add_empty_row();
+            std::string value = "value " + util::to_string(i);
+            table->set_int(0, row, i);
+            table->set_string(1, row, value);
+            wt.commit();
+        }
+        // A changeset that spans many compressed blocks
+        {
+            WriteTransaction wt(sg_w);
+            TableRef table = wt.get_table("table");
+            for (int i = 0; i < 20000; ++i) {
+                size_t row = table->add_empty_row();
+                std::string value = "value " + util::to_string(i % 100);
+                table->set_int(0, row, i % 100);
+                table->set_string(1, row, value);
+            }
+            wt.commit();
+        }
+
+        LangBindHelper::advance_read(sg);
+        group.verify();
+        ConstTableRef table = group.get_table("table");
+        CHECK_EQUAL(20021, table->size());
+        CHECK_EQUAL(19, table->get_int(0, 20));
+        CHECK_EQUAL("value 19", table->get_string(1, 20));
+        CHECK_EQUAL(99, table->get_int(0, 20020));
+        ReadTransaction rt(sg_w);
+        CHECK(*rt.get_table("table") == *table);
+    }
+
+    // Once upgraded, the history can only be accessed with compression
+    {
+        std::unique_ptr<Replication> hist(make_in_realm_history(path));
+        CHECK_THROW(SharedGroup(*hist, make_options(true)), IncompatibleHistories);
+    }
+}
+
+
+TEST(LangBindHelper_CompressedChangeset)
+{
+    class ChangesetHistory : public _impl::History {
+    public:
+        std::vector<BinaryData> changesets;
+
+        void update_from_ref_and_version(ref_type, version_type) override
+        {
+        }
+        void update_from_parent(version_type) override
+        {
+        }
+        void get_changesets(version_type begin_version, version_type end_version, BinaryIterator* buffer) const
+            noexcept override
+        {
+            for (version_type i = begin_version; i < end_version; ++i)
+                buffer[i - begin_version] = BinaryIterator(changesets[size_t(i)]);
+        }
+        void set_oldest_bound_version(version_type) override
+        {
+        }
+        BinaryData get_uncommitted_changes() noexcept override
+        {
+            return {};
+        }
+        void verify() const override
+        {
+        }
+    };
+
+    auto read_all = [](ChangesetHistory& history) {
+        _impl::ChangesetInputStream in(history, 0, history.changesets.size());
+        std::string data;
+        const char* begin;
+        const char* end;
+        while (in.next_block(begin, end))
+            data.append(begin, end);
+        return data;
+    };
+
+    // The first byte of an uncompressed changeset is never zero
+    std::string raw = "\x01" "abc";
+    std::string payload;
+    for (int i = 0; i < 20000; ++i)
+        payload += "\x01" + util::to_string(i % 100) + ";";
+    Buffer<char> buffer;
+    size_t size = 0;
+    CHECK(_impl::compress_changeset(BinaryData(payload), buffer, size));
+    CHECK_LESS(size, payload.size() / 2);
+    std::string compressed(buffer.data(), size);
+
+    ChangesetHistory history;
+    history.changesets.push_back(BinaryData(raw));
+    history.changesets.push_back(BinaryData(compressed));
+    history.changesets.push_back(BinaryData(raw));
+    CHECK_EQUAL(raw + payload + raw, read_all(history));
+
+    // Corrupt block header
+    std::string corrupt = compressed;
+    corrupt[7] = 1;
+    history.changesets[1] = BinaryData(corrupt);
+    CHECK_THROW(read_all(history), _impl::TransactLogParser::BadTransactLog);
+
+    // Truncated block
+    history.changesets[1] = BinaryData(compressed.data(), compressed.size() - 1);
+    CHECK_THROW(read_all(history), _impl::TransactLogParser::BadTransactLog);
+
+    // Data that does not compress is left alone
+    Random random(random_int<unsigned long>());
+    std::string noise(1000, '\0');
+    for (char& c : noise)
+        c = char(random.draw_int(0, 255));
+    CHECK_NOT(_impl::compress_changeset(BinaryData(noise), buffer, size));
+}
+
+
 #endif
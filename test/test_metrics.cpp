@@ -815,6 +815,41 @@ TEST(Metrics_TransactionData)
     CHECK_EQUAL(transactions->at(2).get_total_objects(), 11 + 3 + 7);
 }
 
+TEST(Metrics_TranslationCache)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    std::unique_ptr<Replication> hist(make_in_realm_history(path));
+    SharedGroupOptions options(crypt_key());
+    options.enable_metrics = true;
+    options.translation_cache_size = 64;
+    SharedGroup sg(*hist, options);
+    {
+        WriteTransaction wt(sg);
+        TableRef table = wt.add_table("table");
+        table->add_column(type_Int, "first");
+        table->add_empty_row(10 * REALM_MAX_BPNODE_SIZE);
+        wt.commit();
+    }
+    sg.get_metrics()->take_transactions();
+
+    {
+        // Reading rows from several B+-tree leaves translates their refs
+        ReadTransaction rt(sg);
+        ConstTableRef table = rt.get_table("table");
+        for (size_t i = 0; i < table->size(); i += REALM_MAX_BPNODE_SIZE)
+            table->get_int(0, i);
+    }
+
+    std::shared_ptr<Metrics> metrics = sg.get_metrics();
+    CHECK(metrics);
+    std::unique_ptr<Metrics::TransactionInfoList> transactions = metrics->take_transactions();
+    CHECK(transactions);
+    CHECK_EQUAL(transactions->size(), 1);
+    const TransactionInfo& read = transactions->at(0);
+    CHECK_EQUAL(read.get_transaction_type(), TransactionInfo::read_transaction);
+    CHECK_GREATER(read.get_translation_cache_hits() + read.get_translation_cache_misses(), 0);
+}
+
 TEST(Metrics_TransactionVersions)
 {
     SHARED_GROUP_TEST_PATH(path);
@@ -56,6 +56,7 @@
 #include <realm/history.hpp>
 #include <realm/lang_bind_helper.hpp>
 #include <realm/parser/parser.hpp>
+#include <realm/parser/prepared_query.hpp>
 #include <realm/parser/query_builder.hpp>
 #include <realm/query_expression.hpp>
 #include <realm/replication.hpp>
@@ -3194,4 +3195,70 @@ TEST(Parser_ChainedIntEqualQueries)
 }
 
 
+TEST(Parser_PreparedQuery)
+{
+    Group g;
+    TableRef t = g.add_table("person");
+    size_t age_col = t->add_column(type_Int, "age");
+    size_t name_col = t->add_column(type_String, "name");
+    t->add_empty_row(10);
+    for (size_t i = 0; i < t->size(); ++i) {
+        t->set_int(age_col, i, i);
+        t->set_string(name_col, i, i % 2 ? "odd" : "even");
+    }
+
+    parser::QueryCache cache(2);
+    CHECK_EQUAL(cache.capacity(), 2);
+    CHECK_EQUAL(cache.size(), 0);
+
+    // the same query string is only parsed once and bound with different arguments
+    auto prepared = cache.get("age > $0 && name == $1 SORT(age DESC) LIMIT(2)");
+    CHECK_EQUAL(prepared->get_query_string(), "age > $0 && name == $1 SORT(age DESC) LIMIT(2)");
+    std::string query_string = "age > $0 && name == $1 SORT(age DESC) LIMIT(2)";
+    CHECK_EQUAL(cache.get(query_string), prepared);
+    CHECK_EQUAL(cache.size(), 1);
+
+    query_builder::AnyContext ctx;
+    util::Any args_1[] = {Int(2), String("odd")};
+    util::Any args_2[] = {Int(5), String("even")};
+    query_builder::ArgumentConverter<util::Any, query_builder::AnyContext> arguments_1(ctx, args_1, 2);
+    query_builder::ArgumentConverter<util::Any, query_builder::AnyContext> arguments_2(ctx, args_2, 2);
+    CHECK_EQUAL(prepared->bind(t, arguments_1).count(), 4);
+    CHECK_EQUAL(prepared->bind(t, arguments_2).count(), 2);
+    CHECK_EQUAL(prepared->bind(t, arguments_1).count(), 4);
+
+    DescriptorOrdering ordering;
+    prepared->bind_ordering(ordering, t, arguments_2);
+    TableView tv = prepared->bind(t, arguments_1).find_all();
+    tv.apply_descriptor_ordering(ordering);
+    CHECK_EQUAL(tv.size(), 2);
+    CHECK_EQUAL(tv.get_int(age_col, 0), 9);
+    CHECK_EQUAL(tv.get_int(age_col, 1), 7);
+
+    // a prepared query resolves its key paths when it is bound, so it is not
+    // affected by changes to the schema
+    t->insert_column(0, type_Double, "weight");
+    CHECK_EQUAL(prepared->bind(t, arguments_2).count(), 2);
+    t->remove_column(0);
+
+    // invalid queries are not cached
+    CHECK_THROW_ANY(cache.get("age >"));
+    CHECK_EQUAL(cache.size(), 1);
+
+    // the least recently used query is evicted
+    auto age_query = cache.get("age == $0");
+    CHECK_EQUAL(cache.get(query_string), prepared);
+    auto name_query = cache.get("name == $0");
+    CHECK_EQUAL(cache.size(), 2);
+    CHECK_EQUAL(cache.get(query_string), prepared);
+    CHECK_NOT_EQUAL(cache.get("age == $0"), age_query);
+    CHECK_NOT_EQUAL(cache.get("name == $0"), name_query);
+    CHECK_EQUAL(age_query->bind(t, arguments_1).count(), 1);
+
+    cache.clear();
+    CHECK_EQUAL(cache.size(), 0);
+    CHECK_NOT_EQUAL(cache.get(query_string), prepared);
+}
+
+
 #endif // TEST_PARSER
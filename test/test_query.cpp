@@ -25,6 +25,7 @@
 #include <vector>
 #include <set>
 #include <chrono>
+#include <functional>
 
 #include <realm.hpp>
 #include <realm/lang_bind_helper.hpp>
@@ -4519,6 +4520,468 @@ TEST(Query_FindWithDescriptorOrdering)
 }
 
 
+TEST(Query_SortLimitTopK)
+{
+    // Few enough rows survive the limit for the sort to only order those
+    Table table;
+    size_t int_col = table.add_column(type_Int, "int", true);
+    const size_t num_rows = 500;
+    table.add_empty_row(num_rows);
+    for (size_t i = 0; i < num_rows; ++i) {
+        if (i % 11 == 0)
+            table.set_null(int_col, i);
+        else
+            table.set_int(int_col, i, int64_t((i * 37) % 50));
+    }
+
+    for (bool ascending : {true, false}) {
+        DescriptorOrdering full_ordering;
+        full_ordering.append_sort(SortDescriptor(table, {{int_col}}, {ascending}));
+        TableView full = table.where().find_all(full_ordering);
+
+        DescriptorOrdering ordering;
+        ordering.append_sort(SortDescriptor(table, {{int_col}}, {ascending}));
+        ordering.append_limit({20});
+        TableView tv = table.where().find_all(ordering);
+        CHECK_EQUAL(tv.size(), 20);
+        CHECK_EQUAL(tv.get_num_results_excluded_by_limit(), num_rows - 20);
+        for (size_t i = 0; i < tv.size(); ++i)
+            CHECK_EQUAL(tv.get_source_ndx(i), full.get_source_ndx(i));
+    }
+}
+
+TEST(Query_RangeOverIndexedColumns)
+{
+    // Each indexed column has an unindexed copy, and range queries on both
+    // must agree whether or not the ordered index is selective enough to be used
+    Table table;
+    size_t int_col = table.add_column(type_Int, "int");
+    size_t int_copy = table.add_column(type_Int, "int_copy");
+    size_t null_col = table.add_column(type_Int, "null", true);
+    size_t null_copy = table.add_column(type_Int, "null_copy", true);
+    size_t ts_col = table.add_column(type_Timestamp, "ts", true);
+    size_t ts_copy = table.add_column(type_Timestamp, "ts_copy", true);
+    table.add_search_index(int_col);
+    table.add_search_index(null_col);
+    table.add_search_index(ts_col);
+
+    const size_t num_rows = 3 * REALM_MAX_BPNODE_SIZE;
+    table.add_empty_row(num_rows);
+    auto set_row = [&](size_t i, int64_t v) {
+        table.set_int(int_col, i, v);
+        table.set_int(int_copy, i, v);
+        if (i % 7 == 0) {
+            table.set_null(null_col, i);
+            table.set_null(null_copy, i);
+            table.set_null(ts_col, i);
+            table.set_null(ts_copy, i);
+        }
+        else {
+            table.set_int(null_col, i, v);
+            table.set_int(null_copy, i, v);
+            table.set_timestamp(ts_col, i, Timestamp(v / 3, int32_t(v % 3)));
+            table.set_timestamp(ts_copy, i, Timestamp(v / 3, int32_t(v % 3)));
+        }
+    };
+    for (size_t i = 0; i < num_rows; ++i)
+        set_row(i, int64_t((i * 7919) % num_rows));
+
+    CHECK(!table.has_ordered_index(int_col));
+    CHECK_LOGIC_ERROR(table.build_ordered_index(int_copy), LogicError::no_search_index);
+    auto build_indexes = [&] {
+        table.build_ordered_index(int_col);
+        table.build_ordered_index(null_col);
+        table.build_ordered_index(ts_col);
+        CHECK(table.has_ordered_index(int_col));
+        CHECK(table.has_ordered_index(null_col));
+        CHECK(table.has_ordered_index(ts_col));
+    };
+    build_indexes();
+
+    auto check_range = [&](int64_t v) {
+        Timestamp ts(v / 3, int32_t(v % 3));
+        CHECK_EQUAL(table.where().greater(int_col, v).count(), table.where().greater(int_copy, v).count());
+        CHECK_EQUAL(table.where().less_equal(int_col, v).sum_int(int_copy),
+                    table.where().less_equal(int_copy, v).sum_int(int_copy));
+        CHECK_EQUAL(table.where().greater_equal(null_col, v).count(),
+                    table.where().greater_equal(null_copy, v).count());
+        CHECK_EQUAL(table.where().less(null_col, v).count(), table.where().less(null_copy, v).count());
+        CHECK_EQUAL(table.where().greater(ts_col, ts).count(), table.where().greater(ts_copy, ts).count());
+        CHECK_EQUAL(table.where().less_equal(ts_col, ts).count(), table.where().less_equal(ts_copy, ts).count());
+
+        TableView tv = table.where().between(int_col, v, v + 10).find_all();
+        TableView tv_copy = table.where().between(int_copy, v, v + 10).find_all();
+        CHECK_EQUAL(tv.size(), tv_copy.size());
+        for (size_t i = 0; i < tv.size() && i < tv_copy.size(); ++i)
+            CHECK_EQUAL(tv.get_source_ndx(i), tv_copy.get_source_ndx(i));
+
+        TableView tv_ts = table.where().between(ts_col, ts, Timestamp(v / 3 + 5, 0)).find_all();
+        TableView tv_ts_copy = table.where().between(ts_copy, ts, Timestamp(v / 3 + 5, 0)).find_all();
+        CHECK_EQUAL(tv_ts.size(), tv_ts_copy.size());
+        for (size_t i = 0; i < tv_ts.size() && i < tv_ts_copy.size(); ++i)
+            CHECK_EQUAL(tv_ts.get_source_ndx(i), tv_ts_copy.get_source_ndx(i));
+    };
+    for (int64_t v : {int64_t(-1), int64_t(0), int64_t(5), int64_t(num_rows / 2), int64_t(num_rows - 5),
+                      int64_t(num_rows)})
+        check_range(v);
+
+    // Modifications make the ordered indexes stale, so queries must scan until
+    // they are built again
+    for (size_t i = 0; i < num_rows; i += 3)
+        set_row(i, int64_t(num_rows - i));
+    table.remove(1);
+    CHECK(!table.has_ordered_index(int_col));
+    CHECK(!table.has_ordered_index(ts_col));
+    for (int64_t v : {int64_t(0), int64_t(5), int64_t(num_rows - 5)})
+        check_range(v);
+    build_indexes();
+    for (int64_t v : {int64_t(0), int64_t(5), int64_t(num_rows - 5)})
+        check_range(v);
+}
+
+TEST(Query_SubstringOverIndexedStringColumn)
+{
+    // Substring queries on a column with a trigram index and its unindexed
+    // copy must agree whether or not the trigram index is selective enough to
+    // be used
+    Table table;
+    size_t str_col = table.add_column(type_String, "str", true);
+    size_t str_copy = table.add_column(type_String, "str_copy", true);
+    size_t int_col = table.add_column(type_Int, "int");
+    CHECK(!table.has_trigram_index(str_col));
+    table.set_trigram_index(str_col, true);
+    CHECK(table.has_trigram_index(str_col));
+    CHECK(!table.has_trigram_index(str_copy));
+    CHECK_LOGIC_ERROR(table.set_trigram_index(int_col, true), LogicError::type_mismatch);
+
+    const char* words[] = {"Apple", "banana", "CHERRY", "dates", "Elder\xc3\x86", "fig"};
+    const size_t num_rows = 3 * REALM_MAX_BPNODE_SIZE;
+    table.add_empty_row(num_rows);
+    auto set_row = [&](size_t i, size_t v) {
+        if (v % 11 == 0) {
+            table.set_null(str_col, i);
+            table.set_null(str_copy, i);
+            return;
+        }
+        std::string value = std::string(words[v % 6]) + " item" + util::to_string(v % 500) + " " + words[v % 5];
+        if (v % 13 == 0)
+            value = words[v % 6] + 3;
+        table.set_string(str_col, i, value);
+        table.set_string(str_copy, i, value);
+    };
+    for (size_t i = 0; i < num_rows; ++i)
+        set_row(i, (i * 7919) % num_rows);
+
+    auto check_same = [&](Query q, Query q_copy) {
+        TableView tv = q.find_all();
+        TableView tv_copy = q_copy.find_all();
+        CHECK_EQUAL(tv.size(), tv_copy.size());
+        for (size_t i = 0; i < tv.size() && i < tv_copy.size(); ++i)
+            CHECK_EQUAL(tv.get_source_ndx(i), tv_copy.get_source_ndx(i));
+    };
+    auto check_needles = [&] {
+        for (const char* needle : {"item123 ", "ITEM42 b", "rry", "RRY item7", "er\xc3\x86 it", "ana", "na", "", "zzz"}) {
+            for (bool case_sensitive : {true, false}) {
+                check_same(table.where().contains(str_col, needle, case_sensitive),
+                           table.where().contains(str_copy, needle, case_sensitive));
+                check_same(table.where().begins_with(str_col, needle, case_sensitive),
+                           table.where().begins_with(str_copy, needle, case_sensitive));
+                check_same(table.where().ends_with(str_col, needle, case_sensitive),
+                           table.where().ends_with(str_copy, needle, case_sensitive));
+            }
+        }
+        for (const char* pattern : {"*item12?*", "Apple item1?? *", "*IT?M4*da*", "*?les", "ban*"}) {
+            for (bool case_sensitive : {true, false}) {
+                check_same(table.where().like(str_col, pattern, case_sensitive),
+                           table.where().like(str_copy, pattern, case_sensitive));
+            }
+        }
+        check_same(table.where().contains(str_col, "item12").contains(str_col, "dates"),
+                   table.where().contains(str_copy, "item12").contains(str_copy, "dates"));
+        CHECK_EQUAL(table.where().contains(str_col, "item499 ").count(),
+                    table.where().contains(str_copy, "item499 ").count());
+    };
+    check_needles();
+
+    // Modifications must be picked up by the next query
+    for (size_t i = 0; i < num_rows; i += 3)
+        set_row(i, num_rows - i);
+    table.remove(1);
+    check_needles();
+
+    // Enumerated string columns have their own trigram index
+    table.optimize(true);
+    CHECK(table.has_trigram_index(str_col));
+    CHECK(!table.has_trigram_index(str_copy));
+    check_needles();
+}
+
+TEST(Query_ExpressionBatches)
+{
+    // Expressions are evaluated in batches of growing size, so check them row by
+    // row across leaf boundaries, with and without nulls and constant operands
+    Table table;
+    size_t int_col = table.add_column(type_Int, "int");
+    size_t int2_col = table.add_column(type_Int, "int2");
+    size_t null_col = table.add_column(type_Int, "null", true);
+    size_t dbl_col = table.add_column(type_Double, "dbl");
+    size_t dbl2_col = table.add_column(type_Double, "dbl2");
+
+    const size_t num_rows = 3 * REALM_MAX_BPNODE_SIZE + 17;
+    table.add_empty_row(num_rows);
+    auto set_row = [&](size_t i, size_t v) {
+        table.set_int(int_col, i, int64_t(v % 1000) - 100);
+        table.set_int(int2_col, i, int64_t(v % 7));
+        if (v % 5 == 0)
+            table.set_null(null_col, i);
+        else
+            table.set_int(null_col, i, int64_t(v % 300));
+        table.set_double(dbl_col, i, double(v % 1000) / 2);
+        table.set_double(dbl2_col, i, double((v * 31) % 1000) / 2);
+    };
+    for (size_t i = 0; i < num_rows; ++i)
+        set_row(i, (i * 7919) % num_rows);
+
+    auto check = [&](Query q, std::function<bool(size_t)> pred) {
+        TableView tv = q.find_all();
+        size_t j = 0;
+        for (size_t i = 0; i < table.size(); ++i) {
+            if (!pred(i))
+                continue;
+            if (!CHECK_LESS(j, tv.size()))
+                return;
+            CHECK_EQUAL(tv.get_source_ndx(j), i);
+            ++j;
+        }
+        CHECK_EQUAL(tv.size(), j);
+        CHECK_EQUAL(q.count(), j);
+    };
+    auto check_all = [&] {
+        Columns<Int> a = table.column<Int>(int_col);
+        Columns<Int> b = table.column<Int>(int2_col);
+        Columns<Int> n = table.column<Int>(null_col);
+        Columns<Double> d = table.column<Double>(dbl_col);
+        Columns<Double> d2 = table.column<Double>(dbl2_col);
+        auto get_a = [&](size_t i) { return table.get_int(int_col, i); };
+        auto get_b = [&](size_t i) { return table.get_int(int2_col, i); };
+        auto get_d = [&](size_t i) { return table.get_double(dbl_col, i); };
+        auto get_d2 = [&](size_t i) { return table.get_double(dbl2_col, i); };
+
+        check(a * b > 3000, [&](size_t i) { return get_a(i) * get_b(i) > 3000; });
+        check(a * 2 > 1700, [&](size_t i) { return get_a(i) * 2 > 1700; });
+        check(2 * a <= -150, [&](size_t i) { return 2 * get_a(i) <= -150; });
+        check(a + b == 10, [&](size_t i) { return get_a(i) + get_b(i) == 10; });
+        check(a - b != a, [&](size_t i) { return get_b(i) != 0; });
+        check(10 > a, [&](size_t i) { return 10 > get_a(i); });
+        check(n * b > 1500, [&](size_t i) { return !table.is_null(null_col, i) && table.get_int(null_col, i) * get_b(i) > 1500; });
+        check(n + 1 == null(), [&](size_t i) { return table.is_null(null_col, i); });
+        check(d * 2.0 > 900, [&](size_t i) { return get_d(i) * 2.0 > 900; });
+        check(d + d2 < 100, [&](size_t i) { return get_d(i) + get_d2(i) < 100; });
+        check(d > d2, [&](size_t i) { return get_d(i) > get_d2(i); });
+        check(a > b, [&](size_t i) { return get_a(i) > get_b(i); });
+        check(table.where().equal(int2_col, 3).and_query(a * b > 1500),
+              [&](size_t i) { return get_b(i) == 3 && get_a(i) * 3 > 1500; });
+    };
+    check_all();
+
+    // Modifications must be picked up by the next query
+    for (size_t i = 0; i < num_rows; i += 3)
+        set_row(i, num_rows - i);
+    table.remove(1);
+    table.insert_empty_row(5);
+    set_row(5, 999);
+    check_all();
+}
+
+TEST(Query_ColumnStatistics)
+{
+    // 40% of the values are 0, one in ten is null, and the rest are distinct
+    const size_t size = 100000;
+    auto get = [](size_t row_ndx, int64_t& value) {
+        if (row_ndx % 10 == 3)
+            return false;
+        value = row_ndx % 5 < 2 ? 0 : int64_t(row_ndx);
+        return true;
+    };
+    ColumnStatistics<int64_t> statistics;
+    CHECK(statistics.needs_refresh(size, 0));
+    statistics.build(size, get, 0);
+    CHECK(!statistics.needs_refresh(size, 0));
+    CHECK(!statistics.needs_refresh(size + size / 8, size / 8));
+    CHECK(statistics.needs_refresh(size + size / 8 + 1, 0));
+    CHECK(statistics.needs_refresh(size, size / 8 + 1));
+
+    // The statistics are built from a sample of the rows
+    CHECK_EQUAL(statistics.size(), size);
+    CHECK_APPROXIMATELY_EQUAL(statistics.null_count(), size / 10, 0.1);
+    CHECK_EQUAL(statistics.nan_count(), 0);
+    // Distinct values: 0 and 50000 others
+    CHECK_APPROXIMATELY_EQUAL(statistics.distinct_count(), 50001, 0.1);
+
+    CHECK_APPROXIMATELY_EQUAL(statistics.estimate<Equal>(0, false), 0.4, 0.1);
+    CHECK_LESS(statistics.estimate<Equal>(12345, false), 0.002);
+    CHECK_LESS(statistics.estimate<Equal>(-7, false), 0.002);
+    CHECK_APPROXIMATELY_EQUAL(statistics.estimate<NotEqual>(0, false), 0.6, 0.1);
+    CHECK_APPROXIMATELY_EQUAL(statistics.estimate<Equal>(0, true), 0.1, 0.001);
+    CHECK_APPROXIMATELY_EQUAL(statistics.estimate<NotEqual>(0, true), 0.9, 0.001);
+    CHECK_APPROXIMATELY_EQUAL(statistics.estimate<Greater>(50000, false), 0.25, 0.1);
+    CHECK_APPROXIMATELY_EQUAL(statistics.estimate<LessEqual>(50000, false), 0.65, 0.1);
+    CHECK_APPROXIMATELY_EQUAL(statistics.estimate<Less>(1, false), 0.4, 0.1);
+    CHECK_APPROXIMATELY_EQUAL(statistics.estimate<GreaterEqual>(1, false), 0.5, 0.1);
+    CHECK_LESS(statistics.estimate<BeginsWith>(1, false), 0);
+
+    // Strings are summarized by their hashes, which only supports equality
+    ColumnStatistics<StringData> string_statistics;
+    std::string values[] = {"common", "rare", "other"};
+    auto get_string = [&](size_t row_ndx, StringData& value) {
+        value = values[row_ndx % 10 == 0 ? 1 : row_ndx % 10 < 6 ? 0 : 2];
+        return true;
+    };
+    string_statistics.build(size, get_string, 0);
+    CHECK_APPROXIMATELY_EQUAL(string_statistics.distinct_count(), 3, 0.1);
+    CHECK_APPROXIMATELY_EQUAL(string_statistics.estimate<Equal>("common", false), 0.5, 0.1);
+    CHECK_APPROXIMATELY_EQUAL(string_statistics.estimate<Equal>("rare", false), 0.1, 0.1);
+    CHECK_LESS(string_statistics.estimate<Equal>("missing", false), 0.002);
+    CHECK_LESS(string_statistics.estimate<Greater>("common", false), 0);
+
+    // NaNs are counted, but kept out of the histogram, which must be sorted
+    ColumnStatistics<double> double_statistics;
+    auto get_double = [](size_t row_ndx, double& value) {
+        value = row_ndx % 4 == 0 ? std::numeric_limits<double>::quiet_NaN() : double(row_ndx % 100);
+        return true;
+    };
+    double_statistics.build(size, get_double, 0);
+    CHECK_APPROXIMATELY_EQUAL(double_statistics.nan_count(), size / 4, 0.1);
+    CHECK_APPROXIMATELY_EQUAL(double_statistics.distinct_count(), 75, 0.1);
+    CHECK_APPROXIMATELY_EQUAL(double_statistics.estimate<Less>(50.0, false), 0.37, 0.1);
+    CHECK_APPROXIMATELY_EQUAL(double_statistics.estimate<Equal>(2.0, false), 0.01, 0.2);
+    CHECK_APPROXIMATELY_EQUAL(double_statistics.estimate<NotEqual>(2.0, false), 0.99, 0.01);
+    CHECK_LESS(double_statistics.estimate<Equal>(std::numeric_limits<double>::quiet_NaN(), false), 0);
+
+    // Small columns are summarized exactly
+    ColumnStatistics<int64_t> small_statistics;
+    small_statistics.build(1000, get, 0);
+    CHECK_EQUAL(small_statistics.null_count(), 100);
+    CHECK_EQUAL(small_statistics.distinct_count(), 501);
+
+    // Empty columns
+    ColumnStatistics<double> empty;
+    empty.build(0, [](size_t, double&) { return true; }, 0);
+    CHECK_EQUAL(empty.distinct_count(), 0);
+    CHECK_LESS(empty.estimate<Equal>(1.0, false), 0);
+}
+
+TEST(Query_CostBasedConditionOrder)
+{
+    // The order in which the conditions are searched, and whether the search
+    // index is used, depends on the estimated number of matches. Check that
+    // results don't, on skewed data with and without indexes.
+    Table table;
+    size_t int_col = table.add_column(type_Int, "int");
+    size_t indexed_int_col = table.add_column(type_Int, "indexed_int", true);
+    size_t str_col = table.add_column(type_String, "str");
+    size_t indexed_str_col = table.add_column(type_String, "indexed_str");
+    size_t dbl_col = table.add_column(type_Double, "dbl");
+    table.add_search_index(indexed_int_col);
+    table.add_search_index(indexed_str_col);
+
+    const size_t num_rows = 3 * REALM_MAX_BPNODE_SIZE + 11;
+    table.add_empty_row(num_rows);
+    auto set_row = [&](size_t i, size_t v) {
+        bool common = v % 5 < 2;
+        std::string str = common ? "common" : "s" + util::to_string(v % 97);
+        table.set_int(int_col, i, int64_t(v));
+        if (v % 11 == 0)
+            table.set_null(indexed_int_col, i);
+        else
+            table.set_int(indexed_int_col, i, common ? 0 : int64_t(v % 97));
+        table.set_string(str_col, i, str);
+        table.set_string(indexed_str_col, i, str);
+        table.set_double(dbl_col, i, double(v));
+    };
+    for (size_t i = 0; i < num_rows; ++i)
+        set_row(i, (i * 7919) % num_rows);
+
+    auto check = [&](Query q, std::function<bool(size_t)> pred) {
+        std::vector<size_t> expected;
+        for (size_t i = 0; i < table.size(); ++i) {
+            if (pred(i))
+                expected.push_back(i);
+        }
+        TableView tv = q.find_all();
+        CHECK_EQUAL(tv.size(), expected.size());
+        for (size_t i = 0; i < tv.size() && i < expected.size(); ++i)
+            CHECK_EQUAL(tv.get_source_ndx(i), expected[i]);
+        CHECK_EQUAL(q.count(), expected.size());
+        CHECK_EQUAL(q.find(), expected.empty() ? not_found : expected[0]);
+    };
+    auto check_all = [&] {
+        auto get_int = [&](size_t i) { return table.get_int(int_col, i); };
+        auto get_indexed_int = [&](size_t i) {
+            return table.is_null(indexed_int_col, i) ? util::Optional<int64_t>()
+                                                      : util::make_optional(table.get_int(indexed_int_col, i));
+        };
+        auto get_str = [&](size_t i) { return table.get_string(str_col, i); };
+        auto get_dbl = [&](size_t i) { return table.get_double(dbl_col, i); };
+        int64_t high = int64_t(num_rows) - 30;
+
+        // A common value of an indexed column and'ed with a selective scan
+        check(table.where().equal(indexed_int_col, 0).greater(int_col, high),
+              [&](size_t i) { return get_indexed_int(i) == int64_t(0) && get_int(i) > high; });
+        check(table.where().greater(dbl_col, double(high)).equal(indexed_int_col, 0),
+              [&](size_t i) { return get_indexed_int(i) == int64_t(0) && get_dbl(i) > high; });
+        check(table.where().equal(indexed_str_col, "common").equal(str_col, "s5"),
+              [&](size_t) { return false; });
+        check(table.where().equal(indexed_str_col, "common").greater(int_col, high).equal(str_col, "common"),
+              [&](size_t i) { return get_str(i) == "common" && get_int(i) > high; });
+        // A rare value of an indexed column and'ed with a common one
+        check(table.where().equal(indexed_int_col, 7).not_equal(str_col, "s5"),
+              [&](size_t i) { return get_indexed_int(i) == int64_t(7); });
+        check(table.where().equal(indexed_int_col, null()).less(int_col, 2000),
+              [&](size_t i) { return !get_indexed_int(i) && get_int(i) < 2000; });
+        check(table.where().not_equal(indexed_int_col, 0).equal(str_col, "s3"),
+              [&](size_t i) { return get_str(i) == "s3"; });
+        // ORs of indexed conditions
+        check(table.where()
+                  .group()
+                  .equal(indexed_str_col, "s1")
+                  .Or()
+                  .equal(indexed_int_col, 2)
+                  .end_group()
+                  .greater(int_col, 1000),
+              [&](size_t i) {
+                  return (get_str(i) == "s1" || get_indexed_int(i) == int64_t(2)) && get_int(i) > 1000;
+              });
+        check(table.where()
+                  .less(dbl_col, 3000.0)
+                  .group()
+                  .equal(indexed_str_col, "common")
+                  .Or()
+                  .equal(indexed_str_col, "s4")
+                  .end_group(),
+              [&](size_t i) { return (get_str(i) == "common" || get_str(i) == "s4") && get_dbl(i) < 3000; });
+        check(table.where()
+                  .group()
+                  .equal(str_col, "s1")
+                  .Or()
+                  .equal(indexed_int_col, 0)
+                  .end_group()
+                  .equal(indexed_str_col, "s1"),
+              [&](size_t i) { return get_str(i) == "s1"; });
+    };
+    check_all();
+
+    // Modifications of fewer rows than needed to refresh the statistics must
+    // not affect the results, nor must a refresh
+    for (size_t i = 0; i < 20; ++i)
+        set_row(i, 0);
+    check_all();
+    for (size_t i = 0; i < num_rows; i += 2)
+        set_row(i, num_rows - i);
+    table.remove(1);
+    check_all();
+}
+
 TEST(Query_FindWithDescriptorOrderingOverTableviewSync)
 {
     Group g;
@@ -5940,7 +6403,6 @@ TEST(Query_Threads)
     ttt.add_column(type_String, "2");
 
     // Spread query search hits in an odd way to test more edge cases
-    // (thread job size is THREAD_CHUNK_SIZE = 10)
     for (int i = 0; i < 30; i++) {
         for (int j = 0; j < 10; j++) {
             add(ttt, 5, "a");
@@ -5954,8 +6416,7 @@ TEST(Query_Threads)
     }
     Query q1 = ttt.where().equal(0, 2).equal(1, "b");
 
-    // Note, set THREAD_CHUNK_SIZE to 1.000.000 or more for performance
-    // q1.set_threads(5);
+    q1.set_threads(5);
     TableView tv = q1.find_all();
 
     CHECK_EQUAL(30, tv.size());
@@ -5974,7 +6435,6 @@ TEST(Query_LongString)
     ttt.add_column(type_String, "2");
 
     // Spread query search hits in an odd way to test more edge cases
-    // (thread job size is THREAD_CHUNK_SIZE = 10)
     for (int i = 0; i < 30; i++) {
         for (int j = 0; j < 10; j++) {
             add(ttt, 5, "aaaaaaaaaaaaaaaaaa");
@@ -5988,8 +6448,7 @@ TEST(Query_LongString)
     }
     Query q1 = ttt.where().equal(0, 2).equal(1, "bbbbbbbbbbbbbbbbbb");
 
-    // Note, set THREAD_CHUNK_SIZE to 1.000.000 or more for performance
-    // q1.set_threads(5);
+    q1.set_threads(5);
     TableView tv = q1.find_all();
 
     CHECK_EQUAL(30, tv.size());
@@ -6008,7 +6467,6 @@ TEST(Query_LongEnum)
     ttt.add_column(type_String, "2");
 
     // Spread query search hits in an odd way to test more edge cases
-    // (thread job size is THREAD_CHUNK_SIZE = 10)
     for (int i = 0; i < 30; i++) {
         for (int j = 0; j < 10; j++) {
             add(ttt, 5, "aaaaaaaaaaaaaaaaaa");
@@ -6023,8 +6481,7 @@ TEST(Query_LongEnum)
     ttt.optimize();
     Query q1 = ttt.where().equal(0, 2).not_equal(1, "aaaaaaaaaaaaaaaaaa");
 
-    // Note, set THREAD_CHUNK_SIZE to 1.000.000 or more for performance
-    // q1.set_threads(5);
+    q1.set_threads(5);
     TableView tv = q1.find_all();
 
     CHECK_EQUAL(30, tv.size());
@@ -6035,6 +6492,216 @@ TEST(Query_LongEnum)
     }
 }
 
+TEST(Query_Parallel)
+{
+    Table table;
+    table.add_column(type_Int, "int");
+    table.add_column(type_Double, "double");
+    table.add_column(type_String, "string");
+    table.add_column(type_Int, "nullable", true);
+
+    // Enough rows for the search to be split into several chunks
+    const size_t num_rows = 20 * REALM_MAX_BPNODE_SIZE + 17;
+    table.add_empty_row(num_rows);
+    Random random(random_int<unsigned long>()); // Seed from slow global generator
+    for (size_t i = 0; i < num_rows; ++i) {
+        table.set_int(0, i, random.draw_int<int64_t>(-1000, 1000));
+        table.set_double(1, i, random.draw_int<int>(-1000, 1000) / 4.0);
+        table.set_string(2, i, random.draw_int<int>(0, 3) == 0 ? "foo" : "bar");
+        if (random.draw_bool())
+            table.set_int(3, i, random.draw_int<int64_t>(0, 100));
+    }
+
+    auto check = [&](Query q) {
+        Query parallel = q;
+        parallel.set_threads(4);
+        CHECK_EQUAL(parallel.get_threads(), 4);
+
+        TableView tv1 = q.find_all();
+        TableView tv2 = parallel.find_all();
+        TableView tv3 = q.find_all_multi();
+        CHECK_EQUAL(tv1.size(), tv2.size());
+        CHECK_EQUAL(tv1.size(), tv3.size());
+        for (size_t i = 0; i < tv1.size() && i < tv2.size() && i < tv3.size(); ++i) {
+            CHECK_EQUAL(tv1.get_source_ndx(i), tv2.get_source_ndx(i));
+            CHECK_EQUAL(tv1.get_source_ndx(i), tv3.get_source_ndx(i));
+        }
+        CHECK_EQUAL(q.count(), parallel.count());
+        CHECK_EQUAL(q.count(1000, num_rows - 1000), parallel.count(1000, num_rows - 1000));
+        CHECK_EQUAL(q.find_all(0, size_t(-1), 10).size(), parallel.find_all(0, size_t(-1), 10).size());
+
+        size_t cnt1, cnt2, ndx1, ndx2;
+        CHECK_EQUAL(q.sum_int(0, &cnt1), parallel.sum_int(0, &cnt2));
+        CHECK_EQUAL(cnt1, cnt2);
+        CHECK_EQUAL(q.sum_int(3, &cnt1), parallel.sum_int(3, &cnt2));
+        CHECK_EQUAL(cnt1, cnt2);
+        CHECK_EQUAL(q.maximum_int(0, &cnt1, 0, size_t(-1), size_t(-1), &ndx1),
+                    parallel.maximum_int(0, &cnt2, 0, size_t(-1), size_t(-1), &ndx2));
+        CHECK_EQUAL(cnt1, cnt2);
+        CHECK_EQUAL(ndx1, ndx2);
+        CHECK_EQUAL(q.minimum_int(0, &cnt1, 0, size_t(-1), size_t(-1), &ndx1),
+                    parallel.minimum_int(0, &cnt2, 0, size_t(-1), size_t(-1), &ndx2));
+        CHECK_EQUAL(cnt1, cnt2);
+        CHECK_EQUAL(ndx1, ndx2);
+        CHECK_EQUAL(q.sum_double(1, &cnt1), parallel.sum_double(1, &cnt2));
+        CHECK_EQUAL(cnt1, cnt2);
+        CHECK_EQUAL(q.maximum_double(1, &cnt1, 0, size_t(-1), size_t(-1), &ndx1),
+                    parallel.maximum_double(1, &cnt2, 0, size_t(-1), size_t(-1), &ndx2));
+        CHECK_EQUAL(cnt1, cnt2);
+        CHECK_EQUAL(ndx1, ndx2);
+        CHECK_EQUAL(q.average_int(0, &cnt1), parallel.average_int(0, &cnt2));
+        CHECK_EQUAL(cnt1, cnt2);
+    };
+
+    check(table.where().greater(0, 500));
+    check(table.where().greater(0, 0).equal(2, "foo"));
+    check(table.where().less(1, -100.0).Or().equal(0, 7));
+    check(table.where().Not().greater_equal(0, -900));
+    check(table.where().equal(3, null()));
+    check(table.where().equal(0, 5000));
+
+    table.add_search_index(2);
+    check(table.where().equal(2, "foo").less(0, 0));
+
+    // Queries without conditions or restricted by a view are executed serially
+    check(table.where());
+    TableView view = table.where().greater(0, 0).find_all();
+    check(table.where(&view).less(0, 500));
+}
+
+TEST(Query_ZoneMaps)
+{
+    Table table;
+    size_t col_int = table.add_column(type_Int, "int");
+    size_t col_null = table.add_column(type_Int, "nullable", true);
+    size_t col_double = table.add_column(type_Double, "double", true);
+    size_t col_ts = table.add_column(type_Timestamp, "timestamp", true);
+
+    // Time ordered rows spanning many leaves, so that most leaves can be skipped
+    const size_t num_rows = 10 * REALM_MAX_BPNODE_SIZE + 3;
+    table.add_empty_row(num_rows);
+    for (size_t i = 0; i < num_rows; ++i) {
+        int64_t v = int64_t(i);
+        table.set_int(col_int, i, v);
+        if (i % 7 != 0)
+            table.set_int(col_null, i, v);
+        if (i % 5 != 0)
+            table.set_double(col_double, i, v / 2.0);
+        if (i % 3 != 0)
+            table.set_timestamp(col_ts, i, Timestamp(v, int32_t(i % 1000)));
+    }
+
+    auto check = [&](Query q, std::function<bool(size_t)> pred) {
+        TableView tv = q.find_all();
+        size_t j = 0;
+        for (size_t i = 0; i < table.size(); ++i) {
+            if (pred(i)) {
+                if (!CHECK_LESS(j, tv.size()))
+                    return;
+                CHECK_EQUAL(tv.get_source_ndx(j), i);
+                ++j;
+            }
+        }
+        CHECK_EQUAL(j, tv.size());
+        CHECK_EQUAL(q.count(), tv.size());
+    };
+
+    auto run_checks = [&] {
+        int64_t x = int64_t(num_rows) - 10;
+        check(table.where().greater(col_int, x), [&](size_t i) { return table.get_int(col_int, i) > x; });
+        check(table.where().less_equal(col_int, 10), [&](size_t i) { return table.get_int(col_int, i) <= 10; });
+        check(table.where().equal(col_int, 4711), [&](size_t i) { return table.get_int(col_int, i) == 4711; });
+        check(table.where().not_equal(col_int, 4711), [&](size_t i) { return table.get_int(col_int, i) != 4711; });
+        check(table.where().greater(col_null, x), [&](size_t i) {
+            return !table.is_null(col_null, i) && table.get_int(col_null, i) > x;
+        });
+        check(table.where().equal(col_null, null()), [&](size_t i) { return table.is_null(col_null, i); });
+        check(table.where().less(col_double, 5.0), [&](size_t i) {
+            return !table.is_null(col_double, i) && table.get_double(col_double, i) < 5.0;
+        });
+        check(table.where().greater_equal(col_double, double(x) / 2), [&](size_t i) {
+            return !table.is_null(col_double, i) && table.get_double(col_double, i) >= double(x) / 2;
+        });
+        Timestamp ts(x, 500);
+        check(table.where().greater(col_ts, ts), [&](size_t i) {
+            return !table.is_null(col_ts, i) && table.get_timestamp(col_ts, i) > ts;
+        });
+        check(table.where().less_equal(col_ts, Timestamp(3, 3)), [&](size_t i) {
+            return !table.is_null(col_ts, i) && table.get_timestamp(col_ts, i) <= Timestamp(3, 3);
+        });
+        check(table.where().equal(col_ts, Timestamp(4711, 711)), [&](size_t i) {
+            return !table.is_null(col_ts, i) && table.get_timestamp(col_ts, i) == Timestamp(4711, 711);
+        });
+
+        // Aggregates run through the same leaf skipping
+        size_t count = 0, expected_count = 0;
+        int64_t sum = table.where().greater(col_int, x).sum_int(col_int, &count);
+        int64_t expected_sum = 0;
+        for (size_t i = 0; i < table.size(); ++i) {
+            int64_t v = table.get_int(col_int, i);
+            if (v > x) {
+                expected_sum += v;
+                ++expected_count;
+            }
+        }
+        CHECK_EQUAL(sum, expected_sum);
+        CHECK_EQUAL(count, expected_count);
+    };
+
+    run_checks();
+
+    // Modifications make the leaf summaries stale
+    size_t mid = num_rows / 2;
+    table.set_int(col_int, mid, 1000000);
+    table.set_int(col_null, mid + 1, 1000000);
+    table.set_null(col_null, mid + 2);
+    table.set_double(col_double, mid, -7.0);
+    table.set_timestamp(col_ts, mid, Timestamp(1000000, 0));
+    run_checks();
+
+    table.insert_empty_row(3, REALM_MAX_BPNODE_SIZE / 2);
+    table.remove(num_rows / 3);
+    table.move_last_over(10);
+    run_checks();
+
+    table.clear();
+    run_checks();
+}
+
+TEST(Query_ZoneMapsAcrossTransactions)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    std::unique_ptr<Replication> hist_r(make_in_realm_history(path));
+    std::unique_ptr<Replication> hist_w(make_in_realm_history(path));
+    SharedGroup sg_r(*hist_r, SharedGroupOptions(crypt_key()));
+    SharedGroup sg_w(*hist_w, SharedGroupOptions(crypt_key()));
+
+    const size_t num_rows = 10 * REALM_MAX_BPNODE_SIZE;
+    {
+        WriteTransaction wt(sg_w);
+        TableRef table = wt.add_table("table");
+        table->add_column(type_Int, "int");
+        table->add_empty_row(num_rows);
+        for (size_t i = 0; i < num_rows; ++i)
+            table->set_int(0, i, int64_t(i));
+        wt.commit();
+    }
+
+    const Group& g = sg_r.begin_read();
+    ConstTableRef table = g.get_table("table");
+    Query q = table->where().less(0, 0);
+    CHECK_EQUAL(q.count(), 0);
+
+    {
+        WriteTransaction wt(sg_w);
+        wt.get_table("table")->set_int(0, num_rows / 2, -1);
+        wt.commit();
+    }
+    LangBindHelper::advance_read(sg_r);
+    CHECK_EQUAL(q.count(), 1);
+    CHECK_EQUAL(table->where().less(0, 0).find(), num_rows / 2);
+}
+
 TEST(Query_BigString)
 {
     TestTable ttt;
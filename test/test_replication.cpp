@@ -25,6 +25,7 @@
 #include <realm.hpp>
 #include <realm/util/features.h>
 #include <realm/util/file.hpp>
+#include <realm/util/to_string.hpp>
 #include <realm/replication.hpp>
 #include <realm/history.hpp>
 
@@ -4083,4 +4084,119 @@ TEST(Replication_WriteWithoutHistory)
     }
 }
 
+
+TEST(Replication_BatchEraseRows)
+{
+    SHARED_GROUP_TEST_PATH(path_1);
+    SHARED_GROUP_TEST_PATH(path_2);
+
+    MyTrivialReplication repl(path_1);
+    SharedGroup sg_1(repl);
+    {
+        WriteTransaction wt(sg_1);
+        TableRef origin = wt.add_table("origin");
+        TableRef target = wt.add_table("target");
+        target->add_column(type_Int, "int");
+        target->add_column(type_String, "str");
+        target->add_search_index(0);
+        target->add_search_index(1);
+        origin->add_column_link(type_Link, "link", *target);
+        target->add_empty_row(100);
+        origin->add_empty_row(100);
+        for (size_t i = 0; i < 100; ++i) {
+            target->set_int(0, i, i);
+            std::string str = util::to_string(i % 10);
+            target->set_string(1, i, str);
+            origin->set_link(0, i, 99 - i);
+        }
+        wt.commit();
+    }
+    {
+        // Removes single rows as well as runs of consecutive rows, which are
+        // recorded as one instruction per row
+        WriteTransaction wt(sg_1);
+        TableRef target = wt.get_table("target");
+        size_t num_erased = target->where().less(0, 10).Or().between(0, 40, 59).Or().equal(1, "5").remove();
+        CHECK_EQUAL(37, num_erased);
+        wt.commit();
+    }
+
+    util::Logger& replay_logger = test_context.logger;
+    SharedGroup sg_2(path_2);
+    repl.replay_transacts(sg_2, replay_logger);
+    {
+        ReadTransaction rt_1(sg_1);
+        ReadTransaction rt_2(sg_2);
+        rt_1.get_group().verify();
+        rt_2.get_group().verify();
+        CHECK(rt_1.get_group() == rt_2.get_group());
+        ConstTableRef target = rt_2.get_table("target");
+        CHECK_EQUAL(63, target->size());
+        CHECK_EQUAL(10, target->get_int(0, 0));
+        CHECK_EQUAL(60, target->get_int(0, 27));
+        CHECK_EQUAL(27, target->find_first_int(0, 60));
+        CHECK_EQUAL(0, target->where().equal(1, "5").count());
+        CHECK_EQUAL(7, target->where().equal(1, "6").count());
+    }
+}
+
+
+TEST(Replication_BulkInsertRows)
+{
+    SHARED_GROUP_TEST_PATH(path_1);
+    SHARED_GROUP_TEST_PATH(path_2);
+
+    MyTrivialReplication repl(path_1);
+    SharedGroup sg_1(repl);
+    {
+        WriteTransaction wt(sg_1);
+        TableRef table = wt.add_table("table");
+        table->add_column(type_Int, "int");
+        table->add_column(type_Int, "int_null", true);
+        table->add_column(type_Double, "double");
+        table->add_column(type_String, "string");
+        table->add_column(type_String, "string_null", true);
+        table->add_column(type_Timestamp, "timestamp");
+        table->add_column(type_Bool, "unspecified");
+        table->add_search_index(3);
+        table->add_empty_row(2);
+        wt.commit();
+    }
+    {
+        // Default values, such as 0 in the first column and the empty string
+        // in the fourth, are not recorded in the transaction log, but must
+        // still be present after the replay
+        int64_t ints[] = {0, 1, 0, -3};
+        uint8_t nulls[] = {0x04};
+        double doubles[] = {0.0, 2.5, 1.5, 0.0};
+        StringData strings[] = {"", "a", "", "b"};
+        Timestamp timestamps[] = {Timestamp(0, 0), Timestamp(1, 1), Timestamp(0, 0), Timestamp(-1, -1)};
+        WriteTransaction wt(sg_1);
+        TableRef table = wt.get_table("table");
+        table->insert_rows(1, 4, {BulkColumn(0, ints), BulkColumn(1, ints, nulls), BulkColumn(2, doubles),
+                                  BulkColumn(3, strings), BulkColumn(4, strings), BulkColumn(5, timestamps)});
+        wt.commit();
+    }
+
+    util::Logger& replay_logger = test_context.logger;
+    SharedGroup sg_2(path_2);
+    repl.replay_transacts(sg_2, replay_logger);
+    {
+        ReadTransaction rt_1(sg_1);
+        ReadTransaction rt_2(sg_2);
+        rt_1.get_group().verify();
+        rt_2.get_group().verify();
+        CHECK(rt_1.get_group() == rt_2.get_group());
+        ConstTableRef table = rt_2.get_table("table");
+        CHECK_EQUAL(6, table->size());
+        CHECK_EQUAL(-3, table->get_int(0, 4));
+        CHECK(table->is_null(1, 3));
+        CHECK(!table->is_null(1, 1));
+        CHECK_EQUAL(1.5, table->get_double(2, 3));
+        CHECK(!table->is_null(4, 1));
+        CHECK(table->is_null(4, 5));
+        CHECK_EQUAL(4, table->find_first_string(3, "b"));
+    }
+}
+
 #endif // TEST_REPLICATION
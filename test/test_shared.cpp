@@ -145,10 +145,9 @@ TEST(Shared_Unattached)
 
 namespace {
 
-// async deamon does not start when launching unit tests from osx, so async is currently disabled on osx.
-// Also: async requires interprocess communication, which does not work with our current encryption support.
+// The multiprocess async test relies on fork(), so async is currently only tested on POSIX platforms.
 #if !defined(_WIN32) && !REALM_PLATFORM_APPLE
-#if REALM_ANDROID || defined DISABLE_ASYNC || REALM_ENABLE_ENCRYPTION
+#if REALM_ANDROID || defined DISABLE_ASYNC
 bool allow_async = false;
 #else
 bool allow_async = true;
@@ -1773,6 +1772,140 @@ TEST(Shared_SpaceOveruse)
 }
 
 
+TEST(Shared_SpaceReuseFragmented)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    SharedGroup sg(path, false, SharedGroupOptions(crypt_key()));
+    Random random(random_int<unsigned long>()); // Seed from slow global generator
+
+    // Strings of many different lengths leave free chunks of many different
+    // sizes behind when they are replaced
+    auto random_string = [&] { return std::string(random.draw_int(1, 600), 'x'); };
+    {
+        WriteTransaction wt(sg);
+        auto table = wt.add_table("table");
+        table->add_column(type_String, "text");
+        table->add_empty_row(2000);
+        for (size_t i = 0; i < 2000; ++i) {
+            std::string str = random_string();
+            table->set_string(0, i, str);
+        }
+        wt.commit();
+    }
+
+    auto modify = [&](int n) {
+        for (int i = 0; i < n; ++i) {
+            WriteTransaction wt(sg);
+            auto table = wt.get_table("table");
+            for (int j = 0; j < 50; ++j) {
+                std::string str = random_string();
+                table->set_string(0, random.draw_int_mod(table->size()), str);
+            }
+            wt.commit();
+        }
+    };
+
+    modify(50);
+    size_t size_before = util::File(path).get_size();
+    modify(200);
+    size_t size_after = util::File(path).get_size();
+
+    // The free space left behind by earlier transactions must be recycled
+    // rather than the file growing in proportion to the number of commits.
+    CHECK_LESS_EQUAL(size_after, 2 * size_before);
+
+    ReadTransaction rt(sg);
+    rt.get_group().verify();
+}
+
+
+TEST(Shared_IncrementalCompaction)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    SharedGroupOptions options(crypt_key());
+    options.compaction_budget = 64 * 1024;
+    std::unique_ptr<Replication> hist(make_in_realm_history(path));
+    SharedGroup sg(*hist, options);
+
+    // Fill the beginning of the file with a table that is removed again, and
+    // the end of the file with data that is kept.
+    auto fill = [&](const char* name) {
+        WriteTransaction wt(sg);
+        auto table = wt.add_table(name);
+        table->add_column(type_Int, "int");
+        table->add_column(type_String, "text");
+        table->add_empty_row(20000);
+        for (size_t i = 0; i < 20000; ++i) {
+            std::string str = util::to_string(i);
+            table->set_int(0, i, i);
+            table->set_string(1, i, str);
+        }
+        wt.commit();
+    };
+    fill("removed");
+    fill("kept");
+    {
+        WriteTransaction wt(sg);
+        wt.get_group().remove_table("removed");
+        wt.commit();
+    }
+    size_t size_before = util::File(path).get_size();
+
+    // Ordinary small transactions move the kept data in steps. Readers of
+    // older snapshots are not affected, and the file is not truncated while
+    // another SharedGroup has it open.
+    auto modify = [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            WriteTransaction wt(sg);
+            wt.get_table("kept")->set_int(0, 0, i);
+            wt.commit();
+        }
+    };
+    {
+        std::unique_ptr<Replication> hist2(make_in_realm_history(path));
+        SharedGroup sg2(*hist2, SharedGroupOptions(crypt_key()));
+        ReadTransaction rt(sg2);
+        modify(0, 25);
+        auto table = rt.get_table("kept");
+        for (size_t i = 0; i < 20000; ++i)
+            CHECK_EQUAL(table->get_string(1, i), util::to_string(i));
+        CHECK_GREATER_EQUAL(util::File(path).get_size(), size_before);
+    }
+    {
+        // Accessors which are kept across commits are updated
+        Group& group = const_cast<Group&>(sg.begin_read());
+        ConstTableRef table = group.get_table("kept");
+        for (int i = 25; i < 50; ++i) {
+            LangBindHelper::promote_to_write(sg);
+            group.get_table("kept")->set_int(0, 0, i);
+            LangBindHelper::commit_and_continue_as_read(sg);
+            CHECK_EQUAL(table->get_int(0, 0), i);
+        }
+        for (size_t i = 1; i < 20000; ++i) {
+            CHECK_EQUAL(table->get_int(0, i), int64_t(i));
+            CHECK_EQUAL(table->get_string(1, i), util::to_string(i));
+        }
+        sg.end_read();
+    }
+    size_t size_after = util::File(path).get_size();
+    if (!crypt_key()) {
+        // Encrypted files are only shrunk logically
+        CHECK_LESS(size_after, size_before * 3 / 4);
+    }
+    CHECK_LESS_EQUAL(size_after, size_before);
+
+    ReadTransaction rt(sg);
+    rt.get_group().verify();
+    auto table = rt.get_table("kept");
+    CHECK_EQUAL(table->size(), 20000);
+    CHECK_EQUAL(table->get_int(0, 0), 49);
+    for (size_t i = 1; i < 20000; ++i) {
+        CHECK_EQUAL(table->get_int(0, i), int64_t(i));
+        CHECK_EQUAL(table->get_string(1, i), util::to_string(i));
+    }
+}
+
+
 TEST(Shared_Notifications)
 {
     // Create a new shared db
@@ -1986,9 +2119,7 @@ TEST(Shared_ClearColumnWithBasicArrayRootLeaf)
 }
 
 // disable shared async on windows and any Apple operating system
-// TODO: enable async daemon for OS X - think how to do it in XCode (no issue for build.sh)
 #if !defined(_WIN32) && !REALM_PLATFORM_APPLE
-// Todo. Keywords: winbug
 TEST_IF(Shared_Async, allow_async)
 {
     SHARED_GROUP_TEST_PATH(path);
@@ -1996,7 +2127,7 @@ TEST_IF(Shared_Async, allow_async)
     // Do some changes in a async db
     {
         bool no_create = false;
-        SharedGroup db(path, no_create, SharedGroupOptions(SharedGroupOptions::Durability::Async));
+        SharedGroup db(path, no_create, SharedGroupOptions(SharedGroupOptions::Durability::Async, crypt_key()));
 
         for (size_t i = 0; i < 100; ++i) {
             //            std::cout << "t "<<n<<"\n";
@@ -2012,13 +2143,12 @@ TEST_IF(Shared_Async, allow_async)
         }
     }
 
-    // Wait for async_commit process to shutdown
-    // FIXME: we need a way to determine properly if the daemon has shot down instead of just sleeping
-    millisleep(1000);
+    // Closing the last SharedGroup makes all commits durable, so the data is
+    // found by a new session.
 
     // Read the db again in normal mode to verify
     {
-        SharedGroup db(path);
+        SharedGroup db(path, false, SharedGroupOptions(crypt_key()));
 
         ReadTransaction rt(db);
         rt.get_group().verify();
@@ -2028,6 +2158,51 @@ TEST_IF(Shared_Async, allow_async)
 }
 
 
+TEST_IF(Shared_AsyncDurableVersion, allow_async)
+{
+    SHARED_GROUP_TEST_PATH(path);
+
+    SharedGroupOptions options(SharedGroupOptions::Durability::Async, crypt_key());
+    options.async_commit_latency = std::chrono::milliseconds(1);
+    SharedGroup sg_1(path, false, options);
+    SharedGroup sg_2(path, false, options);
+
+    SharedGroup::version_type version = 0;
+    for (int i = 0; i < 10; ++i) {
+        SharedGroup& sg = i % 2 == 0 ? sg_1 : sg_2;
+        WriteTransaction wt(sg);
+        auto table = wt.get_or_add_table("test");
+        if (table->get_column_count() == 0)
+            table->add_column(type_Int, "i");
+        table->add_empty_row();
+        table->set_int(0, i, i);
+        version = wt.commit();
+    }
+
+    // The durable version may lag behind, but never passes the latest one
+    CHECK_LESS_EQUAL(sg_1.get_version_of_durable_snapshot(), version);
+
+    // The flusher must catch up well within the time limit
+    for (int i = 0; i < 1000; ++i) {
+        if (sg_1.get_version_of_durable_snapshot() == version)
+            break;
+        millisleep(10);
+    }
+    CHECK_EQUAL(version, sg_1.get_version_of_durable_snapshot());
+    CHECK_EQUAL(version, sg_2.get_version_of_durable_snapshot());
+
+    // With full durability, every committed snapshot is durable
+    SHARED_GROUP_TEST_PATH(path_2);
+    SharedGroup sg_3(path_2, false, SharedGroupOptions(crypt_key()));
+    {
+        WriteTransaction wt(sg_3);
+        wt.add_table("test");
+        version = wt.commit();
+    }
+    CHECK_EQUAL(version, sg_3.get_version_of_durable_snapshot());
+}
+
+
 namespace {
 
 #define multiprocess_increments 100
@@ -2127,9 +2302,6 @@ void multiprocess_make_table(std::string path, std::string lock_path, std::strin
     }
 #endif
 #endif
-    // Wait for async_commit process to shutdown
-    // FIXME: No good way of doing this
-    millisleep(1000);
 #else
     {
         Group g(alone_path, Group::mode_ReadWrite);
@@ -2182,10 +2354,7 @@ void multiprocess_threaded(TestContext& test_context, std::string path, size_t n
 void multiprocess_validate_and_clear(TestContext& test_context, std::string path, std::string lock_path, size_t rows,
                                      int result)
 {
-    // Wait for async_commit process to shutdown
-    // FIXME: this is not apropriate
     static_cast<void>(lock_path);
-    millisleep(1000);
 
     // Verify - once more, in sync mode - that the changes were made
     {
@@ -2226,9 +2395,6 @@ TEST_IF(Shared_AsyncMultiprocess, allow_async)
     SHARED_GROUP_TEST_PATH(path);
     SHARED_GROUP_TEST_PATH(alone_path);
 
-    // wait for any daemon hanging around to exit
-    millisleep(1); // FIXME: Is this really acceptable?
-
 #if TEST_DURATION < 1
     multiprocess_make_table(path, path.get_lock_path(), alone_path, 4);
 
@@ -3161,6 +3327,76 @@ TEST(Shared_SessionDurabilityConsistency)
 }
 
 
+TEST(Shared_GroupCommit)
+{
+    SHARED_GROUP_TEST_PATH(path);
+    SharedGroupOptions options;
+    options.enable_group_commit = true;
+    options.group_commit_window = std::chrono::microseconds(100);
+
+    const size_t num_threads = 8;
+    const int num_commits = 50;
+    {
+        std::unique_ptr<Replication> hist(make_in_realm_history(path));
+        SharedGroup sg(*hist, options);
+        {
+            WriteTransaction wt(sg);
+            TableRef t = wt.add_table("table");
+            t->add_column(type_Int, "value");
+            t->add_empty_row(num_threads);
+            wt.commit();
+        }
+
+        Thread threads[num_threads];
+        for (size_t i = 0; i < num_threads; ++i) {
+            threads[i].start([&path, &options, i] {
+                std::unique_ptr<Replication> hist_2(make_in_realm_history(path));
+                SharedGroup sg_2(*hist_2, options);
+                for (int j = 0; j < num_commits; ++j) {
+                    WriteTransaction wt(sg_2);
+                    TableRef t = wt.get_table("table");
+                    t->set_int(0, i, t->get_int(0, i) + 1);
+                    wt.commit();
+                }
+            });
+        }
+        for (size_t i = 0; i < num_threads; ++i)
+            threads[i].join();
+
+        // Committing and continuing as read must also make the snapshot durable
+        Group& group = const_cast<Group&>(sg.begin_read());
+        LangBindHelper::promote_to_write(sg);
+        group.get_table("table")->add_empty_row();
+        LangBindHelper::commit_and_continue_as_read(sg);
+        sg.end_read();
+    }
+
+    // A new session finds the latest snapshot through the file header
+    {
+        std::unique_ptr<Replication> hist(make_in_realm_history(path));
+        SharedGroup sg(*hist);
+        ReadTransaction rt(sg);
+        rt.get_group().verify();
+        ConstTableRef t = rt.get_table("table");
+        CHECK_EQUAL(num_threads + 1, t->size());
+        for (size_t i = 0; i < num_threads; ++i)
+            CHECK_EQUAL(num_commits, t->get_int(0, i));
+    }
+}
+
+
+TEST(Shared_GroupCommitConsistency)
+{
+    // Group commit must be used either by all or by none of the participants
+    // in a session.
+    SHARED_GROUP_TEST_PATH(path);
+    SharedGroupOptions options;
+    options.enable_group_commit = true;
+    SharedGroup sg(path, false, options);
+    CHECK_LOGIC_ERROR(SharedGroup(path, false, SharedGroupOptions()), LogicError::mixed_durability);
+}
+
+
 TEST(Shared_WriteEmpty)
 {
     SHARED_GROUP_TEST_PATH(path_1);
@@ -8407,4 +8407,267 @@ TEST(Table_getLinkType)
     CHECK_THROW(table->get_link_type(1), LogicError);
 }
 
+
+TEST(Table_BatchEraseRows)
+{
+    // Removing the rows of a query in one go must have the same effect as
+    // removing them one by one, also on search indexes, links and accessors.
+    Group g;
+    TableRef origin = g.add_table("origin");
+    TableRef target_1 = g.add_table("target_1");
+    TableRef target_2 = g.add_table("target_2");
+    const size_t num_rows = 300;
+    // A mix of single rows and runs of various lengths
+    auto erase = [](size_t i) { return i % 3 == 0 || (i >= 100 && i < 180) || i >= 290; };
+
+    for (TableRef t : {target_1, target_2}) {
+        t->add_column(type_Int, "int", true);
+        t->add_column(type_String, "str");
+        t->add_column(type_String, "enum");
+        t->add_column(type_Timestamp, "ts");
+        t->add_column(type_Bool, "erase");
+        t->add_column_link(type_Link, "link", *t);
+        t->add_column_link(type_LinkList, "list", *t);
+        for (size_t col_ndx = 0; col_ndx < 4; ++col_ndx)
+            t->add_search_index(col_ndx);
+        origin->add_column_link(type_Link, "link", *t);
+        origin->add_column_link(type_LinkList, "list", *t);
+
+        t->add_empty_row(num_rows);
+        for (size_t i = 0; i < num_rows; ++i) {
+            if (i % 7 != 0)
+                t->set_int(0, i, i % 13);
+            std::string str = util::to_string(i % 17);
+            t->set_string(1, i, str);
+            t->set_string(2, i, i % 2 ? "odd" : "even");
+            t->set_timestamp(3, i, Timestamp(i % 11, 0));
+            t->set_bool(4, i, erase(i));
+            t->set_link(5, i, (i * 7) % num_rows);
+            t->get_linklist(6, i)->add((i * 3) % num_rows);
+            t->get_linklist(6, i)->add(i);
+        }
+        t->optimize(true);
+    }
+    origin->add_empty_row(num_rows);
+    for (size_t i = 0; i < num_rows; ++i) {
+        for (size_t col_ndx = 0; col_ndx < 4; col_ndx += 2) {
+            origin->set_link(col_ndx, i, i);
+            origin->get_linklist(col_ndx + 1, i)->add((i * 5) % num_rows);
+        }
+    }
+
+    Row kept = (*target_2)[1];
+    Row erased = (*target_2)[3];
+    Row last = (*target_2)[289];
+    TableView all = target_2->where().find_all();
+
+    for (size_t i = num_rows; i > 0; --i) {
+        if (erase(i - 1))
+            target_1->remove(i - 1);
+    }
+    size_t num_erased = target_2->where().equal(4, true).remove();
+    CHECK_EQUAL(num_rows - target_1->size(), num_erased);
+    g.verify();
+
+    CHECK_EQUAL(target_1->size(), target_2->size());
+    for (size_t i = 0; i < target_1->size() && i < target_2->size(); ++i) {
+        CHECK_EQUAL(target_1->is_null(0, i), target_2->is_null(0, i));
+        CHECK_EQUAL(target_1->get_int(0, i), target_2->get_int(0, i));
+        CHECK_EQUAL(target_1->get_string(1, i), target_2->get_string(1, i));
+        CHECK_EQUAL(target_1->get_string(2, i), target_2->get_string(2, i));
+        CHECK(target_1->get_timestamp(3, i) == target_2->get_timestamp(3, i));
+        CHECK_EQUAL(target_1->get_link(5, i), target_2->get_link(5, i));
+        LinkViewRef list_1 = target_1->get_linklist(6, i);
+        LinkViewRef list_2 = target_2->get_linklist(6, i);
+        CHECK_EQUAL(list_1->size(), list_2->size());
+        for (size_t j = 0; j < list_1->size() && j < list_2->size(); ++j)
+            CHECK_EQUAL(list_1->get(j).get_index(), list_2->get(j).get_index());
+    }
+    for (size_t i = 0; i < num_rows; ++i) {
+        CHECK_EQUAL(origin->is_null_link(0, i), origin->is_null_link(2, i));
+        if (!origin->is_null_link(0, i))
+            CHECK_EQUAL(origin->get_link(0, i), origin->get_link(2, i));
+        LinkViewRef list_1 = origin->get_linklist(1, i);
+        LinkViewRef list_2 = origin->get_linklist(3, i);
+        CHECK_EQUAL(list_1->size(), list_2->size());
+        for (size_t j = 0; j < list_1->size() && j < list_2->size(); ++j)
+            CHECK_EQUAL(list_1->get(j).get_index(), list_2->get(j).get_index());
+    }
+    for (size_t i = 0; i < target_1->size(); ++i) {
+        CHECK_EQUAL(target_1->get_backlink_count(i, *origin, 0), target_2->get_backlink_count(i, *origin, 2));
+        CHECK_EQUAL(target_1->get_backlink_count(i, *origin, 1), target_2->get_backlink_count(i, *origin, 3));
+        CHECK_EQUAL(target_1->get_backlink_count(i, *target_1, 5), target_2->get_backlink_count(i, *target_2, 5));
+        CHECK_EQUAL(target_1->get_backlink_count(i, *target_1, 6), target_2->get_backlink_count(i, *target_2, 6));
+    }
+
+    // The search indexes must find the remaining rows at their new indexes
+    for (int i = 0; i < 13; ++i) {
+        CHECK_EQUAL(target_1->find_first_int(0, i), target_2->find_first_int(0, i));
+        CHECK_EQUAL(target_1->where().equal(0, i).count(), target_2->where().equal(0, i).count());
+    }
+    CHECK_EQUAL(target_1->where().equal(0, null()).count(), target_2->where().equal(0, null()).count());
+    for (int i = 0; i < 17; ++i) {
+        std::string str = util::to_string(i);
+        CHECK_EQUAL(target_1->find_first_string(1, str), target_2->find_first_string(1, str));
+        CHECK_EQUAL(target_1->where().equal(1, str).count(), target_2->where().equal(1, str).count());
+    }
+    CHECK_EQUAL(target_1->where().equal(2, "odd").count(), target_2->where().equal(2, "odd").count());
+    CHECK_EQUAL(target_1->find_first_string(2, "even"), target_2->find_first_string(2, "even"));
+    for (int i = 0; i < 11; ++i) {
+        Timestamp ts(i, 0);
+        CHECK_EQUAL(target_1->find_first_timestamp(3, ts), target_2->find_first_timestamp(3, ts));
+        CHECK_EQUAL(target_1->where().equal(3, ts).count(), target_2->where().equal(3, ts).count());
+    }
+
+    // Row accessors and views follow the remaining rows
+    CHECK(kept.is_attached());
+    CHECK_EQUAL(0, kept.get_index());
+    CHECK(!erased.is_attached());
+    CHECK(last.is_attached());
+    CHECK_EQUAL(target_2->size() - 1, last.get_index());
+    CHECK_EQUAL("0", last.get_string(1)); // 289 % 17
+    CHECK_EQUAL(num_rows, all.size());
+    CHECK_EQUAL(target_2->size(), all.num_attached_rows());
+    size_t num_attached = 0;
+    for (size_t i = 0; i < num_rows; ++i) {
+        CHECK_EQUAL(!erase(i), all.is_row_attached(i));
+        if (all.is_row_attached(i))
+            CHECK_EQUAL(num_attached++, all.get_source_ndx(i));
+    }
+}
+
+
+TEST(Table_BulkInsertRows)
+{
+    // Inserting rows from column-major buffers must have the same effect as
+    // inserting empty rows and setting each value individually.
+    Group g;
+    TableRef table_1 = g.add_table("table_1");
+    TableRef table_2 = g.add_table("table_2");
+    for (TableRef t : {table_1, table_2}) {
+        t->add_column(type_Int, "int");
+        t->add_column(type_Int, "int_null", true);
+        t->add_column(type_Bool, "bool");
+        t->add_column(type_Float, "float_null", true);
+        t->add_column(type_Double, "double");
+        t->add_column(type_String, "string");
+        t->add_column(type_String, "string_null", true);
+        t->add_column(type_String, "enum");
+        t->add_column(type_Binary, "binary");
+        t->add_column(type_Timestamp, "timestamp", true);
+        t->add_column(type_Double, "unspecified");
+        t->add_search_index(0);
+        t->add_search_index(1);
+        t->add_search_index(5);
+        t->add_search_index(7);
+        t->add_search_index(9);
+    }
+
+    const size_t num_rows = 200;
+    std::vector<int64_t> ints(num_rows);
+    std::vector<uint8_t> nulls((num_rows + 7) / 8);
+    bool bools[num_rows];
+    std::vector<float> floats(num_rows);
+    std::vector<double> doubles(num_rows);
+    std::vector<std::string> strings(num_rows);
+    std::vector<StringData> string_values(num_rows);
+    std::vector<StringData> nullable_string_values(num_rows);
+    std::vector<StringData> enum_values(num_rows);
+    std::vector<BinaryData> binaries(num_rows);
+    std::vector<Timestamp> timestamps(num_rows);
+    for (size_t i = 0; i < num_rows; ++i) {
+        ints[i] = i % 7 == 0 ? 0 : int64_t(i % 23) - 10;
+        if (i % 5 == 0)
+            nulls[i / 8] |= 1 << (i % 8);
+        bools[i] = i % 3 == 0;
+        floats[i] = i % 4 == 0 ? 0.0f : i * 0.25f;
+        doubles[i] = i % 6 == 0 ? 0.0 : i * -1.5;
+        strings[i] = i % 9 == 0 ? "" : "value " + util::to_string(i % 31);
+    }
+    for (size_t i = 0; i < num_rows; ++i) {
+        string_values[i] = strings[i];
+        nullable_string_values[i] = i % 4 == 0 ? StringData() : StringData(strings[i]);
+        enum_values[i] = i % 2 == 0 ? "even" : "odd";
+        binaries[i] = BinaryData(strings[i].data(), strings[i].size());
+        timestamps[i] = i % 8 == 0 ? Timestamp() : Timestamp(int64_t(i) + 100, int32_t(i));
+    }
+    std::vector<BulkColumn> columns = {
+        BulkColumn(0, ints.data()),         BulkColumn(1, ints.data(), nulls.data()),
+        BulkColumn(2, bools),               BulkColumn(3, floats.data(), nulls.data()),
+        BulkColumn(4, doubles.data()),      BulkColumn(5, string_values.data()),
+        BulkColumn(6, nullable_string_values.data()), BulkColumn(7, enum_values.data()),
+        BulkColumn(8, binaries.data()),     BulkColumn(9, timestamps.data()),
+    };
+    auto set_row = [&](TableRef t, size_t row_ndx, size_t i) {
+        t->set_int(0, row_ndx, ints[i]);
+        if (i % 5 == 0) {
+            t->set_null(1, row_ndx);
+            t->set_null(3, row_ndx);
+        }
+        else {
+            t->set_int(1, row_ndx, ints[i]);
+            t->set_float(3, row_ndx, floats[i]);
+        }
+        t->set_bool(2, row_ndx, bools[i]);
+        t->set_double(4, row_ndx, doubles[i]);
+        t->set_string(5, row_ndx, string_values[i]);
+        t->set_string(6, row_ndx, nullable_string_values[i]);
+        t->set_string(7, row_ndx, enum_values[i]);
+        t->set_binary(8, row_ndx, binaries[i]);
+        t->set_timestamp(9, row_ndx, timestamps[i]);
+    };
+
+    // Append to an empty table
+    table_1->add_empty_row(num_rows);
+    for (size_t i = 0; i < num_rows; ++i)
+        set_row(table_1, i, i);
+    CHECK_EQUAL(0, table_2->add_rows(num_rows, columns));
+    table_1->verify();
+    table_2->verify();
+    CHECK(*table_1 == *table_2);
+
+    // Insert in the middle, with an enumerated string column
+    table_1->optimize(true);
+    table_2->optimize(true);
+    Row row_before = (*table_2)[9];
+    Row row_after = (*table_2)[10];
+    table_1->insert_empty_row(10, num_rows);
+    for (size_t i = 0; i < num_rows; ++i)
+        set_row(table_1, 10 + i, i);
+    table_2->insert_rows(10, num_rows, columns);
+    table_1->verify();
+    table_2->verify();
+    CHECK(*table_1 == *table_2);
+    CHECK_EQUAL(9, row_before.get_index());
+    CHECK_EQUAL(10 + num_rows, row_after.get_index());
+
+    // The search indexes must find the rows at their new indexes
+    for (int64_t i = -10; i <= 12; ++i) {
+        CHECK_EQUAL(table_1->find_first_int(0, i), table_2->find_first_int(0, i));
+        CHECK_EQUAL(table_1->where().equal(1, i).count(), table_2->where().equal(1, i).count());
+    }
+    CHECK_EQUAL(table_1->where().equal(1, null()).count(), table_2->where().equal(1, null()).count());
+    for (size_t i = 0; i < 31; ++i) {
+        std::string str = "value " + util::to_string(i);
+        CHECK_EQUAL(table_1->find_first_string(5, str), table_2->find_first_string(5, str));
+        CHECK_EQUAL(table_1->where().equal(5, str).count(), table_2->where().equal(5, str).count());
+    }
+    CHECK_EQUAL(table_1->where().equal(7, "odd").count(), table_2->where().equal(7, "odd").count());
+    CHECK_EQUAL(table_1->find_first_timestamp(9, Timestamp(101, 1)), table_2->find_first_timestamp(9, Timestamp(101, 1)));
+    CHECK_EQUAL(table_1->where().equal(9, Timestamp()).count(), table_2->where().equal(9, Timestamp()).count());
+
+    // Invalid input must leave the table untouched
+    size_t size = table_2->size();
+    CHECK_LOGIC_ERROR(table_2->add_rows(1, {BulkColumn(11, ints.data())}), LogicError::column_index_out_of_range);
+    CHECK_LOGIC_ERROR(table_2->add_rows(1, {BulkColumn(0, doubles.data())}), LogicError::type_mismatch);
+    CHECK_LOGIC_ERROR(table_2->add_rows(1, {BulkColumn(0, ints.data()), BulkColumn(0, ints.data())}),
+                      LogicError::illegal_combination);
+    CHECK_LOGIC_ERROR(table_2->add_rows(1, {BulkColumn(0, ints.data(), nulls.data())}),
+                      LogicError::column_not_nullable);
+    CHECK_LOGIC_ERROR(table_2->add_rows(1, {BulkColumn(5, nullable_string_values.data())}),
+                      LogicError::column_not_nullable);
+    CHECK_LOGIC_ERROR(table_2->insert_rows(size + 1, 1, {}), LogicError::row_index_out_of_range);
+    CHECK_EQUAL(size, table_2->size());
+}
+
 #endif // TEST_TABLE
@@ -1520,6 +1520,42 @@ TEST(TableView_MultiColSort)
     CHECK_EQUAL(tv.get_float(1, 2), 1.f);
 }
 
+TEST(TableView_SortLargeNullableInt)
+{
+    // Large enough to take the radix sort path for single integer columns
+    const size_t num_rows = 1000;
+    Table table;
+    table.add_column(type_Int, "int", true);
+    table.add_empty_row(num_rows);
+    for (size_t i = 0; i < num_rows; ++i) {
+        if (i % 7 == 0)
+            table.set_null(0, i);
+        else
+            table.set_int(0, i, int64_t((i * 7919) % 101) - 50 + (i % 3 == 0 ? int64_t(1) << 40 : 0));
+    }
+
+    for (bool ascending : {true, false}) {
+        TableView tv = table.where().find_all();
+        tv.sort(0, ascending);
+        CHECK_EQUAL(tv.size(), num_rows);
+
+        // Nulls sort first in ascending order, and ties keep the row order
+        for (size_t i = 1; i < num_rows; ++i) {
+            bool prev_null = tv[i - 1].is_null(0);
+            bool cur_null = tv[i].is_null(0);
+            if (prev_null != cur_null) {
+                CHECK_EQUAL(prev_null, ascending);
+                continue;
+            }
+            if (!prev_null && tv.get_int(0, i - 1) != tv.get_int(0, i)) {
+                CHECK_EQUAL(tv.get_int(0, i - 1) < tv.get_int(0, i), ascending);
+                continue;
+            }
+            CHECK_LESS(tv.get_source_ndx(i - 1), tv.get_source_ndx(i));
+        }
+    }
+}
+
 TEST(TableView_QueryCopy)
 {
     Table table;
@@ -2221,6 +2257,40 @@ TEST(TableView_DistinctOverNullLink)
     CHECK_EQUAL(tv.get_source_ndx(1), 1);
 }
 
+TEST(TableView_DistinctMultipleColumnsKeepsFirst)
+{
+    Table table;
+    table.add_column(type_Double, "double", true);
+    table.add_column(type_String, "string", true);
+    table.add_empty_row(8);
+    table.set_double(0, 0, 0.0);
+    table.set_string(1, 0, "a");
+    table.set_double(0, 1, -0.0); // equal to 0.0
+    table.set_string(1, 1, "a");
+    table.set_null(0, 2);
+    table.set_string(1, 2, "a");
+    table.set_double(0, 3, 1.5);
+    table.set_null(1, 3);
+    table.set_null(0, 4);
+    table.set_string(1, 4, "a");
+    table.set_double(0, 5, 1.5);
+    table.set_string(1, 5, "");
+    table.set_double(0, 6, 1.5);
+    table.set_null(1, 6);
+    table.set_double(0, 7, 0.0);
+    table.set_string(1, 7, "b");
+
+    TableView tv = table.where().find_all();
+    tv.sort(1, false);
+    tv.distinct(DistinctDescriptor(table, {{0}, {1}}));
+    CHECK_EQUAL(tv.size(), 5);
+    CHECK_EQUAL(tv.get_source_ndx(0), 7);
+    CHECK_EQUAL(tv.get_source_ndx(1), 0);
+    CHECK_EQUAL(tv.get_source_ndx(2), 2);
+    CHECK_EQUAL(tv.get_source_ndx(3), 5);
+    CHECK_EQUAL(tv.get_source_ndx(4), 3);
+}
+
 TEST(TableView_IsRowAttachedAfterClear)
 {
     Table t;
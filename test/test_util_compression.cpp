@@ -0,0 +1,134 @@
+/*************************************************************************
+ *
+ * Copyright 2018 Realm Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ **************************************************************************/
+
+#include "testsettings.hpp"
+#ifdef TEST_UTIL_COMPRESSION
+
+#include <string>
+#include <vector>
+
+#include <realm/util/compression.hpp>
+
+#include "test.hpp"
+
+using namespace realm;
+using namespace realm::util;
+using namespace realm::test_util;
+
+namespace {
+
+// Returns the compressed block, or an empty string if it did not fit.
+std::string compress(const std::string& data, size_t out_size)
+{
+    std::vector<char> buffer(out_size);
+    size_t size = compression::compress_block(data.data(), data.size(), buffer.data(), buffer.size());
+    return std::string(buffer.data(), size);
+}
+
+bool round_trips(const std::string& data)
+{
+    std::string compressed = compress(data, 2 * data.size() + 16);
+    if (compressed.empty())
+        return false;
+    std::vector<char> out(data.size() + 1);
+    if (!compression::decompress_block(compressed.data(), compressed.size(), out.data(), data.size()))
+        return false;
+    return std::string(out.data(), data.size()) == data;
+}
+
+} // unnamed namespace
+
+
+TEST(Compression_RoundTrip)
+{
+    CHECK(round_trips(""));
+    CHECK(round_trips("a"));
+    CHECK(round_trips("abcd"));
+    CHECK(round_trips("abcdabcdabcdabcd"));
+    CHECK(round_trips(std::string(compression::max_block_size, 'x')));
+
+    Random random(random_int<unsigned long>()); // Seed from slow global generator
+    for (int i = 0; i < 100; ++i) {
+        // Draw from a small alphabet to get a mix of matches and literals
+        size_t size = random.draw_int<size_t>(0, compression::max_block_size);
+        int alphabet_size = random.draw_int(1, 256);
+        std::string data(size, '\0');
+        for (char& c : data)
+            c = char(random.draw_int(0, alphabet_size - 1));
+        CHECK(round_trips(data));
+    }
+}
+
+
+TEST(Compression_Ratio)
+{
+    std::string data;
+    for (int i = 0; i < 1000; ++i)
+        data += "set_int(" + std::to_string(i % 7) + ");";
+    std::string compressed = compress(data, data.size());
+    CHECK_LESS(compressed.size(), data.size() / 4);
+}
+
+
+TEST(Compression_GiveUp)
+{
+    Random random(random_int<unsigned long>());
+    std::string data(1000, '\0');
+    for (char& c : data)
+        c = char(random.draw_int(0, 255));
+    // Random data does not compress, so it does not fit in fewer bytes
+    CHECK(compress(data, data.size() - 1).empty());
+    CHECK(compress(data, 0).empty());
+}
+
+
+TEST(Compression_Malformed)
+{
+    std::string data;
+    for (int i = 0; i < 100; ++i)
+        data += "abcdefgh" + std::to_string(i);
+    std::string compressed = compress(data, data.size());
+    CHECK(!compressed.empty());
+    std::vector<char> out(data.size() + 1);
+
+    // Wrong decompressed size
+    CHECK(!compression::decompress_block(compressed.data(), compressed.size(), out.data(), data.size() - 1));
+    CHECK(!compression::decompress_block(compressed.data(), compressed.size(), out.data(), data.size() + 1));
+
+    // Truncated input
+    for (size_t i = 0; i < compressed.size(); ++i)
+        CHECK(!compression::decompress_block(compressed.data(), i, out.data(), data.size()));
+
+    // A match that refers to data before the start of the output
+    const char bad_offset[] = {0x10, 'a', 0x02, 0x00, 0x00};
+    CHECK(!compression::decompress_block(bad_offset, sizeof bad_offset, out.data(), 5));
+
+    // Random garbage must never be accepted as anything but a correctly sized
+    // output, and must never write outside of it
+    Random random(random_int<unsigned long>());
+    for (int i = 0; i < 1000; ++i) {
+        std::string garbage(random.draw_int<size_t>(0, 64), '\0');
+        for (char& c : garbage)
+            c = char(random.draw_int(0, 255));
+        size_t size = random.draw_int<size_t>(0, 256);
+        std::vector<char> out_2(size);
+        compression::decompress_block(garbage.data(), garbage.size(), out_2.data(), size);
+    }
+}
+
+#endif // TEST_UTIL_COMPRESSION
@@ -78,6 +78,7 @@
 
 #define TEST_UTIL_ANY
 #define TEST_UTIL_BASE64
+#define TEST_UTIL_COMPRESSION
 #define TEST_UTIL_ERROR
 #define TEST_UTIL_INSPECT
 #define TEST_UTIL_FILE
@@ -95,8 +96,4 @@
 // test could perhaps be modified to trigger it (unless it's a language binding problem).
 //#define JAVA_MANY_COLUMNS_CRASH
 
-// Temporarily disable async testing until use of sleep() in the async tests have
-// been replaced with a better solution.
-#define DISABLE_ASYNC
-
 #endif